@@ -502,6 +502,7 @@ absl::Status XlaComputationLaunchContext::PopulateOutputs(
                                    use_multiple_streams_, definition_event));
     var->is_initialized |= write.modified;
     *var->tensor() = output_tensor;
+    var->MarkAllRowsDirty();
     ++output_num;
   }
   return absl::OkStatus();
@@ -778,6 +779,7 @@ absl::Status PopulateCtxOutputsFromPjRtExecutableOutputs(
     }
 
     var->is_initialized |= write.modified;
+    var->MarkAllRowsDirty();
     ++output_num;
   }
   return absl::OkStatus();
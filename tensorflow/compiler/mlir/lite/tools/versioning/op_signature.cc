@@ -255,6 +255,13 @@ OpSignature GetOpSignature(const OperatorCode* op_code, const Operator* op,
             table_quant->scale()->size() > 1 &&
             IsTensorSizeEqual(table_quant->scale()->size(),
                               table_tensor->shape()->Get(0));
+        const int last_dim = table_tensor->shape()->size() - 1;
+        op_sig.ext_options.embedding_lookup
+            .is_per_embedding_channel_quantized =
+            table_quant->scale()->size() > 1 && last_dim > 0 &&
+            table_quant->quantized_dimension() == last_dim &&
+            IsTensorSizeEqual(table_quant->scale()->size(),
+                              table_tensor->shape()->Get(last_dim));
       }
     } break;
 
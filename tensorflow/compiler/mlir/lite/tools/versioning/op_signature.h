@@ -77,6 +77,9 @@ typedef struct {
     } add;
     struct {
       bool is_per_channel_quantized;
+      // Quantized along the channels of the embeddings (the last dimension)
+      // rather than the rows.
+      bool is_per_embedding_channel_quantized;
     } embedding_lookup;
   } ext_options;
 } OpSignature;
@@ -146,6 +146,10 @@ int GetBuiltinOperatorVersion(const OpSignature& op_sig) {
     }
 
     case BuiltinOperator_EMBEDDING_LOOKUP: {
+      if (op_sig.ext_options.embedding_lookup
+              .is_per_embedding_channel_quantized) {
+        return 5;
+      }
       if (op_sig.inputs.at(1).type == kTfLiteInt4 ||
           op_sig.ext_options.embedding_lookup.is_per_channel_quantized) {
         return 4;
@@ -153,6 +157,15 @@ int GetBuiltinOperatorVersion(const OpSignature& op_sig) {
       return 1;
     }
 
+    case BuiltinOperator_EMBEDDING_LOOKUP_SPARSE: {
+      // Hybrid tables, dequantized while the rows are combined.
+      if (op_sig.inputs.at(4).type == kTfLiteInt8 ||
+          op_sig.inputs.at(4).type == kTfLiteInt4) {
+        return 2;
+      }
+      return 1;
+    }
+
     case BuiltinOperator_FAKE_QUANT: {
       auto fake_quant_params =
           reinterpret_cast<TfLiteFakeQuantParams*>(op_sig.builtin_data);
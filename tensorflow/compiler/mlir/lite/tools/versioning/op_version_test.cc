@@ -1029,6 +1029,39 @@ TEST(OpVersionTest, VersioningTransposeTest) {
   };
   EXPECT_EQ(GetBuiltinOperatorVersion(fake_op_sig), 1);
 }
+TEST(OpVersionTest, VersioningEmbeddingLookupTest) {
+  OpSignature fake_op_sig = {
+      .op = BuiltinOperator_EMBEDDING_LOOKUP,
+      .inputs = CreateOpSignatureTensorSpecs(
+          std::vector<TfLiteType>{kTfLiteInt32, kTfLiteInt8}),
+      .outputs = CreateOpSignatureTensorSpecs(kTfLiteFloat32),
+  };
+  EXPECT_EQ(GetBuiltinOperatorVersion(fake_op_sig), 1);
+
+  fake_op_sig.ext_options.embedding_lookup.is_per_channel_quantized = true;
+  EXPECT_EQ(GetBuiltinOperatorVersion(fake_op_sig), 4);
+
+  fake_op_sig.ext_options.embedding_lookup.is_per_channel_quantized = false;
+  fake_op_sig.ext_options.embedding_lookup.is_per_embedding_channel_quantized =
+      true;
+  EXPECT_EQ(GetBuiltinOperatorVersion(fake_op_sig), 5);
+}
+
+TEST(OpVersionTest, VersioningEmbeddingLookupSparseTest) {
+  OpSignature fake_op_sig = {
+      .op = BuiltinOperator_EMBEDDING_LOOKUP_SPARSE,
+      .inputs = CreateOpSignatureTensorSpecs(std::vector<TfLiteType>{
+          kTfLiteInt32, kTfLiteInt32, kTfLiteInt32, kTfLiteFloat32,
+          kTfLiteFloat32}),
+      .outputs = CreateOpSignatureTensorSpecs(kTfLiteFloat32),
+  };
+  EXPECT_EQ(GetBuiltinOperatorVersion(fake_op_sig), 1);
+
+  fake_op_sig.inputs = CreateOpSignatureTensorSpecs(std::vector<TfLiteType>{
+      kTfLiteInt32, kTfLiteInt32, kTfLiteInt32, kTfLiteFloat32, kTfLiteInt4});
+  EXPECT_EQ(GetBuiltinOperatorVersion(fake_op_sig), 2);
+}
+
 TEST(OpVersionTest, VersioningGatherNdOperatorTest) {
   OpSignature fake_op_sig = {
       .op = BuiltinOperator_GATHER_ND,
@@ -15,6 +15,11 @@ limitations under the License.
 
 #include "tensorflow/core/framework/resource_var.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 #include "tensorflow/core/framework/resource_handle.h"
 #include "tensorflow/core/graph/graph_def_builder.h"
 
@@ -45,4 +50,59 @@ std::string Var::MakeRefCountingHandleName(int64_t resource_id) const {
   std::string handle_name = absl::StrFormat("%s%d", debug_name_, resource_id);
   return handle_name;
 }
+
+std::atomic<int64_t> Var::num_dirty_row_tracking_vars_{0};
+
+Var::~Var() {
+  if (dirty_row_tracking_enabled()) {
+    num_dirty_row_tracking_vars_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+void Var::EnableDirtyRowTracking() {
+  mu_.assert_held();
+  mutex_lock l(dirty_rows_mu_);
+  all_rows_dirty_ = false;
+  dirty_rows_.clear();
+  if (!dirty_row_tracking_enabled_.exchange(true)) {
+    num_dirty_row_tracking_vars_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void Var::MarkAllRowsDirty() {
+  if (!dirty_row_tracking_enabled()) return;
+  mu_.assert_held_shared();
+  mutex_lock l(dirty_rows_mu_);
+  all_rows_dirty_ = true;
+  dirty_rows_.clear();
+}
+
+std::vector<std::pair<int64_t, int64_t>> Var::TakeDirtyRowRanges(
+    int64_t num_rows) {
+  mu_.assert_held();
+  std::vector<int64_t> rows;
+  {
+    mutex_lock l(dirty_rows_mu_);
+    if (all_rows_dirty_) {
+      all_rows_dirty_ = false;
+      if (num_rows <= 0) return {};
+      return {{0, num_rows}};
+    }
+    rows.assign(dirty_rows_.begin(), dirty_rows_.end());
+    dirty_rows_.clear();
+  }
+  std::sort(rows.begin(), rows.end());
+
+  std::vector<std::pair<int64_t, int64_t>> ranges;
+  for (int64_t row : rows) {
+    // Updates with out-of-range indices fail, so they changed nothing.
+    if (row < 0 || row >= num_rows) continue;
+    if (!ranges.empty() && ranges.back().second == row) {
+      ++ranges.back().second;
+    } else {
+      ranges.emplace_back(row, row + 1);
+    }
+  }
+  return ranges;
+}
 }  //  end namespace tensorflow
@@ -16,8 +16,14 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_FRAMEWORK_RESOURCE_VAR_H_
 #define TENSORFLOW_CORE_FRAMEWORK_RESOURCE_VAR_H_
 
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "absl/container/flat_hash_set.h"
+#include "absl/types/span.h"
 #include "tensorflow/core/framework/resource_base.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/core/status.h"
@@ -110,12 +116,64 @@ class Var : public ResourceBase {
   // so desired.
   std::atomic<bool> copy_on_read_mode{false};
 
+  // Dirty row tracking, for incremental checkpoints. Once enabled, the ops
+  // updating the variable record the rows (indices along the first dimension)
+  // they may have changed, and TakeDirtyRowRanges() returns them.
+  //
+  // The rows are recorded after the update is written and before mu_ is
+  // released. A save thus takes mu_ exclusively, then calls
+  // TakeDirtyRowRanges() and copies those rows of tensor() before releasing
+  // it: every update is then either in the copied rows, or recorded for the
+  // next save. Tracking is enabled under the same lock as the full save it
+  // follows. The SaveVariableDeltas op implements this protocol.
+  //
+  // REQUIRES: mu_ held exclusively.
+  void EnableDirtyRowTracking();
+  bool dirty_row_tracking_enabled() const {
+    return dirty_row_tracking_enabled_.load(std::memory_order_relaxed);
+  }
+
+  // Whether any variable tracks its dirty rows, so that update ops can skip
+  // looking up their variables otherwise.
+  static bool AnyDirtyRowTrackingEnabled() {
+    return num_dirty_row_tracking_vars_.load(std::memory_order_relaxed) > 0;
+  }
+
+  // Records `rows` as updated. Sparse updates may hold mu_ in shared mode
+  // only, so concurrent calls are allowed.
+  // REQUIRES: mu_ held, at least in shared mode.
+  template <typename Index>
+  void MarkRowsDirty(absl::Span<const Index> rows) {
+    if (!dirty_row_tracking_enabled()) return;
+    mu_.assert_held_shared();
+    mutex_lock l(dirty_rows_mu_);
+    if (all_rows_dirty_) return;
+    dirty_rows_.insert(rows.begin(), rows.end());
+  }
+
+  // Records all rows as updated, e.g. after a dense update.
+  // REQUIRES: mu_ held, at least in shared mode.
+  void MarkAllRowsDirty();
+
+  // Returns the rows updated since tracking was enabled or since the last
+  // call, as sorted, disjoint [begin, end) ranges within [0, num_rows), and
+  // starts tracking anew.
+  // REQUIRES: mu_ held exclusively.
+  std::vector<std::pair<int64_t, int64_t>> TakeDirtyRowRanges(
+      int64_t num_rows);
+
  private:
   mutex mu_;
   Tensor tensor_;
   std::string debug_name_;
 
-  ~Var() override {}
+  static std::atomic<int64_t> num_dirty_row_tracking_vars_;
+  std::atomic<bool> dirty_row_tracking_enabled_{false};
+  mutex dirty_rows_mu_;
+  bool all_rows_dirty_ TF_GUARDED_BY(dirty_rows_mu_) = false;
+  absl::flat_hash_set<int64_t> dirty_rows_ TF_GUARDED_BY(dirty_rows_mu_);
+
+  ~Var() override;
   Var(const Var&) = delete;
   void operator=(const Var&) = delete;
 };
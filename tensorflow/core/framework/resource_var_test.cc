@@ -15,6 +15,10 @@ limitations under the License.
 
 #include "tensorflow/core/framework/resource_var.h"
 
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/test.h"
 
@@ -34,5 +38,26 @@ TEST(ResourceVarTest, Uninitialize) {
   EXPECT_FALSE(var->is_initialized);
   EXPECT_TRUE(var->tensor()->data() == nullptr);
 }
+
+TEST(ResourceVarTest, DirtyRowTracking) {
+  RefCountPtr<Var> var{new Var(DT_FLOAT)};
+  mutex_lock l(*var->mu());
+  const std::vector<int32_t> rows = {3, 1, 2, 7};
+  var->MarkRowsDirty<int32_t>(rows);
+  EXPECT_TRUE(var->TakeDirtyRowRanges(5).empty());
+
+  var->EnableDirtyRowTracking();
+  EXPECT_TRUE(Var::AnyDirtyRowTrackingEnabled());
+  var->MarkRowsDirty<int32_t>(rows);
+  EXPECT_EQ(var->TakeDirtyRowRanges(5),
+            (std::vector<std::pair<int64_t, int64_t>>{{1, 4}}));
+  EXPECT_TRUE(var->TakeDirtyRowRanges(5).empty());
+
+  var->MarkRowsDirty<int32_t>(rows);
+  var->MarkAllRowsDirty();
+  EXPECT_EQ(var->TakeDirtyRowRanges(5),
+            (std::vector<std::pair<int64_t, int64_t>>{{0, 5}}));
+}
+
 }  // namespace core
 }  // namespace tensorflow
@@ -584,6 +584,12 @@ bool IsStridedSliceGrad(const NodeDef& node) {
   return node.op() == "StridedSliceGrad";
 }
 
+bool IsStringNGrams(const NodeDef& node) { return node.op() == "StringNGrams"; }
+
+bool IsStringSplitV2(const NodeDef& node) {
+  return node.op() == "StringSplitV2";
+}
+
 bool IsStringToHashBucketFast(const NodeDef& node) {
   return node.op() == "StringToHashBucketFast";
 }
@@ -190,6 +190,8 @@ bool IsStatefulPartitionedCall(const NodeDef& node);
 bool IsStopGradient(const NodeDef& node);
 bool IsStridedSlice(const NodeDef& node);
 bool IsStridedSliceGrad(const NodeDef& node);
+bool IsStringNGrams(const NodeDef& node);
+bool IsStringSplitV2(const NodeDef& node);
 bool IsStringToHashBucketFast(const NodeDef& node);
 bool IsSub(const NodeDef& node);
 bool IsSum(const NodeDef& node);
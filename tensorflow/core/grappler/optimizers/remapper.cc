@@ -74,6 +74,10 @@ namespace grappler {
 //
 // Sigmoid + Mul -> _MklSwish  // This fusion only works on Intel CPU.
 //
+// StringNGrams + StringToHashBucketFast -> _StringNGramsHashBucketFast
+//   (1) StringSplitV2 + StringNGrams + StringToHashBucketFast
+//       -> _StringSplitNGramsHashBucketFast
+//
 //
 // In all cases, the supported activation functions are Relu, Relu6, and Elu.
 //
@@ -92,6 +96,9 @@ constexpr char kFusedDepthwiseConv2dNative[] = "_FusedDepthwiseConv2dNative";
 constexpr char kFusedBatchNormEx[] = "_FusedBatchNormEx";
 constexpr char kFusedBatchNormGradEx[] = "_FusedBatchNormGradEx";
 constexpr char kTensorToHashBucket[] = "_TensorToHashBucketFast";
+constexpr char kStringNGramsHashBucket[] = "_StringNGramsHashBucketFast";
+constexpr char kStringSplitNGramsHashBucket[] =
+    "_StringSplitNGramsHashBucketFast";
 constexpr char kLeakyRelu[] = "LeakyRelu";
 constexpr char kMklFusedMish[] = "_MklFusedMish";
 constexpr char kRelu[] = "Relu";
@@ -170,6 +177,18 @@ struct TensorToHashBucket {
   int string_to_hash_bucket = kMissingIndex;
 };
 
+// StringNGrams + StringToHashBucketFast that can be replaced with a kernel that
+// hashes the n-grams without materializing them. If the n-grams are formed
+// from the tokens of a StringSplitV2 ("string_split") that nothing else
+// reads, the fused kernel re-splits its input instead.
+struct StringNGramsHashBucket {
+  StringNGramsHashBucket() = default;
+
+  int string_split = kMissingIndex;
+  int string_ngrams = kMissingIndex;
+  int string_to_hash_bucket = kMissingIndex;
+};
+
 // Pad followed by Conv3D/FusedConv3D
 struct PadWithConv3D {
   PadWithConv3D() = default;
@@ -2746,6 +2765,56 @@ bool FindTensorToHashBucket(const RemapperContext& ctx, int node_index,
   return true;
 }
 
+bool FindStringNGramsHashBucket(const RemapperContext& ctx, int node_index,
+                                StringNGramsHashBucket* matched) {
+  // Root of the pattern must be a StringToHashBucketFast.
+  const auto* node_view = ctx.graph_view.GetNode(node_index);
+  const auto* node_def = node_view->node();
+
+  if (!IsStringToHashBucketFast(*node_def) || !NodeIsOnCpu(node_def) ||
+      HasControlFaninOrFanout(*node_view)) {
+    return false;
+  }
+
+  // Input to the StringToHashBucketFast must be the n-grams of StringNGrams,
+  // and nothing else may read them.
+  if (node_view->NumRegularFanins() < 1) return false;
+
+  const auto& regular_fanin_0 = node_view->GetRegularFanin(0);
+  const auto* ngrams_node_view = regular_fanin_0.node_view();
+  const auto* ngrams_node_def = ngrams_node_view->node();
+
+  if (regular_fanin_0.index() != 0 || !IsStringNGrams(*ngrams_node_def) ||
+      !NodeIsOnCpu(ngrams_node_def) ||
+      HasControlFaninOrFanout(*ngrams_node_view) ||
+      !HasAtMostOneFanoutAtPort0(*ngrams_node_view) ||
+      IsInPreserveSet(ctx, ngrams_node_def) ||
+      ngrams_node_view->NumRegularFanins() < 2) {
+    return false;
+  }
+
+  StringNGramsHashBucket pattern;
+  pattern.string_ngrams = ngrams_node_view->node_index();
+  pattern.string_to_hash_bucket = node_index;
+
+  // The StringSplitV2 itself stays in the graph when its indices are used to
+  // build the n-gram splits, but it skips copying the tokens once the fused
+  // kernel is their only reader.
+  const auto& data_fanin = ngrams_node_view->GetRegularFanin(0);
+  const auto* split_node_view = data_fanin.node_view();
+  const auto* split_node_def = split_node_view->node();
+  if (data_fanin.index() == 1 && IsStringSplitV2(*split_node_def) &&
+      NodeIsOnCpu(split_node_def) &&
+      split_node_view->GetRegularFanout(1).size() == 1 &&
+      !IsInPreserveSet(ctx, split_node_def)) {
+    pattern.string_split = split_node_view->node_index();
+  }
+
+  *matched = pattern;
+
+  return true;
+}
+
 // clang-format off
 // HardSwish pattern
 //                        input     Const (value: 3)
@@ -4377,6 +4446,72 @@ absl::Status AddTensorToHashBucketNode(RemapperContext* ctx,
   return absl::OkStatus();
 }
 
+absl::Status AddStringNGramsHashBucketNode(
+    RemapperContext* ctx, const StringNGramsHashBucket& matched,
+    std::vector<bool>* invalidated_nodes, std::vector<bool>* nodes_to_delete) {
+  const GraphDef* graph = ctx->graph_view.graph();
+  const NodeDef& string_ngrams = graph->node(matched.string_ngrams);
+  const NodeDef& string_to_hash_bucket =
+      graph->node(matched.string_to_hash_bucket);
+  VLOG(2) << "Fuse StringNGrams with StringToHashBucketFast:"
+          << " string_split="
+          << (matched.string_split != kMissingIndex
+                  ? graph->node(matched.string_split).name()
+                  : "<none>")
+          << " string_ngrams=" << string_ngrams.name()
+          << " string_to_hash_bucket=" << string_to_hash_bucket.name();
+
+  // The fused node takes over the name of StringNGrams, so that readers of the
+  // n-gram splits are unchanged.
+  NodeDef fused_op;
+  fused_op.set_name(string_ngrams.name());
+  fused_op.set_device(string_ngrams.device());
+  auto* attr = fused_op.mutable_attr();
+  if (matched.string_split != kMissingIndex) {
+    const NodeDef& string_split = graph->node(matched.string_split);
+    fused_op.set_op(kStringSplitNGramsHashBucket);
+    fused_op.add_input(string_split.input(0));   // 0: input
+    fused_op.add_input(string_split.input(1));   // 1: sep
+    fused_op.add_input(string_ngrams.input(1));  // 2: data_splits
+    if (string_split.attr().contains("maxsplit")) {
+      (*attr)["maxsplit"] = string_split.attr().at("maxsplit");
+    }
+  } else {
+    fused_op.set_op(kStringNGramsHashBucket);
+    fused_op.add_input(string_ngrams.input(0));  // 0: data
+    fused_op.add_input(string_ngrams.input(1));  // 1: data_splits
+  }
+  for (const char* name :
+       {"separator", "ngram_widths", "left_pad", "right_pad", "pad_width",
+        "preserve_short_sequences", "Tsplits"}) {
+    if (string_ngrams.attr().contains(name)) {
+      (*attr)[name] = string_ngrams.attr().at(name);
+    }
+  }
+  (*attr)["num_buckets"] = string_to_hash_bucket.attr().at("num_buckets");
+
+  // Turn StringToHashBucketFast into an Identity of the bucket ids.
+  NodeDef identity_op;
+  identity_op.set_op("Identity");
+  identity_op.set_name(string_to_hash_bucket.name());
+  identity_op.set_device(string_to_hash_bucket.device());
+  identity_op.add_input(string_ngrams.name());
+  SetAttrValue(DT_INT64, &(*identity_op.mutable_attr())["T"]);
+
+  utils::Mutation* mutation = ctx->graph_view.GetMutationBuilder();
+  absl::Status status;
+  mutation->AddNode(std::move(fused_op), &status);
+  TF_RETURN_IF_ERROR(status);
+  mutation->AddNode(std::move(identity_op), &status);
+  TF_RETURN_IF_ERROR(status);
+  TF_RETURN_IF_ERROR(mutation->Apply());
+
+  (*invalidated_nodes)[matched.string_ngrams] = true;
+  (*invalidated_nodes)[matched.string_to_hash_bucket] = true;
+
+  return absl::OkStatus();
+}
+
 absl::Status AddFusedBatchMatMul(RemapperContext* ctx,
                                  const std::map<string, int>& matched_nodes_map,
                                  const std::set<int>& remove_node_indices,
@@ -5223,6 +5358,17 @@ absl::Status Remapper::Optimize(Cluster* cluster, const GrapplerItem& item,
       continue;
     }
 
+    // Remap [StringSplitV2+]StringNGrams+StringToHashBucketFast into the
+    // _String[Split]NGramsHashBucketFast.
+    StringNGramsHashBucket string_ngrams_hash_bucket;
+    if (allow_non_differentiable_rewrites &&
+        FindStringNGramsHashBucket(ctx, i, &string_ngrams_hash_bucket)) {
+      TF_RETURN_IF_ERROR(
+          AddStringNGramsHashBucketNode(&ctx, string_ngrams_hash_bucket,
+                                        &invalidated_nodes, &nodes_to_delete));
+      continue;
+    }
+
     // During inference, most of the inputs to FusedBatchNorm are constant, and
     // we can therefore replace the op with a much cheaper set of primitives.
     FusedBatchNorm fused_batch_norm;
@@ -1767,6 +1767,89 @@ TEST_F(RemapperTensorToHashBucketTest, I32) { RunTest<DT_INT32>(); }
 
 TEST_F(RemapperTensorToHashBucketTest, I64) { RunTest<DT_INT64>(); }
 
+class RemapperStringNGramsHashBucketTest : public RemapperTest {
+ public:
+  void RunTest(bool split_input) {
+    using ::tensorflow::ops::Placeholder;
+
+    tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+
+    auto input = Placeholder(s.WithOpName("input"), DT_STRING);
+    auto splits = ops::Const<int64_t>(s.WithOpName("splits"), {0, 2, 5, 6});
+    Output tokens = input;
+    if (split_input) {
+      auto sep = ops::Const(s.WithOpName("sep"), " ");
+      auto split = ops::StringSplitV2(s.WithOpName("split"), input, sep);
+      tokens = split.values;
+    }
+    auto ngrams = ops::StringNGrams(s.WithOpName("ngrams"), tokens, splits,
+                                    "|", {1, 2}, "LP", "RP", -1, false);
+    int num_buckets = 100;
+    auto to_bucket = ops::StringToHashBucketFast(
+        s.WithOpName("to_bucket"), ngrams.ngrams, num_buckets);
+    auto fetch = ops::Identity(s.WithOpName("fetch"), to_bucket);
+    auto fetch_splits =
+        ops::Identity(s.WithOpName("fetch_splits"), ngrams.ngrams_splits);
+
+    Tensor input_t =
+        split_input
+            ? test::AsTensor<tstring>({"a b", "c d e", "f"})
+            : test::AsTensor<tstring>({"a", "b", "c", "d", "e", "f"});
+
+    GrapplerItem item;
+    item.fetch = {"fetch", "fetch_splits"};
+    item.feed = {{"input", input_t}};
+    TF_ASSERT_OK(s.ToGraphDef(&item.graph));
+
+    // Place all nodes on CPU.
+    for (int i = 0; i < item.graph.node_size(); ++i) {
+      item.graph.mutable_node(i)->set_device("/device:CPU:0");
+    }
+
+    Remapper optimizer(RewriterConfig::ON);
+    GraphDef output;
+    TF_ASSERT_OK(optimizer.Optimize(nullptr, item, &output));
+
+    int found = 0;
+    for (const NodeDef& node : output.node()) {
+      if (node.name() == "ngrams") {
+        if (split_input) {
+          EXPECT_EQ(node.op(), "_StringSplitNGramsHashBucketFast");
+          ASSERT_EQ(node.input_size(), 3);
+          EXPECT_EQ(node.input(0), "input");
+          EXPECT_EQ(node.input(1), "sep");
+          EXPECT_EQ(node.input(2), "splits");
+        } else {
+          EXPECT_EQ(node.op(), "_StringNGramsHashBucketFast");
+          ASSERT_EQ(node.input_size(), 2);
+          EXPECT_EQ(node.input(0), "input");
+          EXPECT_EQ(node.input(1), "splits");
+        }
+        EXPECT_EQ(node.attr().at("num_buckets").i(), num_buckets);
+        found++;
+      }
+      if (node.name() == "to_bucket") {
+        EXPECT_EQ(node.op(), "Identity");
+        ASSERT_EQ(node.input_size(), 1);
+        EXPECT_EQ(node.input(0), "ngrams");
+        found++;
+      }
+    }
+    EXPECT_EQ(found, 2);
+
+    auto tensors_expected = EvaluateNodes(item.graph, item.fetch, item.feed);
+    ASSERT_EQ(tensors_expected.size(), 2);
+    auto tensors = EvaluateNodes(output, item.fetch, item.feed);
+    ASSERT_EQ(tensors.size(), 2);
+    test::ExpectTensorEqual<int64_t>(tensors[0], tensors_expected[0]);
+    test::ExpectTensorEqual<int64_t>(tensors[1], tensors_expected[1]);
+  }
+};
+
+TEST_F(RemapperStringNGramsHashBucketTest, Tokens) { RunTest(false); }
+
+TEST_F(RemapperStringNGramsHashBucketTest, SplitTokens) { RunTest(true); }
+
 class RemapperFuseMatMulWithBiasTest : public RemapperTest {
  public:
   template <DataType DTYPE>
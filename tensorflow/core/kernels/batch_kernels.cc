@@ -25,6 +25,7 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "xla/tsl/platform/errors.h"
 #include "xla/tsl/platform/statusor.h"
 #include "tensorflow/core/common_runtime/device_mgr.h"
@@ -65,6 +66,17 @@ constexpr char kMaxInflightBatchesAttr[] = "_max_inflight_batches";
 constexpr char kBatchesToAverageOverAttr[] = "_batches_to_average_over";
 constexpr char kFullBatchSchedulingBoostMicros[] =
     "_full_batch_scheduling_boost_micros";
+constexpr char kBatchLatencyTargetMicrosAttr[] = "_batch_latency_target_micros";
+constexpr char kEnableZeroCopyBatchAssemblyAttr[] =
+    "_enable_zero_copy_batch_assembly";
+constexpr char kBatchLengthDimensionAttr[] = "_batch_length_dimension";
+constexpr char kBatchLengthBucketsAttr[] = "_batch_length_buckets";
+constexpr char kBatchPriorityClassAttr[] = "_batch_priority_class";
+constexpr char kBatchFairShareWeightAttr[] = "_batch_fair_share_weight";
+constexpr char kBatchMaxStarvationMicrosAttr[] = "_batch_max_starvation_micros";
+constexpr char kBatchTaskDeadlineMicrosAttr[] = "_batch_task_deadline_micros";
+constexpr char kBatchSheddableTaskDeadlineMicrosAttr[] =
+    "_batch_sheddable_task_deadline_micros";
 
 // Default thread count in the per-process batching thread pool.
 constexpr int64_t kBatchThreadPoolSize = 128;
@@ -178,7 +190,8 @@ class BatchResource : public serving::BatchResourceBase {
                   serving::MixedPriorityBatchingPolicy::
                       kLowPriorityPaddingWithMaxBatchSize,
                   enable_large_batch_splitting,
-                  /*batch_padding_policy=*/"PAD_UP", resource);
+                  /*batch_padding_policy=*/"PAD_UP",
+                  /*fair_share_queues=*/false, resource);
   }
 
   static absl::Status Create(
@@ -192,7 +205,7 @@ class BatchResource : public serving::BatchResourceBase {
       const std::vector<int32>& low_priority_allowed_batch_sizes,
       serving::MixedPriorityBatchingPolicy mixed_priority_batching_policy,
       bool enable_large_batch_splitting, absl::string_view batch_padding_policy,
-      std::unique_ptr<BatchResource>* resource) {
+      bool fair_share_queues, std::unique_ptr<BatchResource>* resource) {
     BatcherT::Options batcher_options;
     batcher_options.num_batch_threads = num_batch_threads;
     if (mixed_priority_batching_policy ==
@@ -200,6 +213,13 @@ class BatchResource : public serving::BatchResourceBase {
       batcher_options.use_global_scheduler = true;
       batcher_options.rank_queues = true;
     }
+    if (fair_share_queues) {
+      // Queues can only share threads with the queues of other models in the
+      // global scheduler. There is one for fair-shared queues, whose thread
+      // count is that of its first user.
+      batcher_options.use_global_scheduler = true;
+      batcher_options.fair_share_queues = true;
+    }
     std::shared_ptr<BatcherT> batcher;
     TF_RETURN_IF_ERROR(BatcherT::Create(batcher_options, &batcher));
 
@@ -315,6 +335,57 @@ BatchFunctionKernel::BatchFunctionKernel(OpKernelConstruction* c)
 
   OP_REQUIRES_OK(c, c->GetAttr("f", &func_));
 
+  if (c->HasAttr(kBatchLatencyTargetMicrosAttr)) {
+    OP_REQUIRES_OK(c, c->GetAttr(kBatchLatencyTargetMicrosAttr,
+                                 &batch_latency_target_micros_));
+    OP_REQUIRES(c, batch_latency_target_micros_ >= 0,
+                errors::InvalidArgument(kBatchLatencyTargetMicrosAttr,
+                                        " must be non-negative; was ",
+                                        batch_latency_target_micros_));
+  }
+
+  if (c->HasAttr(kEnableZeroCopyBatchAssemblyAttr)) {
+    OP_REQUIRES_OK(c, c->GetAttr(kEnableZeroCopyBatchAssemblyAttr,
+                                 &enable_zero_copy_batch_assembly_));
+  }
+
+  if (c->HasAttr(kBatchLengthDimensionAttr)) {
+    OP_REQUIRES_OK(
+        c, c->GetAttr(kBatchLengthDimensionAttr, &batch_length_dimension_));
+    OP_REQUIRES(c, batch_length_dimension_ >= 0,
+                errors::InvalidArgument(kBatchLengthDimensionAttr,
+                                        " must be non-negative; was ",
+                                        batch_length_dimension_));
+  }
+  if (c->HasAttr(kBatchLengthBucketsAttr)) {
+    OP_REQUIRES_OK(
+        c, c->GetAttr(kBatchLengthBucketsAttr, &batch_length_buckets_));
+  }
+
+  if (c->HasAttr(kBatchPriorityClassAttr)) {
+    OP_REQUIRES_OK(
+        c, c->GetAttr(kBatchPriorityClassAttr, &batch_priority_class_));
+    fair_share_queues_ = true;
+  }
+  if (c->HasAttr(kBatchFairShareWeightAttr)) {
+    OP_REQUIRES_OK(
+        c, c->GetAttr(kBatchFairShareWeightAttr, &batch_fair_share_weight_));
+    fair_share_queues_ = true;
+  }
+  if (c->HasAttr(kBatchMaxStarvationMicrosAttr)) {
+    OP_REQUIRES_OK(c, c->GetAttr(kBatchMaxStarvationMicrosAttr,
+                                 &batch_max_starvation_micros_));
+    fair_share_queues_ = true;
+  }
+  if (c->HasAttr(kBatchTaskDeadlineMicrosAttr)) {
+    OP_REQUIRES_OK(c, c->GetAttr(kBatchTaskDeadlineMicrosAttr,
+                                 &batch_task_deadline_micros_));
+  }
+  if (c->HasAttr(kBatchSheddableTaskDeadlineMicrosAttr)) {
+    OP_REQUIRES_OK(c, c->GetAttr(kBatchSheddableTaskDeadlineMicrosAttr,
+                                 &batch_sheddable_task_deadline_micros_));
+  }
+
   if (c->HasAttr("enable_large_batch_splitting")) {
     OP_REQUIRES_OK(c, c->GetAttr("enable_large_batch_splitting",
                                  &enable_large_batch_splitting_));
@@ -445,10 +516,30 @@ void BatchFunctionKernel::ComputeAsync(OpKernelContext* c, DoneCallback done) {
           low_priority_batch_timeout_micros_,
           low_priority_max_enqueued_batches_, low_priority_allowed_batch_sizes_,
           mixed_priority_batching_policy, enable_large_batch_splitting_,
-          batch_padding_policy_, &new_resource));
+          batch_padding_policy_, fair_share_queues_, &new_resource));
       if (session_metadata) {
         new_resource->set_session_metadata(*session_metadata);
       }
+      if (batch_latency_target_micros_ > 0) {
+        new_resource->set_batch_latency_target(
+            absl::Microseconds(batch_latency_target_micros_));
+      }
+      if (enable_zero_copy_batch_assembly_) {
+        TF_RETURN_IF_ERROR(new_resource->EnableZeroCopyBatchAssembly());
+      }
+      if (batch_length_dimension_ > 0) {
+        TF_RETURN_IF_ERROR(new_resource->SetLengthBucketing(
+            batch_length_dimension_, batch_length_buckets_));
+      }
+      serving::BatchResourceBase::QueueSchedulingOptions scheduling_options;
+      scheduling_options.priority_class = batch_priority_class_;
+      scheduling_options.fair_share_weight = batch_fair_share_weight_;
+      scheduling_options.max_starvation_micros = batch_max_starvation_micros_;
+      scheduling_options.task_deadline_micros = batch_task_deadline_micros_;
+      scheduling_options.sheddable_task_deadline_micros =
+          batch_sheddable_task_deadline_micros_;
+      TF_RETURN_IF_ERROR(
+          new_resource->SetQueueSchedulingOptions(scheduling_options));
       *r = new_resource.release();
       return absl::OkStatus();
     };
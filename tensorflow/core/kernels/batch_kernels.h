@@ -112,6 +112,28 @@ class BatchFunctionKernel : public AsyncOpKernel {
   std::vector<int32> low_priority_allowed_batch_sizes_;
   std::string mixed_priority_policy_;
   std::string batch_padding_policy_;
+  // If positive, the p99 latency target the batch timeout and batch size are
+  // adjusted for. Only used with the non-adaptive scheduler.
+  int64_t batch_latency_target_micros_ = 0;
+  // If true, batches are assembled into pooled buffers and outputs are
+  // returned as aliased slices. Only used with the non-adaptive scheduler.
+  bool enable_zero_copy_batch_assembly_ = false;
+  // If positive, the dimension of the inputs holding the sequence length, and
+  // the length bucket boundaries; see BatchResourceBase::SetLengthBucketing.
+  // Only used with the non-adaptive scheduler.
+  int32 batch_length_dimension_ = 0;
+  std::vector<int32> batch_length_buckets_;
+  // The scheduling options of the batcher queues; see
+  // BatchResourceBase::QueueSchedulingOptions. If a priority class, fair
+  // share weight or starvation bound is set, the queues share the global
+  // scheduler fairly with those of other models. Only used with the
+  // non-adaptive scheduler.
+  int32 batch_priority_class_ = 0;
+  float batch_fair_share_weight_ = 1.0;
+  int64_t batch_max_starvation_micros_ = 0;
+  int64_t batch_task_deadline_micros_ = 0;
+  int64_t batch_sheddable_task_deadline_micros_ = 0;
+  bool fair_share_queues_ = false;
   NameAttrList func_;
   absl::optional<FunctionLibraryRuntime::Handle> fhandle_ TF_GUARDED_BY(mu_);
   bool enable_large_batch_splitting_ = false;
@@ -0,0 +1,118 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Benchmarks for assembling batch inputs and splitting batch outputs, with
+// concatenation into fresh tensors followed by a copying split, versus pooled
+// batch buffers with aliased output slices.
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_util.h"
+#include "tensorflow/core/kernels/batching_util/batch_input_buffer_pool.h"
+#include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace serving {
+namespace {
+
+// The largest allowed batch size, which batches are padded to.
+constexpr int64_t kMaxBatchSize = 128;
+
+// Returns `num_tasks` single-row task inputs with rows of `row_size` floats.
+std::vector<Tensor> MakeTaskInputs(int num_tasks, int64_t row_size) {
+  std::vector<Tensor> inputs;
+  inputs.reserve(num_tasks);
+  for (int i = 0; i < num_tasks; ++i) {
+    Tensor input(DT_FLOAT, TensorShape({1, row_size}));
+    input.flat<float>().setConstant(i);
+    inputs.push_back(std::move(input));
+  }
+  return inputs;
+}
+
+// Concatenates the tasks and the padding rows into a new tensor, then splits
+// the batch back into per-task copies, as BatchResourceBase does by default.
+void BM_ConcatPadSplit(::testing::benchmark::State& state) {
+  const int num_tasks = state.range(0);
+  const int64_t row_size = state.range(1);
+  const std::vector<Tensor> inputs = MakeTaskInputs(num_tasks, row_size);
+  std::vector<int64_t> sizes(num_tasks, 1);
+  sizes.push_back(kMaxBatchSize - num_tasks);
+
+  for (auto s : state) {
+    std::vector<Tensor> to_concatenate(inputs.begin(), inputs.end());
+    for (int i = num_tasks; i < kMaxBatchSize; ++i) {
+      to_concatenate.push_back(inputs[0]);
+    }
+    Tensor batch;
+    TF_CHECK_OK(tensor::Concat(to_concatenate, &batch));
+    std::vector<Tensor> outputs;
+    TF_CHECK_OK(tensor::Split(batch, sizes, &outputs));
+    testing::DoNotOptimize(outputs);
+  }
+  state.SetBytesProcessed(state.iterations() * kMaxBatchSize * row_size *
+                          sizeof(float));
+}
+
+// Copies the tasks and the padding rows into a pooled buffer, then splits the
+// batch into aliased slices.
+void BM_PooledAssembleSlice(::testing::benchmark::State& state) {
+  const int num_tasks = state.range(0);
+  const int64_t row_size = state.range(1);
+  const std::vector<Tensor> inputs = MakeTaskInputs(num_tasks, row_size);
+  std::vector<const Tensor*> to_assemble;
+  for (const Tensor& input : inputs) {
+    to_assemble.push_back(&input);
+  }
+  std::vector<int64_t> sizes(num_tasks, 1);
+  sizes.push_back(kMaxBatchSize - num_tasks);
+  BatchInputBufferPool::Options options;
+  options.max_batch_size = kMaxBatchSize;
+  std::unique_ptr<BatchInputBufferPool> pool;
+  TF_CHECK_OK(BatchInputBufferPool::Create(options, &pool));
+
+  for (auto s : state) {
+    Tensor batch;
+    TF_CHECK_OK(pool->GetBatchTensor(cpu_allocator(), DT_FLOAT,
+                                     TensorShape({row_size}), kMaxBatchSize,
+                                     &batch));
+    TF_CHECK_OK(AssembleBatch(to_assemble, inputs[0], &batch));
+    std::vector<Tensor> outputs;
+    if (!SplitIntoAlignedSlices(batch, sizes, &outputs)) {
+      TF_CHECK_OK(tensor::Split(batch, sizes, &outputs));
+    }
+    testing::DoNotOptimize(outputs);
+  }
+  state.SetBytesProcessed(state.iterations() * kMaxBatchSize * row_size *
+                          sizeof(float));
+}
+
+BENCHMARK(BM_ConcatPadSplit)
+    ->ArgNames({"tasks", "row_size"})
+    ->ArgsProduct({{1, 32, 100, 128}, {16, 256, 4096}});
+BENCHMARK(BM_PooledAssembleSlice)
+    ->ArgNames({"tasks", "row_size"})
+    ->ArgsProduct({{1, 32, 100, 128}, {16, 256, 4096}});
+
+}  // namespace
+}  // namespace serving
+}  // namespace tensorflow
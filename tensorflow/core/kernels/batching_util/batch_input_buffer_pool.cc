@@ -0,0 +1,214 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/batching_util/batch_input_buffer_pool.h"
+
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/types/span.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/mutex.h"
+
+namespace tensorflow {
+namespace serving {
+namespace {
+
+// Returns true if `tensor` is made of rows of `row_shape`.
+bool HasRowShape(const Tensor& tensor, const TensorShape& row_shape) {
+  if (tensor.dims() != row_shape.dims() + 1) {
+    return false;
+  }
+  for (int i = 0; i < row_shape.dims(); ++i) {
+    if (tensor.dim_size(i + 1) != row_shape.dim_size(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+absl::Status BatchInputBufferPool::Create(
+    const Options& options, std::unique_ptr<BatchInputBufferPool>* pool) {
+  if (options.max_batch_size <= 0) {
+    return errors::InvalidArgument("max_batch_size must be positive; was ",
+                                   options.max_batch_size);
+  }
+  if (options.max_buffers < 0) {
+    return errors::InvalidArgument("max_buffers must be non-negative; was ",
+                                   options.max_buffers);
+  }
+  pool->reset(new BatchInputBufferPool(options));
+  return absl::OkStatus();
+}
+
+absl::Status BatchInputBufferPool::GetBatchTensor(Allocator* allocator,
+                                                  DataType dtype,
+                                                  const TensorShape& row_shape,
+                                                  int64_t batch_size,
+                                                  Tensor* batch) {
+  if (batch_size < 0) {
+    return errors::InvalidArgument("Batch size must be non-negative; was ",
+                                   batch_size);
+  }
+  TensorShape batch_shape({batch_size});
+  batch_shape.AppendShape(row_shape);
+  if (batch_size > options_.max_batch_size) {
+    *batch = Tensor(allocator, dtype, batch_shape);
+    return absl::OkStatus();
+  }
+
+  {
+    mutex_lock l(mu_);
+    // `buffers_` is kept in least recently used first order.
+    auto lru_free_buffer = buffers_.end();
+    for (auto it = buffers_.begin(); it != buffers_.end(); ++it) {
+      // A buffer is free once the pool holds the only reference to it.
+      if (!it->RefCountIsOne()) {
+        continue;
+      }
+      if (it->dtype() == dtype && HasRowShape(*it, row_shape)) {
+        *batch = it->Slice(0, batch_size);
+        buffers_.splice(buffers_.end(), buffers_, it);
+        return absl::OkStatus();
+      }
+      if (lru_free_buffer == buffers_.end()) {
+        lru_free_buffer = it;
+      }
+    }
+    const bool full =
+        buffers_.size() >= static_cast<size_t>(options_.max_buffers);
+    // When the pool is full, the least recently used free buffer of another
+    // type or row shape is replaced, so that buffers of shapes no longer
+    // requested do not stay pinned and block reuse.
+    if (!full || lru_free_buffer != buffers_.end()) {
+      TensorShape buffer_shape({options_.max_batch_size});
+      buffer_shape.AppendShape(row_shape);
+      Tensor buffer(allocator, dtype, buffer_shape);
+      if (!buffer.IsInitialized() && buffer_shape.num_elements() > 0) {
+        return errors::ResourceExhausted(
+            "Failed to allocate a batch input buffer of shape ",
+            buffer_shape.DebugString());
+      }
+      if (full) {
+        buffers_.erase(lru_free_buffer);
+      }
+      *batch = buffer.Slice(0, batch_size);
+      buffers_.push_back(std::move(buffer));
+      return absl::OkStatus();
+    }
+  }
+
+  *batch = Tensor(allocator, dtype, batch_shape);
+  return absl::OkStatus();
+}
+
+int BatchInputBufferPool::num_buffers() const {
+  mutex_lock l(mu_);
+  return buffers_.size();
+}
+
+bool CanAssembleBatch(DataType dtype) { return DataTypeCanUseMemcpy(dtype); }
+
+absl::Status AssembleBatch(absl::Span<const Tensor* const> inputs,
+                           const Tensor& padding_row, Tensor* batch) {
+  if (!CanAssembleBatch(batch->dtype())) {
+    return errors::InvalidArgument("Cannot assemble batches of ",
+                                   DataTypeString(batch->dtype()));
+  }
+  if (batch->dims() == 0) {
+    return errors::InvalidArgument("Batch tensor has 0 dimensions");
+  }
+  TensorShape row_shape = batch->shape();
+  row_shape.RemoveDim(0);
+  const int64_t row_bytes =
+      row_shape.num_elements() * DataTypeSize(batch->dtype());
+  char* const batch_data = const_cast<char*>(batch->tensor_data().data());
+  const int64_t num_rows = batch->dim_size(0);
+
+  int64_t row = 0;
+  for (const Tensor* input : inputs) {
+    if (input->dtype() != batch->dtype() || !HasRowShape(*input, row_shape)) {
+      return errors::InvalidArgument(
+          "Input of type ", DataTypeString(input->dtype()), " and shape ",
+          input->shape().DebugString(), " does not fit in a batch of type ",
+          DataTypeString(batch->dtype()), " and shape ",
+          batch->shape().DebugString());
+    }
+    const int64_t input_rows = input->dim_size(0);
+    if (row + input_rows > num_rows) {
+      return errors::InvalidArgument("Inputs have more than ", num_rows,
+                                     " rows");
+    }
+    if (input_rows > 0 && row_bytes > 0) {
+      std::memcpy(batch_data + row * row_bytes, input->tensor_data().data(),
+                  input_rows * row_bytes);
+    }
+    row += input_rows;
+  }
+
+  if (row == num_rows || row_bytes == 0) {
+    return absl::OkStatus();
+  }
+  if (padding_row.dtype() != batch->dtype() ||
+      !HasRowShape(padding_row, row_shape) || padding_row.dim_size(0) == 0) {
+    return errors::InvalidArgument(
+        "Cannot pad a batch of shape ", batch->shape().DebugString(),
+        " with a tensor of shape ", padding_row.shape().DebugString());
+  }
+  const char* const padding_data = padding_row.tensor_data().data();
+  for (; row < num_rows; ++row) {
+    std::memcpy(batch_data + row * row_bytes, padding_data, row_bytes);
+  }
+  return absl::OkStatus();
+}
+
+bool SplitIntoAlignedSlices(const Tensor& batch,
+                            absl::Span<const int64_t> sizes,
+                            std::vector<Tensor>* slices) {
+  slices->clear();
+  if (batch.dims() == 0) {
+    return false;
+  }
+  slices->reserve(sizes.size());
+  int64_t start = 0;
+  for (const int64_t size : sizes) {
+    if (size < 0 || start + size > batch.dim_size(0)) {
+      slices->clear();
+      return false;
+    }
+    Tensor slice = batch.Slice(start, start + size);
+    if (!slice.IsAligned()) {
+      slices->clear();
+      return false;
+    }
+    slices->push_back(std::move(slice));
+    start += size;
+  }
+  return true;
+}
+
+}  // namespace serving
+}  // namespace tensorflow
@@ -0,0 +1,105 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_INPUT_BUFFER_POOL_H_
+#define TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_INPUT_BUFFER_POOL_H_
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/types/span.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tsl/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace serving {
+
+// A pool of preallocated batch input buffers, each sized for the largest batch
+// a queue may process.
+//
+// Batches are assembled by copying each task's rows straight into a pooled
+// buffer, so the padded batch tensor is produced with a single copy and no
+// allocation, instead of concatenating the tasks and the padding rows into a
+// freshly allocated tensor. A buffer is handed out as a prefix slice and
+// becomes reusable once every tensor referencing it, including output slices
+// that alias it, has been destroyed.
+//
+// Thread-safe.
+class BatchInputBufferPool {
+ public:
+  struct Options {
+    // The number of rows of the pooled buffers; normally the largest allowed
+    // batch size. Must be positive.
+    int64_t max_batch_size = 0;
+
+    // The maximum number of buffers the pool keeps. When the pool is full, the
+    // least recently used free buffer is replaced by one of the requested type
+    // and row shape, and when all of them are in use, batches are assembled
+    // into unpooled tensors.
+    int max_buffers = 16;
+  };
+
+  static absl::Status Create(const Options& options,
+                             std::unique_ptr<BatchInputBufferPool>* pool);
+
+  // Returns in `batch` a tensor of `dtype` made of `batch_size` rows of
+  // `row_shape`. If `batch_size` fits in the pooled buffers, `batch` aliases
+  // a free pooled buffer of the same type and row shape, which is allocated
+  // with `allocator` if there is none. The contents of `batch` are undefined.
+  absl::Status GetBatchTensor(Allocator* allocator, DataType dtype,
+                              const TensorShape& row_shape, int64_t batch_size,
+                              Tensor* batch);
+
+  // Exposed for testing.
+  int num_buffers() const;
+
+ private:
+  explicit BatchInputBufferPool(const Options& options) : options_(options) {}
+
+  const Options options_;
+
+  mutable mutex mu_;
+  // Least recently used first.
+  std::list<Tensor> buffers_ TF_GUARDED_BY(mu_);
+};
+
+// Returns true if tensors of `dtype` can be assembled into a batch buffer with
+// `AssembleBatch`.
+bool CanAssembleBatch(DataType dtype);
+
+// Copies the rows of `inputs`, in order, into the rows of `batch` starting at
+// row 0, and fills the remaining rows with copies of row 0 of `padding_row`.
+// All tensors must have the dtype and the row shape of `batch`.
+absl::Status AssembleBatch(absl::Span<const Tensor* const> inputs,
+                           const Tensor& padding_row, Tensor* batch);
+
+// Splits `batch` along the 0th dimension into slices of the given `sizes`,
+// which alias `batch`. Returns false, leaving `slices` empty, if a slice would
+// not be aligned; the caller must then copy.
+bool SplitIntoAlignedSlices(const Tensor& batch,
+                            absl::Span<const int64_t> sizes,
+                            std::vector<Tensor>* slices);
+
+}  // namespace serving
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_INPUT_BUFFER_POOL_H_
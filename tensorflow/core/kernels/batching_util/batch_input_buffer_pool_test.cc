@@ -0,0 +1,322 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/batching_util/batch_input_buffer_pool.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/tensor_util.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace serving {
+namespace {
+
+std::unique_ptr<BatchInputBufferPool> CreatePool(int64_t max_batch_size,
+                                                 int max_buffers) {
+  BatchInputBufferPool::Options options;
+  options.max_batch_size = max_batch_size;
+  options.max_buffers = max_buffers;
+  std::unique_ptr<BatchInputBufferPool> pool;
+  TF_CHECK_OK(BatchInputBufferPool::Create(options, &pool));
+  return pool;
+}
+
+TEST(BatchInputBufferPoolTest, InvalidOptions) {
+  std::unique_ptr<BatchInputBufferPool> pool;
+  BatchInputBufferPool::Options options;
+  options.max_batch_size = 0;
+  EXPECT_EQ(BatchInputBufferPool::Create(options, &pool).code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST(BatchInputBufferPoolTest, ReusesBuffersOnceReleased) {
+  auto pool = CreatePool(/*max_batch_size=*/8, /*max_buffers=*/4);
+
+  Tensor first;
+  TF_ASSERT_OK(pool->GetBatchTensor(cpu_allocator(), DT_FLOAT,
+                                    TensorShape({3}), 5, &first));
+  EXPECT_EQ(first.shape(), TensorShape({5, 3}));
+  const char* first_data = first.tensor_data().data();
+
+  // The first buffer is still in use.
+  Tensor second;
+  TF_ASSERT_OK(pool->GetBatchTensor(cpu_allocator(), DT_FLOAT,
+                                    TensorShape({3}), 8, &second));
+  EXPECT_NE(second.tensor_data().data(), first_data);
+  EXPECT_EQ(pool->num_buffers(), 2);
+
+  first = Tensor();
+  Tensor third;
+  TF_ASSERT_OK(pool->GetBatchTensor(cpu_allocator(), DT_FLOAT,
+                                    TensorShape({3}), 2, &third));
+  EXPECT_EQ(third.tensor_data().data(), first_data);
+  EXPECT_EQ(pool->num_buffers(), 2);
+}
+
+TEST(BatchInputBufferPoolTest, OutputSlicesKeepBufferInUse) {
+  auto pool = CreatePool(/*max_batch_size=*/8, /*max_buffers=*/4);
+
+  Tensor batch;
+  TF_ASSERT_OK(pool->GetBatchTensor(cpu_allocator(), DT_INT32,
+                                    TensorShape({}), 8, &batch));
+  const char* batch_data = batch.tensor_data().data();
+  std::vector<Tensor> slices;
+  ASSERT_TRUE(SplitIntoAlignedSlices(batch, {4, 4}, &slices));
+  batch = Tensor();
+
+  Tensor other;
+  TF_ASSERT_OK(pool->GetBatchTensor(cpu_allocator(), DT_INT32,
+                                    TensorShape({}), 8, &other));
+  EXPECT_NE(other.tensor_data().data(), batch_data);
+}
+
+TEST(BatchInputBufferPoolTest, MatchesTypeAndRowShape) {
+  auto pool = CreatePool(/*max_batch_size=*/8, /*max_buffers=*/4);
+
+  Tensor batch;
+  TF_ASSERT_OK(pool->GetBatchTensor(cpu_allocator(), DT_FLOAT,
+                                    TensorShape({3}), 4, &batch));
+  batch = Tensor();
+  TF_ASSERT_OK(pool->GetBatchTensor(cpu_allocator(), DT_INT32,
+                                    TensorShape({3}), 4, &batch));
+  batch = Tensor();
+  TF_ASSERT_OK(pool->GetBatchTensor(cpu_allocator(), DT_FLOAT,
+                                    TensorShape({2}), 4, &batch));
+  EXPECT_EQ(pool->num_buffers(), 3);
+}
+
+TEST(BatchInputBufferPoolTest, ReplacesFreeBuffersOfOtherRowShapes) {
+  auto pool = CreatePool(/*max_batch_size=*/8, /*max_buffers=*/2);
+
+  // Row shapes vary from batch to batch, as with length-bucketed batching.
+  for (int i = 0; i < 10; ++i) {
+    const TensorShape row_shape({i % 2 == 0 ? 3 : 5});
+    Tensor batch;
+    TF_ASSERT_OK(
+        pool->GetBatchTensor(cpu_allocator(), DT_FLOAT, row_shape, 4, &batch));
+    EXPECT_EQ(batch.shape(), TensorShape({4, row_shape.dim_size(0)}));
+  }
+  EXPECT_EQ(pool->num_buffers(), 2);
+
+  // Once full, a new row shape replaces the least recently used free buffer:
+  // the one of rows of 3 elements, while rows of 5 elements remain pooled.
+  Tensor held;
+  TF_ASSERT_OK(pool->GetBatchTensor(cpu_allocator(), DT_FLOAT,
+                                    TensorShape({5}), 4, &held));
+  const char* held_data = held.tensor_data().data();
+  held = Tensor();
+  Tensor batch;
+  TF_ASSERT_OK(pool->GetBatchTensor(cpu_allocator(), DT_FLOAT,
+                                    TensorShape({7}), 4, &batch));
+  batch = Tensor();
+  EXPECT_EQ(pool->num_buffers(), 2);
+  TF_ASSERT_OK(pool->GetBatchTensor(cpu_allocator(), DT_FLOAT,
+                                    TensorShape({5}), 4, &batch));
+  EXPECT_EQ(batch.tensor_data().data(), held_data);
+  batch = Tensor();
+
+  // Buffers in use are never replaced.
+  Tensor first, second;
+  TF_ASSERT_OK(pool->GetBatchTensor(cpu_allocator(), DT_FLOAT,
+                                    TensorShape({5}), 4, &first));
+  TF_ASSERT_OK(pool->GetBatchTensor(cpu_allocator(), DT_FLOAT,
+                                    TensorShape({7}), 4, &second));
+  Tensor unpooled;
+  TF_ASSERT_OK(pool->GetBatchTensor(cpu_allocator(), DT_FLOAT,
+                                    TensorShape({9}), 4, &unpooled));
+  EXPECT_EQ(unpooled.shape(), TensorShape({4, 9}));
+  EXPECT_EQ(pool->num_buffers(), 2);
+  EXPECT_EQ(first.shape(), TensorShape({4, 5}));
+  EXPECT_EQ(second.shape(), TensorShape({4, 7}));
+}
+
+TEST(BatchInputBufferPoolTest, AllocatesUnpooledTensorsBeyondLimits) {
+  auto pool = CreatePool(/*max_batch_size=*/4, /*max_buffers=*/1);
+
+  Tensor large;
+  TF_ASSERT_OK(pool->GetBatchTensor(cpu_allocator(), DT_FLOAT,
+                                    TensorShape({}), 6, &large));
+  EXPECT_EQ(large.shape(), TensorShape({6}));
+  EXPECT_EQ(pool->num_buffers(), 0);
+
+  Tensor first, second;
+  TF_ASSERT_OK(pool->GetBatchTensor(cpu_allocator(), DT_FLOAT,
+                                    TensorShape({}), 4, &first));
+  TF_ASSERT_OK(pool->GetBatchTensor(cpu_allocator(), DT_FLOAT,
+                                    TensorShape({}), 4, &second));
+  EXPECT_EQ(second.shape(), TensorShape({4}));
+  EXPECT_EQ(pool->num_buffers(), 1);
+}
+
+TEST(AssembleBatchTest, CopiesInputsAndPads) {
+  Tensor a = test::AsTensor<float>({1, 2, 3, 4}, TensorShape({2, 2}));
+  Tensor b = test::AsTensor<float>({5, 6}, TensorShape({1, 2}));
+  Tensor batch(DT_FLOAT, TensorShape({5, 2}));
+
+  TF_ASSERT_OK(AssembleBatch({&a, &b}, a, &batch));
+
+  test::ExpectTensorEqual<float>(
+      batch, test::AsTensor<float>({1, 2, 3, 4, 5, 6, 1, 2, 1, 2},
+                                   TensorShape({5, 2})));
+}
+
+TEST(AssembleBatchTest, PadsWithFirstRowOfPaddingTensor) {
+  Tensor a = test::AsTensor<int32_t>({1, 2, 3, 4}, TensorShape({1, 2, 2}));
+  Tensor padding = test::AsTensor<int32_t>({5, 6, 7, 8, 9, 10, 11, 12},
+                                           TensorShape({2, 2, 2}));
+  Tensor batch(DT_INT32, TensorShape({3, 2, 2}));
+
+  TF_ASSERT_OK(AssembleBatch({&a}, padding, &batch));
+
+  test::ExpectTensorEqual<int32_t>(
+      batch, test::AsTensor<int32_t>({1, 2, 3, 4, 5, 6, 7, 8, 5, 6, 7, 8},
+                                     TensorShape({3, 2, 2})));
+}
+
+TEST(AssembleBatchTest, PaddingIsOnlyNeededForMissingRows) {
+  Tensor a = test::AsTensor<float>({1, 2, 3, 4}, TensorShape({2, 2}));
+  Tensor no_padding(DT_FLOAT, TensorShape({0, 2}));
+
+  // A full batch never reads the padding tensor.
+  Tensor full(DT_FLOAT, TensorShape({2, 2}));
+  TF_ASSERT_OK(AssembleBatch({&a}, no_padding, &full));
+  test::ExpectTensorEqual<float>(full, a);
+
+  Tensor padded(DT_FLOAT, TensorShape({3, 2}));
+  EXPECT_EQ(AssembleBatch({&a}, no_padding, &padded).code(),
+            absl::StatusCode::kInvalidArgument);
+  Tensor wrong_row = test::AsTensor<float>({1, 2, 3}, TensorShape({1, 3}));
+  EXPECT_EQ(AssembleBatch({&a}, wrong_row, &padded).code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST(AssembleBatchTest, RejectsMismatchedInputs) {
+  Tensor a = test::AsTensor<float>({1, 2, 3}, TensorShape({1, 3}));
+  Tensor batch(DT_FLOAT, TensorShape({2, 2}));
+  EXPECT_EQ(AssembleBatch({&a}, a, &batch).code(),
+            absl::StatusCode::kInvalidArgument);
+
+  Tensor too_many = test::AsTensor<float>({1, 2, 3, 4, 5, 6},
+                                          TensorShape({3, 2}));
+  EXPECT_EQ(AssembleBatch({&too_many}, too_many, &batch).code(),
+            absl::StatusCode::kInvalidArgument);
+
+  Tensor empty(DT_FLOAT, TensorShape({0, 2}));
+  EXPECT_EQ(AssembleBatch({}, empty, &batch).code(),
+            absl::StatusCode::kInvalidArgument);
+
+  Tensor strings(DT_STRING, TensorShape({2}));
+  EXPECT_FALSE(CanAssembleBatch(DT_STRING));
+  EXPECT_EQ(AssembleBatch({}, strings, &strings).code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST(SplitIntoAlignedSlicesTest, SlicesAliasTheBatch) {
+  // Rows of 64 floats keep every slice aligned.
+  Tensor batch(DT_FLOAT, TensorShape({4, 64}));
+  std::vector<Tensor> slices;
+  ASSERT_TRUE(SplitIntoAlignedSlices(batch, {1, 2, 1}, &slices));
+  ASSERT_EQ(slices.size(), 3);
+  EXPECT_EQ(slices[1].shape(), TensorShape({2, 64}));
+  EXPECT_EQ(slices[1].tensor_data().data(),
+            batch.tensor_data().data() + 64 * sizeof(float));
+}
+
+TEST(SplitIntoAlignedSlicesTest, RejectsUnalignedSlices) {
+  Tensor batch(DT_FLOAT, TensorShape({4, 3}));
+  std::vector<Tensor> slices;
+  EXPECT_FALSE(SplitIntoAlignedSlices(batch, {1, 3}, &slices));
+  EXPECT_TRUE(slices.empty());
+}
+
+TEST(SplitIntoAlignedSlicesTest, FallsBackToCopyingSplit) {
+  // Rows of 3 floats leave the second slice unaligned, even though the first
+  // one is aligned.
+  Tensor batch = test::AsTensor<float>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11},
+                                       TensorShape({4, 3}));
+  std::vector<Tensor> slices = {batch};
+  ASSERT_FALSE(SplitIntoAlignedSlices(batch, {1, 3}, &slices));
+  EXPECT_TRUE(slices.empty());
+
+  // The caller then copies, as BatchResourceBase does.
+  const std::vector<int64_t> sizes = {1, 3};
+  TF_ASSERT_OK(tensor::Split(batch, sizes, &slices));
+  ASSERT_EQ(slices.size(), 2);
+  test::ExpectTensorEqual<float>(
+      slices[0], test::AsTensor<float>({0, 1, 2}, TensorShape({1, 3})));
+  test::ExpectTensorEqual<float>(
+      slices[1], test::AsTensor<float>({3, 4, 5, 6, 7, 8, 9, 10, 11},
+                                       TensorShape({3, 3})));
+  EXPECT_FALSE(slices[1].SharesBufferWith(batch));
+}
+
+TEST(SplitIntoAlignedSlicesTest, RejectsSizesBeyondTheBatch) {
+  Tensor batch(DT_FLOAT, TensorShape({4, 64}));
+  std::vector<Tensor> slices;
+  EXPECT_FALSE(SplitIntoAlignedSlices(batch, {2, 3}, &slices));
+  EXPECT_TRUE(slices.empty());
+  EXPECT_FALSE(SplitIntoAlignedSlices(batch, {-1, 5}, &slices));
+  EXPECT_TRUE(slices.empty());
+}
+
+TEST(SplitIntoAlignedSlicesTest, SlicesOutliveThePooledBatch) {
+  auto pool = CreatePool(/*max_batch_size=*/4, /*max_buffers=*/1);
+
+  // Rows of 16 int32s keep every slice of the pooled buffer aligned.
+  Tensor input(DT_INT32, TensorShape({3, 16}));
+  for (int64_t i = 0; i < input.NumElements(); ++i) {
+    input.flat<int32_t>()(i) = i;
+  }
+  Tensor batch;
+  TF_ASSERT_OK(pool->GetBatchTensor(cpu_allocator(), DT_INT32,
+                                    TensorShape({16}), 4, &batch));
+  TF_ASSERT_OK(AssembleBatch({&input}, input, &batch));
+  const char* batch_data = batch.tensor_data().data();
+  std::vector<Tensor> slices;
+  ASSERT_TRUE(SplitIntoAlignedSlices(batch, {2, 1, 1}, &slices));
+  batch = Tensor();
+
+  // The slices still read the assembled rows, and the pool does not hand out
+  // the buffer they alias.
+  EXPECT_EQ(slices[0].tensor_data().data(), batch_data);
+  EXPECT_EQ(slices[1].flat<int32_t>()(0), 32);
+  EXPECT_EQ(slices[2].flat<int32_t>()(15), 15);
+  Tensor other;
+  TF_ASSERT_OK(pool->GetBatchTensor(cpu_allocator(), DT_INT32,
+                                    TensorShape({16}), 4, &other));
+  EXPECT_NE(other.tensor_data().data(), batch_data);
+  EXPECT_EQ(pool->num_buffers(), 1);
+  other = Tensor();
+
+  // Once the last slice is gone, the buffer is reused.
+  slices.clear();
+  TF_ASSERT_OK(pool->GetBatchTensor(cpu_allocator(), DT_INT32,
+                                    TensorShape({16}), 4, &other));
+  EXPECT_EQ(other.tensor_data().data(), batch_data);
+}
+
+}  // namespace
+}  // namespace serving
+}  // namespace tensorflow
@@ -191,6 +191,11 @@ TEST_F(BatchInputTaskTest, BatchInputToSplitTasks) {
     auto batch_task = output_tasks[i]->GetSplitTask();
     ASSERT_NE(batch_task, nullptr);
     EXPECT_EQ(batch_task->size(), expected_task_sizes[i]);
+    // The splits share one count of unprocessed splits, so that the latency
+    // of the request is recorded once.
+    ASSERT_NE(batch_task->num_unprocessed_splits, nullptr);
+    EXPECT_EQ(batch_task->num_unprocessed_splits->load(),
+              static_cast<int>(expected_task_sizes.size()));
     batch_task->done_callback();
 
     // `GetSplitTask` returns nullptr from the 2nd call and on.
@@ -32,6 +32,7 @@ limitations under the License.
 #include "absl/functional/bind_front.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/blocking_counter.h"
 #include "absl/synchronization/mutex.h"
@@ -52,13 +53,16 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_util.h"
+#include "tensorflow/core/kernels/batching_util/batch_input_buffer_pool.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler_utils.h"
 #include "tensorflow/core/kernels/batching_util/batch_stats.h"
+#include "tensorflow/core/kernels/batching_util/batch_timeout_controller.h"
 #include "tensorflow/core/kernels/batching_util/concat_split_util.h"
 #include "tensorflow/core/kernels/batching_util/input_split_metadata.h"
 #include "tensorflow/core/kernels/batching_util/threadsafe_status.h"
 #include "tensorflow/core/kernels/batching_util/warmup.h"
+#include "tensorflow/core/lib/core/bits.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/monitoring/counter.h"
 #include "tensorflow/core/lib/monitoring/gauge.h"
@@ -66,6 +70,7 @@ limitations under the License.
 #include "tensorflow/core/lib/monitoring/sampler.h"
 #include "tensorflow/core/lib/monitoring/types.h"
 #include "tensorflow/core/platform/context.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/env_time.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/mutex.h"
@@ -123,6 +128,18 @@ void RecordPaddingSizeV2(int32_t padding_size, const string& model_name,
       ->Add(static_cast<double>(padding_size));
 }
 
+void RecordPaddingEfficiency(double padding_efficiency,
+                             const string& model_name, const string& op_name) {
+  static auto* cell = tensorflow::monitoring::PercentileSampler<2>::New(
+      {"/tensorflow/serving/batching/padding_efficiency",
+       "Tracks the fraction of batched input elements that hold real data, "
+       "as opposed to batch or length padding, by model_name (if available).",
+       "model_name", "op_name"},
+      /*percentiles=*/{1.0, 5.0, 10.0, 25.0, 50.0, 75.0},
+      /*max_samples=*/1024, tensorflow::monitoring::UnitOfMeasure::kNumber);
+  cell->GetCell(model_name, op_name)->Add(padding_efficiency);
+}
+
 // TODO(b/181883417): Replace with RecordInputBatchSizeV2.
 void RecordInputBatchSize(int32_t batch_size, const string& model_name,
                           const string& op_name) {
@@ -309,6 +326,41 @@ int GetTotalTaskSize(
   return tasks_size;
 }
 
+// Returns the length of `task`: the largest size of dimension
+// `length_dimension` among its inputs.
+int64_t GetTaskLength(const BatchResourceBase::BatchTask& task,
+                      int length_dimension) {
+  int64_t length = 0;
+  for (const Tensor& input : task.inputs) {
+    if (input.dims() > length_dimension) {
+      length = std::max(length, input.dim_size(length_dimension));
+    }
+  }
+  return length;
+}
+
+// Pads `tensors` with zeros along `length_dimension` to the largest size of
+// that dimension among them. Tensors without that dimension are left as is.
+absl::Status PadToLongestTask(OpKernelContext* context, int length_dimension,
+                              std::vector<Tensor>* tensors) {
+  int64_t max_length = 0;
+  for (const Tensor& tensor : *tensors) {
+    if (tensor.dims() > length_dimension) {
+      max_length = std::max(max_length, tensor.dim_size(length_dimension));
+    }
+  }
+  for (Tensor& tensor : *tensors) {
+    if (tensor.dims() > length_dimension &&
+        tensor.dim_size(length_dimension) < max_length) {
+      Tensor padded;
+      TF_RETURN_IF_ERROR(concat_split_util::PadAlongDimension(
+          context, tensor, length_dimension, max_length, &padded));
+      tensor = std::move(padded);
+    }
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 std::unique_ptr<BatchResourceBase::BatchTask>
@@ -326,6 +378,7 @@ BatchResourceBase::BatchTask::CreateSplitTask(
   task->output = this->output;
   task->status = this->status;
   task->is_partial = true;
+  task->num_unprocessed_splits = this->num_unprocessed_splits;
   task->start_time = this->start_time;
   task->request_cost = this->request_cost;
   task->forced_warmup_batch_size = this->forced_warmup_batch_size;
@@ -497,7 +550,8 @@ absl::Status BatchResourceBase::RegisterInput(
 
   BatcherQueueT* batcher_queue;
   TF_RETURN_IF_ERROR(LookupOrCreateBatcherQueue(
-      /* queue_name= */ batcher_queue_name,
+      /* queue_name= */ GetLengthBucketQueueName(batcher_queue_name,
+                                                 *batch_components),
       /* model_name= */ GetModelName(context),
       /* op_name= */ context->op_kernel().name(), /* queue= */ &batcher_queue));
 
@@ -726,36 +780,78 @@ absl::Status BatchResourceBase::ConcatInputTensors(
   const int num_inputs = batch.task(0).inputs.size();
   concatenated_tensors->reserve(num_inputs);
 
+  // The number of input elements that hold real data, and of batched input
+  // elements, for the padding efficiency metric.
+  int64_t num_real_elements = 0;
+  int64_t num_batched_elements = 0;
+
   // Process each input one at a time (the typical case has just one). When
   // `just_for_warmup` is true, the real data is not added. Otherwise, the real
   // data is added to the front of each `concatenated_tensor`.
   for (int i = 0; i < num_inputs; ++i) {
-    // Concatenate the tasks ith input tensors into a big output tensor.
-    std::vector<Tensor> to_concatenate;
-    if (just_for_warmup) {
-      to_concatenate.reserve(padding_amount);
-    } else {
-      to_concatenate.reserve(batch.num_tasks() + unbatched_tasks.size() +
-                             padding_amount);
+    // Gather the tasks ith input tensors.
+    std::vector<Tensor> task_inputs;
+    if (!just_for_warmup) {
+      task_inputs.reserve(batch.num_tasks() + unbatched_tasks.size() +
+                          padding_amount);
       for (int task_idx = 0; task_idx < batch.num_tasks(); ++task_idx) {
-        to_concatenate.push_back(batch.task(task_idx).inputs.at(i));
+        task_inputs.push_back(batch.task(task_idx).inputs.at(i));
       }
       for (int task_idx = 0; task_idx < unbatched_tasks.size(); ++task_idx) {
-        to_concatenate.push_back(unbatched_tasks[task_idx]->inputs.at(i));
+        task_inputs.push_back(unbatched_tasks[task_idx]->inputs.at(i));
+      }
+      for (const Tensor& task_input : task_inputs) {
+        num_real_elements += task_input.NumElements();
+      }
+    }
+
+    // With length bucketing, the tasks are padded along the length dimension
+    // to the longest task of the batch.
+    if (length_dimension_ > 0) {
+      TF_RETURN_IF_ERROR(
+          PadToLongestTask(context, length_dimension_, &task_inputs));
+    }
+
+    // Use the first row of the first task's tensor as the data for padding.
+    const Tensor& padding_source =
+        just_for_warmup ? batch.task(0).inputs.at(i) : task_inputs[0];
+    if (padding_amount != 0 && padding_source.shape().dim_size(0) == 0) {
+      return errors::InvalidArgument(
+          "Cannot use an empty tensor with zero rows as padding when "
+          "batching. (Input ",
+          i, " got shape ", padding_source.shape().DebugString(), ".)");
+    }
+
+    // With zero-copy batch assembly, the tasks ith input tensors and the
+    // padding are copied straight into a pooled batch buffer.
+    if (input_buffer_pool_ != nullptr && padding_source.dims() > 0 &&
+        CanAssembleBatch(padding_source.dtype())) {
+      std::vector<const Tensor*> to_assemble;
+      to_assemble.reserve(task_inputs.size());
+      for (const Tensor& task_input : task_inputs) {
+        to_assemble.push_back(&task_input);
       }
+      TensorShape row_shape = padding_source.shape();
+      row_shape.RemoveDim(0);
+      AllocatorAttributes attr;
+      attr.set_on_host(true);
+      Tensor assembled_tensor;
+      TF_RETURN_IF_ERROR(input_buffer_pool_->GetBatchTensor(
+          context->get_allocator(attr), padding_source.dtype(), row_shape,
+          padded_batch_size, &assembled_tensor));
+      TF_RETURN_IF_ERROR(
+          AssembleBatch(to_assemble, padding_source, &assembled_tensor));
+      num_batched_elements += assembled_tensor.NumElements();
+      concatenated_tensors->push_back(std::move(assembled_tensor));
+      continue;
     }
 
-    // Add padding as needed if padding is allowed. Use the first row of the
-    // first task's tensor as the data for padding.
+    // Concatenate the tasks ith input tensors into a big output tensor.
+    std::vector<Tensor> to_concatenate = std::move(task_inputs);
+
+    // Add padding as needed if padding is allowed.
     if (padding_amount != 0) {
-      const Tensor& padding_source = batch.task(0).inputs.at(i);
       Tensor padding;
-      if (padding_source.shape().dim_size(0) == 0) {
-        return errors::InvalidArgument(
-            "Cannot use an empty tensor with zero rows as padding when "
-            "batching. (Input ",
-            i, " got shape ", padding_source.shape().DebugString(), ".)");
-      }
       if (padding_source.shape().dim_size(0) == 1) {
         padding = padding_source;
       } else {
@@ -770,8 +866,15 @@ absl::Status BatchResourceBase::ConcatInputTensors(
     absl::Status concat_status =
         Concat(context, to_concatenate, &concatenated_tensor);
     TF_RETURN_IF_ERROR(concat_status);
+    num_batched_elements += concatenated_tensor.NumElements();
     concatenated_tensors->push_back(concatenated_tensor);
   }
+
+  if (!just_for_warmup && num_batched_elements > 0) {
+    RecordPaddingEfficiency(
+        static_cast<double>(num_real_elements) / num_batched_elements,
+        GetModelName(context), context->op_kernel().name());
+  }
   return absl::OkStatus();
 }
 
@@ -834,6 +937,8 @@ absl::Status BatchResourceBase::ConcatInputTensors(
     (*input_task.output)[i].resize(input_task.context->num_outputs());
   }
 
+  input_task.num_unprocessed_splits =
+      std::make_shared<std::atomic<int>>(num_batches);
   output_tasks->reserve(num_batches);
   for (int i = 0; i < num_batches; i++) {
     output_tasks->push_back(input_task.CreateSplitTask(i, barrier.Inc()));
@@ -928,13 +1033,19 @@ absl::Status BatchResourceBase::SplitOutputTensors(
           "; padding size: ", padding_size);
     }
 
+    // With zero-copy batch assembly, the tasks get slices aliasing the batched
+    // output when they are aligned, and copies otherwise.
     std::vector<Tensor> split_tensor;
-    const absl::Status split_status = tensor::Split(
-        output_tensor, task_sizes_plus_optional_padding, &split_tensor);
-    DCHECK(split_status.ok()) << split_status;
-    if (!split_status.ok()) {
-      return errors::Internal("Tensor split operation failed: ",
-                              split_status.message());
+    if (input_buffer_pool_ == nullptr ||
+        !SplitIntoAlignedSlices(output_tensor, task_sizes_plus_optional_padding,
+                                &split_tensor)) {
+      const absl::Status split_status = tensor::Split(
+          output_tensor, task_sizes_plus_optional_padding, &split_tensor);
+      DCHECK(split_status.ok()) << split_status;
+      if (!split_status.ok()) {
+        return errors::Internal("Tensor split operation failed: ",
+                                split_status.message());
+      }
     }
     DCHECK_EQ(split_tensor.size(), task_sizes_plus_optional_padding.size());
     if (split_tensor.size() != task_sizes_plus_optional_padding.size()) {
@@ -1006,6 +1117,9 @@ void BatchResourceBase::ProcessFuncBatch(
   // Regardless of the outcome, we need to propagate the status to the
   // individual tasks and signal that they are done. We use MakeCleanup() to
   // ensure that this happens no matter how we exit the method below.
+  std::shared_ptr<BatchTimeoutController> batch_timeout_controller =
+      GetBatchTimeoutController(model_name, op_name);
+
   absl::Status status;
   bool cleanup_done = false;
   int64_t processed_size = batch->size();
@@ -1013,6 +1127,25 @@ void BatchResourceBase::ProcessFuncBatch(
     if (cleanup_done) {
       return;
     }
+    if (batch_timeout_controller != nullptr) {
+      // The controller's timestamps must come from the clock the queue stamps
+      // arrivals with, the default Env of the batcher. Task start times are
+      // taken from the same clock, in nanoseconds.
+      const uint64 now_micros = Env::Default()->NowMicros();
+      for (int i = 0; i < batch->num_tasks(); ++i) {
+        const BatchTask& task = batch->task(i);
+        // A split request counts once, when the last of its splits is done,
+        // so that large requests do not weigh on the percentiles per split.
+        if (task.num_unprocessed_splits != nullptr &&
+            task.num_unprocessed_splits->fetch_sub(1) != 1) {
+          continue;
+        }
+        const uint64 start_micros = task.start_time / 1000;
+        batch_timeout_controller->RecordLatency(
+            absl::Microseconds(now_micros - std::min(now_micros, start_micros)),
+            now_micros);
+      }
+    }
     // TODO(b/316379576): Update this to take the unbatch task cost into
     // consideration when excluding the wasted cost and propagate cost to the
     // unbatched tasks.
@@ -1227,6 +1360,28 @@ absl::Status BatchResourceBase::LookupOrCreateBatcherQueue(
     BatcherT::QueueOptions batcher_queue_options = batcher_queue_options_;
     batcher_queue_options.model_batch_stats = &GlobalBatchStatsRegistry().model(
         /* model_name= */ model_name, /* op_name= */ op_name);
+    if (batch_latency_target_ > absl::ZeroDuration()) {
+      std::shared_ptr<BatchTimeoutController>& controller =
+          batch_timeout_controllers_[std::make_pair(model_name, op_name)];
+      if (controller == nullptr) {
+        BatchTimeoutController::Options controller_options;
+        controller_options.target_latency = batch_latency_target_;
+        controller_options.max_batch_timeout_micros =
+            batcher_queue_options.batch_timeout_micros;
+        controller_options.max_batch_size =
+            batcher_queue_options.max_execution_batch_size;
+        controller_options.allowed_batch_sizes = allowed_batch_sizes_;
+        controller_options.model_batch_stats =
+            batcher_queue_options.model_batch_stats;
+        controller_options.model_name = model_name;
+        controller_options.op_name = op_name;
+        std::unique_ptr<BatchTimeoutController> new_controller;
+        TF_RETURN_IF_ERROR(BatchTimeoutController::Create(controller_options,
+                                                          &new_controller));
+        controller = std::move(new_controller);
+      }
+      batcher_queue_options.batch_timeout_controller = controller;
+    }
 
     TF_RETURN_IF_ERROR(batcher_->AddQueue(
         batcher_queue_options,
@@ -1248,6 +1403,119 @@ absl::Status BatchResourceBase::LookupOrCreateBatcherQueue(
   return absl::OkStatus();
 }
 
+std::shared_ptr<BatchTimeoutController>
+BatchResourceBase::GetBatchTimeoutController(const string& model_name,
+                                             const string& op_name) const {
+  if (batch_latency_target_ <= absl::ZeroDuration()) return nullptr;
+  mutex_lock l(batcher_queues_mu_);
+  auto it =
+      batch_timeout_controllers_.find(std::make_pair(model_name, op_name));
+  if (it == batch_timeout_controllers_.end()) return nullptr;
+  return it->second;
+}
+
+Status BatchResourceBase::EnableZeroCopyBatchAssembly() {
+  // The buffers are sized for the largest batch the queues may process.
+  BatchInputBufferPool::Options pool_options;
+  if (!allowed_batch_sizes_.empty()) {
+    pool_options.max_batch_size = *allowed_batch_sizes_.rbegin();
+  } else if (batcher_queue_options_.enable_large_batch_splitting) {
+    pool_options.max_batch_size =
+        batcher_queue_options_.max_execution_batch_size;
+  } else {
+    pool_options.max_batch_size = batcher_queue_options_.input_batch_size_limit;
+  }
+  return BatchInputBufferPool::Create(pool_options, &input_buffer_pool_);
+}
+
+Status BatchResourceBase::SetLengthBucketing(
+    int length_dimension, std::vector<int32> length_bucket_boundaries) {
+  if (length_dimension < 1) {
+    return errors::InvalidArgument(
+        "The length dimension must be at least 1; was ", length_dimension);
+  }
+  for (int i = 0; i < length_bucket_boundaries.size(); ++i) {
+    if (length_bucket_boundaries[i] <= 0 ||
+        (i > 0 &&
+         length_bucket_boundaries[i] <= length_bucket_boundaries[i - 1])) {
+      return errors::InvalidArgument(
+          "Length bucket boundaries must be positive and increasing; got [",
+          absl::StrJoin(length_bucket_boundaries, ","), "]");
+    }
+  }
+  length_dimension_ = length_dimension;
+  length_bucket_boundaries_ = std::move(length_bucket_boundaries);
+  return absl::OkStatus();
+}
+
+Status BatchResourceBase::SetQueueSchedulingOptions(
+    const QueueSchedulingOptions& options) {
+  if (!(options.fair_share_weight > 0)) {
+    return errors::InvalidArgument(
+        "The fair share weight must be positive; was ",
+        options.fair_share_weight);
+  }
+  if (options.max_starvation_micros < 0 || options.task_deadline_micros < 0 ||
+      options.sheddable_task_deadline_micros < 0) {
+    return errors::InvalidArgument(
+        "The starvation bound and task deadlines must be non-negative");
+  }
+  batcher_queue_options_.priority_class = options.priority_class;
+  batcher_queue_options_.fair_share_weight = options.fair_share_weight;
+  batcher_queue_options_.max_starvation_micros = options.max_starvation_micros;
+  if (options.task_deadline_micros == 0 &&
+      options.sheddable_task_deadline_micros == 0) {
+    batcher_queue_options_.task_expiry_func = nullptr;
+    batcher_queue_options_.drop_task_func = nullptr;
+    return absl::OkStatus();
+  }
+
+  batcher_queue_options_.task_expiry_func =
+      [task_deadline_micros = options.task_deadline_micros,
+       sheddable_task_deadline_micros = options.sheddable_task_deadline_micros](
+          const BatchTask& task, uint64 /*now_micros*/) -> absl::Status {
+    // Warmup tasks are never dropped.
+    if (task.forced_warmup_batch_size != 0) return absl::OkStatus();
+    int64_t deadline_micros = task_deadline_micros;
+    if (sheddable_task_deadline_micros > 0 &&
+        (task.criticality() == tsl::criticality::Criticality::kSheddablePlus ||
+         task.criticality() == tsl::criticality::Criticality::kSheddable)) {
+      deadline_micros = sheddable_task_deadline_micros;
+    }
+    if (deadline_micros <= 0) return absl::OkStatus();
+    // The scheduler's time comes from its own Env, which need not follow the
+    // clock that `start_time` was stamped with.
+    const int64_t wait_micros =
+        static_cast<int64_t>(EnvTime::NowMicros()) -
+        static_cast<int64_t>(task.start_time / EnvTime::kMicrosToNanos);
+    if (wait_micros < deadline_micros) return absl::OkStatus();
+    return errors::DeadlineExceeded(
+        "The batch task waited in the batch queue for ", wait_micros,
+        " microseconds, more than its deadline of ", deadline_micros,
+        " microseconds");
+  };
+  batcher_queue_options_.drop_task_func =
+      [this](std::unique_ptr<BatchTask> task, absl::Status status) {
+        CleanUpFunctionHelper(*task, status);
+      };
+  return absl::OkStatus();
+}
+
+string BatchResourceBase::GetLengthBucketQueueName(
+    const string& queue_name, const BatchTask& task) const {
+  if (length_dimension_ <= 0) return queue_name;
+  const int64_t length = GetTaskLength(task, length_dimension_);
+  int64_t bucket;
+  if (length_bucket_boundaries_.empty()) {
+    bucket = length <= 1 ? 0 : Log2Ceiling64(length);
+  } else {
+    bucket = std::lower_bound(length_bucket_boundaries_.begin(),
+                              length_bucket_boundaries_.end(), length) -
+             length_bucket_boundaries_.begin();
+  }
+  return absl::StrCat(queue_name, "/length_bucket_", bucket);
+}
+
 void BatchResourceBase::SplitBatchCostsAndRecordMetrics(
     const std::string& model_name, const std::string& op_name,
     const std::vector<std::unique_ptr<CostMeasurement>>&
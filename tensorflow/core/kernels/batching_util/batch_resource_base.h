@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_RESOURCE_BASE_H_
 #define TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_RESOURCE_BASE_H_
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <map>
@@ -24,9 +25,11 @@ limitations under the License.
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/blocking_counter.h"
+#include "absl/time/time.h"
 #include "xla/tsl/platform/criticality.h"
 #include "tensorflow/core/common_runtime/cost_measurement_registry.h"
 #include "tensorflow/core/common_runtime/request_cost.h"
@@ -35,8 +38,10 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/kernels/batching_util/adaptive_shared_batch_scheduler.h"
+#include "tensorflow/core/kernels/batching_util/batch_input_buffer_pool.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler_utils.h"
+#include "tensorflow/core/kernels/batching_util/batch_timeout_controller.h"
 #include "tensorflow/core/kernels/batching_util/shared_batch_scheduler.h"
 #include "tensorflow/core/kernels/batching_util/threadsafe_status.h"
 #include "tensorflow/core/platform/context.h"
@@ -112,6 +117,11 @@ class BatchResourceBase : public ResourceBase {
 
     bool is_partial = false;
 
+    // The number of splits of the original task whose batches have not been
+    // processed yet. Shared by the splits, null if the task was not split.
+    // Lets the latency of a split request be recorded once, by its last split.
+    std::shared_ptr<std::atomic<int>> num_unprocessed_splits;
+
     uint64 start_time;
 
     size_t size() const override { return inputs[0].shape().dim_size(0); }
@@ -186,6 +196,57 @@ class BatchResourceBase : public ResourceBase {
 
   const SessionMetadata& session_metadata() const { return session_metadata_; }
 
+  // Sets a p99 latency target for the queues of this resource. If positive,
+  // queues created afterwards adjust their batch timeout and batch size online
+  // to meet it; see BatchTimeoutController. Only supported with
+  // SharedBatchScheduler.
+  void set_batch_latency_target(absl::Duration batch_latency_target) {
+    batch_latency_target_ = batch_latency_target;
+  }
+
+  // Enables zero-copy batch assembly: the inputs of a batch are copied once
+  // into a pooled buffer sized for the largest allowed batch size, padding
+  // included, and the outputs are handed to the tasks as slices aliasing the
+  // batched outputs where alignment allows. Only applies to inputs of types
+  // that can be copied with memcpy; other inputs are concatenated as usual.
+  Status EnableZeroCopyBatchAssembly();
+
+  // Enables length-bucketed batching for inputs whose dimension
+  // `length_dimension` (at least 1) holds a sequence length. Tasks are routed
+  // to one queue per length bucket, so that a batch only holds tasks of
+  // similar lengths, and the inputs of a batch are padded with zeros along
+  // `length_dimension` to its longest task rather than to a global maximum.
+  // Outputs keep the padded length.
+  //
+  // `length_bucket_boundaries` are the inclusive upper bounds of the buckets,
+  // in increasing order; longer tasks share a last bucket. If empty, lengths
+  // are bucketed by powers of two.
+  Status SetLengthBucketing(int length_dimension,
+                            std::vector<int32> length_bucket_boundaries);
+
+  // Scheduling options of the batcher queues; see
+  // SharedBatchScheduler::QueueOptions.
+  struct QueueSchedulingOptions {
+    // Only take effect if the scheduler shares its threads fairly among
+    // queues.
+    int32 priority_class = 0;
+    double fair_share_weight = 1.0;
+    int64_t max_starvation_micros = 0;
+
+    // If positive, tasks that have waited for longer than this when their
+    // batch is about to be processed fail with DEADLINE_EXCEEDED instead of
+    // being processed.
+    int64_t task_deadline_micros = 0;
+
+    // If positive, replaces `task_deadline_micros` for tasks of sheddable
+    // criticality, so that they can be shed first under load.
+    int64_t sheddable_task_deadline_micros = 0;
+  };
+
+  // Sets the scheduling options of the batcher queues created afterwards.
+  // Only supported with SharedBatchScheduler.
+  Status SetQueueSchedulingOptions(const QueueSchedulingOptions& options);
+
   using CreateBatchTaskFn =
       std::function<StatusOr<std::unique_ptr<BatchTask>>()>;
 
@@ -346,6 +407,16 @@ class BatchResourceBase : public ResourceBase {
                                     const string& op_name,
                                     BatcherQueueT** queue);
 
+  // Returns the name of the queue `task` goes to: `queue_name`, suffixed with
+  // the task's length bucket if length bucketing is enabled.
+  string GetLengthBucketQueueName(const string& queue_name,
+                                  const BatchTask& task) const;
+
+  // Returns the latency target controller of the queues of the given model
+  // and operation, or null if there is none.
+  std::shared_ptr<BatchTimeoutController> GetBatchTimeoutController(
+      const string& model_name, const string& op_name) const;
+
   SessionMetadata session_metadata_;
 
   absl::Mutex outstanding_batch_mu_;
@@ -368,6 +439,21 @@ class BatchResourceBase : public ResourceBase {
   std::map<string, std::unique_ptr<BatcherQueueT>> batcher_queues_
       TF_GUARDED_BY(batcher_queues_mu_);
 
+  // See set_batch_latency_target().
+  absl::Duration batch_latency_target_ = absl::ZeroDuration();
+  // The latency target controllers, keyed on model name and op name.
+  absl::flat_hash_map<std::pair<string, string>,
+                      std::shared_ptr<BatchTimeoutController>>
+      batch_timeout_controllers_ TF_GUARDED_BY(batcher_queues_mu_);
+
+  // Set by EnableZeroCopyBatchAssembly().
+  std::unique_ptr<BatchInputBufferPool> input_buffer_pool_;
+
+  // Set by SetLengthBucketing(). Length bucketing is disabled while
+  // `length_dimension_` is 0.
+  int length_dimension_ = 0;
+  std::vector<int32> length_bucket_boundaries_;
+
   std::vector<int32> allowed_batch_sizes_;
   // A concatenated string of <allowed_batch_sizes_>, separated by ",". This is
   // used to record batching parameter.
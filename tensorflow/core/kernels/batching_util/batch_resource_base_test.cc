@@ -44,6 +44,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/batching_util/batch_scheduler_utils.h"
 #include "tensorflow/core/kernels/batching_util/batch_stats.h"
 #include "tensorflow/core/kernels/batching_util/shared_batch_scheduler.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/monitoring/cell_reader.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/notification.h"
@@ -430,9 +431,10 @@ class BatchResourceBaseTest : public ::testing::Test {
 
     void ProcessFuncBatchImpl(
         const BatchResourceBase::BatchTask& /* last_task */,
-        absl::Span<const Tensor> /* inputs */,
+        absl::Span<const Tensor> inputs,
         std::vector<Tensor>* /* combined_outputs */,
         std::function<void(const absl::Status&)> /* done */) const override {
+      batch_inputs_.assign(inputs.begin(), inputs.end());
       process_func_batch_called_.Notify();
     }
 
@@ -440,8 +442,13 @@ class BatchResourceBaseTest : public ::testing::Test {
       return process_func_batch_called_;
     }
 
+    // The inputs of the processed batch. Only valid once
+    // process_func_batch_called() is notified.
+    const std::vector<Tensor>& batch_inputs() const { return batch_inputs_; }
+
    private:
     mutable Notification process_func_batch_called_;
+    mutable std::vector<Tensor> batch_inputs_;
   };
 
   BatchResourceBaseTest() {
@@ -622,6 +629,119 @@ TEST_F(BatchResourceBaseTest, ConfiguredBatchPaddingPolicyMetric) {
   my_batch_resource->Unref();
 }
 
+TEST_F(BatchResourceBaseTest, LengthBucketingRejectsInvalidConfiguration) {
+  std::shared_ptr<SharedBatchScheduler<BatchResourceBase::BatchTask>> batcher;
+  TF_CHECK_OK(
+      SharedBatchScheduler<BatchResourceBase::BatchTask>::Create({}, &batcher));
+  MyBatchResource* my_batch_resource = new MyBatchResource(
+      /* has_process_batch_function */ true,
+      /* batcher= */ batcher,
+      /* batcher_queue_options */ {},
+      /* allowed_batch_sizes */ {});
+
+  EXPECT_EQ(my_batch_resource->SetLengthBucketing(0, {}).code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(my_batch_resource->SetLengthBucketing(1, {8, 4}).code(),
+            absl::StatusCode::kInvalidArgument);
+  TF_EXPECT_OK(my_batch_resource->SetLengthBucketing(1, {4, 8}));
+
+  my_batch_resource->Unref();
+}
+
+TEST_F(BatchResourceBaseTest,
+       QueueSchedulingOptionsRejectInvalidConfiguration) {
+  std::shared_ptr<SharedBatchScheduler<BatchResourceBase::BatchTask>> batcher;
+  TF_CHECK_OK(
+      SharedBatchScheduler<BatchResourceBase::BatchTask>::Create({}, &batcher));
+  MyBatchResource* my_batch_resource = new MyBatchResource(
+      /* has_process_batch_function */ true,
+      /* batcher= */ batcher,
+      /* batcher_queue_options */ {},
+      /* allowed_batch_sizes */ {});
+
+  BatchResourceBase::QueueSchedulingOptions options;
+  options.fair_share_weight = 0;
+  EXPECT_EQ(my_batch_resource->SetQueueSchedulingOptions(options).code(),
+            absl::StatusCode::kInvalidArgument);
+
+  options = BatchResourceBase::QueueSchedulingOptions();
+  options.sheddable_task_deadline_micros = -1;
+  EXPECT_EQ(my_batch_resource->SetQueueSchedulingOptions(options).code(),
+            absl::StatusCode::kInvalidArgument);
+
+  options = BatchResourceBase::QueueSchedulingOptions();
+  options.priority_class = 1;
+  options.fair_share_weight = 2;
+  options.max_starvation_micros = 1000;
+  options.task_deadline_micros = 100 * 1000;
+  TF_EXPECT_OK(my_batch_resource->SetQueueSchedulingOptions(options));
+
+  my_batch_resource->Unref();
+}
+
+TEST_F(BatchResourceBaseTest, LengthBucketingPadsToLongestTaskOfBatch) {
+  std::shared_ptr<SharedBatchScheduler<BatchResourceBase::BatchTask>> batcher;
+  TF_CHECK_OK(
+      SharedBatchScheduler<BatchResourceBase::BatchTask>::Create({}, &batcher));
+
+  // Two tasks of five rows fill a batch.
+  MyBatchResource* my_batch_resource = new MyBatchResource(
+      /* has_process_batch_function */ true,
+      /* batcher= */ batcher,
+      /* batcher_queue_options */
+      MyBatchResource::BatcherT::QueueOptions{
+          .input_batch_size_limit = 10,
+          .batch_timeout_micros = 10 * 1000 * 1000,
+      },
+      /* allowed_batch_sizes */ {});
+  TF_ASSERT_OK(my_batch_resource->SetLengthBucketing(
+      /* length_dimension= */ 1, /* length_bucket_boundaries= */ {4, 8}));
+
+  // Lengths 3 and 4 share the first bucket.
+  Tensor short_input(DataType::DT_INT64, TensorShape({5, 3, 1}));
+  short_input.flat<int64_t>().setConstant(1);
+  Tensor long_input(DataType::DT_INT64, TensorShape({5, 4, 1}));
+  long_input.flat<int64_t>().setConstant(2);
+  std::vector<TensorValue> short_values = {TensorValue(&short_input),
+                                           TensorValue(&short_input),
+                                           TensorValue(&input_tensor_)};
+  std::vector<TensorValue> long_values = {TensorValue(&long_input),
+                                          TensorValue(&long_input),
+                                          TensorValue(&input_tensor_)};
+  OpKernelContext::Params short_params = params_;
+  short_params.inputs = short_values;
+  OpKernelContext short_context(&short_params);
+  OpKernelContext::Params long_params = params_;
+  long_params.inputs = long_values;
+  OpKernelContext long_context(&long_params);
+
+  for (OpKernelContext* context : {&short_context, &long_context}) {
+    TF_ASSERT_OK(my_batch_resource->RegisterInput(
+        /* guid= */ 0, context,
+        /* batcher_queue_name= */ "batcher_queue_name",
+        /* create_batch_task_fn= */
+        []() -> absl::StatusOr<std::unique_ptr<BatchResourceBase::BatchTask>> {
+          return std::make_unique<BatchResourceBase::BatchTask>();
+        },
+        /* done_callback= */ [] {}, /* forced_warmup_batch_size= */ 0));
+  }
+
+  ASSERT_TRUE(my_batch_resource->process_func_batch_called()
+                  .WaitForNotificationWithTimeout(absl::Seconds(10)));
+  ASSERT_EQ(my_batch_resource->batch_inputs().size(), 3);
+  const Tensor& batched = my_batch_resource->batch_inputs()[0];
+  ASSERT_EQ(batched.shape(), TensorShape({10, 4, 1}));
+  auto values = batched.tensor<int64_t, 3>();
+  for (int row = 0; row < 5; ++row) {
+    EXPECT_EQ(values(row, 2, 0), 1);
+    // The short task is padded with zeros.
+    EXPECT_EQ(values(row, 3, 0), 0);
+    EXPECT_EQ(values(row + 5, 3, 0), 2);
+  }
+
+  my_batch_resource->Unref();
+}
+
 }  // namespace
 }  // namespace serving
 }  // namespace tensorflow
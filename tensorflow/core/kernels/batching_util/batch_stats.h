@@ -188,6 +188,48 @@ class ModelBatchStats {
     return batch_timeout_micros_.load(std::memory_order_relaxed);
   }
 
+  // Registers that `num_tasks` tasks of this model were dropped without being
+  // processed because their deadline had passed by the time their batch was
+  // about to be processed.
+  void RegisterDroppedTasks(int64_t num_tasks) {
+    cumulative_dropped_tasks_.fetch_add(num_tasks, std::memory_order_relaxed);
+  }
+
+  // Returns the number of tasks of this model dropped before execution.
+  int64_t cumulative_dropped_tasks() const {
+    return cumulative_dropped_tasks_.load(std::memory_order_relaxed);
+  }
+
+  // Registers that a batch of this model was scheduled ahead of its priority
+  // class and fair share because it had waited for longer than the
+  // starvation bound of its queue.
+  void RegisterStarvedBatch() {
+    cumulative_starved_batches_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Returns the number of batches of this model scheduled by the starvation
+  // bound.
+  int64_t cumulative_starved_batches() const {
+    return cumulative_starved_batches_.load(std::memory_order_relaxed);
+  }
+
+  void SetSchedulingPriorityClass(int32 priority_class) {
+    scheduling_priority_class_.store(priority_class,
+                                     std::memory_order_relaxed);
+  }
+
+  int32 scheduling_priority_class() const {
+    return scheduling_priority_class_.load(std::memory_order_relaxed);
+  }
+
+  void SetFairShareWeight(double fair_share_weight) {
+    fair_share_weight_.store(fair_share_weight, std::memory_order_relaxed);
+  }
+
+  double fair_share_weight() const {
+    return fair_share_weight_.load(std::memory_order_relaxed);
+  }
+
  private:
   mutable mutex mu_;
 
@@ -212,6 +254,18 @@ class ModelBatchStats {
   // The timeout in microseconds for this model (after which the current batch
   // is sent to be processed by the TPU).
   std::atomic<int64_t> batch_timeout_micros_ = kBatchTimeoutMicrosUnknown;
+
+  // The number of tasks dropped before execution because their deadline had
+  // passed.
+  std::atomic<int64_t> cumulative_dropped_tasks_ = 0;
+
+  // The number of batches scheduled by the starvation bound of their queue.
+  std::atomic<int64_t> cumulative_starved_batches_ = 0;
+
+  // The priority class and fair share weight of this model's queues in a
+  // SharedBatchScheduler that shares its threads fairly among queues.
+  std::atomic<int32> scheduling_priority_class_ = 0;
+  std::atomic<double> fair_share_weight_ = 1.0;
 };
 
 // Tracks batch statistics for all models.
@@ -148,6 +148,26 @@ TEST(BatchStatsTest, NumBatchThreadsIsCorrect) {
   ASSERT_EQ(stats.num_batch_threads(), 16);
 }
 
+TEST(BatchStatsTest, SchedulingStatsAreCorrect) {
+  ModelBatchStats stats;
+
+  // Queues default to priority class 0 and a fair share weight of 1.
+  ASSERT_EQ(stats.scheduling_priority_class(), 0);
+  ASSERT_EQ(stats.fair_share_weight(), 1.0);
+  ASSERT_EQ(stats.cumulative_dropped_tasks(), 0);
+  ASSERT_EQ(stats.cumulative_starved_batches(), 0);
+
+  stats.SetSchedulingPriorityClass(2);
+  stats.SetFairShareWeight(0.5);
+  stats.RegisterDroppedTasks(3);
+  stats.RegisterDroppedTasks(4);
+  stats.RegisterStarvedBatch();
+  ASSERT_EQ(stats.scheduling_priority_class(), 2);
+  ASSERT_EQ(stats.fair_share_weight(), 0.5);
+  ASSERT_EQ(stats.cumulative_dropped_tasks(), 7);
+  ASSERT_EQ(stats.cumulative_starved_batches(), 1);
+}
+
 }  // namespace
 
 }  // namespace tensorflow::serving
@@ -0,0 +1,321 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/batching_util/batch_timeout_controller.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "tensorflow/core/kernels/batching_util/batch_stats.h"
+#include "tensorflow/core/lib/monitoring/gauge.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/mutex.h"
+
+namespace tensorflow {
+namespace serving {
+namespace {
+
+// The budget shrinks by this factor each time the p99 target is missed, and
+// grows back by `kBudgetIncrease` each time it is met.
+constexpr double kBudgetDecreaseFactor = 0.8;
+constexpr double kBudgetIncrease = 0.05;
+// The budget never drops below this fraction of the target.
+constexpr double kMinBudgetFraction = 0.1;
+// The observed p99 is not trusted with fewer latency samples than this.
+constexpr int64_t kMinLatencySamples = 20;
+
+void RecordAdaptiveBatchTimeoutMicros(int64_t batch_timeout_micros,
+                                      const std::string& model_name,
+                                      const std::string& op_name) {
+  static auto* cell = monitoring::Gauge<int64_t, 2>::New(
+      "/tensorflow/serving/batching/adaptive_batch_timeout_micros",
+      "Tracks the batch timeout picked by the latency target controller.",
+      "model_name", "op_name");
+  cell->GetCell(model_name, op_name)->Set(batch_timeout_micros);
+}
+
+void RecordAdaptiveMaxBatchSize(int64_t max_batch_size,
+                                const std::string& model_name,
+                                const std::string& op_name) {
+  static auto* cell = monitoring::Gauge<int64_t, 2>::New(
+      "/tensorflow/serving/batching/adaptive_max_batch_size",
+      "Tracks the batch size picked by the latency target controller.",
+      "model_name", "op_name");
+  cell->GetCell(model_name, op_name)->Set(max_batch_size);
+}
+
+void RecordAdaptiveLatencyBudgetMicros(int64_t latency_budget_micros,
+                                       const std::string& model_name,
+                                       const std::string& op_name) {
+  static auto* cell = monitoring::Gauge<int64_t, 2>::New(
+      "/tensorflow/serving/batching/adaptive_latency_budget_micros",
+      "Tracks the latency the latency target controller plans for, after "
+      "correcting the target with the observed p99 latency.",
+      "model_name", "op_name");
+  cell->GetCell(model_name, op_name)->Set(latency_budget_micros);
+}
+
+}  // namespace
+
+/*static*/ absl::Status BatchTimeoutController::Create(
+    const Options& options, std::unique_ptr<BatchTimeoutController>* result) {
+  if (options.target_latency <= absl::ZeroDuration()) {
+    return errors::InvalidArgument(
+        "target_latency must be positive; was ",
+        absl::FormatDuration(options.target_latency));
+  }
+  if (options.min_batch_timeout_micros < 0 ||
+      options.max_batch_timeout_micros < options.min_batch_timeout_micros) {
+    return errors::InvalidArgument(
+        "batch timeout bounds must satisfy 0 <= min_batch_timeout_micros <= "
+        "max_batch_timeout_micros; were ",
+        options.min_batch_timeout_micros, " and ",
+        options.max_batch_timeout_micros);
+  }
+  if (options.max_batch_size <= 0) {
+    return errors::InvalidArgument("max_batch_size must be positive; was ",
+                                   options.max_batch_size);
+  }
+  for (int32 size : options.allowed_batch_sizes) {
+    if (size <= 0) {
+      return errors::InvalidArgument(
+          "allowed_batch_sizes entries must be positive; got ", size);
+    }
+  }
+  if (options.arrival_rate_half_life <= absl::ZeroDuration()) {
+    return errors::InvalidArgument(
+        "arrival_rate_half_life must be positive; was ",
+        absl::FormatDuration(options.arrival_rate_half_life));
+  }
+  if (options.latency_window_size <= 0) {
+    return errors::InvalidArgument("latency_window_size must be positive; was ",
+                                   options.latency_window_size);
+  }
+  result->reset(new BatchTimeoutController(options));
+  return absl::OkStatus();
+}
+
+BatchTimeoutController::BatchTimeoutController(const Options& options)
+    : options_(options),
+      batch_stats_(options.model_batch_stats != nullptr
+                       ? *options.model_batch_stats
+                       : local_batch_stats_),
+      batch_timeout_micros_(options.max_batch_timeout_micros),
+      max_batch_size_(options.max_batch_size) {
+  if (options_.allowed_batch_sizes.empty()) {
+    for (int64_t size = 1; size < options_.max_batch_size; size *= 2) {
+      candidate_batch_sizes_.push_back(size);
+    }
+    candidate_batch_sizes_.push_back(options_.max_batch_size);
+  } else {
+    for (int32 size : options_.allowed_batch_sizes) {
+      if (size <= options_.max_batch_size) {
+        candidate_batch_sizes_.push_back(size);
+      }
+    }
+    std::sort(candidate_batch_sizes_.begin(), candidate_batch_sizes_.end());
+    candidate_batch_sizes_.erase(std::unique(candidate_batch_sizes_.begin(),
+                                             candidate_batch_sizes_.end()),
+                                 candidate_batch_sizes_.end());
+  }
+  latencies_.reserve(options_.latency_window_size);
+}
+
+void BatchTimeoutController::RecordArrival(int64_t size, uint64 now_micros) {
+  mutex_lock l(mu_);
+  const double half_life_micros =
+      absl::ToDoubleMicroseconds(options_.arrival_rate_half_life);
+  // An exponentially decaying count of arrivals, normalized so that it
+  // converges to the arrival rate under steady traffic.
+  if (now_micros > last_arrival_micros_) {
+    arrival_rate_ *= std::exp2(
+        -static_cast<double>(now_micros - last_arrival_micros_) /
+        half_life_micros);
+    last_arrival_micros_ = now_micros;
+  }
+  arrival_rate_ += size * std::log(2.0) / half_life_micros;
+  Update(now_micros);
+}
+
+void BatchTimeoutController::RecordLatency(absl::Duration latency,
+                                           uint64 now_micros) {
+  mutex_lock l(mu_);
+  if (latencies_.size() < static_cast<size_t>(options_.latency_window_size)) {
+    latencies_.push_back(latency);
+  } else {
+    latencies_[next_latency_] = latency;
+  }
+  next_latency_ = (next_latency_ + 1) % options_.latency_window_size;
+  Update(now_micros);
+}
+
+void BatchTimeoutController::RegisterBatchCost(int64_t batch_size,
+                                               absl::Duration cost) {
+  local_batch_stats_.batch_size(batch_size).tpu_cost().Register(cost);
+}
+
+void BatchTimeoutController::MaybeUpdate(uint64 now_micros) {
+  mutex_lock l(mu_);
+  Update(now_micros);
+}
+
+double BatchTimeoutController::arrival_rate_per_second() const {
+  mutex_lock l(mu_);
+  return arrival_rate_ * 1e6;
+}
+
+std::optional<absl::Duration> BatchTimeoutController::observed_p99_latency()
+    const {
+  std::vector<absl::Duration> latencies;
+  {
+    mutex_lock l(mu_);
+    latencies = latencies_;
+  }
+  if (latencies.empty()) return std::nullopt;
+  const int64_t rank = std::ceil(0.99 * latencies.size()) - 1;
+  std::nth_element(latencies.begin(), latencies.begin() + rank,
+                   latencies.end());
+  return latencies[rank];
+}
+
+double BatchTimeoutController::latency_budget_fraction() const {
+  mutex_lock l(mu_);
+  return budget_fraction_;
+}
+
+std::optional<absl::Duration> BatchTimeoutController::EstimateBatchCost(
+    int64_t batch_size) const {
+  std::vector<int32> sizes = batch_stats_.BatchSizes();
+  std::sort(sizes.begin(), sizes.end());
+  std::optional<int32> lower, upper;
+  std::optional<absl::Duration> lower_cost, upper_cost;
+  for (int32 size : sizes) {
+    std::optional<absl::Duration> cost =
+        batch_stats_.batch_size(size).tpu_cost().mean();
+    if (!cost.has_value()) continue;
+    if (size == batch_size) return cost;
+    if (size < batch_size) {
+      lower = size;
+      lower_cost = cost;
+    } else {
+      upper = size;
+      upper_cost = cost;
+      break;
+    }
+  }
+  if (lower.has_value() && upper.has_value()) {
+    return *lower_cost + (*upper_cost - *lower_cost) *
+                             (static_cast<double>(batch_size - *lower) /
+                              (*upper - *lower));
+  }
+  // Smaller batches are assumed to cost no less than the smallest measured
+  // one, and larger batches to cost proportionally more than the largest.
+  if (upper.has_value()) return upper_cost;
+  if (lower.has_value()) {
+    return *lower_cost * (static_cast<double>(batch_size) / *lower);
+  }
+  return std::nullopt;
+}
+
+void BatchTimeoutController::Update(uint64 now_micros) {
+  if (last_update_micros_ != 0 &&
+      now_micros < last_update_micros_ +
+                       absl::ToInt64Microseconds(options_.update_interval)) {
+    return;
+  }
+  last_update_micros_ = now_micros;
+
+  // Correct the budget with the latency actually observed.
+  if (latencies_.size() >= kMinLatencySamples) {
+    const int64_t rank = std::ceil(0.99 * latencies_.size()) - 1;
+    std::vector<absl::Duration> latencies = latencies_;
+    std::nth_element(latencies.begin(), latencies.begin() + rank,
+                     latencies.end());
+    if (latencies[rank] > options_.target_latency) {
+      budget_fraction_ = std::max(kMinBudgetFraction,
+                                  budget_fraction_ * kBudgetDecreaseFactor);
+      // Judge the next decision only by the requests it affects.
+      latencies_.clear();
+      next_latency_ = 0;
+    } else {
+      budget_fraction_ = std::min(1.0, budget_fraction_ + kBudgetIncrease);
+    }
+  }
+  const absl::Duration budget = options_.target_latency * budget_fraction_;
+
+  double arrival_rate = arrival_rate_;
+  if (now_micros > last_arrival_micros_) {
+    arrival_rate *= std::exp2(
+        -static_cast<double>(now_micros - last_arrival_micros_) /
+        absl::ToDoubleMicroseconds(options_.arrival_rate_half_life));
+  }
+
+  // Pick the largest batch size whose first task is expected to finish within
+  // the budget.
+  bool has_costs = false;
+  std::optional<int64_t> best_size;
+  absl::Duration best_cost;
+  for (int64_t size : candidate_batch_sizes_) {
+    const std::optional<absl::Duration> cost = EstimateBatchCost(size);
+    if (!cost.has_value()) continue;
+    has_costs = true;
+    double fill_micros = 0;
+    if (size > 1) {
+      fill_micros = arrival_rate > 0 ? (size - 1) / arrival_rate
+                                     : std::numeric_limits<double>::infinity();
+    }
+    if (fill_micros + absl::ToDoubleMicroseconds(*cost) <=
+        absl::ToDoubleMicroseconds(budget)) {
+      best_size = size;
+      best_cost = *cost;
+    }
+  }
+  if (!has_costs) return;
+
+  int64_t batch_timeout_micros = options_.min_batch_timeout_micros;
+  int64_t max_batch_size = candidate_batch_sizes_.front();
+  if (best_size.has_value()) {
+    max_batch_size = *best_size;
+    // Waiting only helps if the batch can grow.
+    if (*best_size > 1) {
+      batch_timeout_micros = std::clamp(
+          absl::ToInt64Microseconds(budget - best_cost),
+          options_.min_batch_timeout_micros, options_.max_batch_timeout_micros);
+    }
+  }
+
+  batch_timeout_micros_.store(batch_timeout_micros, std::memory_order_relaxed);
+  max_batch_size_.store(max_batch_size, std::memory_order_relaxed);
+  if (options_.model_batch_stats != nullptr) {
+    options_.model_batch_stats->SetBatchTimeoutMicros(batch_timeout_micros);
+  }
+  RecordAdaptiveBatchTimeoutMicros(batch_timeout_micros, options_.model_name,
+                                   options_.op_name);
+  RecordAdaptiveMaxBatchSize(max_batch_size, options_.model_name,
+                             options_.op_name);
+  RecordAdaptiveLatencyBudgetMicros(absl::ToInt64Microseconds(budget),
+                                    options_.model_name, options_.op_name);
+}
+
+}  // namespace serving
+}  // namespace tensorflow
@@ -0,0 +1,168 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_TIMEOUT_CONTROLLER_H_
+#define TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_TIMEOUT_CONTROLLER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "tensorflow/core/kernels/batching_util/batch_stats.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/types.h"
+#include "tsl/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace serving {
+
+// Picks the batch timeout and the batch size at which a SharedBatchScheduler
+// queue closes its open batch, so that a p99 latency target is met with the
+// largest batches that fit in it.
+//
+// The controller models the latency of the first task of a batch of size `b`
+// as the time to collect `b` tasks at the observed arrival rate plus the
+// processing cost of a batch of size `b`, taken from the batch costs recorded
+// in `ModelBatchStats`. It selects the largest candidate size whose modeled
+// latency fits in the latency budget:
+//
+//   - At low traffic even a batch of two would not be collected within the
+//     budget, so the timeout drops to `min_batch_timeout_micros` and requests
+//     no longer wait for tasks that will not come.
+//   - At high traffic larger batches fill quickly, so the batch size grows and
+//     the timeout is set to the remaining budget, so that batches do not close
+//     early.
+//
+// The budget starts at `target_latency` and is adjusted with the observed p99
+// latency of recent requests: it shrinks multiplicatively while the target is
+// missed and grows back additively while it is met.
+//
+// The decisions are exported through monitoring gauges labeled with the model
+// and op names, and the timeout is also published to `ModelBatchStats`.
+//
+// Thread-safe.
+class BatchTimeoutController {
+ public:
+  struct Options {
+    // The p99 latency target, from a task entering the queue to its batch
+    // finishing. Must be positive.
+    absl::Duration target_latency;
+
+    // Bounds for the batch timeout. The upper bound is also the timeout used
+    // until there are enough statistics to model the latency.
+    int64_t min_batch_timeout_micros = 0;
+    int64_t max_batch_timeout_micros = 0;
+
+    // The largest batch the queue may form. Must be positive.
+    int64_t max_batch_size = 0;
+
+    // If non-empty, the candidate batch sizes. Otherwise powers of two up to
+    // `max_batch_size`, and `max_batch_size` itself, are considered.
+    std::vector<int32> allowed_batch_sizes;
+
+    // Source of the per-batch-size processing costs. May be null, in which
+    // case the controller keeps the static configuration until costs are
+    // registered with `RegisterBatchCost`.
+    ModelBatchStats* model_batch_stats = nullptr;
+
+    // Labels for the exported metrics.
+    std::string model_name;
+    std::string op_name;
+
+    // How often decisions are recomputed.
+    absl::Duration update_interval = absl::Milliseconds(100);
+
+    // The time constant of the arrival rate estimate.
+    absl::Duration arrival_rate_half_life = absl::Seconds(1);
+
+    // The number of recent request latencies the observed p99 is computed
+    // over.
+    int64_t latency_window_size = 1000;
+  };
+
+  static absl::Status Create(const Options& options,
+                             std::unique_ptr<BatchTimeoutController>* result);
+
+  // Records that a task of `size` units entered the queue at `now_micros`.
+  void RecordArrival(int64_t size, uint64 now_micros);
+
+  // Records the end-to-end latency of a request that finished at `now_micros`.
+  void RecordLatency(absl::Duration latency, uint64 now_micros);
+
+  // Registers the processing cost of a batch of `batch_size`, for use when no
+  // `ModelBatchStats` is configured.
+  void RegisterBatchCost(int64_t batch_size, absl::Duration cost);
+
+  // Recomputes the decisions if `update_interval` has passed since the last
+  // update. Also called by `RecordArrival` and `RecordLatency`.
+  void MaybeUpdate(uint64 now_micros);
+
+  // The current decisions. Cheap enough to be read on every scheduling check.
+  int64_t batch_timeout_micros() const {
+    return batch_timeout_micros_.load(std::memory_order_relaxed);
+  }
+  int64_t max_batch_size() const {
+    return max_batch_size_.load(std::memory_order_relaxed);
+  }
+
+  // Exposed for testing.
+  double arrival_rate_per_second() const;
+  std::optional<absl::Duration> observed_p99_latency() const;
+  double latency_budget_fraction() const;
+
+ private:
+  explicit BatchTimeoutController(const Options& options);
+
+  // Returns the expected processing cost of a batch of `batch_size`, by linear
+  // interpolation between the sizes that have statistics.
+  std::optional<absl::Duration> EstimateBatchCost(int64_t batch_size) const;
+
+  void Update(uint64 now_micros) TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const Options options_;
+  // Holds the costs registered with `RegisterBatchCost`.
+  ModelBatchStats local_batch_stats_;
+  // `options_.model_batch_stats` if set, `local_batch_stats_` otherwise.
+  ModelBatchStats& batch_stats_;
+  // Candidate batch sizes in increasing order.
+  std::vector<int64_t> candidate_batch_sizes_;
+
+  mutable mutex mu_;
+
+  // Exponentially decaying arrival rate, in units per microsecond.
+  double arrival_rate_ TF_GUARDED_BY(mu_) = 0;
+  uint64 last_arrival_micros_ TF_GUARDED_BY(mu_) = 0;
+
+  // Ring buffer of recent request latencies.
+  std::vector<absl::Duration> latencies_ TF_GUARDED_BY(mu_);
+  int64_t next_latency_ TF_GUARDED_BY(mu_) = 0;
+
+  // Fraction of `target_latency` the model plans for.
+  double budget_fraction_ TF_GUARDED_BY(mu_) = 1.0;
+  uint64 last_update_micros_ TF_GUARDED_BY(mu_) = 0;
+
+  std::atomic<int64_t> batch_timeout_micros_;
+  std::atomic<int64_t> max_batch_size_;
+};
+
+}  // namespace serving
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_BATCHING_UTIL_BATCH_TIMEOUT_CONTROLLER_H_
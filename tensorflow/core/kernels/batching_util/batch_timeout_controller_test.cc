@@ -0,0 +1,217 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/batching_util/batch_timeout_controller.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include <gtest/gtest.h>
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "tensorflow/core/kernels/batching_util/batch_stats.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/monitoring/cell_reader.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace serving {
+namespace {
+
+using ::tensorflow::monitoring::testing::CellReader;
+
+BatchTimeoutController::Options DefaultOptions() {
+  BatchTimeoutController::Options options;
+  options.target_latency = absl::Milliseconds(10);
+  options.min_batch_timeout_micros = 0;
+  options.max_batch_timeout_micros = 20000;
+  options.max_batch_size = 32;
+  options.model_name = "m";
+  options.op_name = "o";
+  options.update_interval = absl::ZeroDuration();
+  options.arrival_rate_half_life = absl::Milliseconds(100);
+  return options;
+}
+
+// Batches of one take 1ms, batches of 32 take 4ms.
+void RegisterCosts(BatchTimeoutController& controller) {
+  controller.RegisterBatchCost(1, absl::Milliseconds(1));
+  controller.RegisterBatchCost(32, absl::Milliseconds(4));
+}
+
+// Simulates arrivals of one task every `interval_micros` for `duration`.
+uint64 SimulateArrivals(BatchTimeoutController& controller, uint64 start_micros,
+                        int64_t interval_micros, absl::Duration duration) {
+  const uint64 end_micros = start_micros + absl::ToInt64Microseconds(duration);
+  uint64 now = start_micros;
+  for (; now < end_micros; now += interval_micros) {
+    controller.RecordArrival(/*size=*/1, now);
+  }
+  return now;
+}
+
+TEST(BatchTimeoutControllerTest, InvalidOptions) {
+  std::unique_ptr<BatchTimeoutController> controller;
+
+  BatchTimeoutController::Options options = DefaultOptions();
+  options.target_latency = absl::ZeroDuration();
+  EXPECT_EQ(BatchTimeoutController::Create(options, &controller).code(),
+            absl::StatusCode::kInvalidArgument);
+
+  options = DefaultOptions();
+  options.min_batch_timeout_micros = 100;
+  options.max_batch_timeout_micros = 10;
+  EXPECT_EQ(BatchTimeoutController::Create(options, &controller).code(),
+            absl::StatusCode::kInvalidArgument);
+
+  options = DefaultOptions();
+  options.max_batch_size = 0;
+  EXPECT_EQ(BatchTimeoutController::Create(options, &controller).code(),
+            absl::StatusCode::kInvalidArgument);
+
+  options = DefaultOptions();
+  options.allowed_batch_sizes = {0, 8};
+  EXPECT_EQ(BatchTimeoutController::Create(options, &controller).code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST(BatchTimeoutControllerTest, KeepsStaticConfigurationWithoutCosts) {
+  std::unique_ptr<BatchTimeoutController> controller;
+  TF_ASSERT_OK(BatchTimeoutController::Create(DefaultOptions(), &controller));
+
+  SimulateArrivals(*controller, 1, 1000, absl::Seconds(1));
+
+  EXPECT_EQ(controller->batch_timeout_micros(), 20000);
+  EXPECT_EQ(controller->max_batch_size(), 32);
+}
+
+TEST(BatchTimeoutControllerTest, EstimatesArrivalRate) {
+  std::unique_ptr<BatchTimeoutController> controller;
+  TF_ASSERT_OK(BatchTimeoutController::Create(DefaultOptions(), &controller));
+
+  SimulateArrivals(*controller, 1, 1000, absl::Seconds(2));
+
+  EXPECT_NEAR(controller->arrival_rate_per_second(), 1000, 10);
+}
+
+TEST(BatchTimeoutControllerTest, DoesNotWaitAtLowTraffic) {
+  std::unique_ptr<BatchTimeoutController> controller;
+  TF_ASSERT_OK(BatchTimeoutController::Create(DefaultOptions(), &controller));
+  RegisterCosts(*controller);
+
+  // 10 requests per second; a second request is not expected within 10ms.
+  SimulateArrivals(*controller, 1, 100000, absl::Seconds(2));
+
+  EXPECT_EQ(controller->batch_timeout_micros(), 0);
+  EXPECT_EQ(controller->max_batch_size(), 1);
+}
+
+TEST(BatchTimeoutControllerTest, PicksLargestBatchWithinTarget) {
+  std::unique_ptr<BatchTimeoutController> controller;
+  TF_ASSERT_OK(BatchTimeoutController::Create(DefaultOptions(), &controller));
+  RegisterCosts(*controller);
+
+  // 1000 requests per second: a batch of 8 takes 7ms to collect and about
+  // 1.7ms to process, a batch of 16 would take 15ms to collect.
+  SimulateArrivals(*controller, 1, 1000, absl::Seconds(2));
+
+  EXPECT_EQ(controller->max_batch_size(), 8);
+  // The timeout is what remains of the target after processing.
+  EXPECT_NEAR(controller->batch_timeout_micros(), 10000 - 1677, 2);
+}
+
+TEST(BatchTimeoutControllerTest, GrowsBatchesAtHighTraffic) {
+  std::unique_ptr<BatchTimeoutController> controller;
+  TF_ASSERT_OK(BatchTimeoutController::Create(DefaultOptions(), &controller));
+  RegisterCosts(*controller);
+
+  SimulateArrivals(*controller, 1, 10, absl::Milliseconds(500));
+
+  EXPECT_EQ(controller->max_batch_size(), 32);
+  EXPECT_EQ(controller->batch_timeout_micros(), 6000);
+}
+
+TEST(BatchTimeoutControllerTest, UsesAllowedBatchSizes) {
+  BatchTimeoutController::Options options = DefaultOptions();
+  options.allowed_batch_sizes = {4, 12, 64};
+  std::unique_ptr<BatchTimeoutController> controller;
+  TF_ASSERT_OK(BatchTimeoutController::Create(options, &controller));
+  RegisterCosts(*controller);
+
+  SimulateArrivals(*controller, 1, 10, absl::Milliseconds(500));
+
+  // 64 is above max_batch_size.
+  EXPECT_EQ(controller->max_batch_size(), 12);
+}
+
+TEST(BatchTimeoutControllerTest, ReadsCostsFromModelBatchStats) {
+  ModelBatchStats stats;
+  stats.batch_size(1).tpu_cost().Register(absl::Milliseconds(1));
+  stats.batch_size(32).tpu_cost().Register(absl::Milliseconds(4));
+  BatchTimeoutController::Options options = DefaultOptions();
+  options.model_batch_stats = &stats;
+  std::unique_ptr<BatchTimeoutController> controller;
+  TF_ASSERT_OK(BatchTimeoutController::Create(options, &controller));
+
+  SimulateArrivals(*controller, 1, 1000, absl::Seconds(2));
+
+  EXPECT_EQ(controller->max_batch_size(), 8);
+  EXPECT_EQ(stats.batch_timeout_micros(), controller->batch_timeout_micros());
+}
+
+TEST(BatchTimeoutControllerTest, ShrinksBudgetWhenTargetIsMissed) {
+  std::unique_ptr<BatchTimeoutController> controller;
+  TF_ASSERT_OK(BatchTimeoutController::Create(DefaultOptions(), &controller));
+  RegisterCosts(*controller);
+  uint64 now = SimulateArrivals(*controller, 1, 1000, absl::Seconds(2));
+  const int64_t initial_timeout = controller->batch_timeout_micros();
+
+  for (int i = 0; i < 20; ++i) {
+    controller->RecordLatency(absl::Milliseconds(15), ++now);
+  }
+  EXPECT_EQ(controller->observed_p99_latency(), std::nullopt);
+  EXPECT_DOUBLE_EQ(controller->latency_budget_fraction(), 0.8);
+  EXPECT_LT(controller->batch_timeout_micros(), initial_timeout);
+
+  for (int i = 0; i < 40; ++i) {
+    controller->RecordLatency(absl::Milliseconds(5), ++now);
+  }
+  EXPECT_EQ(controller->observed_p99_latency(), absl::Milliseconds(5));
+  EXPECT_DOUBLE_EQ(controller->latency_budget_fraction(), 1.0);
+  EXPECT_EQ(controller->batch_timeout_micros(), initial_timeout);
+}
+
+TEST(BatchTimeoutControllerTest, ExportsDecisions) {
+  CellReader<int64_t> timeout_reader(
+      "/tensorflow/serving/batching/adaptive_batch_timeout_micros");
+  CellReader<int64_t> batch_size_reader(
+      "/tensorflow/serving/batching/adaptive_max_batch_size");
+  CellReader<int64_t> budget_reader(
+      "/tensorflow/serving/batching/adaptive_latency_budget_micros");
+  std::unique_ptr<BatchTimeoutController> controller;
+  TF_ASSERT_OK(BatchTimeoutController::Create(DefaultOptions(), &controller));
+  RegisterCosts(*controller);
+
+  SimulateArrivals(*controller, 1, 1000, absl::Seconds(2));
+
+  EXPECT_EQ(timeout_reader.Read("m", "o"), controller->batch_timeout_micros());
+  EXPECT_EQ(batch_size_reader.Read("m", "o"), 8);
+  EXPECT_EQ(budget_reader.Read("m", "o"), 10000);
+}
+
+}  // namespace
+}  // namespace serving
+}  // namespace tensorflow
@@ -247,6 +247,82 @@ inline absl::Status Split(OpKernelContext* context, const Tensor& input,
   return split_status;
 }
 
+// Pads 'input' with zeros at the end of dimension 'dim', to size 'size'.
+// Requires that 'input' has element type T and that 'size' is at least the
+// size of its dimension 'dim'. Writes to 'output' using 'context' for the
+// allocation.
+template <typename T>
+absl::Status PadAlongDimension(OpKernelContext* context, const Tensor& input,
+                               int dim, int64_t size, Tensor* output) {
+  if (dim < 0 || dim >= input.dims()) {
+    return errors::InvalidArgument("Cannot pad dimension ", dim,
+                                   " of a tensor of shape ",
+                                   input.shape().DebugString());
+  }
+  const int64_t input_size = input.dim_size(dim);
+  if (size < input_size) {
+    return errors::InvalidArgument("Cannot pad dimension ", dim,
+                                   " of a tensor of shape ",
+                                   input.shape().DebugString(), " to size ",
+                                   size);
+  }
+  if (size == input_size) {
+    *output = input;
+    return absl::OkStatus();
+  }
+
+  TensorShape output_shape(input.shape());
+  output_shape.set_dim(dim, size);
+  AllocatorAttributes attr;
+  attr.set_on_host(true);
+  TF_RETURN_IF_ERROR(context->allocate_temp(DataTypeToEnum<T>::value,
+                                            output_shape, output, attr));
+
+  // View both tensors as {outer, dim, inner}, so that the input is the
+  // leading slice of the output along the middle dimension.
+  int64_t outer_size = 1;
+  for (int i = 0; i < dim; ++i) {
+    outer_size *= input.dim_size(i);
+  }
+  int64_t inner_size = 1;
+  for (int i = dim + 1; i < input.dims(); ++i) {
+    inner_size *= input.dim_size(i);
+  }
+  auto output_shaped = output->shaped<T, 3>({outer_size, size, inner_size});
+  output_shaped.setConstant(T());
+  if (input.NumElements() > 0) {
+    auto input_shaped =
+        input.shaped<T, 3>({outer_size, input_size, inner_size});
+    Eigen::DSizes<Eigen::DenseIndex, 3> slice_indices{0, 0, 0};
+    Eigen::DSizes<Eigen::DenseIndex, 3> slice_sizes{
+        static_cast<Eigen::DenseIndex>(outer_size),
+        static_cast<Eigen::DenseIndex>(input_size),
+        static_cast<Eigen::DenseIndex>(inner_size)};
+    output_shaped.slice(slice_indices, slice_sizes) = input_shaped;
+  }
+  return absl::OkStatus();
+}
+
+// Same as 'PadAlongDimension' above, but handles Tensor dtype automatically.
+inline absl::Status PadAlongDimension(OpKernelContext* context,
+                                      const Tensor& input, int dim,
+                                      int64_t size, Tensor* output) {
+  const DataType type = input.dtype();
+  absl::Status pad_status;
+  switch (type) {
+#define CASE(type)                                                           \
+  case DataTypeToEnum<type>::value:                                          \
+    pad_status = PadAlongDimension<type>(context, input, dim, size, output); \
+    break;
+    TF_CALL_ALL_TYPES(CASE);
+#undef CASE
+    default:
+      pad_status = errors::InvalidArgument("Unsupported data type: ", type);
+      break;
+  }
+  return pad_status;
+}
+
 }  // namespace concat_split_util
 }  // namespace tensorflow
 
@@ -27,10 +27,12 @@ limitations under the License.
 #include <list>
 #include <memory>
 #include <optional>
+#include <tuple>
 #include <utility>
 #include <variant>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_format.h"
 #include "absl/time/clock.h"
@@ -39,6 +41,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler_utils.h"
 #include "tensorflow/core/kernels/batching_util/batch_stats.h"
+#include "tensorflow/core/kernels/batching_util/batch_timeout_controller.h"
 #include "tensorflow/core/kernels/batching_util/periodic_function.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/strings/strcat.h"
@@ -92,9 +95,11 @@ namespace serving {
 // down over the lifetime of a server.
 //
 // The batch thread pool round-robins through the queues, running one batch
-// from a queue and then moving to the next queue. Each queue behaves like a
-// BasicBatchScheduler instance, in the sense that it has maximum batch size and
-// timeout parameters, which govern when a batch is eligible to be processed.
+// from a queue and then moving to the next queue. (With `fair_share_queues`,
+// it instead serves queues by priority class and weighted fair share; see
+// Options.) Each queue behaves like a BasicBatchScheduler instance, in the
+// sense that it has maximum batch size and timeout parameters, which govern
+// when a batch is eligible to be processed.
 //
 // Each queue is independently configured with a maximum size (in terms of the
 // maximum number of batches worth of enqueued tasks). For online serving, it is
@@ -112,10 +117,6 @@ namespace serving {
 // For bulk processing jobs and throughput-oriented benchmarks, you may want to
 // set the maximum queue size to a large value.
 //
-// TODO(b/26539183): Support queue servicing policies other than round-robin.
-// E.g. let each queue specify a "share" (an int >= 1), so e.g. with queues A
-// and B having shares 1 and 2 respectively, the servicing pattern is ABBABB...
-//
 //
 // PERFORMANCE TUNING: See README.md.
 //
@@ -146,9 +147,19 @@ class SharedBatchScheduler
     // will be prioritized based on a (priority, arrival_time) key.
     bool rank_queues = false;
 
-    // If true, Create() will return a global instance of the scheduler. Only
-    // the options provided in the first Create() call will be used to
-    // initialize the global scheduler.
+    // If true, when multiple queues have available batches to process, the
+    // queue with the smallest `QueueOptions::priority_class` is served first,
+    // and queues of the same class share the batch threads in proportion to
+    // their `QueueOptions::fair_share_weight` (weighted fair queuing on the
+    // task units processed). A queue whose next batch has waited for longer
+    // than its `QueueOptions::max_starvation_micros` is served ahead of both.
+    // Takes precedence over `rank_queues`.
+    bool fair_share_queues = false;
+
+    // If true, Create() will return a global instance of the scheduler. There
+    // is one global instance per combination of `rank_queues` and
+    // `fair_share_queues`; only the other options provided in the first
+    // Create() call for that combination will be used to initialize it.
     bool use_global_scheduler = false;
   };
   // Ownership is shared between the caller of Create() and any queues created
@@ -249,6 +260,12 @@ class SharedBatchScheduler
     // requested.
     ModelBatchStats* model_batch_stats = nullptr;
 
+    // If set, the open batch is closed according to the batch timeout and the
+    // batch size picked by the controller, instead of `batch_timeout_micros`
+    // and `max_execution_batch_size`. The controller's batch size is capped at
+    // `max_execution_batch_size`. The queue reports task arrivals to it.
+    std::shared_ptr<BatchTimeoutController> batch_timeout_controller;
+
     // If true, queue implementation would split high priority and low priority
     // inputs into two sub queues.
     bool enable_priority_queue = false;
@@ -278,6 +295,37 @@ class SharedBatchScheduler
     // effective only when enable_priority_queue is true.
     MixedPriorityBatchingPolicy mixed_priority_batching_policy =
         MixedPriorityBatchingPolicy::kLowPriorityPaddingWithMaxBatchSize;
+
+    // The scheduling class of the queue when the scheduler was created with
+    // `fair_share_queues`. Batches of queues with a smaller class are always
+    // processed first.
+    int32 priority_class = 0;
+
+    // The share of the batch threads this queue gets relative to the other
+    // queues of its priority class, when the scheduler was created with
+    // `fair_share_queues`. Must be positive.
+    double fair_share_weight = 1.0;
+
+    // If positive, and the scheduler was created with `fair_share_queues`, a
+    // batch whose earliest task has waited for this many microseconds is
+    // processed ahead of higher priority classes and fair shares, so that low
+    // priority queues are not starved.
+    int64_t max_starvation_micros = 0;
+
+    // If set, called with each task of a batch, and the current time, just
+    // before the batch is processed. Tasks for which it returns an error, e.g.
+    // because their deadline has passed or they are not critical enough to be
+    // processed this late, are removed from the batch and passed with the error
+    // to `drop_task_func`, which must complete them. A batch left without
+    // tasks is not processed. Dropped tasks are counted in
+    // `model_batch_stats`.
+    std::function<absl::Status(const TaskType& task, uint64 now_micros)>
+        task_expiry_func;
+
+    // Completes a task dropped by `task_expiry_func`. Required iff
+    // `task_expiry_func` is set.
+    std::function<void(std::unique_ptr<TaskType> task, absl::Status status)>
+        drop_task_func;
   };
   // This method is marked virtual for testing purposes only.
   virtual absl::Status AddQueue(
@@ -305,6 +353,20 @@ class SharedBatchScheduler
 
   static bool BatchExists(const BatchTaskUniquePtr& batch_to_process);
 
+  // Returns the key by which `queue`, whose next batch has `batch_key`, is
+  // ordered when the scheduler uses `fair_share_queues`. Smaller is served
+  // first: starving queues by age, then the others by priority class and
+  // virtual start time.
+  std::tuple<bool, int64_t, double, std::pair<int, int64_t>> FairShareKey(
+      const internal::Queue<TaskType>& queue,
+      const std::pair<int, int64_t>& batch_key, uint64 now_micros) const
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Advances the virtual time of `queue` for processing `batch`.
+  void ChargeFairShare(const internal::Queue<TaskType>& queue,
+                       const Batch<TaskType>& batch)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   const Options options_;
 
   mutex mu_;
@@ -323,6 +385,15 @@ class SharedBatchScheduler
   // available batch thread should grab work.
   typename QueueList::iterator next_queue_to_schedule_ TF_GUARDED_BY(mu_);
 
+  // With `fair_share_queues`, the virtual time of each queue, i.e. the task
+  // units it has been served divided by its fair share weight, and of each
+  // priority class, i.e. the virtual start time of the last batch scheduled
+  // from the class. A queue's next batch starts at the later of the two, so
+  // that idle queues do not accumulate credit.
+  absl::flat_hash_map<const internal::Queue<TaskType>*, double>
+      queue_virtual_times_ TF_GUARDED_BY(mu_);
+  absl::flat_hash_map<int32, double> class_virtual_times_ TF_GUARDED_BY(mu_);
+
   // Used by idle batch threads to wait for work to enter the system. Notified
   // whenever a batch becomes schedulable.
   condition_variable schedulable_batch_cv_;
@@ -409,6 +480,24 @@ class Queue {
   // size that's provided by caller of batch scheduler.
   size_t max_execution_batch_size() const { return max_execution_batch_size_; }
 
+  // Returns the size open batches are filled up to: max_execution_batch_size()
+  // or, with a batch timeout controller, the possibly smaller batch size it
+  // currently picks.
+  size_t effective_max_execution_batch_size() const {
+    if (options_.batch_timeout_controller == nullptr) {
+      return max_execution_batch_size();
+    }
+    return std::max<size_t>(
+        1, std::min<size_t>(
+               max_execution_batch_size(),
+               options_.batch_timeout_controller->max_batch_size()));
+  }
+
+  const typename SharedBatchScheduler<TaskType>::QueueOptions& options()
+      const {
+    return options_;
+  }
+
   // Called by a thread that is ready to process a batch, to request one from
   // this queue. Either returns a batch that is ready to be processed, or
   // nullptr if the queue declines to schedule a batch at this time. If it
@@ -457,6 +546,14 @@ class Queue {
   // Same as IsEmpty(), but assumes the caller already holds a lock on 'mu_'.
   bool IsEmptyInternal() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Removes from `batch` and `padding_tasks` the tasks rejected by
+  // `options_.task_expiry_func`, and returns them with the rejection status.
+  // If no task of `batch` is left, the remaining padding tasks are moved into
+  // it.
+  std::vector<std::pair<std::unique_ptr<TaskType>, absl::Status>>
+  RemoveExpiredTasks(std::unique_ptr<Batch<TaskType>>* batch,
+                     std::vector<std::unique_ptr<TaskType>>* padding_tasks);
+
   // Returns true iff the task is a low priority task based on the queue option.
   bool IsLowPriorityTask(std::unique_ptr<TaskType>* task);
 
@@ -473,9 +570,12 @@ class Queue {
   // fresh open batch behind it.
   void StartNewBatch() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
-  // Split `input task` into `output_tasks` according to 'task_sizes'.
+  // Split `input task` into `output_tasks`: a first one filling the
+  // `open_batch_remaining_slot` of the open batch, then tasks of at most
+  // `batch_size_limit`.
   absl::Status SplitInputBatchIntoSubtasks(
-      std::unique_ptr<TaskType>* input_task,
+      std::unique_ptr<TaskType>* input_task, int open_batch_remaining_slot,
+      int batch_size_limit,
       std::vector<std::unique_ptr<TaskType>>* output_tasks)
       TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
@@ -640,12 +740,19 @@ absl::Status SharedBatchScheduler<TaskType>::Create(
   }
 
   if (options.use_global_scheduler) {
-    static std::shared_ptr<SharedBatchScheduler<TaskType>>* global_scheduler =
-        [&]() {
-          return new std::shared_ptr<SharedBatchScheduler<TaskType>>(
-              new SharedBatchScheduler<TaskType>(options));
-        }();
-    *scheduler = *global_scheduler;
+    // Keyed by the way queues are picked, so that a caller asking for ranked
+    // or fair-shared queues never gets a scheduler that was created without.
+    static mutex* global_schedulers_mu = new mutex();
+    static auto* global_schedulers = new absl::flat_hash_map<
+        std::pair<bool, bool>,
+        std::shared_ptr<SharedBatchScheduler<TaskType>>>();
+    mutex_lock l(*global_schedulers_mu);
+    std::shared_ptr<SharedBatchScheduler<TaskType>>& global_scheduler =
+        (*global_schedulers)[{options.rank_queues, options.fair_share_queues}];
+    if (global_scheduler == nullptr) {
+      global_scheduler.reset(new SharedBatchScheduler<TaskType>(options));
+    }
+    *scheduler = global_scheduler;
     return absl::OkStatus();
   }
 
@@ -729,6 +836,21 @@ absl::Status SharedBatchScheduler<TaskType>::AddQueueAfterRewritingOptions(
         options.max_execution_batch_size);
   }
 
+  if (!(options.fair_share_weight > 0)) {
+    return errors::InvalidArgument("fair_share_weight must be positive; was ",
+                                   options.fair_share_weight);
+  }
+  if (options.max_starvation_micros < 0) {
+    return errors::InvalidArgument(
+        "max_starvation_micros must be non-negative; was ",
+        options.max_starvation_micros);
+  }
+  if ((options.task_expiry_func == nullptr) !=
+      (options.drop_task_func == nullptr)) {
+    return errors::InvalidArgument(
+        "drop_task_func must be specified iff task_expiry_func is");
+  }
+
   auto schedulable_batch_callback = [this] {
     mutex_lock l(mu_);
     schedulable_batch_cv_.notify_one();
@@ -772,6 +894,43 @@ bool SharedBatchScheduler<TaskType>::BatchExists(
   return batch_to_process != nullptr;
 }
 
+template <typename TaskType>
+std::tuple<bool, int64_t, double, std::pair<int, int64_t>>
+SharedBatchScheduler<TaskType>::FairShareKey(
+    const internal::Queue<TaskType>& queue,
+    const std::pair<int, int64_t>& batch_key, uint64 now_micros) const {
+  const QueueOptions& queue_options = queue.options();
+  const int64_t wait_micros =
+      static_cast<int64_t>(now_micros) - batch_key.second;
+  if (queue_options.max_starvation_micros > 0 &&
+      wait_micros >= queue_options.max_starvation_micros) {
+    // Starving queues are served first, oldest first.
+    return {false, batch_key.second, 0.0, batch_key};
+  }
+  double virtual_start_time = 0;
+  if (auto it = class_virtual_times_.find(queue_options.priority_class);
+      it != class_virtual_times_.end()) {
+    virtual_start_time = it->second;
+  }
+  if (auto it = queue_virtual_times_.find(&queue);
+      it != queue_virtual_times_.end()) {
+    virtual_start_time = std::max(virtual_start_time, it->second);
+  }
+  return {true, queue_options.priority_class, virtual_start_time, batch_key};
+}
+
+template <typename TaskType>
+void SharedBatchScheduler<TaskType>::ChargeFairShare(
+    const internal::Queue<TaskType>& queue, const Batch<TaskType>& batch) {
+  const QueueOptions& queue_options = queue.options();
+  double& class_virtual_time =
+      class_virtual_times_[queue_options.priority_class];
+  double& queue_virtual_time = queue_virtual_times_[&queue];
+  class_virtual_time = std::max(class_virtual_time, queue_virtual_time);
+  queue_virtual_time =
+      class_virtual_time + batch.size() / queue_options.fair_share_weight;
+}
+
 template <typename TaskType>
 void SharedBatchScheduler<TaskType>::GetNextWorkItem_Locked(
     internal::Queue<TaskType>** queue_for_batch_out,
@@ -780,6 +939,10 @@ void SharedBatchScheduler<TaskType>::GetNextWorkItem_Locked(
   internal::Queue<TaskType>* queue_for_batch = nullptr;
   std::optional<typename internal::Queue<TaskType>::BatchPriorityKey>
       batch_priority_key;
+  std::optional<std::tuple<bool, int64_t, double, std::pair<int, int64_t>>>
+      fair_share_key;
+  const uint64 now_micros =
+      options_.fair_share_queues ? options_.env->NowMicros() : 0;
   const int num_queues = queues_.size();
   for (int num_queues_tried = 0;
        !BatchExists(batch_to_process) && num_queues_tried < num_queues;
@@ -794,7 +957,18 @@ void SharedBatchScheduler<TaskType>::GetNextWorkItem_Locked(
 
     bool queue_has_work = false;
 
-    if (options_.rank_queues) {
+    if (options_.fair_share_queues) {
+      auto key = (*next_queue_to_schedule_)->PeekBatchPriority();
+      queue_has_work = key.has_value();
+      if (key.has_value()) {
+        auto queue_key =
+            FairShareKey(**next_queue_to_schedule_, key.value(), now_micros);
+        if (!fair_share_key.has_value() || queue_key < *fair_share_key) {
+          fair_share_key = queue_key;
+          queue_for_batch = next_queue_to_schedule_->get();
+        }
+      }
+    } else if (options_.rank_queues) {
       auto key = (*next_queue_to_schedule_)->PeekBatchPriority();
       queue_has_work = key.has_value();
       if (key.has_value() && (!batch_priority_key.has_value() ||
@@ -817,6 +991,7 @@ void SharedBatchScheduler<TaskType>::GetNextWorkItem_Locked(
         !queue_has_work) {
       // We've encountered a closed queue with no work to do. Drop it.
       DCHECK_NE(queue_for_batch, next_queue_to_schedule_->get());
+      queue_virtual_times_.erase(next_queue_to_schedule_->get());
       next_queue_to_schedule_ = queues_.erase(next_queue_to_schedule_);
     } else {
       ++next_queue_to_schedule_;
@@ -827,7 +1002,18 @@ void SharedBatchScheduler<TaskType>::GetNextWorkItem_Locked(
     }
   }
 
-  if (options_.rank_queues && batch_priority_key.has_value()) {
+  if (options_.fair_share_queues && fair_share_key.has_value()) {
+    batch_to_process = queue_for_batch->ScheduleBatch();
+    if (BatchExists(batch_to_process)) {
+      ChargeFairShare(*queue_for_batch, *batch_to_process);
+      ModelBatchStats* model_batch_stats =
+          queue_for_batch->options().model_batch_stats;
+      const bool starving = !std::get<0>(*fair_share_key);
+      if (starving && model_batch_stats != nullptr) {
+        model_batch_stats->RegisterStarvedBatch();
+      }
+    }
+  } else if (options_.rank_queues && batch_priority_key.has_value()) {
     batch_to_process = queue_for_batch->ScheduleBatch();
   }
 
@@ -879,6 +1065,11 @@ Queue<TaskType>::Queue(
   traceme_context_id_counter_ = (absl::GetCurrentTimeNanos() & 0xFFFFFFFF)
                                 << 32;
   GetBatches().emplace_back(new Batch<TaskType>);
+  if (options_.model_batch_stats != nullptr) {
+    options_.model_batch_stats->SetSchedulingPriorityClass(
+        options_.priority_class);
+    options_.model_batch_stats->SetFairShareWeight(options_.fair_share_weight);
+  }
 }
 
 template <typename TaskType>
@@ -918,8 +1109,11 @@ absl::Status Queue<TaskType>::ScheduleWithoutOrEagerSplitImpl(
 
   std::deque<std::unique_ptr<Batch<TaskType>>>& batches = GetBatches();
 
-  const int64_t open_batch_remaining_slot =
-      max_execution_batch_size() - batches.back()->size();
+  // Read once, so that a concurrent controller update does not change the
+  // limit while the task is split and added.
+  const int64_t batch_size_limit = effective_max_execution_batch_size();
+  const int64_t open_batch_remaining_slot = std::max<int64_t>(
+      0, batch_size_limit - static_cast<int64_t>(batches.back()->size()));
 
   const int64_t input_task_size = (*task)->size();
 
@@ -930,12 +1124,13 @@ absl::Status Queue<TaskType>::ScheduleWithoutOrEagerSplitImpl(
     // This is the fast path when input doesn't need to be split.
     output_tasks.push_back(std::move(*task));
   } else {
-    TF_RETURN_IF_ERROR(SplitInputBatchIntoSubtasks(task, &output_tasks));
+    TF_RETURN_IF_ERROR(SplitInputBatchIntoSubtasks(
+        task, open_batch_remaining_slot, batch_size_limit, &output_tasks));
   }
 
   for (int i = 0; i < output_tasks.size(); ++i) {
-    if (batches.back()->size() + output_tasks[i]->size() >
-        max_execution_batch_size()) {
+    if (!batches.back()->empty() &&
+        batches.back()->size() + output_tasks[i]->size() > batch_size_limit) {
       StartNewBatch();
     }
     if (batches.back()->empty()) {
@@ -970,9 +1165,10 @@ void Queue<TaskType>::PadOpenBatchWithLowPriorityTasks() {
   // the open batch.
   bool out_of_space = false;
 
+  const int64_t batch_size_limit = effective_max_execution_batch_size();
   while (!low_priority_tasks_.empty() && !out_of_space) {
     const int64_t open_batch_remaining_slot =
-        max_execution_batch_size() - batches.back()->size();
+        batch_size_limit - static_cast<int64_t>(batches.back()->size());
     if (open_batch_remaining_slot <= 0) {
       // Terminate early if the open batch is full. Remaining low priority tasks
       // will be re-checked during the next batch formation opportunity.
@@ -991,7 +1187,8 @@ void Queue<TaskType>::PadOpenBatchWithLowPriorityTasks() {
       // This is the fast path when input doesn't need to be split.
       output_tasks.push_back(std::move(task));
     } else {
-      absl::Status status = SplitInputBatchIntoSubtasks(&task, &output_tasks);
+      absl::Status status = SplitInputBatchIntoSubtasks(
+          &task, open_batch_remaining_slot, batch_size_limit, &output_tasks);
       if (!status.ok()) {
         LOG(ERROR) << "Failed to split low priority task: " << status;
         continue;
@@ -1000,7 +1197,7 @@ void Queue<TaskType>::PadOpenBatchWithLowPriorityTasks() {
 
     for (int i = 0; i < output_tasks.size(); ++i) {
       if (batches.back()->size() + output_tasks[i]->size() >
-          max_execution_batch_size()) {
+          batch_size_limit) {
         low_priority_tasks_.PrependTask(std::move(output_tasks[i]), task_time);
         out_of_space = true;
         // NOTE: Future iterations of this loop will also hit this case but are
@@ -1038,6 +1235,11 @@ absl::Status Queue<TaskType>::Schedule(std::unique_ptr<TaskType>* task) {
         {{"batching_input_task_size", (*task)->size()}});
   });
 
+  if (options_.batch_timeout_controller != nullptr) {
+    options_.batch_timeout_controller->RecordArrival((*task)->size(),
+                                                     env_->NowMicros());
+  }
+
   bool notify_of_schedulable_batch = false;
   {
     mutex_lock l(mu_);
@@ -1091,9 +1293,11 @@ size_t Queue<TaskType>::SchedulingCapacityInternal() const {
   const int64 num_new_batches_schedulable =
       static_cast<int64_t>(options_.max_enqueued_batches) -
       this->num_enqueued_batches();
-  const int64 execution_batch_size_limit = max_execution_batch_size();
-  const int64 open_batch_capacity =
-      execution_batch_size_limit - this->tail_batch_task_size();
+  const int64 execution_batch_size_limit =
+      effective_max_execution_batch_size();
+  const int64 open_batch_capacity = std::max<int64>(
+      0, execution_batch_size_limit -
+             static_cast<int64>(this->tail_batch_task_size()));
   // Note the returned value is guaranteed to be not negative, since
   // enqueue operation could only happen if queue has enough capacity.
   return (num_new_batches_schedulable * execution_batch_size_limit) +
@@ -1302,26 +1506,95 @@ Queue<TaskType>::GetLowPriorityTasksForPadding(size_t batch_size) {
   return GetLowPriorityTasks(target_batch_size - batch_size);
 }
 
+template <typename TaskType>
+std::vector<std::pair<std::unique_ptr<TaskType>, absl::Status>>
+Queue<TaskType>::RemoveExpiredTasks(
+    std::unique_ptr<Batch<TaskType>>* batch,
+    std::vector<std::unique_ptr<TaskType>>* padding_tasks) {
+  const uint64 now_micros = env_->NowMicros();
+  std::vector<std::pair<std::unique_ptr<TaskType>, absl::Status>>
+      expired_tasks;
+
+  std::vector<std::unique_ptr<TaskType>> live_padding_tasks;
+  for (std::unique_ptr<TaskType>& task : *padding_tasks) {
+    absl::Status status = options_.task_expiry_func(*task, now_micros);
+    if (status.ok()) {
+      live_padding_tasks.push_back(std::move(task));
+    } else {
+      expired_tasks.emplace_back(std::move(task), std::move(status));
+    }
+  }
+  *padding_tasks = std::move(live_padding_tasks);
+
+  std::vector<absl::Status> statuses;
+  statuses.reserve((*batch)->num_tasks());
+  bool has_expired_tasks = false;
+  for (int i = 0; i < (*batch)->num_tasks(); ++i) {
+    statuses.push_back(
+        options_.task_expiry_func((*batch)->task(i), now_micros));
+    has_expired_tasks = has_expired_tasks || !statuses.back().ok();
+  }
+  if (!has_expired_tasks) {
+    return expired_tasks;
+  }
+
+  // The batch is closed, so the live tasks are moved into a new batch.
+  const uint64 start_time_micros =
+      (*batch)->EarliestTaskStartTime().value_or(now_micros);
+  auto live_batch =
+      std::make_unique<Batch<TaskType>>((*batch)->traceme_context_id());
+  std::vector<std::unique_ptr<TaskType>> tasks = (*batch)->RemoveAllTasks();
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    if (statuses[i].ok()) {
+      live_batch->AddTask(std::move(tasks[i]), start_time_micros);
+    } else {
+      expired_tasks.emplace_back(std::move(tasks[i]), std::move(statuses[i]));
+    }
+  }
+  if (live_batch->empty()) {
+    for (std::unique_ptr<TaskType>& task : *padding_tasks) {
+      live_batch->AddTask(std::move(task), start_time_micros);
+    }
+    padding_tasks->clear();
+  }
+  live_batch->Close();
+  *batch = std::move(live_batch);
+  return expired_tasks;
+}
+
 template <typename TaskType>
 void Queue<TaskType>::ProcessBatch(
     std::unique_ptr<Batch<TaskType>> batch,
     std::vector<std::unique_ptr<TaskType>> padding_task) {
-  tsl::profiler::TraceMeConsumer trace_me(
-      [&] {
-        return profiler::TraceMeEncode(
-            "ProcessBatch", {{"batch_size_before_padding", batch->size()},
-                             {"_r", 2} /*root_event*/});
-      },
-      tsl::profiler::ContextType::kSharedBatchScheduler,
-      batch->traceme_context_id());
-
-  if (std::holds_alternative<ProcessBatchCallbackWithoutPaddingTasks>(
-          process_batch_callback_)) {
-    std::get<ProcessBatchCallbackWithoutPaddingTasks>(process_batch_callback_)(
-        std::move(batch));
-  } else {
-    std::get<ProcessBatchCallbackWithPaddingTasks>(process_batch_callback_)(
-        std::move(batch), std::move(padding_task));
+  if (options_.task_expiry_func != nullptr) {
+    std::vector<std::pair<std::unique_ptr<TaskType>, absl::Status>>
+        expired_tasks = RemoveExpiredTasks(&batch, &padding_task);
+    if (!expired_tasks.empty() && options_.model_batch_stats != nullptr) {
+      options_.model_batch_stats->RegisterDroppedTasks(expired_tasks.size());
+    }
+    for (auto& [task, status] : expired_tasks) {
+      options_.drop_task_func(std::move(task), std::move(status));
+    }
+  }
+
+  if (!batch->empty()) {
+    tsl::profiler::TraceMeConsumer trace_me(
+        [&] {
+          return profiler::TraceMeEncode(
+              "ProcessBatch", {{"batch_size_before_padding", batch->size()},
+                               {"_r", 2} /*root_event*/});
+        },
+        tsl::profiler::ContextType::kSharedBatchScheduler,
+        batch->traceme_context_id());
+
+    if (std::holds_alternative<ProcessBatchCallbackWithoutPaddingTasks>(
+            process_batch_callback_)) {
+      std::get<ProcessBatchCallbackWithoutPaddingTasks>(
+          process_batch_callback_)(std::move(batch));
+    } else {
+      std::get<ProcessBatchCallbackWithPaddingTasks>(process_batch_callback_)(
+          std::move(batch), std::move(padding_task));
+    }
   }
 
   {
@@ -1371,13 +1644,12 @@ void Queue<TaskType>::StartNewBatch() {
 
 template <typename TaskType>
 absl::Status Queue<TaskType>::SplitInputBatchIntoSubtasks(
-    std::unique_ptr<TaskType>* input_task,
+    std::unique_ptr<TaskType>* input_task, int open_batch_remaining_slot,
+    int batch_size_limit,
     std::vector<std::unique_ptr<TaskType>>* output_tasks) {
-  const int open_batch_remaining_slot =
-      max_execution_batch_size() - this->tail_batch_task_size();
   return options_.split_input_task_func(
-      std::move(input_task), open_batch_remaining_slot,
-      max_execution_batch_size(), std::move(output_tasks));
+      std::move(input_task), open_batch_remaining_slot, batch_size_limit,
+      std::move(output_tasks));
 }
 
 template <typename TaskType>
@@ -1413,6 +1685,11 @@ Queue<TaskType>::PeekBatchPriorityImpl() const {
   size_t effective_batch_size = open_batch->size();
   uint64 effective_start_time_micros = open_batch_start_time_micros_;
   int64_t effective_batch_timeout_micros = options_.batch_timeout_micros;
+  const size_t effective_max_batch_size = effective_max_execution_batch_size();
+  if (options_.batch_timeout_controller != nullptr) {
+    effective_batch_timeout_micros =
+        options_.batch_timeout_controller->batch_timeout_micros();
+  }
   if (effective_batch_size == 0) {
     // open_batch_start_time_micros_ is not valid for an empty batch.
     effective_start_time_micros = env_->NowMicros();
@@ -1441,7 +1718,7 @@ Queue<TaskType>::PeekBatchPriorityImpl() const {
   }
 
   bool schedulable = closed_ ||
-                     effective_batch_size >= max_execution_batch_size() ||
+                     effective_batch_size >= effective_max_batch_size ||
                      env_->NowMicros() >= effective_start_time_micros +
                                               effective_batch_timeout_micros;
 
@@ -32,6 +32,8 @@ limitations under the License.
 #include "xla/tsl/platform/criticality.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler.h"
 #include "tensorflow/core/kernels/batching_util/batch_scheduler_utils.h"
+#include "tensorflow/core/kernels/batching_util/batch_stats.h"
+#include "tensorflow/core/kernels/batching_util/batch_timeout_controller.h"
 #include "tensorflow/core/kernels/batching_util/fake_clock_env.h"
 #include "tensorflow/core/kernels/batching_util/input_split_metadata.h"
 #include "tensorflow/core/lib/core/notification.h"
@@ -156,6 +158,21 @@ std::shared_ptr<Scheduler> CreateSharedBatchScheduler(
   return shared_batch_scheduler;
 }
 
+// Creates a shared-batch-scheduler that serves queues by priority class and
+// fair share.
+std::shared_ptr<Scheduler> CreateFairShareScheduler(int num_batch_threads,
+                                                    Env* env) {
+  Scheduler::Options options;
+  options.num_batch_threads = num_batch_threads;
+  options.env = env;
+  options.fair_share_queues = true;
+
+  std::shared_ptr<Scheduler> shared_batch_scheduler;
+  TF_CHECK_OK(Scheduler::Create(options, &shared_batch_scheduler));
+
+  return shared_batch_scheduler;
+}
+
 // Creates a queue with the given `queue_options`.
 //
 // Caller takes ownership of returned queue.
@@ -737,6 +754,109 @@ TEST_P(SharedBatchSchedulerTest,
   stop_teardown.Notify();
 }
 
+TEST_P(SharedBatchSchedulerTest, BatchTimeoutControllerOverridesTimeout) {
+  // Set up a fake clock, and never advance the time.
+  test_util::FakeClockEnv env(Env::Default());
+  Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+
+  {
+    Notification batch_processed;
+    auto callback =
+        [&batch_processed](std::unique_ptr<Batch<FakeTask>> batch) {
+          ASSERT_TRUE(batch->IsClosed());
+          EXPECT_EQ(batch->size(), 1);
+          batch_processed.Notify();
+        };
+
+    auto scheduler = CreateSharedBatchScheduler(1, &env);
+
+    const size_t batch_size_limit = 100;
+    // The static timeout is never reached, since the clock does not advance.
+    const size_t batch_timeout_micros = 1000 * 1000 * 1000;
+    const size_t max_enqueued_batches = 2;
+    QueueOptions options =
+        CreateQueueOptions(batch_size_limit, batch_size_limit,
+                           batch_timeout_micros, max_enqueued_batches);
+
+    // With the costs below, a single request cannot expect company within
+    // its latency target, so the controller stops waiting for it.
+    BatchTimeoutController::Options controller_options;
+    controller_options.target_latency = absl::Milliseconds(10);
+    controller_options.max_batch_timeout_micros = batch_timeout_micros;
+    controller_options.max_batch_size = batch_size_limit;
+    std::unique_ptr<BatchTimeoutController> controller;
+    TF_ASSERT_OK(
+        BatchTimeoutController::Create(controller_options, &controller));
+    controller->RegisterBatchCost(1, absl::Milliseconds(1));
+    controller->RegisterBatchCost(100, absl::Milliseconds(5));
+    options.batch_timeout_controller = std::move(controller);
+
+    auto queue = CreateQueue(scheduler, options, callback);
+    TF_ASSERT_OK(ScheduleTask(1, queue.get()));
+    batch_processed.WaitForNotification();
+    EXPECT_EQ(options.batch_timeout_controller->batch_timeout_micros(), 0);
+
+    // Shut everything down.
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
+TEST_P(SharedBatchSchedulerTest, BatchTimeoutControllerCapsBatchSize) {
+  mutex mu;
+  std::vector<size_t> batch_sizes;
+  auto callback = [&mu, &batch_sizes](std::unique_ptr<Batch<FakeTask>> batch) {
+    ASSERT_TRUE(batch->IsClosed());
+    mutex_lock l(mu);
+    batch_sizes.push_back(batch->size());
+  };
+
+  const size_t batch_size_limit = 100;
+  // Only batches of 4 can meet the latency target with the costs below, so
+  // the controller caps batches at 4 regardless of the traffic.
+  BatchTimeoutController::Options controller_options;
+  controller_options.target_latency = absl::Milliseconds(10);
+  controller_options.max_batch_timeout_micros = 1000;
+  controller_options.max_batch_size = batch_size_limit;
+  controller_options.allowed_batch_sizes = {4, 100};
+  std::unique_ptr<BatchTimeoutController> controller;
+  TF_ASSERT_OK(BatchTimeoutController::Create(controller_options, &controller));
+  controller->RegisterBatchCost(4, absl::Milliseconds(1));
+  controller->RegisterBatchCost(100, absl::Milliseconds(50));
+
+  std::vector<size_t> task_sizes = {3, 3, 2, 1, 4, 3};
+  if (enable_input_batch_split()) {
+    // Larger tasks are split into tasks fitting in the capped batches.
+    task_sizes.push_back(10);
+    task_sizes.push_back(7);
+  }
+  {
+    auto scheduler = CreateSharedBatchScheduler(/*num_batch_threads=*/1);
+    QueueOptions options =
+        CreateQueueOptions(batch_size_limit, batch_size_limit,
+                           /*batch_timeout_micros=*/1000 * 1000 * 1000,
+                           /*max_enqueued_batches=*/100);
+    options.batch_timeout_controller = std::move(controller);
+    auto queue = CreateQueue(scheduler, options, callback);
+    for (size_t task_size : task_sizes) {
+      TF_ASSERT_OK(ScheduleTask(task_size, queue.get()));
+    }
+    EXPECT_EQ(options.batch_timeout_controller->max_batch_size(), 4);
+  }
+
+  mutex_lock l(mu);
+  size_t total_size = 0;
+  for (size_t batch_size : batch_sizes) {
+    EXPECT_LE(batch_size, 4);
+    total_size += batch_size;
+  }
+  size_t total_task_size = 0;
+  for (size_t task_size : task_sizes) total_task_size += task_size;
+  EXPECT_EQ(total_size, total_task_size);
+}
+
 TEST_P(SharedBatchSchedulerTest, Fairness) {
   test_util::FakeClockEnv env(Env::Default());
   Notification start_teardown, stop_teardown;
@@ -990,6 +1110,238 @@ TEST_P(SharedBatchSchedulerTest, QueueDestructorBlocksUntilAllTasksProcessed) {
   stop_teardown.Notify();
 }
 
+// Records the order in which batches of several queues are processed, with the
+// first batch blocking the only batch thread until `Unblock()`, so that the
+// queues can fill up.
+class BatchOrderRecorder {
+ public:
+  explicit BatchOrderRecorder(int num_batches) : num_batches_(num_batches) {}
+
+  internal::Queue<FakeTask>::ProcessBatchCallback Callback(char queue_id) {
+    return [this, queue_id](std::unique_ptr<Batch<FakeTask>> batch) {
+      if (!blocker_started_.HasBeenNotified()) {
+        blocker_started_.Notify();
+        blocker_proceed_.WaitForNotification();
+        return;
+      }
+      mutex_lock l(mu_);
+      order_.push_back(queue_id);
+      if (order_.size() == num_batches_) {
+        all_processed_.Notify();
+      }
+    };
+  }
+
+  void WaitUntilBlocked() { blocker_started_.WaitForNotification(); }
+
+  // Unblocks the batch thread, and returns the ids of the queues of the
+  // following `num_batches` batches, in order.
+  std::string Unblock() {
+    blocker_proceed_.Notify();
+    all_processed_.WaitForNotification();
+    mutex_lock l(mu_);
+    return order_;
+  }
+
+ private:
+  const size_t num_batches_;
+  Notification blocker_started_, blocker_proceed_, all_processed_;
+  mutex mu_;
+  std::string order_ TF_GUARDED_BY(mu_);
+};
+
+TEST_P(SharedBatchSchedulerTest, FairShareWeights) {
+  test_util::FakeClockEnv env(Env::Default());
+  Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+
+  {
+    BatchOrderRecorder recorder(/*num_batches=*/12);
+    auto scheduler = CreateFairShareScheduler(1, &env);
+    QueueOptions a_options = CreateQueueOptions(1, 1, 0, 100);
+    a_options.fair_share_weight = 2;
+    const QueueOptions b_options = CreateQueueOptions(1, 1, 0, 100);
+    auto queue_a = CreateQueue(scheduler, a_options, recorder.Callback('a'));
+    auto queue_b = CreateQueue(scheduler, b_options, recorder.Callback('b'));
+
+    TF_ASSERT_OK(ScheduleTask(1, queue_a.get()));
+    recorder.WaitUntilBlocked();
+    // The tasks of queue b are older, so queue b wins ties.
+    for (int i = 0; i < 6; ++i) {
+      TF_ASSERT_OK(ScheduleTask(1, queue_b.get()));
+    }
+    env.AdvanceByMicroseconds(1);
+    for (int i = 0; i < 6; ++i) {
+      TF_ASSERT_OK(ScheduleTask(1, queue_a.get()));
+    }
+
+    // Once queue a has caught up on the blocking batch, it gets two batches
+    // for each batch of queue b, until it runs out of tasks.
+    EXPECT_EQ(recorder.Unblock(), "babaabaababb");
+
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
+TEST_P(SharedBatchSchedulerTest, StrictPriorityClasses) {
+  test_util::FakeClockEnv env(Env::Default());
+  Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+
+  {
+    BatchOrderRecorder recorder(/*num_batches=*/4);
+    auto scheduler = CreateFairShareScheduler(1, &env);
+    const QueueOptions high_options = CreateQueueOptions(1, 1, 0, 100);
+    QueueOptions low_options = CreateQueueOptions(1, 1, 0, 100);
+    low_options.priority_class = 1;
+    low_options.max_starvation_micros = 1000;
+    auto high_queue =
+        CreateQueue(scheduler, high_options, recorder.Callback('h'));
+    auto low_queue =
+        CreateQueue(scheduler, low_options, recorder.Callback('l'));
+
+    TF_ASSERT_OK(ScheduleTask(1, high_queue.get()));
+    recorder.WaitUntilBlocked();
+    TF_ASSERT_OK(ScheduleTask(1, low_queue.get()));
+    for (int i = 0; i < 3; ++i) {
+      TF_ASSERT_OK(ScheduleTask(1, high_queue.get()));
+    }
+
+    EXPECT_EQ(recorder.Unblock(), "hhhl");
+
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
+TEST_P(SharedBatchSchedulerTest, StarvationBoundOverridesPriorityClasses) {
+  test_util::FakeClockEnv env(Env::Default());
+  Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+
+  {
+    ModelBatchStats low_stats;
+    BatchOrderRecorder recorder(/*num_batches=*/3);
+    auto scheduler = CreateFairShareScheduler(1, &env);
+    const QueueOptions high_options = CreateQueueOptions(1, 1, 0, 100);
+    QueueOptions low_options = CreateQueueOptions(1, 1, 0, 100);
+    low_options.priority_class = 1;
+    low_options.max_starvation_micros = 1000;
+    low_options.model_batch_stats = &low_stats;
+    auto high_queue =
+        CreateQueue(scheduler, high_options, recorder.Callback('h'));
+    auto low_queue =
+        CreateQueue(scheduler, low_options, recorder.Callback('l'));
+    EXPECT_EQ(low_stats.scheduling_priority_class(), 1);
+
+    TF_ASSERT_OK(ScheduleTask(1, high_queue.get()));
+    recorder.WaitUntilBlocked();
+    TF_ASSERT_OK(ScheduleTask(1, low_queue.get()));
+    env.AdvanceByMicroseconds(1000);
+    for (int i = 0; i < 2; ++i) {
+      TF_ASSERT_OK(ScheduleTask(1, high_queue.get()));
+    }
+
+    // The low priority batch has waited for the starvation bound.
+    EXPECT_EQ(recorder.Unblock(), "lhh");
+    EXPECT_EQ(low_stats.cumulative_starved_batches(), 1);
+
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
+TEST_P(SharedBatchSchedulerTest, DropsExpiredTasks) {
+  test_util::FakeClockEnv env(Env::Default());
+  Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+
+  {
+    ModelBatchStats stats;
+    mutex mu;
+    int num_batches_processed = 0;
+    std::vector<absl::Status> drop_statuses;
+    Notification first_batch_processed, second_batch_dropped;
+    auto callback = [&](std::unique_ptr<Batch<FakeTask>> batch) {
+      ASSERT_TRUE(batch->IsClosed());
+      EXPECT_EQ(batch->num_tasks(), 2);
+      EXPECT_EQ(batch->size(), 3);
+      mutex_lock l(mu);
+      ++num_batches_processed;
+      first_batch_processed.Notify();
+    };
+
+    auto scheduler = CreateSharedBatchScheduler(1, &env);
+    QueueOptions options = CreateQueueOptions(10, 10, 1000, 10);
+    options.model_batch_stats = &stats;
+    // Tasks of size 3 stand for tasks whose deadline has passed.
+    options.task_expiry_func = [](const FakeTask& task,
+                                  uint64 now_micros) -> absl::Status {
+      if (task.size() == 3) {
+        return absl::DeadlineExceededError("Deadline passed");
+      }
+      return absl::OkStatus();
+    };
+    options.drop_task_func = [&](std::unique_ptr<FakeTask> task,
+                                 absl::Status status) {
+      mutex_lock l(mu);
+      drop_statuses.push_back(status);
+      if (drop_statuses.size() == 2) {
+        second_batch_dropped.Notify();
+      }
+    };
+    auto queue = CreateQueue(scheduler, options, callback);
+
+    TF_ASSERT_OK(ScheduleTask(1, queue.get()));
+    TF_ASSERT_OK(ScheduleTask(3, queue.get()));
+    TF_ASSERT_OK(ScheduleTask(2, queue.get()));
+    env.AdvanceByMicroseconds(1000);
+    first_batch_processed.WaitForNotification();
+
+    // A batch left without tasks is not processed.
+    TF_ASSERT_OK(ScheduleTask(3, queue.get()));
+    env.AdvanceByMicroseconds(1000);
+    second_batch_dropped.WaitForNotification();
+
+    {
+      mutex_lock l(mu);
+      EXPECT_EQ(num_batches_processed, 1);
+      for (const absl::Status& status : drop_statuses) {
+        EXPECT_EQ(status.code(), absl::StatusCode::kDeadlineExceeded);
+      }
+    }
+    EXPECT_EQ(stats.cumulative_dropped_tasks(), 2);
+
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
+TEST_P(SharedBatchSchedulerTest, InvalidFairShareOptions) {
+  auto callback = [](std::unique_ptr<Batch<FakeTask>> batch) {};
+  auto scheduler = CreateFairShareScheduler(1, Env::Default());
+  std::unique_ptr<Queue> queue;
+
+  QueueOptions options = CreateQueueOptions(10, 10, 0, 10);
+  options.fair_share_weight = 0;
+  EXPECT_THAT(scheduler->AddQueue(options, callback, &queue),
+              testing::StatusIs(error::INVALID_ARGUMENT,
+                                HasSubstr("fair_share_weight")));
+
+  options = CreateQueueOptions(10, 10, 0, 10);
+  options.task_expiry_func = [](const FakeTask& task, uint64 now_micros) {
+    return absl::OkStatus();
+  };
+  EXPECT_THAT(scheduler->AddQueue(options, callback, &queue),
+              testing::StatusIs(error::INVALID_ARGUMENT,
+                                HasSubstr("drop_task_func")));
+}
+
 // Tests that queue configured with zero `max_enqueued_batches` get one queue.
 // Note, technically an invalid-argument error should be returned.
 // Since existing models (with very low QPS) rely on the rewrite, retain the
@@ -2359,6 +2711,35 @@ TEST_P(SharedBatchSchedulerPriorityPolicyTest,
   EXPECT_NE(scheduler_ptr, scheduler4.get());
 }
 
+TEST(SharedBatchSchedulerGlobalTest, GlobalSchedulersAreKeyedByQueuePolicy) {
+  auto create_global_scheduler = [](bool rank_queues, bool fair_share_queues) {
+    Scheduler::Options options;
+    options.num_batch_threads = 1;
+    options.rank_queues = rank_queues;
+    options.fair_share_queues = fair_share_queues;
+    options.use_global_scheduler = true;
+    std::shared_ptr<Scheduler> scheduler;
+    TF_CHECK_OK(Scheduler::Create(options, &scheduler));
+    return scheduler;
+  };
+
+  std::shared_ptr<Scheduler> ranked = create_global_scheduler(
+      /*rank_queues=*/true, /*fair_share_queues=*/false);
+  std::shared_ptr<Scheduler> fair_shared = create_global_scheduler(
+      /*rank_queues=*/false, /*fair_share_queues=*/true);
+  // A fair-sharing caller does not get the scheduler created for ranked
+  // queues, nor the other way around.
+  EXPECT_NE(ranked.get(), fair_shared.get());
+  EXPECT_EQ(create_global_scheduler(/*rank_queues=*/true,
+                                    /*fair_share_queues=*/false)
+                .get(),
+            ranked.get());
+  EXPECT_EQ(create_global_scheduler(/*rank_queues=*/false,
+                                    /*fair_share_queues=*/true)
+                .get(),
+            fair_shared.get());
+}
+
 // Lazy split is to be removed. The mixed priority batching is only supported
 // when the lazy split is not enabled.
 INSTANTIATE_TEST_SUITE_P(Parameter, SharedBatchSchedulerPriorityPolicyTest,
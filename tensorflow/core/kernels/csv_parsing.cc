@@ -0,0 +1,215 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/csv_parsing.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "absl/numeric/bits.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace tensorflow {
+namespace csv {
+
+uint64_t CsvScanner::StructuralMask(const char* block) const {
+#if defined(__AVX2__)
+  const __m256i delim = _mm256_set1_epi8(delim_);
+  const __m256i quote = _mm256_set1_epi8(quote_);
+  const __m256i lf = _mm256_set1_epi8('\n');
+  const __m256i cr = _mm256_set1_epi8('\r');
+  auto classify = [&](const char* p) -> uint32_t {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const __m256i m = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, delim),
+                        _mm256_cmpeq_epi8(v, quote)),
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, lf), _mm256_cmpeq_epi8(v, cr)));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(m));
+  };
+  return static_cast<uint64_t>(classify(block)) |
+         (static_cast<uint64_t>(classify(block + 32)) << 32);
+#elif defined(__SSE2__)
+  const __m128i delim = _mm_set1_epi8(delim_);
+  const __m128i quote = _mm_set1_epi8(quote_);
+  const __m128i lf = _mm_set1_epi8('\n');
+  const __m128i cr = _mm_set1_epi8('\r');
+  uint64_t mask = 0;
+  for (int i = 0; i < 4; ++i) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+    const __m128i m = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, delim), _mm_cmpeq_epi8(v, quote)),
+        _mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr)));
+    mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(m)))
+            << (16 * i);
+  }
+  return mask;
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+  const uint8x16_t delim = vdupq_n_u8(static_cast<uint8_t>(delim_));
+  const uint8x16_t quote = vdupq_n_u8(static_cast<uint8_t>(quote_));
+  const uint8x16_t lf = vdupq_n_u8('\n');
+  const uint8x16_t cr = vdupq_n_u8('\r');
+  // Each lane keeps only its own bit, so that pairwise additions pack the
+  // comparison results of 64 bytes into a single 64-bit mask.
+  const uint8x16_t bits = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+                           0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80};
+  uint8x16_t m[4];
+  for (int i = 0; i < 4; ++i) {
+    const uint8x16_t v =
+        vld1q_u8(reinterpret_cast<const uint8_t*>(block + 16 * i));
+    m[i] = vandq_u8(vorrq_u8(vorrq_u8(vceqq_u8(v, delim), vceqq_u8(v, quote)),
+                             vorrq_u8(vceqq_u8(v, lf), vceqq_u8(v, cr))),
+                    bits);
+  }
+  uint8x16_t sum = vpaddq_u8(vpaddq_u8(m[0], m[1]), vpaddq_u8(m[2], m[3]));
+  sum = vpaddq_u8(sum, sum);
+  return vgetq_lane_u64(vreinterpretq_u64_u8(sum), 0);
+#else
+  uint64_t mask = 0;
+  for (int i = 0; i < 64; ++i) {
+    const char c = block[i];
+    if (c == delim_ || c == quote_ || c == '\n' || c == '\r') {
+      mask |= uint64_t{1} << i;
+    }
+  }
+  return mask;
+#endif
+}
+
+size_t CsvScanner::FindStructural(absl::string_view data, size_t pos) const {
+  const char* const base = data.data();
+  const size_t size = data.size();
+  while (pos + 64 <= size) {
+    const uint64_t mask = StructuralMask(base + pos);
+    if (mask != 0) return pos + absl::countr_zero(mask);
+    pos += 64;
+  }
+  for (; pos < size; ++pos) {
+    const char c = base[pos];
+    if (c == delim_ || c == quote_ || c == '\n' || c == '\r') return pos;
+  }
+  return size;
+}
+
+size_t CsvScanner::FindQuote(absl::string_view data, size_t pos) {
+  if (pos >= data.size()) return data.size();
+  const void* found = memchr(data.data() + pos, '"', data.size() - pos);
+  if (found == nullptr) return data.size();
+  return static_cast<const char*>(found) - data.data();
+}
+
+void UnescapeCsvField(const CsvField& field, std::string* out) {
+  if (!field.escaped) {
+    out->assign(field.text.data(), field.text.size());
+    return;
+  }
+  out->clear();
+  out->reserve(field.text.size());
+  const absl::string_view text = field.text;
+  size_t from = 0;
+  size_t quote = CsvScanner::FindQuote(text, from);
+  while (quote < text.size()) {
+    // Keep the first quote of each escaped pair and skip the second.
+    out->append(text.data() + from, quote + 1 - from);
+    from = quote + 2;
+    quote = CsvScanner::FindQuote(text, from);
+  }
+  if (from < text.size()) out->append(text.data() + from, text.size() - from);
+}
+
+absl::Status SplitCsvRecord(const CsvScanner& scanner, absl::string_view record,
+                            absl::Span<const int64_t> select_cols,
+                            std::vector<CsvField>* fields) {
+  fields->clear();
+  if (record.empty()) return absl::OkStatus();
+
+  const bool select_all = select_cols.empty();
+  const size_t size = record.size();
+  const char delim = scanner.delim();
+  size_t idx = 0;
+  int64_t num_fields_parsed = 0;
+  size_t selector_idx = 0;  // Keep track of index into select_cols
+
+  while (idx < size) {
+    if (record[idx] == '\n' || record[idx] == '\r') {
+      idx++;
+      continue;
+    }
+
+    const bool include =
+        select_all || select_cols[selector_idx] == num_fields_parsed;
+    CsvField field;
+
+    if (scanner.use_quote_delim() && record[idx] == '"') {
+      // A quoted field ends with a quote followed by the delimiter or by the
+      // end of the record. Any other quote inside it must be doubled.
+      const size_t start = ++idx;
+      while (true) {
+        const size_t quote = CsvScanner::FindQuote(record, idx);
+        if (quote >= size) {
+          return absl::InvalidArgumentError(
+              "Quoted field has to end with quote followed by delim or end");
+        }
+        if (quote == size - 1 || record[quote + 1] == delim) {
+          idx = quote;
+          break;
+        }
+        if (record[quote + 1] != '"') {
+          return absl::InvalidArgumentError(
+              "Quote inside a string has to be escaped by another quote");
+        }
+        field.escaped = true;
+        idx = quote + 2;
+      }
+      field.text = record.substr(start, idx - start);
+      idx += 2;
+    } else {
+      const size_t start = idx;
+      idx = scanner.FindStructural(record, idx);
+      if (idx < size && record[idx] != delim) {
+        return absl::InvalidArgumentError(
+            "Unquoted fields cannot have quotes/CRLFs inside");
+      }
+      field.text = record.substr(start, idx - start);
+      // Go to next field or the end
+      idx++;
+    }
+
+    num_fields_parsed++;
+    if (include) {
+      fields->push_back(field);
+      selector_idx++;
+      if (selector_idx == select_cols.size()) return absl::OkStatus();
+    }
+  }
+
+  const bool include =
+      select_all || select_cols[selector_idx] == num_fields_parsed;
+  // Check if the last field is missing
+  if (include && record[size - 1] == delim) fields->push_back(CsvField());
+  return absl::OkStatus();
+}
+
+}  // namespace csv
+}  // namespace tensorflow
@@ -0,0 +1,110 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_CSV_PARSING_H_
+#define TENSORFLOW_CORE_KERNELS_CSV_PARSING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+
+namespace tensorflow {
+namespace csv {
+
+// Parsing core shared by the `DecodeCSV` op and `CsvDataset`.
+//
+// `CsvScanner` finds the structural characters of a CSV record (the field
+// delimiter, line breaks and, when quoting is enabled, quotes). Input is
+// classified 64 bytes at a time into a bitmask, using SSE2/AVX2 on x86 and
+// NEON on AArch64, so runs of ordinary characters are skipped without
+// inspecting them one by one.
+class CsvScanner {
+ public:
+  CsvScanner(char delim, bool use_quote_delim)
+      : delim_(delim),
+        use_quote_delim_(use_quote_delim),
+        quote_(use_quote_delim ? '"' : delim) {}
+
+  char delim() const { return delim_; }
+  bool use_quote_delim() const { return use_quote_delim_; }
+
+  // Returns the offset of the first character of `data` at or after `pos`
+  // that is the field delimiter, '\n', '\r' or, if quoting is enabled, '"'.
+  // Returns `data.size()` if there is no such character.
+  size_t FindStructural(absl::string_view data, size_t pos) const;
+
+  // Returns the offset of the first '"' in `data` at or after `pos`, or
+  // `data.size()` if there is none.
+  static size_t FindQuote(absl::string_view data, size_t pos);
+
+ private:
+  // Returns a mask whose bit `i` is set iff `block[i]` is a structural
+  // character. `block` must point to at least 64 readable bytes.
+  uint64_t StructuralMask(const char* block) const;
+
+  const char delim_;
+  const bool use_quote_delim_;
+  // The quote character, or `delim_` when quoting is disabled, so that the
+  // block classifier can compare against it unconditionally.
+  const char quote_;
+};
+
+// A field of a CSV record, referring into the record it was split from.
+struct CsvField {
+  // The contents of the field, without framing quotes.
+  absl::string_view text;
+  // True if `text` contains escaped quotes (`""`) that must be collapsed with
+  // `UnescapeCsvField` before use.
+  bool escaped = false;
+};
+
+// Stores the contents of `field`, with escaped quotes collapsed, in `*out`.
+void UnescapeCsvField(const CsvField& field, std::string* out);
+
+// Splits `record` into fields, following the `DecodeCSV` format: fields are
+// separated by the scanner's delimiter, may be framed by quotes when quoting
+// is enabled, and line breaks at the start of a field are ignored.
+//
+// If `select_cols` is non-empty, only the fields at those (strictly
+// increasing) column indices are returned and parsing stops after the last
+// one. `fields` is cleared first; the returned fields refer into `record`.
+absl::Status SplitCsvRecord(const CsvScanner& scanner, absl::string_view record,
+                            absl::Span<const int64_t> select_cols,
+                            std::vector<CsvField>* fields);
+
+// Converts the text of a numeric field, without an intermediate string.
+inline bool ParseCsvNumber(absl::string_view text, int32_t* value) {
+  return absl::SimpleAtoi(text, value);
+}
+inline bool ParseCsvNumber(absl::string_view text, int64_t* value) {
+  return absl::SimpleAtoi(text, value);
+}
+inline bool ParseCsvNumber(absl::string_view text, float* value) {
+  return absl::SimpleAtof(text, value);
+}
+inline bool ParseCsvNumber(absl::string_view text, double* value) {
+  return absl::SimpleAtod(text, value);
+}
+
+}  // namespace csv
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_CSV_PARSING_H_
@@ -0,0 +1,128 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/csv_parsing.h"
+
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace csv {
+namespace {
+
+std::vector<std::string> Split(const CsvScanner& scanner,
+                               absl::string_view record,
+                               std::vector<int64_t> select_cols = {}) {
+  std::vector<CsvField> fields;
+  absl::Status status = SplitCsvRecord(scanner, record, select_cols, &fields);
+  EXPECT_TRUE(status.ok()) << status;
+  std::vector<std::string> result;
+  for (const CsvField& field : fields) {
+    std::string text;
+    UnescapeCsvField(field, &text);
+    result.push_back(text);
+  }
+  return result;
+}
+
+TEST(CsvScannerTest, FindStructuralAcrossBlocks) {
+  const CsvScanner scanner(',', /*use_quote_delim=*/true);
+  for (int pos : {0, 1, 15, 16, 31, 32, 63, 64, 65, 127, 130}) {
+    std::string data(200, 'a');
+    data[pos] = ',';
+    EXPECT_EQ(scanner.FindStructural(data, 0), pos);
+    EXPECT_EQ(scanner.FindStructural(data, pos), pos);
+    EXPECT_EQ(scanner.FindStructural(data, pos + 1), data.size());
+  }
+  for (char c : {'\n', '\r', '"'}) {
+    std::string data(100, 'a');
+    data[70] = c;
+    EXPECT_EQ(scanner.FindStructural(data, 3), 70);
+  }
+}
+
+TEST(CsvScannerTest, QuotesAreOrdinaryWithoutQuoteDelim) {
+  const CsvScanner scanner('\t', /*use_quote_delim=*/false);
+  std::string data(100, 'a');
+  data[10] = '"';
+  data[80] = '\t';
+  EXPECT_EQ(scanner.FindStructural(data, 0), 80);
+  EXPECT_EQ(CsvScanner::FindQuote(data, 0), 10);
+  EXPECT_EQ(CsvScanner::FindQuote(data, 11), data.size());
+}
+
+TEST(CsvScannerTest, HighBitBytesAreNotStructural) {
+  const CsvScanner scanner(',', /*use_quote_delim=*/true);
+  std::string data(128, static_cast<char>(0xAC));
+  EXPECT_EQ(scanner.FindStructural(data, 0), data.size());
+}
+
+TEST(SplitCsvRecordTest, Basic) {
+  const CsvScanner scanner(',', /*use_quote_delim=*/true);
+  EXPECT_EQ(Split(scanner, "1,2.5,abc"),
+            (std::vector<std::string>{"1", "2.5", "abc"}));
+  EXPECT_EQ(Split(scanner, "1,,3,"),
+            (std::vector<std::string>{"1", "", "3", ""}));
+  EXPECT_TRUE(Split(scanner, "").empty());
+}
+
+TEST(SplitCsvRecordTest, Quoted) {
+  const CsvScanner scanner(',', /*use_quote_delim=*/true);
+  EXPECT_EQ(Split(scanner, "\"a,b\",\"say \"\"hi\"\"\",c"),
+            (std::vector<std::string>{"a,b", "say \"hi\"", "c"}));
+  EXPECT_EQ(Split(scanner, "x,\"\""), (std::vector<std::string>{"x", ""}));
+}
+
+TEST(SplitCsvRecordTest, SelectCols) {
+  const CsvScanner scanner(',', /*use_quote_delim=*/true);
+  EXPECT_EQ(Split(scanner, "a,b,c,d", {1, 3}),
+            (std::vector<std::string>{"b", "d"}));
+  // Parsing stops after the last selected column.
+  EXPECT_EQ(Split(scanner, "a,b,\"bad\"x", {1}),
+            (std::vector<std::string>{"b"}));
+}
+
+TEST(SplitCsvRecordTest, Errors) {
+  const CsvScanner scanner(',', /*use_quote_delim=*/true);
+  std::vector<CsvField> fields;
+  EXPECT_EQ(SplitCsvRecord(scanner, "a\"b,c", {}, &fields).code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(SplitCsvRecord(scanner, "\"a\"b,c", {}, &fields).code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_EQ(SplitCsvRecord(scanner, "\"abc", {}, &fields).code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+TEST(ParseCsvNumberTest, Basic) {
+  int32_t i32;
+  EXPECT_TRUE(ParseCsvNumber("-12", &i32));
+  EXPECT_EQ(i32, -12);
+  int64_t i64;
+  EXPECT_TRUE(ParseCsvNumber("123456789012", &i64));
+  EXPECT_EQ(i64, 123456789012);
+  float f;
+  EXPECT_TRUE(ParseCsvNumber("1.5", &f));
+  EXPECT_EQ(f, 1.5f);
+  double d;
+  EXPECT_FALSE(ParseCsvNumber("1.5x", &d));
+}
+
+}  // namespace
+}  // namespace csv
+}  // namespace tensorflow
@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/shape_inference.h"
+#include "tensorflow/core/kernels/csv_parsing.h"
 #include "tensorflow/core/lib/io/inputstream_interface.h"
 #include "tensorflow/core/lib/io/random_inputstream.h"
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
@@ -180,6 +181,7 @@ class CSVDatasetOp : public DatasetOpKernel {
           exclude_cols_(std::move(exclude_cols)),
           use_quote_delim_(use_quote_delim),
           delim_(delim),
+          scanner_(delim, use_quote_delim),
           na_value_(std::move(na_value)),
           op_version_(op_version),
           use_compression_(!compression_type.empty()),
@@ -511,7 +513,8 @@ class CSVDatasetOp : public DatasetOpKernel {
         pos_++;  // Starting quotation mark
 
         absl::Status parse_result;
-        while (true) {  // Each iter reads 1 char, filling buffer if necessary
+        while (true) {  // Each iter finds the next quote, filling buffer if
+                        // necessary
           if (pos_ >= buffer_.size()) {
             absl::Status s =
                 SaveAndFillBuffer(&earlier_pieces, &start, include);
@@ -524,6 +527,10 @@ class CSVDatasetOp : public DatasetOpKernel {
             }
           }
 
+          // Only quotes are significant inside a quoted field.
+          pos_ = csv::CsvScanner::FindQuote(buffer_, pos_);
+          if (pos_ >= buffer_.size()) continue;
+
           char ch = buffer_[pos_];
           if (ch == '"') {
             // When we encounter a quote, we look ahead to the next character to
@@ -648,7 +655,8 @@ class CSVDatasetOp : public DatasetOpKernel {
         size_t start = pos_;
         absl::Status parse_result;
 
-        while (true) {  // Each iter reads 1 char, filling buffer if necessary
+        while (true) {  // Each iter finds the next delimiter, line break or
+                        // quote, filling buffer if necessary
           if (pos_ >= buffer_.size()) {
             absl::Status s =
                 SaveAndFillBuffer(&earlier_pieces, &start, include);
@@ -665,6 +673,9 @@ class CSVDatasetOp : public DatasetOpKernel {
             }
           }
 
+          pos_ = dataset()->scanner_.FindStructural(buffer_, pos_);
+          if (pos_ >= buffer_.size()) continue;
+
           char ch = buffer_[pos_];
 
           if (ch == dataset()->delim_) {
@@ -690,7 +701,7 @@ class CSVDatasetOp : public DatasetOpKernel {
             parse_result.Update(errors::InvalidArgument(
                 "Unquoted fields cannot have quotes inside"));
           }
-          // Otherwise, go to next character
+          // Otherwise, go past the quote
           pos_++;
         }
       }
@@ -739,7 +750,7 @@ class CSVDatasetOp : public DatasetOpKernel {
                   dataset()->record_defaults_[output_idx].flat<int32>()(0);
             } else {
               int32_t value;
-              if (!absl::SimpleAtoi(field, &value)) {
+              if (!csv::ParseCsvNumber(field, &value)) {
                 return errors::InvalidArgument(
                     "Field ", output_idx,
                     " in record is not a valid int32: ", field);
@@ -754,7 +765,7 @@ class CSVDatasetOp : public DatasetOpKernel {
                   dataset()->record_defaults_[output_idx].flat<int64_t>()(0);
             } else {
               int64_t value;
-              if (!absl::SimpleAtoi(field, &value)) {
+              if (!csv::ParseCsvNumber(field, &value)) {
                 return errors::InvalidArgument(
                     "Field ", output_idx,
                     " in record is not a valid int64: ", field);
@@ -769,7 +780,7 @@ class CSVDatasetOp : public DatasetOpKernel {
                   dataset()->record_defaults_[output_idx].flat<float>()(0);
             } else {
               float value;
-              if (!absl::SimpleAtof(field, &value)) {
+              if (!csv::ParseCsvNumber(field, &value)) {
                 return errors::InvalidArgument(
                     "Field ", output_idx,
                     " in record is not a valid float: ", field);
@@ -784,7 +795,7 @@ class CSVDatasetOp : public DatasetOpKernel {
                   dataset()->record_defaults_[output_idx].flat<double>()(0);
             } else {
               double value;
-              if (!absl::SimpleAtod(field, &value)) {
+              if (!csv::ParseCsvNumber(field, &value)) {
                 return errors::InvalidArgument(
                     "Field ", output_idx,
                     " in record is not a valid double: ", field);
@@ -798,7 +809,7 @@ class CSVDatasetOp : public DatasetOpKernel {
               component.scalar<tstring>()() =
                   dataset()->record_defaults_[output_idx].flat<tstring>()(0);
             } else {
-              component.scalar<tstring>()() = string(field);
+              component.scalar<tstring>()().assign(field.data(), field.size());
             }
             break;
           }
@@ -925,6 +936,8 @@ class CSVDatasetOp : public DatasetOpKernel {
     const std::vector<int64_t> exclude_cols_;
     const bool use_quote_delim_;
     const char delim_;
+    // Locates delimiters, line breaks and quotes in the read buffer.
+    const csv::CsvScanner scanner_;
     const tstring na_value_;
     const int op_version_;
     const bool use_compression_;
@@ -15,12 +15,17 @@ limitations under the License.
 
 // See docs in ../ops/parsing_ops.cc.
 #include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/csv_parsing.h"
 #include "tensorflow/core/lib/core/errors.h"
-#include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -76,129 +81,48 @@ class DecodeCSVOp : public OpKernel {
     OpOutputList output;
     OP_REQUIRES_OK(ctx, ctx->output_list("output", &output));
 
+    std::vector<Tensor*> outputs(out_type_.size());
     for (int i = 0; i < static_cast<int>(out_type_.size()); ++i) {
-      Tensor* out = nullptr;
-      OP_REQUIRES_OK(ctx, output.allocate(i, records->shape(), &out));
+      OP_REQUIRES_OK(ctx, output.allocate(i, records->shape(), &outputs[i]));
     }
 
-    for (int64_t i = 0; i < records_size; ++i) {
-      const absl::string_view record(records_t(i));
-      std::vector<string> fields;
-      ExtractFields(ctx, record, &fields);
-      OP_REQUIRES(ctx, fields.size() == out_type_.size(),
-                  errors::InvalidArgument("Expect ", out_type_.size(),
-                                          " fields but have ", fields.size(),
-                                          " in record ", i));
-
-      // Check each field in the record
-      for (int f = 0; f < static_cast<int>(out_type_.size()); ++f) {
-        const DataType& dtype = out_type_[f];
-        switch (dtype) {
-          case DT_INT32: {
-            // If this field is empty or NA value, check if default is given:
-            // If yes, use default value; Otherwise report error.
-            if (fields[f].empty() || fields[f] == na_value_) {
-              OP_REQUIRES(ctx, record_defaults[f].NumElements() == 1,
-                          errors::InvalidArgument(
-                              "Field ", f,
-                              " is required but missing in record ", i, "!"));
-
-              output[f]->flat<int32>()(i) = record_defaults[f].flat<int32>()(0);
-            } else {
-              int32_t value;
-              OP_REQUIRES(ctx, absl::SimpleAtoi(fields[f], &value),
-                          errors::InvalidArgument(
-                              "Field ", f, " in record ", i,
-                              " is not a valid int32: ", fields[f]));
-              output[f]->flat<int32>()(i) = value;
-            }
-            break;
-          }
-          case DT_INT64: {
-            // If this field is empty or NA value, check if default is given:
-            // If yes, use default value; Otherwise report error.
-            if (fields[f].empty() || fields[f] == na_value_) {
-              OP_REQUIRES(ctx, record_defaults[f].NumElements() == 1,
-                          errors::InvalidArgument(
-                              "Field ", f,
-                              " is required but missing in record ", i, "!"));
-
-              output[f]->flat<int64_t>()(i) =
-                  record_defaults[f].flat<int64_t>()(0);
-            } else {
-              int64_t value;
-              OP_REQUIRES(ctx, absl::SimpleAtoi(fields[f], &value),
-                          errors::InvalidArgument(
-                              "Field ", f, " in record ", i,
-                              " is not a valid int64: ", fields[f]));
-              output[f]->flat<int64_t>()(i) = value;
-            }
-            break;
-          }
-          case DT_FLOAT: {
-            // If this field is empty or NA value, check if default is given:
-            // If yes, use default value; Otherwise report error.
-            if (fields[f].empty() || fields[f] == na_value_) {
-              OP_REQUIRES(ctx, record_defaults[f].NumElements() == 1,
-                          errors::InvalidArgument(
-                              "Field ", f,
-                              " is required but missing in record ", i, "!"));
-              output[f]->flat<float>()(i) = record_defaults[f].flat<float>()(0);
-            } else {
-              float value;
-              OP_REQUIRES(ctx, absl::SimpleAtof(fields[f], &value),
-                          errors::InvalidArgument(
-                              "Field ", f, " in record ", i,
-                              " is not a valid float: ", fields[f]));
-              output[f]->flat<float>()(i) = value;
-            }
-            break;
+    // Records are parsed independently and written straight into their row
+    // of each output, so large batches are split across the worker threads
+    // at record boundaries. If several records are malformed, the error of
+    // the first one is reported, as with sequential parsing.
+    const csv::CsvScanner scanner(delim_, use_quote_delim_);
+    mutex mu;
+    int64_t first_error_record = records_size;
+    absl::Status first_error;
+    auto parse_records = [&](int64_t start, int64_t limit) {
+      std::vector<csv::CsvField> fields;
+      string scratch;
+      for (int64_t i = start; i < limit; ++i) {
+        absl::Status s = ParseRecord(scanner, records_t(i), i, record_defaults,
+                                     outputs, &fields, &scratch);
+        if (!s.ok()) {
+          mutex_lock l(mu);
+          if (i < first_error_record) {
+            first_error_record = i;
+            first_error = std::move(s);
           }
-          case DT_DOUBLE: {
-            // If this field is empty or NA value, check if default is given:
-            // If yes, use default value; Otherwise report error.
-            if (fields[f].empty() || fields[f] == na_value_) {
-              OP_REQUIRES(ctx, record_defaults[f].NumElements() == 1,
-                          errors::InvalidArgument(
-                              "Field ", f,
-                              " is required but missing in record ", i, "!"));
-              output[f]->flat<double>()(i) =
-                  record_defaults[f].flat<double>()(0);
-            } else {
-              double value;
-              OP_REQUIRES(ctx, absl::SimpleAtod(fields[f], &value),
-                          errors::InvalidArgument(
-                              "Field ", f, " in record ", i,
-                              " is not a valid double: ", fields[f]));
-              output[f]->flat<double>()(i) = value;
-            }
-            break;
-          }
-          case DT_STRING: {
-            // If this field is empty or NA value, check if default is given:
-            // If yes, use default value; Otherwise report error.
-            if (fields[f].empty() || fields[f] == na_value_) {
-              OP_REQUIRES(ctx, record_defaults[f].NumElements() == 1,
-                          errors::InvalidArgument(
-                              "Field ", f,
-                              " is required but missing in record ", i, "!"));
-              output[f]->flat<tstring>()(i) =
-                  record_defaults[f].flat<tstring>()(0);
-            } else {
-              output[f]->flat<tstring>()(i) = std::move(fields[f]);
-            }
-            break;
-          }
-          default:
-            OP_REQUIRES(ctx, false,
-                        errors::InvalidArgument("csv: data type ", dtype,
-                                                " not supported in field ", f));
+          return;
         }
       }
-    }
+    };
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *ctx->device()->tensorflow_cpu_worker_threads();
+    const int64_t cost_per_record =
+        kCostPerField * static_cast<int64_t>(out_type_.size());
+    Shard(worker_threads.num_threads, worker_threads.workers, records_size,
+          cost_per_record, parse_records);
+    OP_REQUIRES_OK(ctx, first_error);
   }
 
  private:
+  // Rough cost, in cycles, of splitting and converting one field.
+  static constexpr int64_t kCostPerField = 200;
+
   std::vector<DataType> out_type_;
   std::vector<int64_t> select_cols_;
   char delim_;
@@ -206,91 +130,102 @@ class DecodeCSVOp : public OpKernel {
   bool select_all_cols_;
   string na_value_;
 
-  void ExtractFields(OpKernelContext* ctx, absl::string_view input,
-                     std::vector<string>* result) {
-    int64_t current_idx = 0;
-    int64_t num_fields_parsed = 0;
-    int64_t selector_idx = 0;  // Keep track of index into select_cols
-
-    if (!input.empty()) {
-      while (static_cast<size_t>(current_idx) < input.size()) {
-        if (input[current_idx] == '\n' || input[current_idx] == '\r') {
-          current_idx++;
-          continue;
-        }
+  // Parses record `i` and stores its fields in row `i` of `outputs`. `fields`
+  // and `scratch` are reused across calls to avoid allocations.
+  absl::Status ParseRecord(const csv::CsvScanner& scanner,
+                           absl::string_view record, int64_t i,
+                           const OpInputList& record_defaults,
+                           const std::vector<Tensor*>& outputs,
+                           std::vector<csv::CsvField>* fields,
+                           string* scratch) const {
+    TF_RETURN_IF_ERROR(
+        csv::SplitCsvRecord(scanner, record, select_cols_, fields));
+    if (fields->size() != out_type_.size()) {
+      return errors::InvalidArgument("Expect ", out_type_.size(),
+                                     " fields but have ", fields->size(),
+                                     " in record ", i);
+    }
 
-        bool quoted = false;
-        bool include =
-            (select_all_cols_ || select_cols_[selector_idx] ==
-                                     static_cast<size_t>(num_fields_parsed));
+    // Check each field in the record
+    for (int f = 0; f < static_cast<int>(out_type_.size()); ++f) {
+      const csv::CsvField& field = (*fields)[f];
+      absl::string_view text = field.text;
+      if (field.escaped) {
+        csv::UnescapeCsvField(field, scratch);
+        text = *scratch;
+      }
 
-        if (use_quote_delim_ && input[current_idx] == '"') {
-          quoted = true;
-          current_idx++;
+      // If this field is empty or NA value, check if default is given:
+      // If yes, use default value; Otherwise report error.
+      if (text.empty() || text == na_value_) {
+        if (record_defaults[f].NumElements() != 1) {
+          return errors::InvalidArgument(
+              "Field ", f, " is required but missing in record ", i, "!");
         }
-
-        // This is the body of the field;
-        string field;
-        if (!quoted) {
-          while (static_cast<size_t>(current_idx) < input.size() &&
-                 input[current_idx] != delim_) {
-            OP_REQUIRES(ctx,
-                        (!use_quote_delim_ || input[current_idx] != '"') &&
-                            input[current_idx] != '\n' &&
-                            input[current_idx] != '\r',
-                        errors::InvalidArgument(
-                            "Unquoted fields cannot have quotes/CRLFs inside"));
-            if (include) field += input[current_idx];
-            current_idx++;
-          }
-
-          // Go to next field or the end
-          current_idx++;
-        } else if (use_quote_delim_) {
-          // Quoted field needs to be ended with '"' and delim or end
-          while (
-              (static_cast<size_t>(current_idx) < input.size() - 1) &&
-              (input[current_idx] != '"' || input[current_idx + 1] != delim_)) {
-            if (input[current_idx] != '"') {
-              if (include) field += input[current_idx];
-              current_idx++;
-            } else {
-              OP_REQUIRES(
-                  ctx, input[current_idx + 1] == '"',
-                  errors::InvalidArgument("Quote inside a string has to be "
-                                          "escaped by another quote"));
-              if (include) field += '"';
-              current_idx += 2;
-            }
-          }
-
-          OP_REQUIRES(
-              ctx,
-              (static_cast<size_t>(current_idx) < input.size() &&
-               input[current_idx] == '"' &&
-               (static_cast<size_t>(current_idx) == input.size() - 1 ||
-                input[current_idx + 1] == delim_)),
-              errors::InvalidArgument("Quoted field has to end with quote "
-                                      "followed by delim or end"));
-
-          current_idx += 2;
+        switch (out_type_[f]) {
+          case DT_INT32:
+            outputs[f]->flat<int32>()(i) = record_defaults[f].flat<int32>()(0);
+            break;
+          case DT_INT64:
+            outputs[f]->flat<int64_t>()(i) =
+                record_defaults[f].flat<int64_t>()(0);
+            break;
+          case DT_FLOAT:
+            outputs[f]->flat<float>()(i) = record_defaults[f].flat<float>()(0);
+            break;
+          case DT_DOUBLE:
+            outputs[f]->flat<double>()(i) =
+                record_defaults[f].flat<double>()(0);
+            break;
+          case DT_STRING:
+            outputs[f]->flat<tstring>()(i) =
+                record_defaults[f].flat<tstring>()(0);
+            break;
+          default:
+            return errors::InvalidArgument("csv: data type ", out_type_[f],
+                                           " not supported in field ", f);
         }
+        continue;
+      }
 
-        num_fields_parsed++;
-        if (include) {
-          result->push_back(field);
-          selector_idx++;
-          if (selector_idx == select_cols_.size()) return;
-        }
+      switch (out_type_[f]) {
+        case DT_INT32:
+          TF_RETURN_IF_ERROR(ParseNumber(text, f, i, "int32",
+                                         &outputs[f]->flat<int32>()(i)));
+          break;
+        case DT_INT64:
+          TF_RETURN_IF_ERROR(ParseNumber(text, f, i, "int64",
+                                         &outputs[f]->flat<int64_t>()(i)));
+          break;
+        case DT_FLOAT:
+          TF_RETURN_IF_ERROR(ParseNumber(text, f, i, "float",
+                                         &outputs[f]->flat<float>()(i)));
+          break;
+        case DT_DOUBLE:
+          TF_RETURN_IF_ERROR(ParseNumber(text, f, i, "double",
+                                         &outputs[f]->flat<double>()(i)));
+          break;
+        case DT_STRING:
+          outputs[f]->flat<tstring>()(i).assign(text.data(), text.size());
+          break;
+        default:
+          return errors::InvalidArgument("csv: data type ", out_type_[f],
+                                         " not supported in field ", f);
       }
+    }
+    return absl::OkStatus();
+  }
 
-      bool include =
-          (select_all_cols_ || select_cols_[selector_idx] ==
-                                   static_cast<size_t>(num_fields_parsed));
-      // Check if the last field is missing
-      if (include && input[input.size() - 1] == delim_)
-        result->push_back(string());
+  // Converts `text`, field `f` of record `i`, directly into `*value`.
+  template <typename T>
+  static absl::Status ParseNumber(absl::string_view text, int f, int64_t i,
+                                  const char* type_name, T* value) {
+    if (!csv::ParseCsvNumber(text, value)) {
+      return errors::InvalidArgument("Field ", f, " in record ", i,
+                                     " is not a valid ", type_name, ": ",
+                                     text);
     }
+    return absl::OkStatus();
   }
 };
 
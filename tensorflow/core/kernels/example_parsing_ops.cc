@@ -15,6 +15,7 @@ limitations under the License.
 
 // See docs in ../ops/parsing_ops.cc.
 
+#include <memory>
 #include <numeric>
 #include <unordered_set>
 #include <vector>
@@ -30,7 +31,9 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/array_slice.h"
 #include "tensorflow/core/platform/errors.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/platform/statusor.h"
 #include "tensorflow/core/util/example_proto_fast_parsing.h"
 #include "tensorflow/core/util/example_proto_helper.h"
 #include "tensorflow/core/util/sparse/sparse_tensor.h"
@@ -89,13 +92,17 @@ class ParseExampleOp : public OpKernel {
 
     example::FastParseExampleConfig config =
         MakeConfig(dense_keys_t, sparse_keys_t, ragged_keys_t, dense_defaults);
+    absl::StatusOr<std::shared_ptr<const example::FastParseExampleIndex>>
+        index = GetIndex(dense_keys_t, sparse_keys_t, ragged_keys_t);
+    OP_REQUIRES_OK(ctx, index.status());
 
     example::Result result;
     if (TensorShapeUtils::IsVector(serialized->shape())) {
-      OP_REQUIRES_OK(
-          ctx, ParseExampleVector(config, serialized, names, ctx, &result));
+      OP_REQUIRES_OK(ctx, ParseExampleVector(config, **index, serialized,
+                                             names, ctx, &result));
     } else {
-      OP_REQUIRES_OK(ctx, ParseExampleScalar(config, serialized, ctx, &result));
+      OP_REQUIRES_OK(ctx, ParseExampleScalar(config, **index, serialized, ctx,
+                                             &result));
     }
     OP_REQUIRES_OK(ctx, WriteOutput(result, ctx));
   }
@@ -236,17 +243,36 @@ class ParseExampleOp : public OpKernel {
     return config;
   }
 
+  // Returns the feature-name index for the given keys. The keys are inputs,
+  // but in practice they are constants, so the index is built on first use
+  // and only rebuilt if a later call passes different keys.
+  absl::StatusOr<std::shared_ptr<const example::FastParseExampleIndex>>
+  GetIndex(const std::vector<absl::string_view>& dense_keys_t,
+           const std::vector<absl::string_view>& sparse_keys_t,
+           const std::vector<absl::string_view>& ragged_keys_t) {
+    mutex_lock l(index_mu_);
+    if (index_ == nullptr ||
+        !index_->Matches(dense_keys_t, sparse_keys_t, ragged_keys_t)) {
+      TF_ASSIGN_OR_RETURN(index_,
+                          example::FastParseExampleIndex::Create(
+                              dense_keys_t, sparse_keys_t, ragged_keys_t));
+    }
+    return index_;
+  }
+
   // Parses a single example.
   absl::Status ParseExampleScalar(const example::FastParseExampleConfig& config,
+                                  const example::FastParseExampleIndex& index,
                                   const Tensor* serialized,
                                   OpKernelContext* ctx,
                                   example::Result* result) const {
     const tstring& serialized_proto = serialized->scalar<tstring>()();
-    return FastParseSingleExample(config, serialized_proto, result);
+    return FastParseSingleExample(config, index, serialized_proto, result);
   }
 
   // Parses a vector of examples.
   absl::Status ParseExampleVector(const example::FastParseExampleConfig& config,
+                                  const example::FastParseExampleIndex& index,
                                   const Tensor* serialized, const Tensor* names,
                                   OpKernelContext* ctx,
                                   example::Result* result) const {
@@ -255,7 +281,7 @@ class ParseExampleOp : public OpKernel {
     absl::Span<const tstring> slice(serialized_t.data(), serialized_t.size());
     absl::Span<const tstring> names_slice(names_t.data(), names_t.size());
     return FastParseExample(
-        config, slice, names_slice,
+        config, index, slice, names_slice,
         ctx->device()->tensorflow_cpu_worker_threads()->workers, result);
   }
 
@@ -293,6 +319,9 @@ class ParseExampleOp : public OpKernel {
   ParseExampleAttrs attrs_;
   int op_version_;
   absl::once_flag flag_;
+  mutex index_mu_;
+  std::shared_ptr<const example::FastParseExampleIndex> index_
+      TF_GUARDED_BY(index_mu_);
 };
 
 REGISTER_KERNEL_BUILDER(Name("ParseExample").Device(DEVICE_CPU),
@@ -306,6 +335,15 @@ class ParseSingleExampleOp : public OpKernel {
     OP_REQUIRES_OK(ctx, attrs_.Init(ctx));
     metrics::RecordParseDenseFeature(attrs_.dense_keys.size());
     metrics::RecordParseSparseFeature(attrs_.sparse_keys.size());
+    // The keys are attributes, so the feature-name index is built once here.
+    std::vector<absl::string_view> dense_keys(attrs_.dense_keys.begin(),
+                                              attrs_.dense_keys.end());
+    std::vector<absl::string_view> sparse_keys(attrs_.sparse_keys.begin(),
+                                               attrs_.sparse_keys.end());
+    absl::StatusOr<std::unique_ptr<example::FastParseExampleIndex>> index =
+        example::FastParseExampleIndex::Create(dense_keys, sparse_keys, {});
+    OP_REQUIRES_OK(ctx, index.status());
+    index_ = *std::move(index);
   }
 
   void Compute(OpKernelContext* ctx) override {
@@ -370,8 +408,8 @@ class ParseSingleExampleOp : public OpKernel {
 
     const tstring& serialized_proto = serialized->scalar<tstring>()();
 
-    OP_REQUIRES_OK(ctx,
-                   FastParseSingleExample(config, serialized_proto, &result));
+    OP_REQUIRES_OK(ctx, FastParseSingleExample(config, *index_,
+                                               serialized_proto, &result));
 
     OpOutputList dense_values;
     OpOutputList sparse_indices;
@@ -393,6 +431,7 @@ class ParseSingleExampleOp : public OpKernel {
 
  protected:
   ParseSingleExampleAttrs attrs_;
+  std::unique_ptr<const example::FastParseExampleIndex> index_;
 };
 
 REGISTER_KERNEL_BUILDER(Name("ParseSingleExample").Device(DEVICE_CPU),
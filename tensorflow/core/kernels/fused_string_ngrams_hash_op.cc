@@ -0,0 +1,321 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/string_ops.cc.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/op_requires.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/kernels/string_util.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+namespace text {
+
+namespace {
+
+// Rough cost, in cycles, of assembling and fingerprinting one n-gram.
+constexpr int64_t kCostPerNGram = 250;
+
+// Forms the n-grams of ragged rows of tokens exactly like StringNGrams and
+// maps each of them to a bucket exactly like StringToHashBucketFast. Each
+// n-gram is assembled in a scratch buffer that is reused for the whole shard,
+// so the only tensors allocated are the int64 bucket ids and their splits.
+template <typename SPLITS_TYPE>
+class NGramsHashBucketOpBase : public OpKernel {
+ public:
+  explicit NGramsHashBucketOpBase(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("separator", &separator_));
+    OP_REQUIRES_OK(context, context->GetAttr("ngram_widths", &ngram_widths_));
+    OP_REQUIRES_OK(context, context->GetAttr("left_pad", &left_pad_));
+    OP_REQUIRES_OK(context, context->GetAttr("right_pad", &right_pad_));
+    OP_REQUIRES_OK(context, context->GetAttr("pad_width", &pad_width_));
+    OP_REQUIRES_OK(context, context->GetAttr("preserve_short_sequences",
+                                             &preserve_short_));
+    OP_REQUIRES_OK(context, context->GetAttr("num_buckets", &num_buckets_));
+  }
+
+ protected:
+  // Computes both outputs for the `num_tokens` tokens at `tokens`, which
+  // `splits` partitions into rows. `TokenT` is any type that converts to
+  // absl::string_view.
+  template <typename TokenT>
+  void ComputeFromTokens(OpKernelContext* context, const TokenT* tokens,
+                         int64_t num_tokens, const Tensor& splits) {
+    for (int ngram_width : ngram_widths_) {
+      OP_REQUIRES(
+          context, ngram_width > 0,
+          errors::InvalidArgument("ngram_widths must contain positive values"));
+    }
+
+    const auto splits_vec = splits.flat<SPLITS_TYPE>();
+    const int64_t splits_vec_size = splits_vec.size();
+    if (splits_vec_size > 0) {
+      int64_t prev_split = splits_vec(0);
+      OP_REQUIRES(context, prev_split == 0,
+                  errors::InvalidArgument("First split value must be 0, got ",
+                                          prev_split));
+      for (int64_t i = 1; i < splits_vec_size; ++i) {
+        bool valid_splits = splits_vec(i) >= prev_split;
+        valid_splits = valid_splits && (splits_vec(i) <= num_tokens);
+        OP_REQUIRES(context, valid_splits,
+                    errors::InvalidArgument(
+                        "Invalid split value ", splits_vec(i), ", must be in [",
+                        prev_split, ", ", num_tokens, "]"));
+        prev_split = splits_vec(i);
+      }
+      OP_REQUIRES(context, prev_split == num_tokens,
+                  errors::InvalidArgument(
+                      "Last split value must be data size. Expected ",
+                      num_tokens, ", got ", prev_split));
+    }
+
+    const int64_t num_batch_items = splits_vec_size - 1;
+    Tensor* output_splits;
+    OP_REQUIRES_OK(context,
+                   context->allocate_output(1, splits.shape(), &output_splits));
+    auto output_splits_data = output_splits->flat<SPLITS_TYPE>().data();
+
+    // If there is no data or size, return an empty RT.
+    if (num_tokens == 0 || splits_vec_size == 0) {
+      Tensor* empty;
+      OP_REQUIRES_OK(context,
+                     context->allocate_output(0, TensorShape({0}), &empty));
+      for (int64_t i = 0; i <= num_batch_items; ++i) {
+        output_splits_data[i] = 0;
+      }
+      return;
+    }
+
+    output_splits_data[0] = 0;
+    for (int64_t i = 1; i <= num_batch_items; ++i) {
+      const int length = splits_vec(i) - splits_vec(i - 1);
+      int num_ngrams = 0;
+      for (int ngram_width : ngram_widths_) {
+        auto ngrams_or = GetNumNGrams(length, ngram_width);
+        OP_REQUIRES_OK(context, ngrams_or.status());
+        num_ngrams += ngrams_or.value();
+      }
+      if (preserve_short_ && length > 0 && num_ngrams == 0) {
+        // The preserved sequence is padded with a fixed width on both sides,
+        // which requires a non-negative `pad_width`.
+        OP_REQUIRES(
+            context, pad_width_ >= 0,
+            errors::InvalidArgument("Pad width should be >= 0 when "
+                                    "preserve_short_sequences is True and "
+                                    "ngram_widths are not provided, got ",
+                                    pad_width_));
+        num_ngrams = 1;
+      }
+      output_splits_data[i] = output_splits_data[i - 1] + num_ngrams;
+    }
+
+    const int64_t total_ngrams = output_splits_data[num_batch_items];
+    Tensor* output;
+    OP_REQUIRES_OK(context, context->allocate_output(
+                                0, TensorShape({total_ngrams}), &output));
+    int64_t* const output_data = output->flat<int64_t>().data();
+
+    auto hash_rows = [&](int64_t start, int64_t limit) {
+      std::string ngram;
+      for (int64_t i = start; i < limit; ++i) {
+        const TokenT* row_tokens = tokens + splits_vec(i);
+        const int length = splits_vec(i + 1) - splits_vec(i);
+        int64_t* const row_output = output_data + output_splits_data[i];
+        int num_hashed = 0;
+        for (int ngram_width : ngram_widths_) {
+          // Validated above, when the output splits were computed.
+          const int num_ngrams = GetNumNGrams(length, ngram_width).value();
+          HashNGrams(row_tokens, row_output + num_hashed, num_ngrams,
+                     ngram_width, &ngram);
+          num_hashed += num_ngrams;
+        }
+        if (preserve_short_ && length > 0 && num_hashed == 0) {
+          HashNGrams(row_tokens, row_output, 1, length + 2 * pad_width_,
+                     &ngram);
+        }
+      }
+    };
+    const auto* worker_threads =
+        context->device()->tensorflow_cpu_worker_threads();
+    const int64_t cost_per_row =
+        kCostPerNGram * (total_ngrams / num_batch_items + 1);
+    Shard(worker_threads->num_threads, worker_threads->workers,
+          num_batch_items, cost_per_row, hash_rows);
+  }
+
+ private:
+  int GetPadWidth(const int ngram_width) const {
+    // Ngrams can be padded with either a fixed pad width or a dynamic pad
+    // width depending on the 'pad_width' arg, but in no case should the padding
+    // ever be wider than 'ngram_width' - 1.
+    return std::min(pad_width_ < 0 ? ngram_width - 1 : pad_width_,
+                    ngram_width - 1);
+  }
+
+  absl::StatusOr<int> GetNumNGrams(const int length,
+                                   const int ngram_width) const {
+    int64 limit = kint32max;
+    int pad_width = GetPadWidth(ngram_width);
+    if (pad_width > limit / 2 - length) {
+      return errors::InvalidArgument(
+          "Pad width could lead to integer overflow, got pad_width = ",
+          pad_width);
+    }
+    return std::max(0, ((length + 2 * pad_width) - ngram_width) + 1);
+  }
+
+  // Writes the bucket ids of the first `num_ngrams` n-grams of width
+  // `ngram_width` formed from `data`, using `ngram` as scratch space. The
+  // n-grams are the same strings StringNGramsOp::CreateNgrams would produce:
+  // the pads and tokens of each n-gram joined by the separator.
+  template <typename TokenT>
+  void HashNGrams(const TokenT* data, int64_t* output, int num_ngrams,
+                  int ngram_width, std::string* ngram) const {
+    const int pad_width = GetPadWidth(ngram_width);
+    for (int ngram_index = 0; ngram_index < num_ngrams; ++ngram_index) {
+      int left_padding = std::max(0, pad_width - ngram_index);
+      int right_padding =
+          std::max(0, pad_width - (num_ngrams - (ngram_index + 1)));
+      int num_tokens = ngram_width - (left_padding + right_padding);
+      int data_start_index = left_padding > 0 ? 0 : ngram_index - pad_width;
+
+      ngram->clear();
+      for (int n = 0; n < left_padding; ++n) {
+        ngram->append(left_pad_);
+        ngram->append(separator_);
+      }
+      for (int n = 0; n < num_tokens; ++n) {
+        const absl::string_view token(data[data_start_index + n]);
+        ngram->append(token.data(), token.size());
+        ngram->append(separator_);
+      }
+      for (int n = 0; n < right_padding; ++n) {
+        ngram->append(right_pad_);
+        ngram->append(separator_);
+      }
+      // Every n-gram has at least one piece, so there is always a trailing
+      // separator to drop.
+      ngram->resize(ngram->size() - separator_.size());
+
+      // The number of buckets is always in the positive range of int64 so is
+      // the resulting bucket id.
+      output[ngram_index] =
+          static_cast<int64_t>(Fingerprint64(*ngram) % num_buckets_);
+    }
+  }
+
+  string separator_;
+  string left_pad_;
+  string right_pad_;
+  bool preserve_short_;
+  std::vector<int> ngram_widths_;
+  int pad_width_;
+  int64_t num_buckets_;
+};
+
+// StringNGrams + StringToHashBucketFast.
+template <typename SPLITS_TYPE>
+class StringNGramsHashBucketFastOp
+    : public NGramsHashBucketOpBase<SPLITS_TYPE> {
+ public:
+  explicit StringNGramsHashBucketFastOp(OpKernelConstruction* context)
+      : NGramsHashBucketOpBase<SPLITS_TYPE>(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor* data;
+    OP_REQUIRES_OK(context, context->input("data", &data));
+    const Tensor* splits;
+    OP_REQUIRES_OK(context, context->input("data_splits", &splits));
+    const auto data_flat = data->flat<tstring>();
+    this->ComputeFromTokens(context, data_flat.data(), data_flat.size(),
+                            *splits);
+  }
+};
+
+// StringSplitV2 + StringNGrams + StringToHashBucketFast. The tokens are kept
+// as views into the input strings, so they are never copied.
+template <typename SPLITS_TYPE>
+class StringSplitNGramsHashBucketFastOp
+    : public NGramsHashBucketOpBase<SPLITS_TYPE> {
+ public:
+  explicit StringSplitNGramsHashBucketFastOp(OpKernelConstruction* context)
+      : NGramsHashBucketOpBase<SPLITS_TYPE>(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("maxsplit", &maxsplit_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor* input_tensor;
+    OP_REQUIRES_OK(context, context->input("input", &input_tensor));
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(input_tensor->shape()),
+                errors::InvalidArgument("input must be a vector, got shape: ",
+                                        input_tensor->shape().DebugString()));
+    const auto input_vec = input_tensor->vec<tstring>();
+
+    const Tensor* sep_tensor;
+    OP_REQUIRES_OK(context, context->input("sep", &sep_tensor));
+    OP_REQUIRES(context, TensorShapeUtils::IsScalar(sep_tensor->shape()),
+                errors::InvalidArgument("sep must be a scalar, got shape: ",
+                                        sep_tensor->shape().DebugString()));
+    const absl::string_view sep(sep_tensor->scalar<tstring>()());
+
+    const Tensor* splits;
+    OP_REQUIRES_OK(context, context->input("data_splits", &splits));
+
+    std::vector<absl::string_view> tokens;
+    // Guess that we'll be unpacking a handful of tokens per example.
+    static constexpr int kReserveSize = 4;
+    tokens.reserve(input_vec.size() * kReserveSize);
+    for (int64_t i = 0; i < input_vec.size(); ++i) {
+      std::vector<absl::string_view> parts =
+          SplitV2(input_vec(i), sep, maxsplit_);
+      tokens.insert(tokens.end(), parts.begin(), parts.end());
+    }
+    this->ComputeFromTokens(context, tokens.data(), tokens.size(), *splits);
+  }
+
+ private:
+  int maxsplit_;
+};
+
+}  // namespace
+
+#define REGISTER_KERNELS(splits_type)                                  \
+  REGISTER_KERNEL_BUILDER(Name("_StringNGramsHashBucketFast")          \
+                              .Device(tensorflow::DEVICE_CPU)          \
+                              .TypeConstraint<splits_type>("Tsplits"), \
+                          StringNGramsHashBucketFastOp<splits_type>);  \
+  REGISTER_KERNEL_BUILDER(Name("_StringSplitNGramsHashBucketFast")     \
+                              .Device(tensorflow::DEVICE_CPU)          \
+                              .TypeConstraint<splits_type>("Tsplits"), \
+                          StringSplitNGramsHashBucketFastOp<splits_type>);
+
+REGISTER_KERNELS(int32);
+REGISTER_KERNELS(int64_t);
+#undef REGISTER_KERNELS
+
+}  // namespace text
+}  // namespace tensorflow
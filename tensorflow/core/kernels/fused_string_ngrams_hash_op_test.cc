@@ -0,0 +1,178 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include <vector>
+
+#include "absl/strings/match.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/fingerprint.h"
+
+namespace tensorflow {
+namespace text {
+namespace {
+
+constexpr int64_t kNumBuckets = 1000;
+
+class FusedNgramHashKernelTest : public OpsTestBase {
+ public:
+  void MakeNGramsOp(string separator, std::vector<int> ngram_width,
+                    string left_pad, string right_pad, int pad_width,
+                    bool preserve) {
+    TF_ASSERT_OK(NodeDefBuilder("tested_op", "_StringNGramsHashBucketFast")
+                     .Attr("separator", separator)
+                     .Attr("ngram_widths", ngram_width)
+                     .Attr("left_pad", left_pad)
+                     .Attr("right_pad", right_pad)
+                     .Attr("pad_width", pad_width)
+                     .Attr("preserve_short_sequences", preserve)
+                     .Attr("num_buckets", kNumBuckets)
+                     .Input(FakeInput(DT_STRING))
+                     .Input(FakeInput(DT_INT64))
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+
+  void MakeSplitNGramsOp(string separator, std::vector<int> ngram_width,
+                         int pad_width) {
+    TF_ASSERT_OK(
+        NodeDefBuilder("tested_op", "_StringSplitNGramsHashBucketFast")
+            .Attr("separator", separator)
+            .Attr("ngram_widths", ngram_width)
+            .Attr("left_pad", "LP")
+            .Attr("right_pad", "RP")
+            .Attr("pad_width", pad_width)
+            .Attr("preserve_short_sequences", false)
+            .Attr("num_buckets", kNumBuckets)
+            .Input(FakeInput(DT_STRING))
+            .Input(FakeInput(DT_STRING))
+            .Input(FakeInput(DT_INT64))
+            .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+
+  // Checks that output 0 holds the StringToHashBucketFast buckets of
+  // `expected_ngrams`, i.e. what the unfused StringNGrams would produce.
+  void AssertBucketsOf(const std::vector<tstring>& expected_ngrams) {
+    Tensor expected_tensor(
+        allocator(), DT_INT64,
+        TensorShape({static_cast<int64_t>(expected_ngrams.size())}));
+    auto expected = expected_tensor.vec<int64_t>();
+    for (size_t i = 0; i < expected_ngrams.size(); ++i) {
+      expected(i) = Fingerprint64(expected_ngrams[i]) % kNumBuckets;
+    }
+    test::ExpectTensorEqual<int64_t>(expected_tensor, *GetOutput(0));
+  }
+
+  void AssertSplits(const std::vector<int64_t>& expected_splits) {
+    test::ExpectTensorEqual<int64_t>(
+        test::AsTensor<int64_t>(expected_splits), *GetOutput(1));
+  }
+};
+
+TEST_F(FusedNgramHashKernelTest, TestPaddedBigramsAndTrigrams) {
+  MakeNGramsOp("|", {2, 3}, "LP", "RP", -1, false);
+  // Batch items are:
+  // 0: "a", "b", "c", "d"
+  // 1: "e", "f"
+  AddInputFromArray<tstring>(TensorShape({6}), {"a", "b", "c", "d", "e", "f"});
+  AddInputFromArray<int64_t>(TensorShape({3}), {0, 4, 6});
+  TF_ASSERT_OK(RunOpKernel());
+
+  AssertBucketsOf(
+      {"LP|a", "a|b", "b|c", "c|d", "d|RP", "LP|LP|a", "LP|a|b", "a|b|c",
+       "b|c|d", "c|d|RP", "d|RP|RP",                                       // 0
+       "LP|e", "e|f", "f|RP", "LP|LP|e", "LP|e|f", "e|f|RP", "f|RP|RP"});  // 1
+  AssertSplits({0, 11, 18});
+}
+
+TEST_F(FusedNgramHashKernelTest, TestUnpaddedTrigramsWithEmptySequence) {
+  MakeNGramsOp("|", {3}, "", "", 0, false);
+  // Batch items are:
+  // 0: "a", "b", "c", "d"
+  // 1: <empty>
+  // 2: "e", "f"
+  AddInputFromArray<tstring>(TensorShape({6}), {"a", "b", "c", "d", "e", "f"});
+  AddInputFromArray<int64_t>(TensorShape({4}), {0, 4, 4, 6});
+  TF_ASSERT_OK(RunOpKernel());
+
+  AssertBucketsOf({"a|b|c", "b|c|d"});
+  AssertSplits({0, 2, 2, 2});
+}
+
+TEST_F(FusedNgramHashKernelTest, TestPreserveShortSequences) {
+  MakeNGramsOp("|", {4}, "LP", "RP", 0, true);
+  // Batch items are:
+  // 0: "a", "b", "c", "d"
+  // 1: "e", "f"
+  AddInputFromArray<tstring>(TensorShape({6}), {"a", "b", "c", "d", "e", "f"});
+  AddInputFromArray<int64_t>(TensorShape({3}), {0, 4, 6});
+  TF_ASSERT_OK(RunOpKernel());
+
+  AssertBucketsOf({"a|b|c|d", "e|f"});
+  AssertSplits({0, 1, 2});
+}
+
+TEST_F(FusedNgramHashKernelTest, TestEmptyInput) {
+  MakeNGramsOp("|", {2}, "LP", "RP", -1, false);
+  AddInputFromArray<tstring>(TensorShape({0}), {});
+  AddInputFromArray<int64_t>(TensorShape({0}), {});
+  TF_ASSERT_OK(RunOpKernel());
+
+  AssertBucketsOf({});
+  AssertSplits({});
+}
+
+TEST_F(FusedNgramHashKernelTest, TestInvalidSplits) {
+  MakeNGramsOp("|", {2}, "LP", "RP", -1, false);
+  AddInputFromArray<tstring>(TensorShape({3}), {"a", "b", "c"});
+  AddInputFromArray<int64_t>(TensorShape({2}), {0, 2});
+  EXPECT_TRUE(absl::StrContains(RunOpKernel().message(),
+                                "Last split value must be data size"));
+}
+
+TEST_F(FusedNgramHashKernelTest, TestSplitPaddedBigrams) {
+  MakeSplitNGramsOp("|", {2}, -1);
+  // The splits partition the tokens of all inputs, like the `values` output
+  // of StringSplitV2; they need not follow the input strings.
+  AddInputFromArray<tstring>(TensorShape({2}), {"a b c", "d"});
+  AddInputFromArray<tstring>(TensorShape({}), {" "});
+  AddInputFromArray<int64_t>(TensorShape({3}), {0, 2, 4});
+  TF_ASSERT_OK(RunOpKernel());
+
+  AssertBucketsOf({"LP|a", "a|b", "b|RP",    // 0
+                   "LP|c", "c|d", "d|RP"});  // 1
+  AssertSplits({0, 3, 6});
+}
+
+TEST_F(FusedNgramHashKernelTest, TestSplitOnWhitespace) {
+  MakeSplitNGramsOp(" ", {2}, 0);
+  AddInputFromArray<tstring>(TensorShape({3}), {"  a  b ", "", "c d e"});
+  AddInputFromArray<tstring>(TensorShape({}), {""});
+  AddInputFromArray<int64_t>(TensorShape({4}), {0, 2, 2, 5});
+  TF_ASSERT_OK(RunOpKernel());
+
+  AssertBucketsOf({"a b", "c d", "d e"});
+  AssertSplits({0, 1, 1, 3});
+}
+
+}  // namespace
+}  // namespace text
+}  // namespace tensorflow
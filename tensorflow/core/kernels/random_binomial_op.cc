@@ -394,34 +394,45 @@ class RandomBinomialOp : public OpKernel {
     core::RefCountPtr<Var> var;
     OP_REQUIRES_OK(ctx, LookupResource(ctx, HandleFromInput(ctx, 0), &var));
 
-    Tensor* var_tensor = var->tensor();
-    OP_REQUIRES(
-        ctx, var_tensor->dtype() == STATE_ELEMENT_DTYPE,
-        errors::InvalidArgument("dtype of RNG state variable must be ",
-                                DataTypeString(STATE_ELEMENT_DTYPE), ", not ",
-                                DataTypeString(var_tensor->dtype())));
-    OP_REQUIRES(ctx, var_tensor->dims() == 1,
-                errors::InvalidArgument(
-                    "RNG state must have one and only one dimension, not ",
-                    var_tensor->dims()));
-    auto var_tensor_flat = var_tensor->flat<StateElementType>();
-    OP_REQUIRES(ctx, alg == RNG_ALG_PHILOX,
-                errors::InvalidArgument("Unsupported algorithm id: ", alg));
-    static_assert(std::is_same<StateElementType, int64_t>::value,
-                  "StateElementType must be int64");
-    static_assert(std::is_same<PhiloxRandom::ResultElementType, uint32>::value,
-                  "PhiloxRandom::ResultElementType must be uint32");
-    OP_REQUIRES(ctx, var_tensor_flat.size() >= PHILOX_MIN_STATE_SIZE,
-                errors::InvalidArgument(
-                    "For Philox algorithm, the size of state must be at least ",
-                    PHILOX_MIN_STATE_SIZE, "; got ", var_tensor_flat.size()));
-
-    OP_REQUIRES_OK(ctx, PrepareToUpdateVariable<Device, StateElementType>(
-                            ctx, var_tensor, var->copy_on_read_mode.load()));
-    auto var_data = var_tensor_flat.data();
-    auto philox = GetPhiloxRandomFromMem(var_data);
-    UpdateMemWithPhiloxRandom(
-        philox, num_batches * 2 * 100 * (samples_per_batch + 3) / 4, var_data);
+    // The state is updated under the variable's mutex, which delta saves of
+    // the variable rely on (see Var::TakeDirtyRowRanges()).
+    PhiloxRandom philox;
+    {
+      mutex_lock l(*var->mu());
+      Tensor* var_tensor = var->tensor();
+      OP_REQUIRES(
+          ctx, var_tensor->dtype() == STATE_ELEMENT_DTYPE,
+          errors::InvalidArgument(
+              "dtype of RNG state variable must be ",
+              DataTypeString(STATE_ELEMENT_DTYPE), ", not ",
+              DataTypeString(var_tensor->dtype())));
+      OP_REQUIRES(ctx, var_tensor->dims() == 1,
+                  errors::InvalidArgument(
+                      "RNG state must have one and only one dimension, not ",
+                      var_tensor->dims()));
+      auto var_tensor_flat = var_tensor->flat<StateElementType>();
+      OP_REQUIRES(ctx, alg == RNG_ALG_PHILOX,
+                  errors::InvalidArgument("Unsupported algorithm id: ", alg));
+      static_assert(std::is_same<StateElementType, int64_t>::value,
+                    "StateElementType must be int64");
+      static_assert(
+          std::is_same<PhiloxRandom::ResultElementType, uint32>::value,
+          "PhiloxRandom::ResultElementType must be uint32");
+      OP_REQUIRES(
+          ctx, var_tensor_flat.size() >= PHILOX_MIN_STATE_SIZE,
+          errors::InvalidArgument(
+              "For Philox algorithm, the size of state must be at least ",
+              PHILOX_MIN_STATE_SIZE, "; got ", var_tensor_flat.size()));
+
+      OP_REQUIRES_OK(ctx, PrepareToUpdateVariable<Device, StateElementType>(
+                              ctx, var_tensor, var->copy_on_read_mode.load()));
+      var->MarkAllRowsDirty();
+      auto var_data = var_tensor_flat.data();
+      philox = GetPhiloxRandomFromMem(var_data);
+      UpdateMemWithPhiloxRandom(
+          philox, num_batches * 2 * 100 * (samples_per_batch + 3) / 4,
+          var_data);
+    }
 
     auto binomial_functor = functor::RandomBinomialFunctor<Device, T, U>();
     binomial_functor(ctx, ctx->eigen_device<Device>(), num_batches,
@@ -436,6 +436,7 @@ class AssignVariableOp : public OpKernel {
                                   return absl::OkStatus();
                                 }));
     mutex_lock ml(*variable->mu());
+    variable->MarkAllRowsDirty();
     // (variable->tensor()->dtype() == DT_INVALID && !variable->is_initialized)
     // check below is to allow an XLA specific situation wherein update can
     // happen first by the AssignVariableOp,
@@ -524,6 +525,7 @@ class AssignVariableOp<Device, Variant> : public OpKernel {
         attr);
 
     mutex_lock ml(*variable->mu());
+    variable->MarkAllRowsDirty();
     OP_REQUIRES(context, variable->tensor()->dtype() == DT_VARIANT,
                 errors::InvalidArgument(
                     "Trying to assign variable with wrong dtype. Expected ",
@@ -616,6 +618,7 @@ class AssignUpdateVariableOp : public OpKernel {
     // PrepareToUpdateVariable() for commutative operations like Op ==
     // ADD if value's refcount was 1.
     mutex_lock ml(*variable->mu());
+    variable->MarkAllRowsDirty();
     Tensor* var_tensor = variable->tensor();
     OP_REQUIRES_OK(context, ValidateAssignUpdateVariableOpShapes(
                                 var_tensor->shape(), value.shape()));
@@ -1131,13 +1134,17 @@ class ResourceScatterUpdateOp : public OpKernel {
     OP_REQUIRES_OK(c, EnsureSparseVariableAccess<Device, T>(c, v.get()));
     const bool is_non_pod_dtype =
         update_dtype == DT_STRING || update_dtype == DT_VARIANT;
+    // The updated rows are recorded before the mutex is released, see
+    // ScopedMarkVariableRowsDirty.
     if (is_non_pod_dtype || use_exclusive_lock_) {
       mutex_lock ml(*v->mu());
       DoCompute(c, v.get());
+      MarkVariableRowsDirty<Device, Index>(v.get(), c->input(1));
     } else {
       // For POD dtypes, we can safely run the update without the mutex.
       tf_shared_lock ml(*v->mu());
       DoCompute(c, v.get());
+      MarkVariableRowsDirty<Device, Index>(v.get(), c->input(1));
     }
   }
 
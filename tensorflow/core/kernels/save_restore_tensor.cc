@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/kernels/save_restore_tensor.h"
 
+#include <algorithm>
 #include <memory>
 #include <numeric>
 #include <unordered_map>
@@ -34,6 +35,8 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
+#include "tensorflow/core/util/tensor_bundle/delta_bundle.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 #include "tensorflow/core/util/tensor_slice_reader.h"
 #include "tensorflow/core/util/tensor_slice_reader_cache.h"
@@ -251,6 +254,63 @@ namespace {
 // Tensors larger than this threshold will be restored from a thread-pool.
 const int64_t kLargeShapeThreshold = 16 << 20;  // 16M
 
+// Returns the store through which restored tensors share their buffers with
+// identical tensors restored before, or nullptr if sharing is disabled.
+SharedTensorStore* GetSharedTensorStore() {
+  static SharedTensorStore* const store = []() -> SharedTensorStore* {
+    bool share_restored_tensors = false;
+    const absl::Status status =
+        ReadBoolFromEnvVar("TF_SHARE_RESTORED_TENSORS",
+                           /*default_val=*/false, &share_restored_tensors);
+    if (!status.ok()) {
+      LOG(WARNING) << status;
+      share_restored_tensors = false;
+    }
+    return share_restored_tensors ? &GlobalSharedTensorStore() : nullptr;
+  }();
+  return store;
+}
+
+// Returns whether the data files of the restored checkpoints are memory-mapped,
+// in which case aligned tensors alias the mapping instead of being read.
+bool UseMmap() {
+  static const bool use_mmap = []() {
+    bool use_mmap = false;
+    const absl::Status status = ReadBoolFromEnvVar(
+        "TF_RESTORE_USE_MMAP", /*default_val=*/false, &use_mmap);
+    if (!status.ok()) {
+      LOG(WARNING) << status;
+      use_mmap = false;
+    }
+    return use_mmap;
+  }();
+  return use_mmap;
+}
+
+// Returns the number of threads restoring tensors in parallel, or 0 to use the
+// session's intra-op parallelism.
+int64_t NumRestoreThreads() {
+  static const int64_t num_threads = []() {
+    int64_t num_threads = 0;
+    const absl::Status status = ReadInt64FromEnvVar(
+        "TF_RESTORE_NUM_THREADS", /*default_val=*/0, &num_threads);
+    if (!status.ok()) {
+      LOG(WARNING) << status;
+      num_threads = 0;
+    }
+    return num_threads;
+  }();
+  return num_threads;
+}
+
+BundleReader::Options RestoreReaderOptions(BundleCache* cache) {
+  BundleReader::Options options;
+  options.cache = cache;
+  options.shared_tensor_store = GetSharedTensorStore();
+  options.use_mmap = UseMmap();
+  return options;
+}
+
 // A restore operation for a single tensor.  Small tensors may be restored
 // directly from the op thread to improve read locality.  Large tensors can be
 // restored from a thread pool: this requires creating a separate BundleReader
@@ -285,7 +345,8 @@ struct RestoreOp {
 
   // Run this restore operation using a new BundleReader.
   void run_with_new_reader(BundleCache* cache) {
-    BundleReader reader(tsl::Env::Default(), reader_prefix, {cache, false});
+    BundleReader reader(tsl::Env::Default(), reader_prefix,
+                        RestoreReaderOptions(cache));
     if (!reader.status().ok()) {
       status = reader.status();
       return;
@@ -295,6 +356,7 @@ struct RestoreOp {
   }
 
   absl::Status run(BundleReader* reader) {
+    const int64_t reader_shared_bytes = reader->shared_bytes();
     TensorShape restored_full_shape;
     TF_RETURN_IF_ERROR(
         reader->LookupTensorShape(tensor_name, &restored_full_shape));
@@ -302,7 +364,14 @@ struct RestoreOp {
     VLOG(1) << "Restoring tensor " << idx << " : " << tensor_name << " : "
             << restored_full_shape.num_elements();
     Tensor* restored_tensor;
-    if (shape_and_slice.empty()) {
+    if (shape_and_slice.empty() && UseMmap()) {
+      // Lookup the full tensor, which may alias the mapped data file, so that
+      // no output buffer is allocated for it.
+      Tensor restored;
+      TF_RETURN_IF_ERROR(reader->Lookup(tensor_name, &restored));
+      context->set_output(idx, restored);
+      restored_tensor = context->mutable_output(idx);
+    } else if (shape_and_slice.empty()) {
       // Lookup the full tensor.
       TF_RETURN_IF_ERROR(
           context->allocate_output(idx, restored_full_shape, &restored_tensor));
@@ -345,6 +414,7 @@ struct RestoreOp {
                 << restored_tensor->NumElements();
       }
     }
+    shared_bytes = reader->shared_bytes() - reader_shared_bytes;
     VLOG(1) << "Done restoring tensor " << idx << " : " << tensor_name << " : "
             << restored_full_shape.num_elements();
     return absl::OkStatus();
@@ -358,8 +428,76 @@ struct RestoreOp {
   DataType dtype;
 
   absl::Status status;
+  // The number of restored bytes that share a buffer with a tensor restored
+  // before.
+  int64_t shared_bytes = 0;
 };
 
+// Runs `ops` in order on a single new BundleReader, so that the ops reading
+// neighbouring tensors of a shard share the reader's buffered input.
+void RunRestoreOpsWithNewReader(absl::Span<RestoreOp* const> ops,
+                                BundleCache* cache) {
+  BundleReader reader(tsl::Env::Default(), ops.front()->reader_prefix,
+                      RestoreReaderOptions(cache));
+  for (RestoreOp* op : ops) {
+    op->status = reader.status().ok() ? op->run(&reader) : reader.status();
+  }
+}
+
+// Restores the tensors of the delta bundle at `prefix`, serially, by layering
+// the deltas on top of the full bundle at the root of its chain. A slice is cut
+// out of the whole layered tensor.
+absl::Status RestoreTensorsFromDeltaBundle(OpKernelContext* context,
+                                           const string& prefix,
+                                           const Tensor& tensor_names,
+                                           const Tensor& shape_and_slices,
+                                           absl::Span<const DataType> dtypes) {
+  const auto& tensor_names_flat = tensor_names.flat<tstring>();
+  const auto& shape_and_slices_flat = shape_and_slices.flat<tstring>();
+  LayeredBundleReader reader(tsl::Env::Default(), prefix);
+  TF_RETURN_IF_ERROR(reader.status());
+  for (int i = 0; i < tensor_names_flat.size(); ++i) {
+    const string& tensor_name = tensor_names_flat(i);
+    const string& shape_and_slice = shape_and_slices_flat(i);
+    DataType original_dtype;
+    TensorShape restored_full_shape;
+    TF_RETURN_IF_ERROR(reader.LookupDtypeAndShape(
+        tensor_name, &original_dtype, &restored_full_shape));
+    if (original_dtype != dtypes[i]) {
+      return errors::InvalidArgument(
+          "tensor_name = ", tensor_name, "; expected dtype ",
+          DataTypeString(dtypes[i]), " does not equal original dtype ",
+          DataTypeString(original_dtype));
+    }
+    if (shape_and_slice.empty()) {
+      Tensor restored_tensor;
+      TF_RETURN_IF_ERROR(reader.Lookup(tensor_name, &restored_tensor));
+      context->set_output(i, restored_tensor);
+      continue;
+    }
+
+    TensorShape parsed_full_shape;
+    TensorSlice parsed_slice;
+    TensorShape parsed_slice_shape;
+    TF_RETURN_IF_ERROR(
+        checkpoint::ParseShapeAndSlice(shape_and_slice, &parsed_full_shape,
+                                       &parsed_slice, &parsed_slice_shape));
+    if (!restored_full_shape.IsSameSize(parsed_full_shape)) {
+      return errors::InvalidArgument(
+          "tensor_name = ", tensor_name, "; shape in shape_and_slice spec ",
+          parsed_full_shape.DebugString(),
+          " does not match the shape stored in checkpoint: ",
+          restored_full_shape.DebugString());
+    }
+    Tensor* restored_tensor = nullptr;
+    TF_RETURN_IF_ERROR(
+        context->allocate_output(i, parsed_slice_shape, &restored_tensor));
+    TF_RETURN_IF_ERROR(
+        reader.LookupSlice(tensor_name, parsed_slice, restored_tensor));
+  }
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 absl::Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
@@ -378,10 +516,22 @@ absl::Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
                            shape_and_slices_flat(i), prefix_string, dtypes[i]});
   }
 
+  SharedTensorStore* const shared_tensor_store = GetSharedTensorStore();
+  if (shared_tensor_store != nullptr) {
+    // Frees the tensors of the models that were unloaded since the last
+    // restore.
+    shared_tensor_store->Prune();
+  }
+
   tsl::Env* const env = tsl::Env::Default();
   BundleCache cache(env);
-  BundleReader default_reader(env, prefix_string, {&cache, false});
+  BundleReader default_reader(env, prefix_string,
+                              RestoreReaderOptions(&cache));
   TF_RETURN_IF_ERROR(default_reader.status());
+  if (!default_reader.base_prefix().empty()) {
+    return RestoreTensorsFromDeltaBundle(context, prefix_string, tensor_names,
+                                         shape_and_slices, dtypes);
+  }
 
   TF_RETURN_IF_ERROR(default_reader.SortForSequentialAccess<RestoreOp>(
       restore_ops, [](const RestoreOp& op) { return op.tensor_name; }));
@@ -417,22 +567,34 @@ absl::Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
     }
   }
 
-  if (context->session_config() != nullptr &&
-      context->session_config()->intra_op_parallelism_threads() > 0) {
+  int64_t num_restore_threads = NumRestoreThreads();
+  if (num_restore_threads <= 0 && context->session_config() != nullptr) {
+    num_restore_threads =
+        context->session_config()->intra_op_parallelism_threads();
+  }
+  if (num_restore_threads > 0) {
     // If an explicit restore parallelism is specified, we use it to run
     // run both small and large restore ops in parallel.
     auto reader_pool = std::make_unique<thread::ThreadPool>(
-        tsl::Env::Default(), "restore_tensors",
-        context->session_config()->intra_op_parallelism_threads());
+        tsl::Env::Default(), "restore_tensors", num_restore_threads);
 
     // Schedule large ops first, followed by the small.
     for (auto* op : large_restore_ops) {
       reader_pool->Schedule(
           [op, &cache]() { op->run_with_new_reader(&cache); });
     }
-    for (auto* op : small_restore_ops) {
+    // The small ops are sorted by shard and offset. Each thread restores a
+    // contiguous run of them with its own reader, instead of opening a reader
+    // per tensor.
+    const size_t num_chunks = std::min<size_t>(
+        small_restore_ops.size(), static_cast<size_t>(num_restore_threads));
+    for (size_t i = 0; i < num_chunks; ++i) {
+      const size_t begin = small_restore_ops.size() * i / num_chunks;
+      const size_t end = small_restore_ops.size() * (i + 1) / num_chunks;
+      absl::Span<RestoreOp* const> ops =
+          absl::MakeConstSpan(small_restore_ops).subspan(begin, end - begin);
       reader_pool->Schedule(
-          [op, &cache]() { op->run_with_new_reader(&cache); });
+          [ops, &cache]() { RunRestoreOpsWithNewReader(ops, &cache); });
     }
 
     // Wait for all scheduled work to finish and check the status of all
@@ -478,6 +640,21 @@ absl::Status RestoreTensorsV2(OpKernelContext* context, const Tensor& prefix,
     }
   }
 
+  if (shared_tensor_store != nullptr) {
+    int64_t shared_bytes = 0;
+    for (const RestoreOp& restore_op : restore_ops) {
+      shared_bytes += restore_op.shared_bytes;
+    }
+    const SharedTensorStore::Stats stats = shared_tensor_store->stats();
+    LOG(INFO) << "Restored " << restore_ops.size() << " tensors from "
+              << prefix_string << ", " << shared_bytes
+              << " bytes of which share buffers with previously restored "
+                 "tensors. The shared tensor store holds "
+              << stats.num_tensors << " tensors (" << stats.stored_bytes
+              << " bytes) and has saved " << stats.shared_bytes
+              << " bytes in total.";
+  }
+
   return absl::OkStatus();
 }
 
@@ -15,15 +15,26 @@ limitations under the License.
 
 // See docs in ../ops/io_ops.cc.
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
 #include <limits>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/framework/resource_var.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_util.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
 #include "tensorflow/core/kernels/checkpoint_callback_manager.h"
@@ -32,8 +43,11 @@ limitations under the License.
 #include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"  // IWYU pragma: keep
+#include "tensorflow/core/platform/notification.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/saved_tensor_slice_util.h"
+#include "tensorflow/core/util/tensor_bundle/delta_bundle.h"
 #include "tensorflow/core/util/tensor_bundle/naming.h"
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 #include "tensorflow/core/util/tensor_slice_reader.h"
@@ -90,12 +104,134 @@ void ValidateInputs(bool is_save_op, OpKernelContext* context,
   }
 }
 
+// Returns the number of data files SaveV2 writes in parallel, each on its own
+// thread.
+int64_t NumSaveThreads() {
+  static const int64_t num_threads = []() {
+    int64_t num_threads = 1;
+    const absl::Status status = ReadInt64FromEnvVar(
+        "TF_SAVE_NUM_THREADS", /*default_val=*/1, &num_threads);
+    if (!status.ok()) {
+      LOG(WARNING) << status;
+      num_threads = 1;
+    }
+    return std::max<int64_t>(num_threads, 1);
+  }();
+  return num_threads;
+}
+
+// The checkpoints that SaveV2 writes in the background, by prefix. A save is
+// tracked until its status is reported by WaitFor() or WaitForAll(), so that
+// a failed save is reported to the first op waiting for it.
+class PendingSaves {
+ public:
+  static PendingSaves& Global() {
+    static PendingSaves* const pending_saves = []() {
+      // The saves still pending at exit are completed rather than lost.
+      std::atexit([]() {
+        const absl::Status status = Global().WaitForAll();
+        if (!status.ok()) {
+          LOG(ERROR) << "Failed to save checkpoints at exit: " << status;
+        }
+      });
+      return new PendingSaves();
+    }();
+    return *pending_saves;
+  }
+
+  // Writes the checkpoint at `prefix` with `save` on a thread of `env`. There
+  // must be no pending save of `prefix`.
+  void Schedule(Env* env, const string& prefix,
+                std::function<absl::Status()> save) {
+    auto pending = std::make_shared<PendingSave>();
+    {
+      absl::MutexLock l(&mu_);
+      pending_saves_[prefix] = pending;
+    }
+    env->SchedClosure([prefix, pending, save = std::move(save)]() {
+      pending->status = save();
+      if (!pending->status.ok()) {
+        LOG(ERROR) << "Failed to save checkpoint " << prefix << ": "
+                   << pending->status;
+      }
+      pending->done.Notify();
+    });
+  }
+
+  // Waits for the pending save of `prefix`, if any, and returns its status.
+  absl::Status WaitFor(const string& prefix) {
+    std::shared_ptr<PendingSave> pending;
+    {
+      absl::MutexLock l(&mu_);
+      auto it = pending_saves_.find(prefix);
+      if (it == pending_saves_.end()) return absl::OkStatus();
+      pending = it->second;
+    }
+    pending->done.WaitForNotification();
+    Erase(prefix, pending.get());
+    return pending->status;
+  }
+
+  // Waits for all the pending saves and returns the first error among them.
+  absl::Status WaitForAll() {
+    std::vector<string> prefixes;
+    {
+      absl::MutexLock l(&mu_);
+      for (const auto& it : pending_saves_) prefixes.push_back(it.first);
+    }
+    absl::Status status;
+    for (const string& prefix : prefixes) status.Update(WaitFor(prefix));
+    return status;
+  }
+
+ private:
+  struct PendingSave {
+    Notification done;
+    absl::Status status;
+  };
+
+  void Erase(const string& prefix, const PendingSave* pending) {
+    absl::MutexLock l(&mu_);
+    auto it = pending_saves_.find(prefix);
+    if (it != pending_saves_.end() && it->second.get() == pending) {
+      pending_saves_.erase(it);
+    }
+  }
+
+  absl::Mutex mu_;
+  absl::flat_hash_map<string, std::shared_ptr<PendingSave>> pending_saves_
+      TF_GUARDED_BY(mu_);
+};
+
+// Returns the manager of the checkpoint callbacks of `context`, or nullptr if
+// it has no resource manager. The caller owns a reference to it.
+absl::Status GetCheckpointCallbackManager(
+    OpKernelContext* context,
+    checkpoint::CheckpointCallbackManager** checkpoint_callback_manager) {
+  *checkpoint_callback_manager = nullptr;
+  ResourceMgr* resource_manager = context->resource_manager();
+  if (resource_manager == nullptr) return absl::OkStatus();
+  return resource_manager
+      ->LookupOrCreate<checkpoint::CheckpointCallbackManager>(
+          resource_manager->default_container(),
+          std::string(checkpoint::kCheckpointCallbackManagerResourceName),
+          checkpoint_callback_manager,
+          [](checkpoint::CheckpointCallbackManager** out) {
+            *out = new checkpoint::CheckpointCallbackManager();
+            return absl::OkStatus();
+          });
+}
+
 }  // namespace
 
 // Saves a list of named tensors using the tensor bundle library.
 class SaveV2 : public OpKernel {
  public:
-  explicit SaveV2(OpKernelConstruction* context) : OpKernel(context) {}
+  explicit SaveV2(OpKernelConstruction* context) : OpKernel(context) {
+    if (context->HasAttr("async_save")) {
+      OP_REQUIRES_OK(context, context->GetAttr("async_save", &async_save_));
+    }
+  }
 
   void Compute(OpKernelContext* context) override {
     const Tensor& prefix = context->input(0);
@@ -111,34 +247,95 @@ class SaveV2 : public OpKernel {
     const auto& tensor_names_flat = tensor_names.flat<tstring>();
     const auto& shape_and_slices_flat = shape_and_slices.flat<tstring>();
 
-    BundleWriter writer(Env::Default(), prefix_string);
-    OP_REQUIRES_OK(context, writer.status());
-    VLOG(1) << "BundleWriter, prefix_string: " << prefix_string;
-
+    std::vector<SavedTensor> saved_tensors(num_tensors);
     for (int i = 0; i < num_tensors; ++i) {
-      const string& tensor_name = tensor_names_flat(i);
-      const Tensor& tensor = context->input(i + kFixedInputs);
-      VLOG(2) << "Starting save of " << tensor_name;
+      SavedTensor& saved = saved_tensors[i];
+      saved.name = tensor_names_flat(i);
+      // An asynchronous save snapshots its inputs. They are copied since
+      // reference variables, unlike resource variables, are updated in place
+      // while their values are referenced, and the kernel cannot tell them
+      // apart.
+      saved.tensor = async_save_
+                         ? tensor::DeepCopy(context->input(i + kFixedInputs))
+                         : context->input(i + kFixedInputs);
 
       if (!shape_and_slices_flat(i).empty()) {
         const string& shape_spec = shape_and_slices_flat(i);
-        TensorShape shape;
-        TensorSlice slice(tensor.dims());
+        saved.slice = TensorSlice(saved.tensor.dims());
         TensorShape slice_shape;
 
         OP_REQUIRES_OK(context, checkpoint::ParseShapeAndSlice(
-                                    shape_spec, &shape, &slice, &slice_shape));
+                                    shape_spec, &saved.shape, &saved.slice,
+                                    &slice_shape));
+        const Tensor& tensor = saved.tensor;
         OP_REQUIRES(context, slice_shape.IsSameSize(tensor.shape()),
                     errors::InvalidArgument("Slice in shape_and_slice "
                                             "specification does not match the "
                                             "shape of the tensor to  save: ",
                                             shape_spec, ", tensor: ",
                                             tensor.shape().DebugString()));
+        saved.is_slice = true;
+      }
+    }
+
+    // A previous save to the same prefix must not be writing the same files.
+    OP_REQUIRES_OK(context, PendingSaves::Global().WaitFor(prefix_string));
+    Env* env = context->env();
+    if (!async_save_) {
+      OP_REQUIRES_OK(context, WriteBundle(env, prefix_string, saved_tensors));
+    }
+
+    checkpoint::CheckpointCallbackManager* checkpoint_callback_manager;
+    OP_REQUIRES_OK(context, GetCheckpointCallbackManager(
+                                context, &checkpoint_callback_manager));
+    if (async_save_) {
+      // The callbacks run once the checkpoint is written.
+      PendingSaves::Global().Schedule(
+          env, prefix_string,
+          [env, prefix_string, saved_tensors = std::move(saved_tensors),
+           checkpoint_callback_manager]() {
+            const absl::Status status =
+                WriteBundle(env, prefix_string, saved_tensors);
+            if (checkpoint_callback_manager != nullptr) {
+              if (status.ok()) checkpoint_callback_manager->Save(prefix_string);
+              checkpoint_callback_manager->Unref();
+            }
+            return status;
+          });
+    } else if (checkpoint_callback_manager != nullptr) {
+      checkpoint_callback_manager->Save(prefix_string);
+      checkpoint_callback_manager->Unref();
+    }
+  }
 
-        OP_REQUIRES_OK(context,
-                       writer.AddSlice(tensor_name, shape, slice, tensor));
+ private:
+  // A tensor to save, or a slice of one if `is_slice`.
+  struct SavedTensor {
+    string name;
+    Tensor tensor;
+    bool is_slice = false;
+    TensorShape shape;
+    TensorSlice slice;
+  };
+
+  static absl::Status WriteBundle(Env* env, const string& prefix_string,
+                                  const std::vector<SavedTensor>& tensors) {
+    BundleWriter::Options options;
+    options.num_data_shards = static_cast<int>(std::min<int64_t>(
+        NumSaveThreads(), std::max<int64_t>(tensors.size(), 1)));
+    BundleWriter writer(env, prefix_string, options);
+    TF_RETURN_IF_ERROR(writer.status());
+    VLOG(1) << "BundleWriter, prefix_string: " << prefix_string;
+
+    for (const SavedTensor& saved : tensors) {
+      const Tensor& tensor = saved.tensor;
+      VLOG(2) << "Starting save of " << saved.name;
+
+      if (saved.is_slice) {
+        TF_RETURN_IF_ERROR(
+            writer.AddSlice(saved.name, saved.shape, saved.slice, tensor));
       } else {
-        OP_REQUIRES_OK(context, writer.Add(tensor_name, tensor));
+        TF_RETURN_IF_ERROR(writer.Add(saved.name, tensor));
       }
 
       if (VLOG_IS_ON(5)) {
@@ -158,30 +355,15 @@ class SaveV2 : public OpKernel {
         }
       }
 
-      VLOG(2) << "Done save of " << tensor_name;
+      VLOG(2) << "Done save of " << saved.name;
     }
-    OP_REQUIRES_OK(context, writer.Finish());
+    TF_RETURN_IF_ERROR(writer.Finish());
     VLOG(1) << "Done BundleWriter, prefix_string: " << prefix_string;
-
-    ResourceMgr* resource_manager = context->resource_manager();
-    if (resource_manager != nullptr) {
-      checkpoint::CheckpointCallbackManager* checkpoint_callback_manager;
-      OP_REQUIRES_OK(
-          context,
-          resource_manager
-              ->LookupOrCreate<checkpoint::CheckpointCallbackManager>(
-                  resource_manager->default_container(),
-                  std::string(
-                      checkpoint::kCheckpointCallbackManagerResourceName),
-                  &checkpoint_callback_manager,
-                  [](checkpoint::CheckpointCallbackManager** out) {
-                    *out = new checkpoint::CheckpointCallbackManager();
-                    return absl::OkStatus();
-                  }));
-      checkpoint_callback_manager->Save(prefix_string);
-      checkpoint_callback_manager->Unref();
-    }
+    return absl::OkStatus();
   }
+
+  // Whether the checkpoint is written in the background.
+  bool async_save_ = false;
 };
 REGISTER_KERNEL_BUILDER(Name("SaveV2").Device(DEVICE_CPU), SaveV2);
 
@@ -207,6 +389,7 @@ class RestoreV2 : public OpKernel {
     const string& prefix_string = prefix.scalar<tstring>()();
 
     VLOG(2) << "Started Restore at prefix: " << prefix_string;
+    OP_REQUIRES_OK(context, PendingSaves::Global().WaitFor(prefix_string));
     // Intention: we plan to use the RestoreV2 op as a backward-compatible
     // reader as we upgrade to the V2 format.  This allows transparent upgrade.
     // We here attempt to read a V1 checkpoint, if "prefix_string" does not
@@ -287,6 +470,9 @@ class MergeV2Checkpoints : public OpKernel {
         absl::Span<const tstring>(checkpoint_prefixes.flat<tstring>());
     Env* env = Env::Default();
     const string& merged_prefix = destination_prefix.scalar<tstring>()();
+    for (const tstring& input_prefix : input_prefixes) {
+      OP_REQUIRES_OK(context, PendingSaves::Global().WaitFor(input_prefix));
+    }
     OP_REQUIRES_OK(context,
                    tensorflow::MergeBundles(env, input_prefixes, merged_prefix,
                                             allow_missing_files_));
@@ -315,4 +501,199 @@ class MergeV2Checkpoints : public OpKernel {
 REGISTER_KERNEL_BUILDER(Name("MergeV2Checkpoints").Device(DEVICE_CPU),
                         MergeV2Checkpoints);
 
+// Saves resource variables, in full if `base_prefix` is empty, or else as a
+// delta bundle on top of `base_prefix` holding only the rows updated since the
+// previous save of each variable. Follows the protocol of
+// Var::TakeDirtyRowRanges(): each variable is locked exclusively while its
+// dirty rows are taken and copied, so that no update is missed.
+class SaveVariableDeltas : public OpKernel {
+ public:
+  explicit SaveVariableDeltas(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    const int kFixedInputs = 3;  // Prefix, base prefix, tensor names.
+    const Tensor& prefix = context->input(0);
+    const Tensor& base_prefix = context->input(1);
+    const Tensor& tensor_names = context->input(2);
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsScalar(prefix.shape()) &&
+                    TensorShapeUtils::IsScalar(base_prefix.shape()),
+                errors::InvalidArgument(
+                    "Inputs prefix and base_prefix should be scalars, got ",
+                    prefix.shape().DebugString(), " and ",
+                    base_prefix.shape().DebugString(), " instead."));
+    const int num_vars = context->num_inputs() - kFixedInputs;
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsVector(tensor_names.shape()) &&
+                    tensor_names.NumElements() == num_vars,
+                errors::InvalidArgument(
+                    "Input tensor_names should be a 1-D tensor of ", num_vars,
+                    " names, got ", tensor_names.shape().DebugString(),
+                    " instead."));
+    const string& prefix_string = prefix.scalar<tstring>()();
+    const string& base_prefix_string = base_prefix.scalar<tstring>()();
+    const auto& tensor_names_flat = tensor_names.flat<tstring>();
+
+    std::vector<core::RefCountPtr<Var>> vars(num_vars);
+    for (int i = 0; i < num_vars; ++i) {
+      OP_REQUIRES_OK(context,
+                     LookupResource(context,
+                                    HandleFromInput(context, i + kFixedInputs),
+                                    &vars[i]));
+    }
+
+    std::vector<SavedVariable> saved(num_vars);
+    absl::Status status;
+    for (int i = 0; i < num_vars && status.ok(); ++i) {
+      saved[i].name = tensor_names_flat(i);
+      status = Snapshot(vars[i].get(), base_prefix_string.empty(), &saved[i]);
+    }
+    if (status.ok()) {
+      // A previous save to the same prefix must not be writing the same files.
+      status = PendingSaves::Global().WaitFor(prefix_string);
+    }
+    if (status.ok()) {
+      status =
+          WriteBundle(context->env(), prefix_string, base_prefix_string, saved);
+    }
+    if (!status.ok()) {
+      // The rows taken are in no bundle, so the next delta has to save them.
+      for (const auto& var : vars) {
+        mutex_lock l(*var->mu());
+        var->MarkAllRowsDirty();
+      }
+    }
+    OP_REQUIRES_OK(context, status);
+  }
+
+ private:
+  // A variable to save: in full if `full` is initialized, or else the rows
+  // `ranges` of it, gathered into `rows`.
+  struct SavedVariable {
+    string name;
+    TensorShape shape;
+    Tensor full;
+    RowRanges ranges;
+    Tensor rows;
+  };
+
+  static absl::Status Snapshot(Var* var, bool save_in_full,
+                               SavedVariable* saved) {
+    mutex_lock l(*var->mu());
+    if (!var->is_initialized) {
+      return errors::FailedPrecondition("Cannot save uninitialized variable ",
+                                        saved->name);
+    }
+    const Tensor& val = *var->tensor();
+    saved->shape = val.shape();
+    if (save_in_full || !var->dirty_row_tracking_enabled()) {
+      var->EnableDirtyRowTracking();
+      return SnapshotInFull(var, saved);
+    }
+    const int64_t num_rows = val.dims() > 0 ? val.dim_size(0) : 1;
+    saved->ranges = var->TakeDirtyRowRanges(num_rows);
+    if (saved->ranges.empty()) return absl::OkStatus();
+    const bool all_rows =
+        saved->ranges.size() == 1 &&
+        saved->ranges[0] == std::make_pair(int64_t{0}, num_rows);
+    if (val.dims() == 0 || all_rows ||
+        !(DataTypeCanUseMemcpy(val.dtype()) || val.dtype() == DT_STRING)) {
+      saved->ranges.clear();
+      return SnapshotInFull(var, saved);
+    }
+    return GatherTensorRows(val, saved->ranges, &saved->rows);
+  }
+
+  // REQUIRES: *var->mu() held exclusively.
+  static absl::Status SnapshotInFull(Var* var, SavedVariable* saved) {
+    // Sparse updates write in place in copy-on-read mode; otherwise, updates
+    // copy the tensor while it is referenced here.
+    saved->full = var->copy_on_read_mode.load()
+                      ? tensor::DeepCopy(*var->tensor())
+                      : *var->tensor();
+    return absl::OkStatus();
+  }
+
+  static absl::Status WriteBundle(Env* env, const string& prefix_string,
+                                  const string& base_prefix_string,
+                                  const std::vector<SavedVariable>& saved) {
+    BundleWriter::Options options;
+    options.base_prefix = base_prefix_string;
+    BundleWriter writer(env, prefix_string, options);
+    TF_RETURN_IF_ERROR(writer.status());
+    for (const SavedVariable& var : saved) {
+      if (var.full.IsInitialized()) {
+        TF_RETURN_IF_ERROR(writer.Add(var.name, var.full));
+      } else if (!var.ranges.empty()) {
+        TF_RETURN_IF_ERROR(AddGatheredTensorRows(&writer, var.name, var.shape,
+                                                 var.rows, var.ranges));
+      }
+    }
+    return writer.Finish();
+  }
+};
+REGISTER_KERNEL_BUILDER(Name("SaveVariableDeltas").Device(DEVICE_CPU),
+                        SaveVariableDeltas);
+
+// Rewrites a delta checkpoint, layered on top of its chain of bases, as a full
+// checkpoint.
+class CompactDeltaCheckpoints : public OpKernel {
+ public:
+  explicit CompactDeltaCheckpoints(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& prefix = context->input(0);
+    const Tensor& compacted_prefix = context->input(1);
+    OP_REQUIRES(context,
+                TensorShapeUtils::IsScalar(prefix.shape()) &&
+                    TensorShapeUtils::IsScalar(compacted_prefix.shape()),
+                errors::InvalidArgument(
+                    "Inputs prefix and compacted_prefix should be scalars, "
+                    "got ",
+                    prefix.shape().DebugString(), " and ",
+                    compacted_prefix.shape().DebugString(), " instead."));
+    const string& prefix_string = prefix.scalar<tstring>()();
+    const string& compacted_prefix_string =
+        compacted_prefix.scalar<tstring>()();
+    OP_REQUIRES_OK(context, PendingSaves::Global().WaitFor(prefix_string));
+    OP_REQUIRES_OK(context,
+                   PendingSaves::Global().WaitFor(compacted_prefix_string));
+    OP_REQUIRES_OK(context,
+                   CompactDeltaBundles(context->env(), prefix_string,
+                                       compacted_prefix_string));
+  }
+};
+REGISTER_KERNEL_BUILDER(Name("CompactDeltaCheckpoints").Device(DEVICE_CPU),
+                        CompactDeltaCheckpoints);
+
+// Waits for the asynchronous saves of the given prefixes, or of all prefixes
+// if none is given, and reports their errors.
+class WaitForCheckpointSaves : public OpKernel {
+ public:
+  explicit WaitForCheckpointSaves(OpKernelConstruction* context)
+      : OpKernel(context) {}
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& prefixes = context->input(0);
+    OP_REQUIRES(context, TensorShapeUtils::IsVector(prefixes.shape()),
+                errors::InvalidArgument(
+                    "Input prefixes should be a 1-D tensor, got ",
+                    prefixes.shape().DebugString(), " instead."));
+    if (prefixes.NumElements() == 0) {
+      OP_REQUIRES_OK(context, PendingSaves::Global().WaitForAll());
+      return;
+    }
+    const auto& prefixes_flat = prefixes.flat<tstring>();
+    absl::Status status;
+    for (int64_t i = 0; i < prefixes.NumElements(); ++i) {
+      status.Update(PendingSaves::Global().WaitFor(prefixes_flat(i)));
+    }
+    OP_REQUIRES_OK(context, status);
+  }
+};
+REGISTER_KERNEL_BUILDER(Name("WaitForCheckpointSaves").Device(DEVICE_CPU),
+                        WaitForCheckpointSaves);
+
 }  // namespace tensorflow
@@ -0,0 +1,103 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <string>
+#include <vector>
+
+#include "tensorflow/cc/client/client_session.h"
+#include "tensorflow/cc/framework/ops.h"
+#include "tensorflow/cc/framework/scope.h"
+#include "tensorflow/cc/ops/const_op.h"
+#include "tensorflow/cc/ops/io_ops.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/util/tensor_bundle/naming.h"
+
+namespace tensorflow {
+namespace {
+
+class SaveV2AsyncOpTest : public ::testing::Test {
+ protected:
+  SaveV2AsyncOpTest() : root_(Scope::NewRootScope()), session_(root_) {}
+
+  absl::Status Run(const Operation& op) {
+    return session_.Run({}, {}, {op}, nullptr);
+  }
+
+  absl::Status SaveAsync(const string& prefix, const Tensor& tensor) {
+    return Run(ops::SaveV2(root_, ops::Const(root_, prefix),
+                           ops::Const(root_, {"t"}), ops::Const(root_, {""}),
+                           {ops::Const(root_, tensor)},
+                           ops::SaveV2::AsyncSave(true))
+                   .operation);
+  }
+
+  absl::Status Wait(const string& prefix) {
+    return Run(ops::WaitForCheckpointSaves(
+                   root_, ops::Const(root_, test::AsTensor<tstring>({prefix})))
+                   .operation);
+  }
+
+  Scope root_;
+  ClientSession session_;
+};
+
+TEST_F(SaveV2AsyncOpTest, WritesInBackgroundThenRestores) {
+  const string prefix = io::JoinPath(testing::TmpDir(), "async_save");
+  const Tensor tensor =
+      test::AsTensor<float>({1.f, 2.f, 3.f, 4.f}, TensorShape({2, 2}));
+  TF_ASSERT_OK(SaveAsync(prefix, tensor));
+  TF_ASSERT_OK(Wait(prefix));
+  // The checkpoint is complete once waited for.
+  TF_EXPECT_OK(Env::Default()->FileExists(MetaFilename(prefix)));
+
+  auto restore = ops::RestoreV2(root_, ops::Const(root_, prefix),
+                                ops::Const(root_, {"t"}),
+                                ops::Const(root_, {""}), {DT_FLOAT});
+  std::vector<Tensor> outputs;
+  TF_ASSERT_OK(session_.Run({restore.tensors[0]}, &outputs));
+  test::ExpectTensorEqual<float>(outputs[0], tensor);
+}
+
+TEST_F(SaveV2AsyncOpTest, ReportsWriteErrorsOnceWaitedFor) {
+  // The checkpoint can't be written below a regular file.
+  const string file = io::JoinPath(testing::TmpDir(), "async_save_file");
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), file, "not a directory"));
+  const string prefix = io::JoinPath(file, "ckpt");
+
+  // The save returns before it is written.
+  TF_ASSERT_OK(SaveAsync(prefix, test::AsScalar<float>(1.f)));
+  EXPECT_FALSE(Wait(prefix).ok());
+  // The error is reported to the first op waiting only.
+  TF_EXPECT_OK(Wait(prefix));
+}
+
+TEST_F(SaveV2AsyncOpTest, WaitsForAllSaves) {
+  const string prefix = io::JoinPath(testing::TmpDir(), "async_save_all");
+  TF_ASSERT_OK(SaveAsync(prefix, test::AsScalar<float>(1.f)));
+  // No prefixes waits for all.
+  TF_ASSERT_OK(Run(ops::WaitForCheckpointSaves(
+                       root_, ops::Const(root_, Tensor(DT_STRING, {0})))
+                       .operation));
+  TF_EXPECT_OK(Env::Default()->FileExists(MetaFilename(prefix)));
+}
+
+}  // namespace
+}  // namespace tensorflow
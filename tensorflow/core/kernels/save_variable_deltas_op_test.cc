@@ -0,0 +1,150 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <string>
+#include <vector>
+
+#include "tensorflow/cc/client/client_session.h"
+#include "tensorflow/cc/framework/ops.h"
+#include "tensorflow/cc/framework/scope.h"
+#include "tensorflow/cc/ops/const_op.h"
+#include "tensorflow/cc/ops/io_ops.h"
+#include "tensorflow/cc/ops/resource_variable_ops.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_slice.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
+
+namespace tensorflow {
+namespace {
+
+class SaveVariableDeltasOpTest : public ::testing::Test {
+ protected:
+  SaveVariableDeltasOpTest()
+      : root_(Scope::NewRootScope()),
+        var_(ops::VarHandleOp(root_, DT_FLOAT, TensorShape({4, 2}))),
+        session_(root_) {}
+
+  void Run(const Operation& op) {
+    TF_ASSERT_OK(session_.Run({}, {}, {op}, nullptr));
+  }
+
+  void Save(const string& prefix, const string& base_prefix) {
+    Run(ops::SaveVariableDeltas(root_, ops::Const(root_, prefix),
+                                ops::Const(root_, base_prefix),
+                                ops::Const(root_, {"var"}), {var_})
+            .operation);
+  }
+
+  Tensor Restore(const string& prefix, const string& shape_and_slice = "") {
+    auto restore = ops::RestoreV2(root_, ops::Const(root_, prefix),
+                                  ops::Const(root_, {"var"}),
+                                  ops::Const(root_, {shape_and_slice}),
+                                  {DT_FLOAT});
+    std::vector<Tensor> outputs;
+    TF_CHECK_OK(session_.Run({restore.tensors[0]}, &outputs));
+    return outputs[0];
+  }
+
+  // Returns the rows of "var" stored by the bundle at `prefix`.
+  std::vector<TensorSlice> StoredSlices(const string& prefix) {
+    BundleReader reader(Env::Default(), prefix);
+    TF_CHECK_OK(reader.status());
+    std::vector<TensorSlice> slices;
+    if (reader.Contains("var")) {
+      TF_CHECK_OK(reader.LookupTensorSlices("var", &slices));
+    }
+    return slices;
+  }
+
+  Scope root_;
+  Output var_;
+  ClientSession session_;
+};
+
+TEST_F(SaveVariableDeltasOpTest, SaveDeltasThenRestore) {
+  const string dir = testing::TmpDir();
+  const string full_prefix = io::JoinPath(dir, "deltas_full");
+  const string delta_prefix = io::JoinPath(dir, "deltas_1");
+  const string empty_delta_prefix = io::JoinPath(dir, "deltas_2");
+  const string compacted_prefix = io::JoinPath(dir, "deltas_compacted");
+
+  Run(ops::AssignVariableOp(
+      root_, var_,
+      ops::Const(root_, {{0.f, 1.f}, {2.f, 3.f}, {4.f, 5.f}, {6.f, 7.f}})));
+  Save(full_prefix, "");
+
+  Run(ops::ResourceScatterUpdate(root_, var_, ops::Const(root_, {2}),
+                                 ops::Const(root_, {{10.f, 11.f}})));
+  Save(delta_prefix, full_prefix);
+  // The delta stores only the updated row.
+  const std::vector<TensorSlice> slices = StoredSlices(delta_prefix);
+  ASSERT_EQ(slices.size(), 1);
+  EXPECT_EQ(slices[0].start(0), 2);
+  EXPECT_EQ(slices[0].length(0), 1);
+
+  // Nothing changed since the previous save.
+  Save(empty_delta_prefix, delta_prefix);
+  EXPECT_TRUE(StoredSlices(empty_delta_prefix).empty());
+
+  // Updates after the save are not in the checkpoint.
+  Run(ops::ResourceScatterUpdate(root_, var_, ops::Const(root_, {0}),
+                                 ops::Const(root_, {{20.f, 21.f}})));
+
+  const Tensor expected = test::AsTensor<float>(
+      {0.f, 1.f, 2.f, 3.f, 10.f, 11.f, 6.f, 7.f}, TensorShape({4, 2}));
+  test::ExpectTensorEqual<float>(Restore(empty_delta_prefix), expected);
+  // Slices are cut out of the layered tensor.
+  test::ExpectTensorEqual<float>(
+      Restore(empty_delta_prefix, "4 2 1,2:-"),
+      test::AsTensor<float>({2.f, 3.f, 10.f, 11.f}, TensorShape({2, 2})));
+
+  Run(ops::CompactDeltaCheckpoints(root_,
+                                   ops::Const(root_, empty_delta_prefix),
+                                   ops::Const(root_, compacted_prefix))
+          .operation);
+  BundleReader reader(Env::Default(), compacted_prefix);
+  TF_ASSERT_OK(reader.status());
+  EXPECT_TRUE(reader.base_prefix().empty());
+  test::ExpectTensorEqual<float>(Restore(compacted_prefix), expected);
+}
+
+TEST_F(SaveVariableDeltasOpTest, DenseUpdateSavesVariableInFull) {
+  const string dir = testing::TmpDir();
+  const string full_prefix = io::JoinPath(dir, "dense_full");
+  const string delta_prefix = io::JoinPath(dir, "dense_delta");
+
+  Run(ops::AssignVariableOp(root_, var_, ops::Const(root_, 1.f, {4, 2})));
+  Save(full_prefix, "");
+  Run(ops::AssignAddVariableOp(root_, var_, ops::Const(root_, 1.f, {4, 2})));
+  Save(delta_prefix, full_prefix);
+
+  // The variable is saved in full, rather than as rows.
+  EXPECT_TRUE(StoredSlices(delta_prefix).empty());
+  BundleReader reader(Env::Default(), delta_prefix);
+  TF_ASSERT_OK(reader.status());
+  EXPECT_TRUE(reader.Contains("var"));
+  test::ExpectTensorEqual<float>(
+      Restore(delta_prefix),
+      test::AsTensor<float>(std::vector<float>(8, 2.f), TensorShape({4, 2})));
+}
+
+}  // namespace
+}  // namespace tensorflow
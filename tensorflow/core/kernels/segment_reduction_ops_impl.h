@@ -51,6 +51,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/bfloat16.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/util/determinism.h"
 #include "tensorflow/core/util/util.h"
 
@@ -85,6 +86,44 @@ absl::Status ValidateSparseSegmentReduction(OpKernelContext* context,
                                             const Tensor& indices,
                                             const Tensor& segment_ids,
                                             bool has_num_segments);
+
+// Splits the non-empty, sorted `segment_vec` into runs of equal ids. Run `s`
+// covers positions [(*segment_starts)[s], (*segment_starts)[s + 1]) and is
+// reduced into output row (*segment_rows)[s]. Fails if the ids decrease or
+// fall outside [0, output_rows).
+template <typename SegmentId>
+absl::Status FindSortedSegments(
+    typename TTypes<SegmentId>::ConstVec segment_vec, int64_t output_rows,
+    std::vector<int64_t>* segment_starts,
+    std::vector<SegmentId>* segment_rows) {
+  const int64_t num_indices = segment_vec.size();
+  segment_starts->assign(1, 0);
+  segment_rows->clear();
+  SegmentId out_index = SubtleMustCopy(segment_vec(0));
+  for (int64_t end = 1; end <= num_indices; ++end) {
+    // We initialize next_index to 0 to avoid "warning: 'next_index' may be
+    // used uninitialized in this function" in the Mac build (since the
+    // compiler isn't smart enough to realize the code is safe).
+    SegmentId next_index = 0;
+    if (end < num_indices) {
+      next_index = SubtleMustCopy(segment_vec(end));
+      if (out_index == next_index) continue;
+      // We have a new segment here.  Verify that the segment ids are growing.
+      if (out_index >= next_index) {
+        return errors::InvalidArgument("segment ids are not increasing");
+      }
+    }
+    if (!FastBoundsCheck(out_index, output_rows)) {
+      return errors::InvalidArgument(
+          "Segment id ", out_index, " out of range [0, ", output_rows,
+          "), possibly because 'segment_ids' input is not sorted.");
+    }
+    segment_rows->push_back(out_index);
+    segment_starts->push_back(end);
+    out_index = next_index;
+  }
+  return absl::OkStatus();
+}
 }  // namespace internal
 
 // This operator handles reducing segments along the first dimension.
@@ -134,81 +173,75 @@ class SegmentReductionOp : public OpKernel {
                 errors::InvalidArgument("segment ids must be >= 0"));
     auto output_flat = output->flat_outer_dims<T>();
 
-    Eigen::IndexList<Eigen::type2index<0> > dims_to_reduce;
-    Index start = 0, end = 1;
-
-    Index uninitialized_index = 0;  // Index from which the output is not set.
-    Index out_index = internal::SubtleMustCopy(segment_vec(start));
-
-    // TODO(agarwal): if this loop becomes a bottleneck, consider sharding it
-    // across threads.
-    Eigen::DSizes<Eigen::DenseIndex, 1> out_slice_shape(num_col);
-    while (end <= num_indices) {
-      // We initialize next_index to 0 to avoid "warning: 'next_index' may be
-      // used uninitialized in this function" in the Mac build (since the
-      // compiler isn't smart enough to realize the code is safe).
-      Index next_index = 0;
-      if (end < num_indices) {
-        next_index = internal::SubtleMustCopy(segment_vec(end));
-        if (out_index == next_index) {
-          ++end;
-          continue;
-        }
-        // We have a new segment here.  Verify that the segment ids are growing.
-        OP_REQUIRES(context, out_index < next_index,
-                    errors::InvalidArgument("segment ids are not increasing"));
-      }
-
-      // Process segment [start, end)
-      const T* in_slice_ptr = &input_flat(start, 0);
-      typedef Eigen::TensorMap<Eigen::Tensor<T, 1, Eigen::RowMajor>,
-                               Eigen::Unaligned>
-          OutT;
-
-      OP_REQUIRES(
-          context, FastBoundsCheck(out_index, output_rows),
-          errors::InvalidArgument(
-              "Segment id ", out_index, " out of range [0, ", output_rows,
-              "), possibly because 'segment_ids' input is not sorted."));
-
-      // If there is a gap between two indices, we need to set that gap to the
-      // default value.
-      if (out_index > uninitialized_index) {
-        Eigen::DSizes<Eigen::DenseIndex, 2> gap_slice_shape(
-            out_index - uninitialized_index, num_col);
-        Eigen::TensorMap<Eigen::Tensor<T, 2, Eigen::RowMajor>, Eigen::Unaligned>
-            gap_slice(&output_flat(uninitialized_index, 0), gap_slice_shape);
-        gap_slice.setConstant(T(default_value));
-      }
-
-      T* out_slice_ptr = &output_flat(out_index, 0);
-      OutT out_slice(out_slice_ptr, out_slice_shape);
-      // We don't use out_slice.device(context->eigen_device<Device>)
-      // because these pieces of work are likely to be very small and
-      // the context switching overhead dwarfs any benefit we get from
-      // using another thread to do this work.
-      if (start == end - 1) {
-        typedef Eigen::TensorMap<Eigen::Tensor<const T, 1, Eigen::RowMajor>,
-                                 Eigen::Unaligned>
-            InT;
-        InT in_slice(in_slice_ptr, out_slice_shape);
-        out_slice = in_slice;
-      } else {
-        Eigen::DSizes<Eigen::DenseIndex, 2> in_slice_shape(end - start,
-                                                           num_col);
-        typedef Eigen::TensorMap<Eigen::Tensor<const T, 2, Eigen::RowMajor>,
+    // Validate all the ids first, so that the segments can then be reduced
+    // independently of each other.
+    std::vector<int64_t> segment_starts;
+    std::vector<Index> segment_rows;
+    OP_REQUIRES_OK(context, internal::FindSortedSegments<Index>(
+                                segment_vec, output_rows, &segment_starts,
+                                &segment_rows));
+    const int64_t num_segments = segment_rows.size();
+
+    auto reduce_segments = [&](int64_t first, int64_t last) {
+      Eigen::IndexList<Eigen::type2index<0> > dims_to_reduce;
+      Eigen::DSizes<Eigen::DenseIndex, 1> out_slice_shape(num_col);
+      for (int64_t s = first; s < last; ++s) {
+        const int64_t start = segment_starts[s];
+        const int64_t end = segment_starts[s + 1];
+        const Index out_index = segment_rows[s];
+        // Index from which the output is not set by the previous segment.
+        const Index uninitialized_index = s == 0 ? 0 : segment_rows[s - 1] + 1;
+
+        // Process segment [start, end)
+        const T* in_slice_ptr = &input_flat(start, 0);
+        typedef Eigen::TensorMap<Eigen::Tensor<T, 1, Eigen::RowMajor>,
                                  Eigen::Unaligned>
-            InT;
-        InT in_slice(in_slice_ptr, in_slice_shape);
+            OutT;
+
+        // If there is a gap between two indices, we need to set that gap to
+        // the default value.
+        if (out_index > uninitialized_index) {
+          Eigen::DSizes<Eigen::DenseIndex, 2> gap_slice_shape(
+              out_index - uninitialized_index, num_col);
+          Eigen::TensorMap<Eigen::Tensor<T, 2, Eigen::RowMajor>,
+                           Eigen::Unaligned>
+              gap_slice(&output_flat(uninitialized_index, 0), gap_slice_shape);
+          gap_slice.setConstant(T(default_value));
+        }
 
-        out_slice = in_slice.reduce(dims_to_reduce, Reducer());
+        T* out_slice_ptr = &output_flat(out_index, 0);
+        OutT out_slice(out_slice_ptr, out_slice_shape);
+        // We don't use out_slice.device(context->eigen_device<Device>)
+        // because these pieces of work are likely to be very small and
+        // the context switching overhead dwarfs any benefit we get from
+        // using another thread to do this work. Instead, whole segments are
+        // distributed over the threads below.
+        if (start == end - 1) {
+          typedef Eigen::TensorMap<Eigen::Tensor<const T, 1, Eigen::RowMajor>,
+                                   Eigen::Unaligned>
+              InT;
+          InT in_slice(in_slice_ptr, out_slice_shape);
+          out_slice = in_slice;
+        } else {
+          Eigen::DSizes<Eigen::DenseIndex, 2> in_slice_shape(end - start,
+                                                             num_col);
+          typedef Eigen::TensorMap<Eigen::Tensor<const T, 2, Eigen::RowMajor>,
+                                   Eigen::Unaligned>
+              InT;
+          InT in_slice(in_slice_ptr, in_slice_shape);
+
+          out_slice = in_slice.reduce(dims_to_reduce, Reducer());
+        }
       }
-      if (end >= num_indices) break;
-      start = end;
-      ++end;
-      uninitialized_index = out_index + 1;
-      out_index = next_index;
-    }
+    };
+    // Reducers cost a few cycles per element. Small inputs are reduced on the
+    // calling thread.
+    const int64_t rows_per_segment = num_indices / num_segments;
+    const Eigen::TensorOpCost cost_per_segment(
+        sizeof(T) * num_col * rows_per_segment, sizeof(T) * num_col,
+        5 * num_col * rows_per_segment);
+    context->eigen_cpu_device().parallelFor(num_segments, cost_per_segment,
+                                            reduce_segments);
   }
 };
 
@@ -398,47 +431,80 @@ struct UnsortedSegmentFunctor<CPUDevice, T, Index, InitialValueF, ReductionF> {
     // Nothing to reduce. All output values equal to `InitialValueF()`.
     if (num_reductions == 0) return;
 
-    // Parallelize by `num_segments`. It's simple, efficient and safe
-    // (no data dependency):
+    // Group the input rows by segment with a stable counting sort, so that
+    // each worker visits only the rows of its own segments, and every segment
+    // is still reduced in input order:
     //
-    //   input   segment_ids                 num_segments  operation
-    //   | a0 |  | 0 |            worker 1:  |0|           f(a0, a1)
-    //   | b0 |  | 1 |            worker 2:  |1|           f(b0, b1)
-    // N | c0 |  | 2 |       -->  worker 3:  |2|           f(c0)
-    //   | b1 |  | 1 |
-    //   | a1 |  | 0 |
+    //   input   segment_ids      rows     num_segments  operation
+    //   | a0 |  | 0 |            | 0 |    worker 1: |0| f(a0, a1)
+    //   | b0 |  | 1 |            | 4 |
+    // N | c0 |  | 2 |       -->  | 1 |    worker 2: |1| f(b0, b1)
+    //   | b1 |  | 1 |            | 3 |
+    //   | a1 |  | 0 |            | 2 |    worker 3: |2| f(c0)
     //
-    // TODO(intel-tf): Balance workload in `row_counter` to make parallelism
-    //                 more efficient.
-    auto reductionWorker = [&](int64_t begin, int64_t end) -> void {
-      for (int64_t i = 0; i < N; i++) {
+    // Rows of segment `j` are rows[segment_offsets[j], segment_offsets[j+1]).
+    std::vector<int64_t> segment_offsets(num_segments + 1);
+    segment_offsets[0] = 0;
+    for (int64_t j = 0; j < num_segments; ++j) {
+      segment_offsets[j + 1] = segment_offsets[j] + row_counter[j];
+    }
+    std::vector<int64_t> rows(num_real_segment);
+    {
+      std::vector<int64_t> cursor(segment_offsets.begin(),
+                                  segment_offsets.end() - 1);
+      for (int64_t i = 0; i < N; ++i) {
         Index j = internal::SubtleMustCopy(segment_ids(i));
-        // If `j` is in work scope of this worker, do the reduction.
-        if (j >= begin && j < end) {
-          reduction(data.template chip<0>(i), output.template chip<0>(j));
+        // The ids were validated above; skip anything that changed since.
+        if (!FastBoundsCheck(j, num_segments) ||
+            cursor[j] == segment_offsets[j + 1]) {
+          continue;
+        }
+        rows[cursor[j]++] = i;
+      }
+    }
+
+    // Split the segments into blocks of about the same number of input rows,
+    // so that a few large segments do not leave the other workers idle.
+    const int64_t rows_per_block = std::max<int64_t>(
+        1, num_real_segment / (4 * std::max(1, cpu_device.numThreads())));
+    std::vector<int64_t> block_starts(1, 0);
+    int64_t rows_in_block = 0;
+    for (int64_t j = 0; j + 1 < num_segments; ++j) {
+      rows_in_block += row_counter[j];
+      if (rows_in_block >= rows_per_block) {
+        block_starts.push_back(j + 1);
+        rows_in_block = 0;
+      }
+    }
+    block_starts.push_back(num_segments);
+    const int64_t num_blocks = block_starts.size() - 1;
+
+    auto reductionWorker = [&](int64_t begin, int64_t end) -> void {
+      for (int64_t j = block_starts[begin]; j < block_starts[end]; ++j) {
+        auto out = output.template chip<0>(j);
+        for (int64_t k = segment_offsets[j]; k < segment_offsets[j + 1]; ++k) {
+          reduction(data.template chip<0>(rows[k]), out);
         }
       }
     };
     auto reductionWorker1D = [&](int64_t begin, int64_t end) -> void {
-      for (int64_t i = 0; i < N; i++) {
-        Index j = internal::SubtleMustCopy(segment_ids(i));
-        // If `j` is in work scope of this worker, do the reduction.
-        if (j >= begin && j < end) {
-          reduction(data_ptr[i], out_ptr[j]);
+      for (int64_t j = block_starts[begin]; j < block_starts[end]; ++j) {
+        for (int64_t k = segment_offsets[j]; k < segment_offsets[j + 1]; ++k) {
+          reduction(data_ptr[rows[k]], out_ptr[j]);
         }
       }
     };
     // Reduction functors includes Sum, Max, Min, etc. Simply consider it
     // will cost 5 cycles per operation.
-    const int64_t kAverTaskSize = num_real_segment / num_segments;
-    const int64_t compute_cycles = 5 * inner_dim * kAverTaskSize;
-    const int64_t input_bytes = sizeof(T) * inner_dim * kAverTaskSize;
-    const int64_t output_bytes = sizeof(T) * inner_dim * kAverTaskSize;
+    const int64_t compute_cycles = 5 * inner_dim * rows_per_block;
+    const int64_t input_bytes = sizeof(T) * inner_dim * rows_per_block;
+    const int64_t output_bytes =
+        sizeof(T) * inner_dim * (num_segments / num_blocks + 1);
     const Eigen::TensorOpCost cost(input_bytes, output_bytes, compute_cycles);
     if (is_inner_dim_1d) {
-      cpu_device.parallelFor(num_segments, cost, reductionWorker1D);
+      cpu_device.parallelFor(num_blocks, cost, reductionWorker1D);
     } else {
-      cpu_device.parallelFor(num_segments, cost, reductionWorker);
+      cpu_device.parallelFor(num_blocks, cost, reductionWorker);
     }
   }
 };
@@ -616,72 +682,71 @@ class SparseSegmentReductionOpBase : public OpKernel {
                 errors::InvalidArgument("segment ids must be >= 0"));
     auto output_flat = output->flat_outer_dims<T>();
 
-    // If we use DT_BFLOAT16 or DT_HALF, we need to use DT_FLOAT for
-    // accumulation. We create a temp tensor to perform this accumulation for
-    // every segment.
-    Tensor temp;
-    if (input.dtype() == DT_BFLOAT16 || input.dtype() == DT_HALF) {
-      TensorShape temp_shape = output_shape;
-      OP_REQUIRES_OK(context, temp_shape.SetDimWithStatus(/*d=*/0, /*size=*/1));
-      temp = tensorflow::Tensor(DT_FLOAT, temp_shape);
-    }
-    auto temp_flat = temp.flat_outer_dims<float>();
-
-    int64_t start = 0, end = 1;
-    // Index from which the output is not initialized.
-    SegmentId uninitialized_index = 0;
-    SegmentId out_index = internal::SubtleMustCopy(segment_vec(start));
-
-    while (true) {
-      // We initialize next_index to 0 to avoid "warning: 'next_index' may be
-      // used uninitialized in this function" in the Mac build (since the
-      // compiler isn't smart enough to realize the code is safe).
-      SegmentId next_index = 0;
-      if (end < num_indices) {
-        next_index = internal::SubtleMustCopy(segment_vec(end));
-        if (out_index == next_index) {
-          ++end;
-          continue;
-        }
-        // We have a new segment here.  Verify that the segment ids are growing.
-        OP_REQUIRES(context, out_index < next_index,
-                    errors::InvalidArgument("segment ids are not increasing"));
+    std::vector<int64_t> segment_starts;
+    std::vector<SegmentId> segment_rows;
+    OP_REQUIRES_OK(context, internal::FindSortedSegments<SegmentId>(
+                                segment_vec, output_rows, &segment_starts,
+                                &segment_rows));
+    const int64_t num_segments = segment_rows.size();
+
+    // Segments are reduced in parallel. The first out of range index, in
+    // input order, is reported after all workers finish.
+    mutex mu;
+    int64_t bad_index = num_indices;
+    auto reduce_segments = [&](int64_t first, int64_t last) {
+      // If we use DT_BFLOAT16 or DT_HALF, we need to use DT_FLOAT for
+      // accumulation. Each worker creates a temp tensor to perform this
+      // accumulation for its segments.
+      Tensor temp;
+      if (input.dtype() == DT_BFLOAT16 || input.dtype() == DT_HALF) {
+        temp = tensorflow::Tensor(DT_FLOAT, TensorShape({1, num_col}));
       }
+      auto temp_flat = temp.flat_outer_dims<float>();
+      for (int64_t s = first; s < last; ++s) {
+        const int64_t start = segment_starts[s];
+        const int64_t end = segment_starts[s + 1];
+        const SegmentId out_index = segment_rows[s];
+        // Index from which the output is not set by the previous segment.
+        const SegmentId uninitialized_index =
+            s == 0 ? 0 : segment_rows[s - 1] + 1;
+
+        // If there is a gap between two indices, we need to set that gap to
+        // the default value.
+        if (out_index > uninitialized_index) {
+          Eigen::DSizes<Eigen::DenseIndex, 2> gap_slice_shape(
+              out_index - uninitialized_index, num_col);
+          Eigen::TensorMap<Eigen::Tensor<T, 2, Eigen::RowMajor>,
+                           Eigen::Unaligned>
+              gap_slice(&output_flat(uninitialized_index, 0), gap_slice_shape);
+          gap_slice.setConstant(default_value_);
+        }
 
-      OP_REQUIRES(
-          context, FastBoundsCheck(out_index, output_rows),
-          errors::InvalidArgument(
-              "Segment id ", out_index, " out of range [0, ", output_rows,
-              "), possibly because 'segment_ids' input is not sorted."));
-
-      // If there is a gap between two indices, we need to set that gap to the
-      // default value.
-      if (out_index > uninitialized_index) {
-        Eigen::DSizes<Eigen::DenseIndex, 2> gap_slice_shape(
-            out_index - uninitialized_index, num_col);
-        Eigen::TensorMap<Eigen::Tensor<T, 2, Eigen::RowMajor>, Eigen::Unaligned>
-            gap_slice(&output_flat(uninitialized_index, 0), gap_slice_shape);
-        gap_slice.setConstant(default_value_);
+        auto out = output_flat.template chip<0>(out_index);
+        auto temp_row = temp_flat.template chip<0>(0);
+        const int64_t bad_offset = Reduce<T, Index>(
+            input_flat, indices_vec, start, end - start, out, temp_row);
+        if (bad_offset >= 0) {
+          mutex_lock l(mu);
+          bad_index = std::min(bad_index, start + bad_offset);
+          return;
+        }
       }
-
-      auto out = output_flat.template chip<0>(out_index);
-      auto temp = temp_flat.template chip<0>(0);
-      const int bad_offset = Reduce<T, Index>(input_flat, indices_vec, start,
-                                              end - start, out, temp);
-      OP_REQUIRES(context, bad_offset < 0,
-                  errors::InvalidArgument(
-                      "Bad: indices[", start + bad_offset,
-                      "] == ", indices_vec(start + bad_offset),
-                      " out of range [0, ", input_flat.dimension(0), ")"));
-
-      start = end;
-      ++end;
-      uninitialized_index = out_index + 1;
-      out_index = next_index;
-      if (end > num_indices) break;
-    }
+    };
+    // Reductions cost a few cycles per element. Small inputs are reduced on
+    // the calling thread.
+    const int64_t rows_per_segment = num_indices / num_segments;
+    const Eigen::TensorOpCost cost_per_segment(
+        sizeof(T) * num_col * rows_per_segment, sizeof(T) * num_col,
+        5 * num_col * rows_per_segment);
+    context->eigen_cpu_device().parallelFor(num_segments, cost_per_segment,
+                                            reduce_segments);
+    OP_REQUIRES(context, bad_index == num_indices,
+                errors::InvalidArgument(
+                    "Bad: indices[", bad_index, "] == ", indices_vec(bad_index),
+                    " out of range [0, ", input_flat.dimension(0), ")"));
 
     // Fill the gap at the end with the default value.
+    const SegmentId uninitialized_index = segment_rows.back() + 1;
     if (uninitialized_index < output_rows) {
       Eigen::DSizes<Eigen::DenseIndex, 2> gap_slice_shape(
           output_rows - uninitialized_index, num_col);
@@ -100,11 +100,16 @@ static void BM_UnsortedSegmentReduction(::testing::benchmark::State& state,
   }                                                                          \
   BENCHMARK(BM_##O##_##R##_##C##_##S);
 
-#define BM_UnsortedReduce_Arg(R, C, S) \
-  BM_UnsortedReduce(UnsortedSegmentSum, R, C, S);
+#define BM_UnsortedReduce_Arg(R, C, S)            \
+  BM_UnsortedReduce(UnsortedSegmentSum, R, C, S); \
+  BM_UnsortedReduce(UnsortedSegmentMax, R, C, S); \
+  BM_UnsortedReduce(UnsortedSegmentMin, R, C, S); \
+  BM_UnsortedReduce(UnsortedSegmentProd, R, C, S);
 
 BM_UnsortedReduce_Arg(4096, 1024, 1);
 BM_UnsortedReduce_Arg(4096, 1024, 128);
+BM_UnsortedReduce_Arg(65536, 1, 64);
+BM_UnsortedReduce_Arg(65536, 128, 4096);
 
 template <typename Index>
 static void BM_SegmentReduction(::testing::benchmark::State& state,
@@ -180,6 +185,61 @@ BM_Reduce_Arg(16, 8, 2);
 BM_Reduce_Arg(64, 32, 2);
 BM_Reduce_Arg(4096, 32, 2);
 BM_Reduce_Arg(4096, 128, 2);
+BM_Reduce_Arg(65536, 128, 16);
+
+#define BM_Reduce_MinMaxProd_Arg(R, C, S) \
+  BM_Reduce(SegmentMax, R, C, S);         \
+  BM_Reduce(SegmentMin, R, C, S);         \
+  BM_Reduce(SegmentProd, R, C, S);
+
+BM_Reduce_MinMaxProd_Arg(4096, 1024, 2);
+BM_Reduce_MinMaxProd_Arg(65536, 128, 16);
+
+template <DataType T>
+static void SparseSegmentReductionHelper(::testing::benchmark::State& state,
+                                         const string& reduction,
+                                         int num_indices, int segment_size) {
+  typedef typename EnumToDataType<T>::Type DT;
+  Graph* g = new Graph(OpRegistry::Global());
+
+  const int kDim1 = 4096;
+  const int kDim2 = 128;
+  Tensor input(T, TensorShape({kDim1, kDim2}));
+  input.flat<DT>().setRandom();
+
+  Tensor indices(DT_INT32, TensorShape({num_indices}));
+  auto indices_flat = indices.flat<int32>();
+  Tensor segments(DT_INT32, TensorShape({num_indices}));
+  auto segments_flat = segments.flat<int32>();
+  for (int i = 0; i < num_indices; ++i) {
+    indices_flat(i) = (i * 31) % kDim1;
+    segments_flat(i) = i / segment_size;
+  }
+
+  Node* node;
+  TF_CHECK_OK(NodeBuilder(g->NewName("n"), reduction)
+                  .Input(test::graph::Constant(g, input))
+                  .Input(test::graph::Constant(g, indices))
+                  .Input(test::graph::Constant(g, segments))
+                  .Attr("T", T)
+                  .Finalize(g, &node));
+
+  test::Benchmark("cpu", g, /*old_benchmark_api*/ false).Run(state);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          num_indices * kDim2 * sizeof(DT));
+}
+
+#define BM_SparseReduce(O, T, S)                                        \
+  static void BM_##O##_##T##_##S(::testing::benchmark::State& state) {  \
+    SparseSegmentReductionHelper<DT_##T>(state, #O, state.range(0), S); \
+  }                                                                     \
+  BENCHMARK(BM_##O##_##T##_##S)->UseRealTime()->Arg(1000)->Arg(100000);
+
+BM_SparseReduce(SparseSegmentSum, FLOAT, 1);
+BM_SparseReduce(SparseSegmentSum, FLOAT, 32);
+BM_SparseReduce(SparseSegmentMean, FLOAT, 32);
+BM_SparseReduce(SparseSegmentSum, BFLOAT16, 32);
+BM_SparseReduce(SparseSegmentMean, BFLOAT16, 32);
 
 template <DataType T>
 static void SparseSegmentMeanGradHelper(::testing::benchmark::State& state,
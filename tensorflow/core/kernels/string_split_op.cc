@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/core/framework/kernel_def_builder.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/kernels/string_util.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
@@ -102,64 +103,6 @@ std::vector<absl::string_view> Split(const tstring& str,
   return SplitOnCharSet(str, delimiter, predicate);
 }
 
-std::vector<absl::string_view> SplitV2(const tstring& str,
-                                       absl::string_view sep, int maxsplit) {
-  // This SplitV2 method matches the behavior of python's str.split:
-  //   If sep is given, consecutive delimiters are not grouped together
-  //   and are deemed to delimit empty strings (for example, '1,,2'.split(',')
-  //   returns ['1', '', '2']). The sep argument may consist of multiple
-  //   characters (for example, '1<>2<>3'.split('<>') returns ['1', '2', '3']).
-  //   Splitting an empty string with a specified separator returns [''].
-  //
-  //   If sep is not specified or is None, a different splitting algorithm is
-  //   applied: runs of consecutive whitespace are regarded as a single
-  //   separator, and the result will contain no empty strings at the start or
-  //   end if the string has leading or trailing whitespace. Consequently,
-  //   splitting an empty string or a string consisting of just whitespace
-  //   with a None separator returns [].
-
-  std::vector<absl::string_view> result;
-
-  absl::string_view text(str);
-  if (maxsplit == 0) {
-    result.emplace_back(text);
-    return result;
-  }
-
-  if (sep.empty()) {
-    absl::string_view token;
-    // Remove leading whitespaces.
-    str_util::RemoveLeadingWhitespace(&text);
-    int split = 0;
-    while (str_util::ConsumeNonWhitespace(&text, &token)) {
-      result.push_back(token);
-      str_util::RemoveLeadingWhitespace(&text);
-      ++split;
-      if (maxsplit > 0 && split == maxsplit) {
-        result.push_back(text);
-        return result;
-      }
-    }
-    return result;
-  }
-  auto p = std::search(text.begin(), text.end(), sep.begin(), sep.end());
-  int split = 0;
-  while (p != text.end()) {
-    absl::string_view token = text.substr(0, p - text.begin());
-    result.push_back(token);
-    text.remove_prefix(token.size());
-    text.remove_prefix(sep.size());
-    ++split;
-    if (maxsplit > 0 && split == maxsplit) {
-      result.push_back(absl::string_view(text));
-      return result;
-    }
-    p = std::search(text.begin(), text.end(), sep.begin(), sep.end());
-  }
-  result.push_back(text);
-  return result;
-}
-
 }  // namespace
 
 class StringSplitOp : public OpKernel {
@@ -287,14 +230,10 @@ class StringSplitV2Op : public OpKernel {
     Tensor* sp_indices_t;
     OP_REQUIRES_OK(ctx, ctx->allocate_output(0, TensorShape({output_size, 2}),
                                              &sp_indices_t));
-    Tensor* sp_tokens_t;
-    OP_REQUIRES_OK(
-        ctx, ctx->allocate_output(1, TensorShape({output_size}), &sp_tokens_t));
     Tensor* sp_shape_t;
     OP_REQUIRES_OK(ctx, ctx->allocate_output(2, TensorShape({2}), &sp_shape_t));
 
     auto sp_indices = sp_indices_t->matrix<int64_t>();
-    auto sp_tokens = sp_tokens_t->vec<tstring>();
     auto sp_shape = sp_shape_t->vec<int64_t>();
     sp_shape(0) = batch_size;
     sp_shape(1) = max_num_entries;
@@ -303,10 +242,21 @@ class StringSplitV2Op : public OpKernel {
       for (size_t j = 0; j < num_indices[i]; ++j) {
         sp_indices(c, 0) = i;
         sp_indices(c, 1) = j;
-        sp_tokens(c).assign(tokens[c].data(), tokens[c].size());
         ++c;
       }
     }
+
+    // When the tokens are consumed by a fused kernel that re-splits the input
+    // itself (see fused_string_ngrams_hash_op.cc), only the indices are used
+    // and the token strings need not be copied.
+    if (!ctx->output_required(1)) return;
+    Tensor* sp_tokens_t;
+    OP_REQUIRES_OK(
+        ctx, ctx->allocate_output(1, TensorShape({output_size}), &sp_tokens_t));
+    auto sp_tokens = sp_tokens_t->vec<tstring>();
+    for (int64_t i = 0; i < output_size; ++i) {
+      sp_tokens(i).assign(tokens[i].data(), tokens[i].size());
+    }
   }
 
  private:
@@ -15,6 +15,9 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_STRING_UTIL_H_
 #define TENSORFLOW_CORE_KERNELS_STRING_UTIL_H_
 
+#include <vector>
+
+#include "absl/strings/string_view.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
 
@@ -38,6 +41,12 @@ absl::Status ParseUnicodeEncoding(const string& str, UnicodeEncoding* encoding);
 // Sets `unit` value based on `str`.
 absl::Status ParseCharUnit(const string& str, CharUnit* unit);
 
+// Splits `str` on `sep` like Python's `str.split`; an empty `sep` splits on
+// runs of whitespace. At most `maxsplit` splits are done if it is positive.
+// The returned pieces refer into `str`.
+std::vector<absl::string_view> SplitV2(absl::string_view str,
+                                       absl::string_view sep, int maxsplit);
+
 // Returns the number of Unicode characters in a UTF-8 string.
 // Result may be incorrect if the input string is not valid UTF-8.
 int32 UTF8StrLen(const string& str);
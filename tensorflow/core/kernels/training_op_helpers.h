@@ -25,6 +25,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/types/span.h"
 #include "xla/tsl/framework/allocator.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/resource_mgr.h"
@@ -289,6 +290,7 @@ absl::Status GetInputTensorFromVariable(OpKernelContext* ctx, int input,
     var->mu()->assert_held();
     TF_RETURN_IF_ERROR(PrepareToUpdateVariable<Device, T>(
         ctx, var->tensor(), var->copy_on_read_mode.load()));
+    var->MarkAllRowsDirty();
     *out = *var->tensor();
     return absl::OkStatus();
   }
@@ -296,6 +298,60 @@ absl::Status GetInputTensorFromVariable(OpKernelContext* ctx, int input,
   return absl::OkStatus();
 }
 
+// Records the rows `indices` of `var` as updated, if it tracks its dirty rows
+// (see Var::EnableDirtyRowTracking()). Indices in device memory cannot be read
+// here, so all rows are recorded instead.
+// REQUIRES: *var->mu() held, at least in shared mode, since the update.
+template <typename Device, typename Tindex>
+void MarkVariableRowsDirty(Var* var, const Tensor& indices) {
+  if (!var->dirty_row_tracking_enabled()) return;
+  if (std::is_same<Device, Eigen::ThreadPoolDevice>::value) {
+    const auto rows = indices.flat<Tindex>();
+    var->MarkRowsDirty(absl::Span<const Tindex>(rows.data(), rows.size()));
+  } else {
+    var->MarkAllRowsDirty();
+  }
+}
+
+// Records the rows `indices` of the resource variables passed as inputs
+// `input_ids` as updated when it goes out of scope. Declare it after the
+// VariableInputLockHolder of the update, so that the rows are recorded once
+// the update is written but before the variables are unlocked: a save taking
+// the dirty rows under the variable's exclusive lock then sees both the
+// update and its rows, or neither. The rows are recorded even if the op
+// fails, as it may have updated some of them before failing.
+template <typename Device, typename Tindex>
+class ScopedMarkVariableRowsDirty {
+ public:
+  ScopedMarkVariableRowsDirty(OpKernelContext* ctx,
+                              const std::vector<int>& input_ids,
+                              const Tensor& indices)
+      : indices_(indices) {
+    if (!Var::AnyDirtyRowTrackingEnabled()) return;
+    for (int input : input_ids) {
+      if (ctx->input_dtype(input) != DT_RESOURCE) continue;
+      core::RefCountPtr<Var> var;
+      if (!LookupResource(ctx, HandleFromInput(ctx, input), &var).ok()) {
+        continue;
+      }
+      if (var->dirty_row_tracking_enabled()) vars_.push_back(std::move(var));
+    }
+  }
+
+  ~ScopedMarkVariableRowsDirty() {
+    for (const auto& var : vars_) {
+      MarkVariableRowsDirty<Device, Tindex>(var.get(), indices_);
+    }
+  }
+
+ private:
+  const Tensor indices_;
+  std::vector<core::RefCountPtr<Var>> vars_;
+
+  ScopedMarkVariableRowsDirty(const ScopedMarkVariableRowsDirty&) = delete;
+  void operator=(const ScopedMarkVariableRowsDirty&) = delete;
+};
+
 }  // end namespace tensorflow
 
 #endif  // TENSORFLOW_CORE_KERNELS_TRAINING_OP_HELPERS_H_
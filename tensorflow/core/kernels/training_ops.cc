@@ -1251,6 +1251,8 @@ class SparseApplyAdadeltaOp : public OpKernel {
                                         epsilon.shape().DebugString()));
     const Tensor& grad = ctx->input(6);
     const Tensor& indices = ctx->input(7);
+    ScopedMarkVariableRowsDirty<Device, Tindex> mark_rows_dirty(
+        ctx, {0, 1, 2}, indices);
     OP_REQUIRES(ctx, TensorShapeUtils::IsVector(indices.shape()),
                 errors::InvalidArgument("indices must be one-dimensional"));
 
@@ -1459,6 +1461,8 @@ class SparseApplyProximalGradientDescentOp : public OpKernel {
 
     const Tensor& grad = ctx->input(4);
     const Tensor& indices = ctx->input(5);
+    ScopedMarkVariableRowsDirty<CPUDevice, Tindex> mark_rows_dirty(
+        ctx, {0}, indices);
     OP_REQUIRES(ctx, TensorShapeUtils::IsVector(indices.shape()),
                 errors::InvalidArgument("indices must be one-dimensional"));
 
@@ -1919,6 +1923,8 @@ class SparseApplyAdagradOp : public OpKernel {
                                         lr.shape().DebugString()));
     const Tensor& grad = ctx->input(3);
     const Tensor& indices = ctx->input(4);
+    ScopedMarkVariableRowsDirty<Device, Tindex> mark_rows_dirty(
+        ctx, {0, 1}, indices);
     OP_REQUIRES(ctx, TensorShapeUtils::IsVector(indices.shape()),
                 errors::InvalidArgument("indices must be one-dimensional"));
 
@@ -2053,6 +2059,8 @@ class SparseApplyAdagradV2Op : public OpKernel {
                                         epsilon.shape().DebugString()));
     const Tensor& grad = ctx->input(4);
     const Tensor& indices = ctx->input(5);
+    ScopedMarkVariableRowsDirty<Device, Tindex> mark_rows_dirty(
+        ctx, {0, 1}, indices);
     OP_REQUIRES(ctx, TensorShapeUtils::IsVector(indices.shape()),
                 errors::InvalidArgument("indices must be one-dimensional"));
 
@@ -2202,6 +2210,8 @@ class SparseApplyProximalAdagradOp : public OpKernel {
 
     const Tensor& grad = ctx->input(5);
     const Tensor& indices = ctx->input(6);
+    ScopedMarkVariableRowsDirty<Device, Tindex> mark_rows_dirty(
+        ctx, {0, 1}, indices);
     OP_REQUIRES(ctx, TensorShapeUtils::IsVector(indices.shape()),
                 errors::InvalidArgument("indices must be one-dimensional"));
 
@@ -2437,6 +2447,8 @@ class SparseApplyAdagradDAOp : public OpKernel {
 
     const Tensor& grad = ctx->input(3);
     const Tensor& indices = ctx->input(4);
+    ScopedMarkVariableRowsDirty<CPUDevice, Tindex> mark_rows_dirty(
+        ctx, {0, 1, 2}, indices);
     OP_REQUIRES(ctx, TensorShapeUtils::IsVector(indices.shape()),
                 errors::InvalidArgument("indices must be one-dimensional"));
 
@@ -2845,6 +2857,8 @@ class SparseApplyFtrlOp : public OpKernel {
 
     const Tensor& grad = ctx->input(3);
     const Tensor& indices = ctx->input(4);
+    ScopedMarkVariableRowsDirty<Device, Tindex> mark_rows_dirty(
+        ctx, {0, 1, 2}, indices);
     OP_REQUIRES(ctx, TensorShapeUtils::IsVector(indices.shape()),
                 errors::InvalidArgument("indices must be one-dimensional"));
 
@@ -3204,6 +3218,8 @@ class SparseApplyMomentumOp : public OpKernel {
                                         lr.shape().DebugString()));
     const Tensor& grad = ctx->input(3);
     const Tensor& indices = ctx->input(4);
+    ScopedMarkVariableRowsDirty<CPUDevice, Tindex> mark_rows_dirty(
+        ctx, {0, 1}, indices);
     OP_REQUIRES(ctx, TensorShapeUtils::IsVector(indices.shape()),
                 errors::InvalidArgument("indices must be one-dimensional"));
 
@@ -3423,6 +3439,8 @@ class SparseApplyKerasMomentumOp : public OpKernel {
                                         lr.shape().DebugString()));
     const Tensor& grad = ctx->input(3);
     const Tensor& indices = ctx->input(4);
+    ScopedMarkVariableRowsDirty<Device, Tindex> mark_rows_dirty(
+        ctx, {0, 1}, indices);
     OP_REQUIRES(ctx, TensorShapeUtils::IsVector(indices.shape()),
                 errors::InvalidArgument("indices must be one-dimensional"));
 
@@ -4212,6 +4230,8 @@ class SparseApplyRMSPropOp : public OpKernel {
     const Tensor& epsilon = ctx->input(6);
     const Tensor& grad = ctx->input(7);
     const Tensor& indices = ctx->input(8);
+    ScopedMarkVariableRowsDirty<CPUDevice, Tindex> mark_rows_dirty(
+        ctx, {0, 1, 2}, indices);
 
     OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(lr.shape()),
                 errors::InvalidArgument("lr is not a scalar: ",
@@ -4345,6 +4365,8 @@ class SparseApplyCenteredRMSPropOp : public OpKernel {
     const Tensor& epsilon = ctx->input(7);
     const Tensor& grad = ctx->input(8);
     const Tensor& indices = ctx->input(9);
+    ScopedMarkVariableRowsDirty<CPUDevice, Tindex> mark_rows_dirty(
+        ctx, {0, 1, 2, 3}, indices);
 
     OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(lr.shape()),
                 errors::InvalidArgument("lr is not a scalar: ",
@@ -13,9 +13,12 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <functional>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/framework/bounds_check.h"
@@ -26,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/bfloat16.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 namespace {
@@ -68,6 +72,42 @@ struct UniqueOpHashMap<bfloat16, TIndex> {
   using map_type = std::unordered_map<bfloat16, TIndex>;
 };
 
+// Inputs with at least this many elements are uniquified with the parallel,
+// hash-partitioned implementation when the element type supports it and the
+// device has more than one worker thread. Below this size the cost of the
+// extra passes over the input outweighs the gain from parallelism.
+constexpr int64_t kParallelUniqueMinElements = 128 * 1024;
+
+// Upper bound on the number of hash partitions, so that the partition of each
+// element can be stored in a `uint8`.
+constexpr int kParallelUniqueMaxPartitions = 256;
+
+// `UniqueOpSupportsParallel<T>` is true for the element types that use the
+// parallel implementation for large 1-D inputs.
+template <typename T>
+struct UniqueOpSupportsParallel : std::false_type {};
+template <>
+struct UniqueOpSupportsParallel<int32> : std::true_type {};
+template <>
+struct UniqueOpSupportsParallel<int64_t> : std::true_type {};
+template <>
+struct UniqueOpSupportsParallel<tstring> : std::true_type {};
+
+// Returns the hash partition of `value`, in `[0, num_partitions)`. The hash
+// differs from the one used by `UniqueOpHashMap`, so keys that land in the same
+// partition still spread across the buckets of the per-partition map.
+template <typename T>
+inline int UniquePartitionOf(const T& value, int num_partitions) {
+  const uint64 h = static_cast<uint64>(value) * 0x9E3779B97F4A7C15ULL;
+  return static_cast<int>((h >> 32) % num_partitions);
+}
+template <>
+inline int UniquePartitionOf<tstring>(const tstring& value,
+                                      int num_partitions) {
+  const uint64 h = Hash64(value.data(), value.size());
+  return static_cast<int>((h >> 32) % num_partitions);
+}
+
 // `UniqueOp` computes the unique elements in the input tensor.
 //
 // * `T` is the element type.
@@ -142,6 +182,16 @@ class UniqueOp : public OpKernel {
                                 1, TensorShape({new_sizes[1]}), &idx));
     auto idx_vec = idx->template vec<TIndex>();
 
+    if constexpr (UniqueOpSupportsParallel<T>::value) {
+      const int num_threads =
+          context->device()->tensorflow_cpu_worker_threads()->num_threads;
+      if (new_sizes[0] == 1 && new_sizes[2] == 1 && num_threads > 1 &&
+          input.NumElements() >= kParallelUniqueMinElements) {
+        ComputeParallel(context, input, axis, idx_vec);
+        return;
+      }
+    }
+
     int64_t uniq_size;
     if (new_sizes[0] == 1 && new_sizes[2] == 1) {
       // Specialized and faster implementation when unique is run over single
@@ -237,6 +287,176 @@ class UniqueOp : public OpKernel {
       }
     }
   }
+
+ private:
+  // Parallel implementation of the single-element case. The input is split
+  // into disjoint sets of keys by hash, each partition is deduplicated
+  // independently, and the partial results are merged so that the unique
+  // elements appear in order of first occurrence, exactly as in the serial
+  // implementation.
+  //
+  // The input is divided into a fixed number of contiguous blocks. Every
+  // phase that walks the input does so block by block, so the result does not
+  // depend on how the blocks are scheduled onto threads.
+  void ComputeParallel(OpKernelContext* context, const Tensor& input,
+                       int64_t axis, typename TTypes<TIndex>::Vec idx_vec) {
+    auto Tin = input.flat<T>();
+    const int64_t N = static_cast<int64_t>(Tin.size());
+    const DeviceBase::CpuWorkerThreads& worker_threads =
+        *context->device()->tensorflow_cpu_worker_threads();
+    const int num_partitions =
+        std::min(worker_threads.num_threads, kParallelUniqueMaxPartitions);
+    const int64_t num_blocks = num_partitions;
+    const int64_t block_size = Eigen::divup(N, num_blocks);
+    // Rough per-element costs, in cycles, used to shard the work.
+    const int64_t hash_cost = std::is_same<T, tstring>::value ? 100 : 10;
+    const int64_t map_cost = std::is_same<T, tstring>::value ? 200 : 50;
+
+    auto for_each_block = [&](int64_t cost_per_element,
+                              const std::function<void(int64_t, int64_t)>& fn) {
+      Shard(worker_threads.num_threads, worker_threads.workers, num_blocks,
+            cost_per_element * block_size,
+            [&](int64_t start_block, int64_t limit_block) {
+              for (int64_t b = start_block; b < limit_block; ++b) {
+                fn(b * block_size, std::min(N, (b + 1) * block_size));
+              }
+            });
+    };
+    auto for_each_partition = [&](const std::function<void(int)>& fn) {
+      Shard(worker_threads.num_threads, worker_threads.workers, num_partitions,
+            map_cost * Eigen::divup(N, static_cast<int64_t>(num_partitions)),
+            [&](int64_t start_partition, int64_t limit_partition) {
+              for (int64_t p = start_partition; p < limit_partition; ++p) {
+                fn(static_cast<int>(p));
+              }
+            });
+    };
+
+    // Phase 1: assign every element to a partition, and count the elements of
+    // each partition within each block.
+    std::vector<uint8> partition_of(N);
+    std::vector<int64_t> offsets(num_blocks * num_partitions, 0);
+    for_each_block(hash_cost, [&](int64_t start, int64_t limit) {
+      int64_t* block_counts = &offsets[(start / block_size) * num_partitions];
+      for (int64_t i = start; i < limit; ++i) {
+        const int p = UniquePartitionOf<T>(Tin(i), num_partitions);
+        partition_of[i] = static_cast<uint8>(p);
+        ++block_counts[p];
+      }
+    });
+
+    // Phase 2: turn the counts into write offsets, laying out the elements of
+    // partition 0 first (block by block), then partition 1, and so on.
+    std::vector<int64_t> partition_start(num_partitions + 1);
+    int64_t running = 0;
+    for (int p = 0; p < num_partitions; ++p) {
+      partition_start[p] = running;
+      for (int64_t b = 0; b < num_blocks; ++b) {
+        const int64_t count = offsets[b * num_partitions + p];
+        offsets[b * num_partitions + p] = running;
+        running += count;
+      }
+    }
+    partition_start[num_partitions] = running;
+
+    // Phase 3: scatter the element positions into their partitions. Positions
+    // within a partition remain in increasing order.
+    std::vector<int64_t> order(N);
+    for_each_block(2, [&](int64_t start, int64_t limit) {
+      int64_t* cursors = &offsets[(start / block_size) * num_partitions];
+      for (int64_t i = start; i < limit; ++i) {
+        order[cursors[partition_of[i]]++] = i;
+      }
+    });
+
+    // Phase 4: deduplicate each partition. `idx_vec` temporarily holds the
+    // partition-local id of every element, and `firsts[p]` the position of the
+    // first occurrence of each unique element of partition `p`.
+    const bool with_counts = num_outputs() > 2;
+    std::vector<std::vector<int64_t>> firsts(num_partitions);
+    std::vector<std::vector<TIndex>> counts(num_partitions);
+    std::vector<uint8> is_first(N, 0);
+    for_each_partition([&](int p) {
+      const int64_t start = partition_start[p];
+      const int64_t limit = partition_start[p + 1];
+      typename UniqueOpHashMap<T, TIndex>::map_type uniq;
+      uniq.reserve(2 * (limit - start));
+      std::vector<int64_t>& partition_firsts = firsts[p];
+      std::vector<TIndex>& partition_counts = counts[p];
+      for (int64_t k = start; k < limit; ++k) {
+        const int64_t i = order[k];
+        auto it = uniq.emplace(Tin(i),
+                               static_cast<TIndex>(partition_firsts.size()));
+        if (it.second) {
+          partition_firsts.push_back(i);
+          is_first[i] = 1;
+          if (with_counts) partition_counts.push_back(0);
+        }
+        idx_vec(i) = it.first->second;
+        if (with_counts) ++partition_counts[it.first->second];
+      }
+    });
+
+    // Phase 5: the output id of a unique element is the number of first
+    // occurrences that precede it in the input. Count the first occurrences in
+    // each block, then rank them within each block. `order` is no longer
+    // needed and is reused to hold the rank of each first occurrence.
+    std::vector<int64_t> block_uniques(num_blocks, 0);
+    for_each_block(1, [&](int64_t start, int64_t limit) {
+      int64_t count = 0;
+      for (int64_t i = start; i < limit; ++i) count += is_first[i];
+      block_uniques[start / block_size] = count;
+    });
+    int64_t uniq_size = 0;
+    for (int64_t b = 0; b < num_blocks; ++b) {
+      const int64_t count = block_uniques[b];
+      block_uniques[b] = uniq_size;
+      uniq_size += count;
+    }
+    std::vector<int64_t>& rank = order;
+    for_each_block(1, [&](int64_t start, int64_t limit) {
+      int64_t r = block_uniques[start / block_size];
+      for (int64_t i = start; i < limit; ++i) {
+        if (is_first[i]) rank[i] = r++;
+      }
+    });
+
+    TensorShape output_shape(input.shape());
+    output_shape.set_dim(axis, uniq_size);
+    Tensor* output = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(0, output_shape, &output));
+    auto Tout = output->flat<T>();
+    TIndex* count_output_data = nullptr;
+    if (with_counts) {
+      Tensor* count_output = nullptr;
+      OP_REQUIRES_OK(context,
+                     context->allocate_output(2, TensorShape({uniq_size}),
+                                              &count_output));
+      count_output_data = count_output->template flat<TIndex>().data();
+    }
+
+    // Phase 6: map each partition-local id to its output id, and write the
+    // unique elements and their counts.
+    std::vector<std::vector<TIndex>> output_ids(num_partitions);
+    for_each_partition([&](int p) {
+      const std::vector<int64_t>& partition_firsts = firsts[p];
+      std::vector<TIndex>& partition_output_ids = output_ids[p];
+      partition_output_ids.resize(partition_firsts.size());
+      for (size_t l = 0; l < partition_firsts.size(); ++l) {
+        const int64_t out = rank[partition_firsts[l]];
+        partition_output_ids[l] = static_cast<TIndex>(out);
+        Tout(out) = Tin(partition_firsts[l]);
+        if (with_counts) count_output_data[out] = counts[p][l];
+      }
+    });
+
+    // Phase 7: rewrite the partition-local ids in `idx_vec` as output ids.
+    for_each_block(2, [&](int64_t start, int64_t limit) {
+      for (int64_t i = start; i < limit; ++i) {
+        idx_vec(i) = output_ids[partition_of[i]][idx_vec(i)];
+      }
+    });
+  }
 };
 
 #define REGISTER_UNIQUE(type)                                      \
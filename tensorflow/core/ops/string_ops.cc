@@ -402,4 +402,71 @@ REGISTER_OP("StringNGrams")
       return absl::OkStatus();
     });
 
+REGISTER_OP("_StringNGramsHashBucketFast")
+    .Attr("separator: string")
+    .Attr("ngram_widths: list(int) >= 0")
+    .Attr("left_pad: string")
+    .Attr("right_pad: string")
+    .Attr("pad_width: int")
+    .Attr("preserve_short_sequences: bool")
+    .Attr("num_buckets: int >= 1")
+    .Attr("Tsplits: {int32, int64} = DT_INT64")
+    .Input("data: string")
+    .Input("data_splits: Tsplits")
+    .Output("output: int64")
+    .Output("output_splits: Tsplits")
+    .SetShapeFn([](InferenceContext* c) {
+      c->set_output(0, c->UnknownShapeOfRank(1));
+      ShapeHandle data = c->input(0);
+      TF_RETURN_IF_ERROR(c->WithRank(data, 1, &data));
+      ShapeHandle data_splits = c->input(1);
+      TF_RETURN_IF_ERROR(c->WithRank(data_splits, 1, &data_splits));
+      c->set_output(1, data_splits);
+      return absl::OkStatus();
+    })
+    .Doc(R"doc(
+Internal operation which is a composition of StringNGrams and
+StringToHashBucketFast: reserved for internal use.
+
+Do not invoke this operator directly in Python. A fusion optimization is
+expected to create these operators.
+)doc");
+
+REGISTER_OP("_StringSplitNGramsHashBucketFast")
+    .Attr("maxsplit: int = -1")
+    .Attr("separator: string")
+    .Attr("ngram_widths: list(int) >= 0")
+    .Attr("left_pad: string")
+    .Attr("right_pad: string")
+    .Attr("pad_width: int")
+    .Attr("preserve_short_sequences: bool")
+    .Attr("num_buckets: int >= 1")
+    .Attr("Tsplits: {int32, int64} = DT_INT64")
+    .Input("input: string")
+    .Input("sep: string")
+    .Input("data_splits: Tsplits")
+    .Output("output: int64")
+    .Output("output_splits: Tsplits")
+    .SetShapeFn([](InferenceContext* c) {
+      ShapeHandle unused;
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 1, &unused));
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 0, &unused));
+      c->set_output(0, c->UnknownShapeOfRank(1));
+      ShapeHandle data_splits = c->input(2);
+      TF_RETURN_IF_ERROR(c->WithRank(data_splits, 1, &data_splits));
+      c->set_output(1, data_splits);
+      return absl::OkStatus();
+    })
+    .Doc(R"doc(
+Internal operation which is a composition of StringSplitV2 (values only),
+StringNGrams and StringToHashBucketFast: reserved for internal use.
+
+`data_splits` partitions the tokens obtained by splitting every element of
+`input` on `sep`, in order, exactly as it would partition the `values` output
+of StringSplitV2.
+
+Do not invoke this operator directly in Python. A fusion optimization is
+expected to create these operators.
+)doc");
+
 }  // namespace tensorflow
@@ -36,7 +36,8 @@ namespace tfrt_stub {
 // unique within a model.
 class CostRecorder {
  public:
-  // Records an execution duration for the op keyed by `op_key`.
+  // Records an execution duration for the op keyed by `op_key`. The fallback
+  // kernels measure durations in CPU cycles.
   void RecordCost(int64_t op_key, uint64_t execution_time);
 
   // Returns the normalized average execution duration of the op keyed by
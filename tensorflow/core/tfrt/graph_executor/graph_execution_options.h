@@ -15,6 +15,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_TFRT_GRAPH_EXECUTOR_GRAPH_EXECUTION_OPTIONS_H_
 #define TENSORFLOW_CORE_TFRT_GRAPH_EXECUTOR_GRAPH_EXECUTION_OPTIONS_H_
 
+#include <cstdint>
 #include <functional>
 #include <optional>
 #include <ostream>
@@ -96,6 +97,15 @@ struct GraphExecutionOptions {
     // Number of times to record costs before resetting Op cost estimates.
     // However, a reset always occurs after the first execution.
     int updates_per_interval = 1;
+
+    // The cost threshold, in CPU cycles as measured by `CostRecorder`, used
+    // when the executable is recompiled with recorded costs. Sequences of ops
+    // cheaper than this are merged into their parent stream and run inline on
+    // the caller's thread, while more expensive ones keep their own task. The
+    // classic executor considers ops of more than 8000 cycles expensive. If 0,
+    // `compile_options.cost_threshold` is used, although it is meant for the
+    // static cost model and is usually too low for measured costs.
+    uint64_t inline_cost_threshold = 0;
   };
 
   CostAnalysisOptions cost_analysis_options;
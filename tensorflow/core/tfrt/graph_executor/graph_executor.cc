@@ -40,6 +40,7 @@ limitations under the License.
 #include "llvm/ADT/SmallVector.h"
 #include "mlir/Dialect/Func/Extensions/AllExtensions.h"  // from @llvm-project
 #include "mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
+#include "mlir/IR/Builders.h"  // from @llvm-project
 #include "mlir/IR/BuiltinAttributes.h"  // from @llvm-project
 #include "mlir/IR/BuiltinDialect.h"  // from @llvm-project
 #include "mlir/IR/BuiltinOps.h"  // from @llvm-project
@@ -1062,6 +1063,16 @@ absl::Status GraphExecutor::LoadedClientGraph::UpdateCost(
     const CostRecorder& cost_recorder, const Runtime& runtime) {
   LOG(INFO) << "TFRT updating op costs of loaded client graph (" << this << ") "
             << name_;
+  // The recorded costs are in CPU cycles, so the threshold deciding which ops
+  // run inline has to be in cycles as well.
+  TfrtCompileOptions compile_options =
+      graph_executor_->options().compile_options;
+  const uint64_t inline_cost_threshold =
+      graph_executor_->options().cost_analysis_options.inline_cost_threshold;
+  if (inline_cost_threshold > 0) {
+    compile_options.cost_threshold = inline_cost_threshold;
+  }
+
   std::shared_ptr<ExecutableContext> new_executable_context = nullptr;
   if (executable_context()->IsForMlrt()) {
     auto tf_mlir_with_op_keys = ::mlir::OwningOpRef<mlir::ModuleOp>(
@@ -1071,9 +1082,8 @@ absl::Status GraphExecutor::LoadedClientGraph::UpdateCost(
     TF_ASSIGN_OR_RETURN(
         auto bytecode_buffer,
         tensorflow::mlrt_compiler::ConvertTfMlirWithOpKeysToBytecode(
-            graph_executor_->options().compile_options,
-            graph_executor_->fallback_state(), tf_mlir_with_op_keys.get(),
-            cost_recorder));
+            compile_options, graph_executor_->fallback_state(),
+            tf_mlir_with_op_keys.get(), cost_recorder));
     mlrt::bc::Executable executable(bytecode_buffer.data());
     auto bytecode_executable = std::make_unique<mlrt::LoadedExecutable>(
         executable, *graph_executor_->kernel_registry_);
@@ -1086,6 +1096,13 @@ absl::Status GraphExecutor::LoadedClientGraph::UpdateCost(
     mlir::StatusScopedDiagnosticHandler diag_handler(
         tfrt_mlir.get().getContext());
     tfrt_compiler::UpdateOpCostInTfrtMlir(tfrt_mlir.get(), cost_recorder);
+    if (inline_cost_threshold > 0) {
+      // Stream Analysis reads the threshold from the module.
+      tfrt_mlir.get()->setAttr(
+          "tfrt.cost_threshold",
+          mlir::Builder(tfrt_mlir.get()).getI64IntegerAttr(
+              compile_options.cost_threshold));
+    }
     // Recompile from the updated TFRT MLIR, during which Stream Analysis is
     // redone.
     auto bef = tfrt::ConvertMLIRToBEF(tfrt_mlir.get(),
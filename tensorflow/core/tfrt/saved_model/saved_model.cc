@@ -76,6 +76,7 @@ limitations under the License.
 #include "tensorflow/core/tfrt/mlrt/kernel/kernel.h"
 #include "tensorflow/core/tfrt/runtime/runtime.h"
 #include "tensorflow/core/tfrt/saved_model/saved_model_util.h"
+#include "tensorflow/core/tfrt/saved_model/saved_model_warmup.h"
 #include "tensorflow/core/tfrt/saved_model/utils/serialize_utils.h"
 #include "tensorflow/core/tfrt/stubs/model_config_stub.h"
 #include "tensorflow/core/tfrt/utils/utils.h"
@@ -828,13 +829,24 @@ absl::StatusOr<std::unique_ptr<SavedModel>> SavedModelImpl::LoadSavedModel(
   }
 
   // Finally, create the saved model.
-  return {std::make_unique<SavedModelImpl>(
+  const SavedModel::Options::WarmupOptions warmup_options =
+      options.warmup_options;
+  auto saved_model = std::make_unique<SavedModelImpl>(
       std::move(options), std::move(symbol_uids), std::move(meta_graph_def),
       std::move(bef), std::move(bef_file), std::move(bytecode),
       std::move(loaded_executable),
       std::move(initializers_and_signatures.signature_map),
       std::move(runner_table), std::move(resource_array),
-      std::move(graph_executor), inferred_model_type)};
+      std::move(graph_executor), inferred_model_type);
+
+  // Warm up the model before it is returned, so that the first requests after
+  // loading do not pay for kernel instantiation and compilation.
+  if (warmup_options.enable) {
+    TF_RETURN_IF_ERROR(
+        WarmupSavedModel(warmup_options, saved_model_dir, *saved_model)
+            .status());
+  }
+  return {std::move(saved_model)};
 }
 
 SavedModelImpl::SavedModelImpl(
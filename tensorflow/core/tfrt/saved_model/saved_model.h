@@ -118,6 +118,43 @@ class SavedModel {
     GraphExecutionOptions graph_execution_options;
 
     bool disable_output_filter = false;
+
+    // Options for running warm-up requests at load time, so that the first
+    // real requests do not pay for kernel instantiation and compilation.
+    struct WarmupOptions {
+      // If true, warm-up requests are run before the model is returned by
+      // LoadSavedModel().
+      bool enable = false;
+
+      // If true and the SavedModel has
+      // `assets.extra/tf_serving_warmup_requests`, the recorded requests are
+      // replayed. Otherwise, a synthetic request is generated for each
+      // signature and batch size in `synthetic_batch_sizes`.
+      bool replay_warmup_requests = true;
+
+      // The maximum number of recorded requests to replay.
+      int max_replayed_requests = 1000;
+
+      // The batch sizes of the synthetic requests. Unknown leading dimensions
+      // in the signature input specs are set to the batch size and the other
+      // unknown dimensions are set to 1.
+      std::vector<int> synthetic_batch_sizes = {1};
+
+      // If true, batch ops run each warm-up request at all of their allowed
+      // batch sizes. See `serving::WarmupStateRegistry`.
+      bool warmup_all_batch_sizes = true;
+
+      // The number of times each warm-up request is run.
+      int num_request_iterations = 1;
+
+      // The number of threads that run the warm-up requests.
+      int num_threads = 4;
+
+      // If true, loading fails when a warm-up request fails. Otherwise the
+      // failures are only logged and reported in the warm-up stats.
+      bool fail_on_error = false;
+    };
+    WarmupOptions warmup_options;
   };
 
   // Per-request options.
@@ -0,0 +1,417 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/tfrt/saved_model/saved_model_warmup.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/functional/function_ref.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "tensorflow/cc/saved_model/constants.h"
+#include "tensorflow/cc/saved_model/signature_constants.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/batching_util/warmup.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/lib/monitoring/counter.h"
+#include "tensorflow/core/lib/monitoring/gauge.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/path.h"
+#include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/platform/threadpool.h"
+#include "tensorflow/core/tfrt/saved_model/saved_model.h"
+#include "tsl/platform/errors.h"
+
+namespace tensorflow {
+namespace tfrt_stub {
+namespace {
+
+using ::tensorflow::protobuf::internal::WireFormatLite;
+
+// Field numbers of the parts of `tensorflow.serving.PredictionLog` that are
+// replayed. The serving protos are not a dependency of TensorFlow, so the
+// records are decoded from their wire format.
+constexpr int kPredictionLogPredictLogField = 6;
+constexpr int kPredictLogRequestField = 1;
+constexpr int kPredictRequestModelSpecField = 1;
+constexpr int kPredictRequestInputsField = 2;
+constexpr int kModelSpecSignatureNameField = 3;
+constexpr int kMapEntryKeyField = 1;
+constexpr int kMapEntryValueField = 2;
+
+auto* saved_model_warmup_time_milliseconds =
+    tensorflow::monitoring::Gauge<int64_t, 1>::New(
+        "/tensorflow/tfrt/saved_model/warmup_time",
+        "Record the warm-up time in milliseconds for the savedmodel.",
+        "model_name");
+
+auto* saved_model_warmup_coverage =
+    tensorflow::monitoring::Gauge<double, 1>::New(
+        "/tensorflow/tfrt/saved_model/warmup_coverage",
+        "Record the fraction of signatures of the savedmodel that were warmed "
+        "up by at least one successful request.",
+        "model_name");
+
+auto* saved_model_warmup_request_count = monitoring::Counter<2>::New(
+    "/tensorflow/tfrt/saved_model/warmup_request_count",
+    "The total number of warm-up requests.", "model_name", "status");
+
+// Calls `fn` with the field number and the bytes of each length-delimited
+// field of the serialized `message`, skipping the other fields. Returns false
+// if `message` is malformed.
+bool ForEachLengthDelimitedField(
+    absl::string_view message,
+    absl::FunctionRef<void(int, absl::string_view)> fn) {
+  protobuf::io::CodedInputStream input(
+      reinterpret_cast<const uint8_t*>(message.data()), message.size());
+  while (true) {
+    const uint32_t tag = input.ReadTag();
+    if (tag == 0) {
+      return input.CurrentPosition() == static_cast<int>(message.size());
+    }
+    if (WireFormatLite::GetTagWireType(tag) !=
+        WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      if (!WireFormatLite::SkipField(&input, tag)) return false;
+      continue;
+    }
+    uint32_t length;
+    if (!input.ReadVarint32(&length)) return false;
+    const int start = input.CurrentPosition();
+    if (!input.Skip(length)) return false;
+    fn(WireFormatLite::GetTagFieldNumber(tag), message.substr(start, length));
+  }
+}
+
+// Returns the last occurrence of the length-delimited field `field_number` in
+// the serialized `message`, or nullopt if it is missing or `message` is
+// malformed.
+std::optional<absl::string_view> FindField(absl::string_view message,
+                                           int field_number) {
+  std::optional<absl::string_view> result;
+  if (!ForEachLengthDelimitedField(
+          message, [&](int field, absl::string_view value) {
+            if (field == field_number) result = value;
+          })) {
+    return std::nullopt;
+  }
+  return result;
+}
+
+// Decodes the PredictRequest of the serialized PredictionLog `record`. Returns
+// false if `record` is not a well-formed PredictLog.
+bool DecodePredictRequest(
+    absl::string_view record, std::string* signature_name,
+    absl::flat_hash_map<std::string, TensorProto>* inputs) {
+  const std::optional<absl::string_view> predict_log =
+      FindField(record, kPredictionLogPredictLogField);
+  if (!predict_log.has_value()) return false;
+  const std::optional<absl::string_view> request =
+      FindField(*predict_log, kPredictLogRequestField);
+  if (!request.has_value()) return false;
+
+  bool ok = true;
+  if (!ForEachLengthDelimitedField(
+          *request, [&](int field, absl::string_view value) {
+            if (field == kPredictRequestModelSpecField) {
+              const std::optional<absl::string_view> name =
+                  FindField(value, kModelSpecSignatureNameField);
+              *signature_name = std::string(name.value_or(""));
+            } else if (field == kPredictRequestInputsField) {
+              const std::optional<absl::string_view> key =
+                  FindField(value, kMapEntryKeyField);
+              const std::optional<absl::string_view> tensor =
+                  FindField(value, kMapEntryValueField);
+              TensorProto proto;
+              if (!key.has_value() ||
+                  !proto.ParseFromArray(tensor.value_or("").data(),
+                                        tensor.value_or("").size())) {
+                ok = false;
+                return;
+              }
+              (*inputs)[std::string(*key)] = std::move(proto);
+            }
+          })) {
+    return false;
+  }
+  if (signature_name->empty()) {
+    *signature_name = kDefaultServingSignatureDefKey;
+  }
+  return ok;
+}
+
+// Returns a zero-filled tensor for `spec`, with unknown leading dimensions set
+// to `batch_size` and the other unknown dimensions set to 1. Sets `*batched`
+// if the tensor depends on `batch_size`. Returns nullopt if the dtype cannot be
+// synthesized.
+std::optional<Tensor> MakeSyntheticTensor(const TensorSpec& spec,
+                                          int batch_size, bool* batched) {
+  if (!DataTypeCanUseMemcpy(spec.dtype) && spec.dtype != DT_STRING) {
+    return std::nullopt;
+  }
+  TensorShape shape;
+  if (spec.shape.unknown_rank()) {
+    shape.AddDim(batch_size);
+    *batched = true;
+  } else {
+    for (int i = 0; i < spec.shape.dims(); ++i) {
+      int64_t dim = spec.shape.dim_size(i);
+      if (dim < 0) {
+        dim = i == 0 ? batch_size : 1;
+        *batched |= i == 0;
+      }
+      shape.AddDim(dim);
+    }
+  }
+  Tensor tensor(spec.dtype, shape);
+  if (spec.dtype != DT_STRING && tensor.TotalBytes() > 0) {
+    std::memset(const_cast<char*>(tensor.tensor_data().data()), 0,
+                tensor.TotalBytes());
+  }
+  return tensor;
+}
+
+}  // namespace
+
+absl::StatusOr<std::vector<WarmupRequest>> ReadWarmupRequests(
+    const SavedModel& saved_model, absl::string_view saved_model_dir,
+    int max_requests, int* num_skipped_records) {
+  *num_skipped_records = 0;
+  std::vector<WarmupRequest> requests;
+  const std::string path =
+      io::JoinPath(saved_model_dir, kSavedModelAssetsExtraDirectory,
+                   kWarmupRequestsFilename);
+  Env* env = Env::Default();
+  if (!env->FileExists(path).ok()) return requests;
+
+  std::unique_ptr<RandomAccessFile> file;
+  TF_RETURN_IF_ERROR(env->NewRandomAccessFile(path, &file));
+  io::SequentialRecordReader reader(file.get());
+  tstring record;
+  while (requests.size() < static_cast<size_t>(max_requests)) {
+    const absl::Status status = reader.ReadRecord(&record);
+    if (absl::IsOutOfRange(status)) break;
+    TF_RETURN_IF_ERROR(status);
+
+    WarmupRequest request;
+    absl::flat_hash_map<std::string, TensorProto> inputs;
+    if (!DecodePredictRequest(record, &request.signature_name, &inputs)) {
+      ++*num_skipped_records;
+      continue;
+    }
+    const std::optional<FunctionMetadata> metadata =
+        saved_model.GetFunctionMetadata(request.signature_name);
+    if (!metadata.has_value()) {
+      ++*num_skipped_records;
+      continue;
+    }
+    bool complete = true;
+    for (const std::string& name : metadata->GetInputNames()) {
+      auto iter = inputs.find(name);
+      const TensorProto* proto = nullptr;
+      if (iter != inputs.end()) {
+        proto = &iter->second;
+      } else if (auto default_iter = metadata->GetDefaultInputs().find(name);
+                 default_iter != metadata->GetDefaultInputs().end()) {
+        proto = &default_iter->second;
+      }
+      Tensor tensor;
+      if (proto == nullptr || !tensor.FromProto(*proto)) {
+        complete = false;
+        break;
+      }
+      request.inputs.push_back(std::move(tensor));
+    }
+    if (!complete) {
+      ++*num_skipped_records;
+      continue;
+    }
+    requests.push_back(std::move(request));
+  }
+  return requests;
+}
+
+std::vector<WarmupRequest> GenerateSyntheticWarmupRequests(
+    const SavedModel& saved_model, const std::vector<int>& batch_sizes) {
+  std::vector<std::string> signature_names = saved_model.GetFunctionNames();
+  std::sort(signature_names.begin(), signature_names.end());
+
+  std::vector<WarmupRequest> requests;
+  for (const std::string& signature_name : signature_names) {
+    const std::optional<FunctionMetadata> metadata =
+        saved_model.GetFunctionMetadata(signature_name);
+    if (!metadata.has_value()) continue;
+    for (int batch_size : batch_sizes) {
+      WarmupRequest request;
+      request.signature_name = signature_name;
+      bool batched = false;
+      bool complete = true;
+      for (const TensorSpec& spec : metadata->GetInputSpecs()) {
+        std::optional<Tensor> tensor =
+            MakeSyntheticTensor(spec, std::max(batch_size, 1), &batched);
+        if (!tensor.has_value()) {
+          complete = false;
+          break;
+        }
+        request.inputs.push_back(*std::move(tensor));
+      }
+      if (!complete) break;
+      requests.push_back(std::move(request));
+      // Requests with no batched inputs are the same for all batch sizes.
+      if (!batched) break;
+    }
+  }
+  return requests;
+}
+
+absl::StatusOr<WarmupStats> WarmupSavedModel(
+    const SavedModel::Options::WarmupOptions& options,
+    absl::string_view saved_model_dir, SavedModel& saved_model) {
+  const absl::Time start_time = absl::Now();
+  WarmupStats stats;
+  const std::vector<std::string> signature_names =
+      saved_model.GetFunctionNames();
+  stats.num_signatures = signature_names.size();
+
+  std::vector<WarmupRequest> requests;
+  if (options.replay_warmup_requests) {
+    absl::StatusOr<std::vector<WarmupRequest>> replayed =
+        ReadWarmupRequests(saved_model, saved_model_dir,
+                           options.max_replayed_requests,
+                           &stats.num_skipped_records);
+    if (replayed.ok()) {
+      requests = *std::move(replayed);
+      stats.num_replayed_requests = requests.size();
+    } else if (options.fail_on_error) {
+      return replayed.status();
+    } else {
+      LOG(WARNING) << "Failed to read the warm-up requests of "
+                   << saved_model_dir << ": " << replayed.status();
+    }
+  }
+  if (requests.empty()) {
+    requests = GenerateSyntheticWarmupRequests(saved_model,
+                                               options.synthetic_batch_sizes);
+    stats.num_synthetic_requests = requests.size();
+  }
+
+  // Let the batch ops run the warm-up requests at all their allowed batch
+  // sizes while the model is registered.
+  std::optional<serving::WarmupStateRegistry::Handle> warmup_handle;
+  const SessionMetadata& model_metadata = saved_model.model_metadata();
+  if (options.warmup_all_batch_sizes && !model_metadata.name().empty()) {
+    auto per_model_data =
+        std::make_unique<serving::WarmupStateRegistry::PerModelData>();
+    per_model_data->warmup_all_batch_sizes = true;
+    auto handle = serving::GetGlobalWarmupStateRegistry().Register(
+        {model_metadata.name(), model_metadata.version()},
+        std::move(per_model_data));
+    if (handle.ok()) {
+      warmup_handle.emplace(*std::move(handle));
+    } else {
+      LOG(WARNING) << "Failed to register " << model_metadata.name()
+                   << " for warm-up: " << handle.status();
+    }
+  }
+
+  mutex mu;
+  absl::flat_hash_set<std::string> warmed_up_signatures;
+  absl::Status first_error;
+  {
+    thread::ThreadPool thread_pool(Env::Default(), "tfrt_saved_model_warmup",
+                                   std::max(options.num_threads, 1));
+    for (const WarmupRequest& request : requests) {
+      for (int i = 0; i < std::max(options.num_request_iterations, 1); ++i) {
+        thread_pool.Schedule([&]() {
+          std::vector<Tensor> outputs;
+          const absl::Status status = saved_model.Run(
+              /*run_options=*/{}, request.signature_name, request.inputs,
+              &outputs);
+          mutex_lock lock(mu);
+          ++stats.num_requests;
+          if (status.ok()) {
+            warmed_up_signatures.insert(request.signature_name);
+            return;
+          }
+          ++stats.num_failed_requests;
+          if (first_error.ok()) {
+            first_error = absl::Status(
+                status.code(), absl::StrCat("Warm-up request to signature ",
+                                            request.signature_name,
+                                            " failed: ", status.message()));
+          }
+        });
+      }
+    }
+    // The thread pool waits for the scheduled requests on destruction.
+  }
+  warmup_handle.reset();
+
+  stats.num_warmed_up_signatures = warmed_up_signatures.size();
+  for (const std::string& signature_name : signature_names) {
+    if (!warmed_up_signatures.contains(signature_name)) {
+      stats.uncovered_signatures.push_back(signature_name);
+    }
+  }
+  std::sort(stats.uncovered_signatures.begin(),
+            stats.uncovered_signatures.end());
+  stats.duration = absl::Now() - start_time;
+
+  const std::string model_name(saved_model_dir);
+  saved_model_warmup_time_milliseconds->GetCell(model_name)
+      ->Set(absl::ToInt64Milliseconds(stats.duration));
+  saved_model_warmup_coverage->GetCell(model_name)
+      ->Set(stats.num_signatures == 0
+                ? 1.0
+                : static_cast<double>(stats.num_warmed_up_signatures) /
+                      stats.num_signatures);
+  saved_model_warmup_request_count->GetCell(model_name, "ok")
+      ->IncrementBy(stats.num_requests - stats.num_failed_requests);
+  saved_model_warmup_request_count->GetCell(model_name, "error")
+      ->IncrementBy(stats.num_failed_requests);
+
+  LOG(INFO) << "TFRT finished warming up savedmodel. Took "
+            << absl::ToInt64Milliseconds(stats.duration) << " ms. Warmed up "
+            << stats.num_warmed_up_signatures << " of " << stats.num_signatures
+            << " signatures with " << stats.num_requests << " requests ("
+            << stats.num_replayed_requests << " replayed, "
+            << stats.num_synthetic_requests << " synthetic, "
+            << stats.num_skipped_records << " records skipped, "
+            << stats.num_failed_requests << " failed).";
+  if (!first_error.ok()) {
+    LOG(WARNING) << first_error;
+    if (options.fail_on_error) return first_error;
+  }
+  return stats;
+}
+
+}  // namespace tfrt_stub
+}  // namespace tensorflow
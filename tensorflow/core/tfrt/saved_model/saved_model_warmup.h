@@ -0,0 +1,89 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_TFRT_SAVED_MODEL_SAVED_MODEL_WARMUP_H_
+#define TENSORFLOW_CORE_TFRT_SAVED_MODEL_SAVED_MODEL_WARMUP_H_
+
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/tfrt/saved_model/saved_model.h"
+
+namespace tensorflow {
+namespace tfrt_stub {
+
+// Filename of the recorded warm-up requests under `assets.extra`, as written
+// for TensorFlow Serving.
+inline constexpr char kWarmupRequestsFilename[] = "tf_serving_warmup_requests";
+
+// A request that is run against a signature to warm up the model.
+struct WarmupRequest {
+  std::string signature_name;
+  // The inputs in the order of the signature's input names.
+  std::vector<tensorflow::Tensor> inputs;
+};
+
+// Coverage and duration of the warm-up of a model.
+struct WarmupStats {
+  // The number of signatures in the model.
+  int num_signatures = 0;
+  // The number of signatures with at least one successful warm-up request.
+  int num_warmed_up_signatures = 0;
+  // The number of warm-up requests run, counting each iteration.
+  int num_requests = 0;
+  int num_failed_requests = 0;
+  // The number of requests replayed from the warm-up records.
+  int num_replayed_requests = 0;
+  // The number of warm-up records that could not be replayed, e.g. because
+  // they are not PredictRequests or they target an unknown signature.
+  int num_skipped_records = 0;
+  // The number of synthetic requests generated from the signatures.
+  int num_synthetic_requests = 0;
+  // The signatures that no warm-up request succeeded on.
+  std::vector<std::string> uncovered_signatures;
+  absl::Duration duration;
+};
+
+// Reads the recorded warm-up requests of the SavedModel at `saved_model_dir`.
+// Returns an empty list if the SavedModel has no warm-up records. Only the
+// PredictRequests in the `tensorflow.serving.PredictionLog` records are read,
+// at most `max_requests` of them; the other records are counted in
+// `num_skipped_records`.
+absl::StatusOr<std::vector<WarmupRequest>> ReadWarmupRequests(
+    const SavedModel& saved_model, absl::string_view saved_model_dir,
+    int max_requests, int* num_skipped_records);
+
+// Generates a zero-filled request for each signature of `saved_model` and each
+// of `batch_sizes`. Signatures with inputs that cannot be synthesized, e.g.
+// resources or variants, are left out.
+std::vector<WarmupRequest> GenerateSyntheticWarmupRequests(
+    const SavedModel& saved_model, const std::vector<int>& batch_sizes);
+
+// Warms up `saved_model` according to `options`, running the requests on a
+// background thread pool and waiting for all of them to finish. The returned
+// stats are also exported as metrics labeled by `saved_model_dir`. Returns an
+// error only if `options.fail_on_error` is set and a request failed.
+absl::StatusOr<WarmupStats> WarmupSavedModel(
+    const SavedModel::Options::WarmupOptions& options,
+    absl::string_view saved_model_dir, SavedModel& saved_model);
+
+}  // namespace tfrt_stub
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_TFRT_SAVED_MODEL_SAVED_MODEL_WARMUP_H_
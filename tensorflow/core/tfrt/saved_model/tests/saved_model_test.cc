@@ -28,6 +28,8 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
@@ -36,9 +38,15 @@ limitations under the License.
 #include "tensorflow/compiler/mlir/tfrt/backend_compiler.h"
 #include "xla/tsl/lib/core/status_test_util.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/lib/io/record_writer.h"
+#include "tensorflow/core/platform/coding.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/resource_loader.h"
+#include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/tfrt/graph_executor/config.h"
 #include "tensorflow/core/tfrt/graph_executor/test_config.pb.h"
 #include "tensorflow/core/tfrt/run_handler_thread_pool/run_handler_concurrent_work_queue.h"
@@ -46,6 +54,7 @@ limitations under the License.
 #include "tensorflow/core/tfrt/runtime/work_queue_interface.h"
 #include "tensorflow/core/tfrt/saved_model/saved_model_testutil.h"
 #include "tensorflow/core/tfrt/saved_model/saved_model_util.h"
+#include "tensorflow/core/tfrt/saved_model/saved_model_warmup.h"
 #include "tsl/platform/status.h"
 #include "tsl/platform/statusor.h"
 #include "tfrt/host_context/concurrent_work_queue.h"  // from @tf_runtime
@@ -673,6 +682,156 @@ TEST(SavedModelTest, FunctionMetadata) {
                   &TensorSpec::dtype, tensorflow::DT_INT32)}));
 }
 
+TEST(SavedModelTest, SyntheticWarmupRequests) {
+  std::string saved_model_dir = tensorflow::GetDataDependencyFilepath(
+      "tensorflow/core/tfrt/saved_model/tests/toy_v1/1");
+
+  TFRTSavedModelTest test(saved_model_dir);
+  auto* saved_model = test.GetSavedModel();
+
+  // The input of signature 'toy' has a static shape, so a single request is
+  // generated for all batch sizes.
+  std::vector<WarmupRequest> requests =
+      GenerateSyntheticWarmupRequests(*saved_model, /*batch_sizes=*/{1, 4});
+  ASSERT_EQ(requests.size(), 1);
+  EXPECT_EQ(requests[0].signature_name, "toy");
+  ASSERT_EQ(requests[0].inputs.size(), 1);
+  EXPECT_EQ(requests[0].inputs[0].shape(), TensorShape({1, 3}));
+
+  SavedModel::Options::WarmupOptions warmup_options;
+  warmup_options.enable = true;
+  warmup_options.num_request_iterations = 3;
+  TF_ASSERT_OK_AND_ASSIGN(
+      WarmupStats stats,
+      WarmupSavedModel(warmup_options, saved_model_dir, *saved_model));
+  EXPECT_EQ(stats.num_signatures, 1);
+  EXPECT_EQ(stats.num_warmed_up_signatures, 1);
+  EXPECT_EQ(stats.num_synthetic_requests, 1);
+  EXPECT_EQ(stats.num_replayed_requests, 0);
+  EXPECT_EQ(stats.num_requests, 3);
+  EXPECT_EQ(stats.num_failed_requests, 0);
+  EXPECT_TRUE(stats.uncovered_signatures.empty());
+}
+
+// Returns the length-delimited field `field_number` holding `value`, in the
+// protobuf wire format.
+std::string LengthDelimitedField(int field_number, absl::string_view value) {
+  std::string field;
+  core::PutVarint32(&field, (field_number << 3) | 2);
+  core::PutVarint32(&field, value.size());
+  absl::StrAppend(&field, value);
+  return field;
+}
+
+// Returns a serialized `tensorflow.serving.PredictionLog` holding a
+// PredictRequest to `signature_name` with the single input `input_name`.
+std::string PredictionLogRecord(absl::string_view signature_name,
+                                absl::string_view input_name,
+                                const tensorflow::Tensor& input) {
+  TensorProto input_proto;
+  input.AsProtoTensorContent(&input_proto);
+  // ModelSpec.signature_name and the `inputs` map entry of PredictRequest.
+  const std::string model_spec = LengthDelimitedField(3, signature_name);
+  const std::string inputs_entry =
+      absl::StrCat(LengthDelimitedField(1, input_name),
+                   LengthDelimitedField(2, input_proto.SerializeAsString()));
+  const std::string request =
+      absl::StrCat(LengthDelimitedField(1, model_spec),
+                   LengthDelimitedField(2, inputs_entry));
+  // PredictionLog.predict_log and PredictLog.request.
+  return LengthDelimitedField(6, LengthDelimitedField(1, request));
+}
+
+TEST(SavedModelTest, ReplayedWarmupRequests) {
+  std::string saved_model_dir = tensorflow::GetDataDependencyFilepath(
+      "tensorflow/core/tfrt/saved_model/tests/toy_v1/1");
+
+  TFRTSavedModelTest test(saved_model_dir);
+  auto* saved_model = test.GetSavedModel();
+
+  // The warm-up records are only read from `assets.extra`, so they are written
+  // to a directory of their own.
+  const std::string warmup_dir =
+      tensorflow::io::JoinPath(testing::TmpDir(), "replayed_warmup_requests");
+  const std::string assets_extra_dir =
+      tensorflow::io::JoinPath(warmup_dir, "assets.extra");
+  tensorflow::Env* env = tensorflow::Env::Default();
+  TF_ASSERT_OK(env->RecursivelyCreateDir(assets_extra_dir));
+  const tensorflow::Tensor input =
+      CreateTfTensor<int32_t>(/*shape=*/{1, 3}, /*data=*/{1, 2, 3});
+  {
+    std::unique_ptr<tensorflow::WritableFile> file;
+    TF_ASSERT_OK(env->NewWritableFile(
+        tensorflow::io::JoinPath(assets_extra_dir, kWarmupRequestsFilename),
+        &file));
+    tensorflow::io::RecordWriter writer(file.get());
+    TF_ASSERT_OK(writer.WriteRecord(PredictionLogRecord("toy", "x1", input)));
+    // A ClassifyLog, which is not replayed.
+    TF_ASSERT_OK(writer.WriteRecord(LengthDelimitedField(1, "")));
+    // A PredictionLog cut short in the middle of its PredictLog.
+    TF_ASSERT_OK(writer.WriteRecord(
+        PredictionLogRecord("toy", "x1", input).substr(0, 10)));
+    // Requests to an unknown signature and without the signature's input.
+    TF_ASSERT_OK(
+        writer.WriteRecord(PredictionLogRecord("unknown", "x1", input)));
+    TF_ASSERT_OK(writer.WriteRecord(PredictionLogRecord("toy", "x2", input)));
+    TF_ASSERT_OK(writer.Close());
+    TF_ASSERT_OK(file->Close());
+  }
+
+  int num_skipped_records = 0;
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::vector<WarmupRequest> requests,
+      ReadWarmupRequests(*saved_model, warmup_dir, /*max_requests=*/10,
+                         &num_skipped_records));
+  EXPECT_EQ(num_skipped_records, 4);
+  ASSERT_EQ(requests.size(), 1);
+  EXPECT_EQ(requests[0].signature_name, "toy");
+  ASSERT_EQ(requests[0].inputs.size(), 1);
+  EXPECT_THAT(GetTfTensorData<int32_t>(requests[0].inputs[0]),
+              ::testing::ElementsAreArray({1, 2, 3}));
+
+  SavedModel::Options::WarmupOptions warmup_options;
+  warmup_options.enable = true;
+  warmup_options.num_request_iterations = 2;
+  warmup_options.fail_on_error = true;
+  TF_ASSERT_OK_AND_ASSIGN(
+      WarmupStats stats,
+      WarmupSavedModel(warmup_options, warmup_dir, *saved_model));
+  EXPECT_EQ(stats.num_replayed_requests, 1);
+  EXPECT_EQ(stats.num_skipped_records, 4);
+  EXPECT_EQ(stats.num_synthetic_requests, 0);
+  EXPECT_EQ(stats.num_requests, 2);
+  EXPECT_EQ(stats.num_failed_requests, 0);
+  EXPECT_EQ(stats.num_warmed_up_signatures, 1);
+  EXPECT_TRUE(stats.uncovered_signatures.empty());
+}
+
+TEST(SavedModelTest, WarmupOnLoad) {
+  std::string saved_model_dir = tensorflow::GetDataDependencyFilepath(
+      "tensorflow/core/tfrt/saved_model/tests/toy_v1/1");
+
+  auto runtime = DefaultTfrtRuntime(/*num_threads=*/1);
+  auto options = DefaultSavedModelOptions(runtime.get());
+  options.enable_lazy_loading = true;
+  options.warmup_options.enable = true;
+  options.warmup_options.fail_on_error = true;
+
+  TF_ASSERT_OK_AND_ASSIGN(
+      auto saved_model,
+      SavedModelImpl::LoadSavedModel(options, saved_model_dir,
+                                     /*tags=*/{"serve"}));
+
+  std::vector<tensorflow::Tensor> inputs;
+  inputs.push_back(
+      CreateTfTensor<int32_t>(/*shape=*/{1, 3}, /*data=*/{1, 1, 1}));
+  std::vector<tensorflow::Tensor> outputs;
+  TF_ASSERT_OK(saved_model->Run({}, "toy", inputs, &outputs));
+  ASSERT_EQ(outputs.size(), 1);
+  EXPECT_THAT(GetTfTensorData<int32_t>(outputs[0]),
+              ::testing::ElementsAreArray({6}));
+}
+
 TEST(SavedModelTest, WrongShape) {
   // SavedModel toy contains a graph of a single 'tf.AddV2' op. It is generated
   // using the following python code:
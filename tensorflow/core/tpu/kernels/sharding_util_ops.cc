@@ -457,6 +457,7 @@ class AssignVariableXlaConcatNDOp : public XlaConcatNDBaseOp<Device, T> {
     this->ComputeInternal(/*resource=*/true, ctx, inputs,
                           assign_or_copy_value_fn, get_output_fn);
     variable->is_initialized = true;
+    variable->MarkAllRowsDirty();
   }
 
   DataType dtype_;
@@ -38,7 +38,9 @@ limitations under the License.
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/node_builder.h"
 #include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/platform/status.h"
+#include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/protobuf/config.pb.h"
 #include "tensorflow/core/public/session.h"
 #include "tensorflow/core/public/session_options.h"
@@ -788,6 +790,96 @@ TEST(AssignVariableXlaConcatNDOpTest, AssignDifferentShape) {
                                 /*atol=*/1e-6);
 }
 
+TEST(AssignVariableXlaConcatNDOpTest, SavesAssignedVariableInDelta) {
+  Graph graph(OpRegistry::Global());
+
+  Node* var_handle = nullptr;
+  DataType data_type = DataTypeToEnum<float>::value;
+  const TensorShape input_shape({4, 2});
+  TF_ASSERT_OK(NodeBuilder(graph.NewName("var_handle"), "VarHandleOp")
+                   .Attr("dtype", data_type)
+                   .Attr("shape", input_shape)
+                   .Finalize(&graph, &var_handle));
+
+  Tensor init_input_tensor(data_type, input_shape);
+  test::FillFn<float>(&init_input_tensor, [](int unused) { return -1.f; });
+  Node* init_input = test::graph::Constant(&graph, init_input_tensor);
+
+  Node* assign_var = nullptr;
+  TF_ASSERT_OK(NodeBuilder(graph.NewName("assign_var"), "AssignVariableOp")
+                   .Input(var_handle)
+                   .Input(init_input)
+                   .Attr("dtype", data_type)
+                   .Finalize(&graph, &assign_var));
+
+  // Saves the variable in full, which starts tracking its updated rows.
+  const std::string full_prefix =
+      io::JoinPath(testing::TmpDir(), "xla_concat_full");
+  const std::string delta_prefix =
+      io::JoinPath(testing::TmpDir(), "xla_concat_delta");
+  Node* tensor_names =
+      test::graph::Constant(&graph, test::AsTensor<tstring>({"var"}));
+  Node* full_save = nullptr;
+  TF_ASSERT_OK(
+      NodeBuilder(graph.NewName("full_save"), "SaveVariableDeltas")
+          .Input(test::graph::Constant(&graph,
+                                       test::AsScalar<tstring>(full_prefix)))
+          .Input(test::graph::Constant(&graph, test::AsScalar<tstring>("")))
+          .Input(tensor_names)
+          .Input(std::vector<NodeBuilder::NodeOut>{var_handle})
+          .ControlInput(assign_var)
+          .Attr("N", 1)
+          .Finalize(&graph, &full_save));
+
+  Tensor update_input_tensor(data_type, input_shape);
+  test::FillIota<float>(&update_input_tensor, /*val=*/0.f);
+  Node* update_input = test::graph::Constant(&graph, update_input_tensor);
+
+  Node* xla_op = nullptr;
+  const std::vector<int32_t> num_concats = {1, 1};
+  const int num_inputs = 1;
+  TF_ASSERT_OK(NodeBuilder(graph.NewName("xla_op"), "AssignVariableXlaConcatND")
+                   .Input(var_handle)
+                   .Input(std::vector<NodeBuilder::NodeOut>{update_input})
+                   .ControlInput(full_save)
+                   .Attr("num_concats", num_concats)
+                   .Attr("T", data_type)
+                   .Attr("N", num_inputs)
+                   .Finalize(&graph, &xla_op));
+
+  // The delta holds every row, since the assign replaced the variable.
+  Node* delta_save = nullptr;
+  TF_ASSERT_OK(
+      NodeBuilder(graph.NewName("delta_save"), "SaveVariableDeltas")
+          .Input(test::graph::Constant(&graph,
+                                       test::AsScalar<tstring>(delta_prefix)))
+          .Input(test::graph::Constant(&graph,
+                                       test::AsScalar<tstring>(full_prefix)))
+          .Input(tensor_names)
+          .Input(std::vector<NodeBuilder::NodeOut>{var_handle})
+          .ControlInput(xla_op)
+          .Attr("N", 1)
+          .Finalize(&graph, &delta_save));
+
+  Node* restore = nullptr;
+  TF_ASSERT_OK(
+      NodeBuilder(graph.NewName("restore"), "RestoreV2")
+          .Input(test::graph::Constant(&graph,
+                                       test::AsScalar<tstring>(delta_prefix)))
+          .Input(tensor_names)
+          .Input(test::graph::Constant(&graph, test::AsTensor<tstring>({""})))
+          .ControlInput(delta_save)
+          .Attr("dtypes", DataTypeVector{data_type})
+          .Finalize(&graph, &restore));
+
+  std::vector<Tensor> output_tensors;
+  TF_ASSERT_OK(RunGraph(
+      graph, /*output_tensor_names=*/{absl::StrCat(restore->name(), ":", 0)},
+      /*target_tensor_names=*/{}, &output_tensors));
+  ASSERT_EQ(output_tensors.size(), 1);
+  test::ExpectTensorEqual<float>(output_tensors[0], update_input_tensor);
+}
+
 absl::Status CreateConcatTensorGraph(
     absl::Span<const TensorShape> input_shapes,
     absl::Span<const int32_t> num_concats, absl::Span<const int32_t> paddings,
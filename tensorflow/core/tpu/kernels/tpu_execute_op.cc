@@ -578,6 +578,7 @@ absl::StatusOr<std::unique_ptr<OutputBuffers>> AllocateOutputTensors(
                                                 output_tensor_shapes[i],
                                                 var.var()->tensor()));
       transfer_buffers(i, var.var()->tensor());
+      var.var()->MarkAllRowsDirty();
     } else {
       // This output corresponds to a non-resource input to the TPUExecute
       // operator. This case occurs for the distributed TPU rewrite which
@@ -304,6 +304,7 @@ absl::Status UpdateOutputVariables(
         variables[i].var()->tensor()->dtype(), output_tensor_shapes[i],
         variables[i].var()->tensor()));
     transfer_buffers(i, variables[i].var()->tensor());
+    variables[i].var()->MarkAllRowsDirty();
   }
   return allocator->Deallocate(output_buffers.device_ordinal(),
                                output_buffers.buffer({}));
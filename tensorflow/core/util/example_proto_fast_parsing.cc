@@ -16,12 +16,15 @@ limitations under the License.
 
 #include <algorithm>
 #include <functional>
+#include <memory>
+#include <numeric>
 #include <optional>
 #include <utility>
 #include <vector>
 
 #include "absl/base/casts.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/strings/substitute.h"
 #include "tensorflow/core/example/example.pb.h"
@@ -39,7 +42,7 @@ limitations under the License.
 #include "tensorflow/core/platform/byte_order.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/protobuf.h"
-#include "tensorflow/core/util/presized_cuckoo_map.h"
+#include "tensorflow/core/platform/statusor.h"
 #include "tensorflow/core/util/sparse/sparse_tensor.h"
 
 namespace tensorflow {
@@ -561,13 +564,6 @@ struct SparseBuffer {
   std::vector<size_t> example_end_indices;
 };
 
-struct SeededHasher {
-  uint64 operator()(absl::string_view s) const {
-    return Hash64(s.data(), s.size(), seed);
-  }
-  uint64 seed{0xDECAFCAFFE};
-};
-
 void LogDenseFeatureDataLoss(absl::string_view feature_name) {
   LOG(WARNING) << "Data loss! Feature '" << feature_name
                << "' is present in multiple concatenated "
@@ -593,8 +589,8 @@ void LogSparseFeatureDataLoss(absl::string_view feature_name) {
 absl::Status FastParseSerializedExample(
     const tstring& serialized_example, const tstring& example_name,
     const size_t example_index, const Config& config,
-    const PresizedCuckooMap<std::pair<size_t, Type>>& config_index,
-    SeededHasher hasher, std::vector<Tensor>* output_dense,
+    const FastParseExampleIndex& config_index,
+    std::vector<Tensor>* output_dense,
     std::vector<SparseBuffer>* output_varlen_dense,
     std::vector<SparseBuffer>* output_sparse,
     std::vector<SparseBuffer>* output_ragged,
@@ -630,23 +626,12 @@ absl::Status FastParseSerializedExample(
     const absl::string_view feature_name = name_and_feature.first;
     parsed::Feature& feature = name_and_feature.second;
 
-    std::pair<size_t, Type> d_and_type;
-    uint64 h = hasher(feature_name);
-    if (!config_index.Find(h, &d_and_type)) continue;
-
-    size_t d = d_and_type.first;
-    bool is_dense = d_and_type.second == Type::Dense;
-    bool is_ragged = d_and_type.second == Type::Ragged;
+    size_t d;
+    FastParseExampleIndex::Kind kind;
+    if (!config_index.Find(feature_name, &d, &kind)) continue;
 
-    {
-      // Testing for PresizedCuckooMap collision.
-      // TODO(lew): Use dense_hash_map and avoid this and hasher creation.
-      const tstring& config_feature_name =
-          is_dense ? config.dense[d].feature_name
-                   : (is_ragged ? config.ragged[d].feature_name
-                                : config.sparse[d].feature_name);
-      if (feature_name != config_feature_name) continue;
-    }
+    bool is_dense = kind == FastParseExampleIndex::Kind::kDense;
+    bool is_ragged = kind == FastParseExampleIndex::Kind::kRagged;
 
     auto example_error = [&](absl::string_view suffix) {
       return errors::InvalidArgument("Name: ", example_name,
@@ -1134,11 +1119,187 @@ void CopySparseBufferToTensor(DataType dtype, size_t offset, SparseBuffer* src,
 
 }  // namespace
 
+uint64_t FastParseExampleIndex::Hash(absl::string_view name, uint64_t seed) {
+  return Hash64(name.data(), name.size(), seed);
+}
+
+absl::StatusOr<std::unique_ptr<FastParseExampleIndex>>
+FastParseExampleIndex::Create(
+    absl::Span<const absl::string_view> dense_names,
+    absl::Span<const absl::string_view> sparse_names,
+    absl::Span<const absl::string_view> ragged_names) {
+  std::unique_ptr<FastParseExampleIndex> index(new FastParseExampleIndex());
+  struct Key {
+    absl::string_view name;
+    uint32_t index;
+    Kind kind;
+  };
+  std::vector<Key> keys;
+  keys.reserve(dense_names.size() + sparse_names.size() + ragged_names.size());
+  auto add_keys = [&](absl::Span<const absl::string_view> names, Kind kind,
+                      std::vector<std::string>* stored_names) {
+    stored_names->reserve(names.size());
+    for (size_t d = 0; d < names.size(); ++d) {
+      stored_names->emplace_back(names[d]);
+      keys.push_back({names[d], static_cast<uint32_t>(d), kind});
+    }
+  };
+  add_keys(dense_names, Kind::kDense, &index->dense_names_);
+  add_keys(sparse_names, Kind::kSparse, &index->sparse_names_);
+  add_keys(ragged_names, Kind::kRagged, &index->ragged_names_);
+
+  const size_t n = keys.size();
+  if (n == 0) return index;
+
+  absl::flat_hash_set<absl::string_view> seen;
+  for (const Key& key : keys) {
+    if (!seen.insert(key.name).second) {
+      return errors::InvalidArgument("Feature name '", key.name,
+                                     "' appears more than once in the config.");
+    }
+  }
+
+  // Hash-and-displace: names are grouped into buckets by hash, and buckets
+  // are placed largest first, each with the smallest displacement that moves
+  // all of its names to free slots. With twice as many slots as names and
+  // about two names per bucket, this almost always succeeds on the first seed.
+  size_t num_slots = 2;
+  while (num_slots < 2 * n) num_slots *= 2;
+  const size_t num_buckets = std::max<size_t>(1, num_slots / 4);
+  index->slot_mask_ = num_slots - 1;
+  index->bucket_mask_ = num_buckets - 1;
+
+  std::vector<uint64_t> hashes(n);
+  std::vector<std::vector<size_t>> buckets(num_buckets);
+  std::vector<size_t> bucket_order(num_buckets);
+  std::vector<bool> taken(num_slots);
+  std::vector<size_t> bucket_slots;
+  auto try_seed = [&](uint64_t seed) {
+    for (auto& bucket : buckets) bucket.clear();
+    for (size_t i = 0; i < n; ++i) {
+      hashes[i] = Hash(keys[i].name, seed);
+      buckets[hashes[i] & index->bucket_mask_].push_back(i);
+    }
+    std::iota(bucket_order.begin(), bucket_order.end(), 0);
+    std::stable_sort(bucket_order.begin(), bucket_order.end(),
+                     [&](size_t a, size_t b) {
+                       return buckets[a].size() > buckets[b].size();
+                     });
+    std::fill(taken.begin(), taken.end(), false);
+    index->displacements_.assign(num_buckets, 0);
+    index->slots_.assign(num_slots, Slot());
+    for (size_t b : bucket_order) {
+      const std::vector<size_t>& members = buckets[b];
+      if (members.empty()) break;
+      bool placed = false;
+      for (uint32_t displacement = 0; displacement < num_slots && !placed;
+           ++displacement) {
+        bucket_slots.clear();
+        placed = true;
+        for (size_t i : members) {
+          const size_t slot = index->SlotOf(hashes[i], displacement);
+          if (taken[slot] || std::find(bucket_slots.begin(), bucket_slots.end(),
+                                       slot) != bucket_slots.end()) {
+            placed = false;
+            break;
+          }
+          bucket_slots.push_back(slot);
+        }
+        if (!placed) continue;
+        index->displacements_[b] = displacement;
+        for (size_t j = 0; j < members.size(); ++j) {
+          const Key& key = keys[members[j]];
+          Slot& slot = index->slots_[bucket_slots[j]];
+          taken[bucket_slots[j]] = true;
+          slot.name = std::string(key.name);
+          slot.index = key.index;
+          slot.kind = key.kind;
+          slot.used = true;
+        }
+      }
+      if (!placed) return false;
+    }
+    return true;
+  };
+
+  constexpr uint64_t kInitialSeed = 0xDECAFCAFFE;
+  for (uint64_t seed = kInitialSeed; seed < kInitialSeed + 1000; ++seed) {
+    if (try_seed(seed)) {
+      index->seed_ = seed;
+      return index;
+    }
+  }
+  return errors::Internal(
+      "Could not avoid collision. This should not happen.");
+}
+
+absl::StatusOr<std::unique_ptr<FastParseExampleIndex>>
+FastParseExampleIndex::Create(const FastParseExampleConfig& config) {
+  std::vector<absl::string_view> dense_names;
+  std::vector<absl::string_view> sparse_names;
+  std::vector<absl::string_view> ragged_names;
+  dense_names.reserve(config.dense.size());
+  for (const auto& dense : config.dense) {
+    dense_names.push_back(dense.feature_name);
+  }
+  sparse_names.reserve(config.sparse.size());
+  for (const auto& sparse : config.sparse) {
+    sparse_names.push_back(sparse.feature_name);
+  }
+  ragged_names.reserve(config.ragged.size());
+  for (const auto& ragged : config.ragged) {
+    ragged_names.push_back(ragged.feature_name);
+  }
+  return Create(dense_names, sparse_names, ragged_names);
+}
+
+bool FastParseExampleIndex::Matches(
+    absl::Span<const absl::string_view> dense_names,
+    absl::Span<const absl::string_view> sparse_names,
+    absl::Span<const absl::string_view> ragged_names) const {
+  auto equal = [](const std::vector<std::string>& stored,
+                  absl::Span<const absl::string_view> names) {
+    return std::equal(stored.begin(), stored.end(), names.begin(), names.end());
+  };
+  return equal(dense_names_, dense_names) &&
+         equal(sparse_names_, sparse_names) &&
+         equal(ragged_names_, ragged_names);
+}
+
+bool FastParseExampleIndex::Matches(
+    const FastParseExampleConfig& config) const {
+  auto equal = [](const std::vector<std::string>& stored, const auto& entries) {
+    if (stored.size() != entries.size()) return false;
+    for (size_t d = 0; d < stored.size(); ++d) {
+      if (absl::string_view(stored[d]) !=
+          absl::string_view(entries[d].feature_name)) {
+        return false;
+      }
+    }
+    return true;
+  };
+  return equal(dense_names_, config.dense) &&
+         equal(sparse_names_, config.sparse) &&
+         equal(ragged_names_, config.ragged);
+}
+
+absl::Status FastParseExample(const Config& config,
+                              absl::Span<const tstring> serialized,
+                              absl::Span<const tstring> example_names,
+                              thread::ThreadPool* thread_pool, Result* result) {
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<FastParseExampleIndex> config_index,
+                      FastParseExampleIndex::Create(config));
+  return FastParseExample(config, *config_index, serialized, example_names,
+                          thread_pool, result);
+}
+
 absl::Status FastParseExample(const Config& config,
+                              const FastParseExampleIndex& config_index,
                               absl::Span<const tstring> serialized,
                               absl::Span<const tstring> example_names,
                               thread::ThreadPool* thread_pool, Result* result) {
   DCHECK(result != nullptr);
+  DCHECK(config_index.Matches(config));
   // Check config so we can safely CHECK(false) in switches on config.*.dtype
   TF_RETURN_IF_ERROR(CheckConfigDataTypes(config));
 
@@ -1146,37 +1307,6 @@ absl::Status FastParseExample(const Config& config,
     result->feature_stats.resize(serialized.size());
   }
 
-  size_t config_size =
-      config.dense.size() + config.sparse.size() + config.ragged.size();
-  SeededHasher hasher;
-  // Build config index.
-  PresizedCuckooMap<std::pair<size_t, Type>> config_index(config_size);
-  bool ok = true;
-  for (size_t i = 0; i < 1000; ++i) {
-    for (size_t d = 0; d < config.dense.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.dense[d].feature_name),
-                                      {d, Type::Dense});
-    }
-    for (size_t d = 0; d < config.sparse.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.sparse[d].feature_name),
-                                      {d, Type::Sparse});
-    }
-    for (size_t d = 0; d < config.ragged.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.ragged[d].feature_name),
-                                      {d, Type::Ragged});
-    }
-    if (ok) break;
-    LOG(WARNING) << "Collision found. This should happen only if you have "
-                    "around 2^32 entries in your config.";
-    hasher.seed++;
-    config_index.Clear(config_size);
-    ok = true;
-  }
-  if (!ok) {
-    return errors::Internal(
-        "Could not avoid collision. This should not happen.");
-  }
-
   // Allocate dense output for fixed length dense values
   // (variable-length dense and sparse and ragged have to be buffered).
   std::vector<Tensor> fixed_dense_values(config.dense.size());
@@ -1246,7 +1376,7 @@ absl::Status FastParseExample(const Config& config,
       status_of_minibatch[minibatch] = FastParseSerializedExample(
           serialized[e],
           (!example_names.empty() ? example_names[e] : "<unknown>"), e, config,
-          config_index, hasher, &fixed_dense_values,
+          config_index, &fixed_dense_values,
           &varlen_dense_buffers[minibatch], &sparse_buffers[minibatch],
           &ragged_buffers[minibatch], stats);
       if (!status_of_minibatch[minibatch].ok()) break;
@@ -1451,7 +1581,17 @@ absl::Status FastParseExample(const Config& config,
 absl::Status FastParseSingleExample(const Config& config,
                                     absl::string_view serialized,
                                     Result* result) {
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<FastParseExampleIndex> config_index,
+                      FastParseExampleIndex::Create(config));
+  return FastParseSingleExample(config, *config_index, serialized, result);
+}
+
+absl::Status FastParseSingleExample(const Config& config,
+                                    const FastParseExampleIndex& config_index,
+                                    absl::string_view serialized,
+                                    Result* result) {
   DCHECK(result != nullptr);
+  DCHECK(config_index.Matches(config));
   // Check config so we can safely CHECK(false) in switches on config.*.dtype
   TF_RETURN_IF_ERROR(CheckConfigDataTypes(config));
 
@@ -1461,38 +1601,6 @@ absl::Status FastParseSingleExample(const Config& config,
     stats = &result->feature_stats.back();
   }
 
-  // TODO(mrry): Cache the construction of this map at Op construction time.
-  size_t config_size =
-      config.dense.size() + config.sparse.size() + config.ragged.size();
-  SeededHasher hasher;
-  // Build config index.
-  PresizedCuckooMap<std::pair<size_t, Type>> config_index(config_size);
-  bool ok = true;
-  for (size_t i = 0; i < 1000; ++i) {
-    for (size_t d = 0; d < config.dense.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.dense[d].feature_name),
-                                      {d, Type::Dense});
-    }
-    for (size_t d = 0; d < config.sparse.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.sparse[d].feature_name),
-                                      {d, Type::Sparse});
-    }
-    for (size_t d = 0; d < config.ragged.size(); ++d) {
-      ok &= config_index.InsertUnique(hasher(config.ragged[d].feature_name),
-                                      {d, Type::Ragged});
-    }
-    if (ok) break;
-    LOG(WARNING) << "Collision found. This should happen only if you have "
-                    "around 2^32 entries in your config.";
-    hasher.seed++;
-    config_index.Clear(config_size);
-    ok = true;
-  }
-  if (!ok) {
-    return errors::Internal(
-        "Could not avoid collision. This should not happen.");
-  }
-
   result->sparse_indices.reserve(config.sparse.size());
   result->sparse_values.reserve(config.sparse.size());
   result->sparse_shapes.reserve(config.sparse.size());
@@ -1560,23 +1668,12 @@ absl::Status FastParseSingleExample(const Config& config,
     const absl::string_view feature_name = name_and_feature.first;
     parsed::Feature& feature = name_and_feature.second;
 
-    std::pair<size_t, Type> d_and_type;
-    uint64 h = hasher(feature_name);
-    if (!config_index.Find(h, &d_and_type)) continue;
+    size_t d;
+    FastParseExampleIndex::Kind kind;
+    if (!config_index.Find(feature_name, &d, &kind)) continue;
 
-    size_t d = d_and_type.first;
-    bool is_dense = d_and_type.second == Type::Dense;
-    bool is_sparse = d_and_type.second == Type::Sparse;
-
-    {
-      // Testing for PresizedCuckooMap collision.
-      // TODO(lew): Use dense_hash_map and avoid this and hasher creation.
-      const tstring& config_feature_name =
-          is_dense ? config.dense[d].feature_name
-                   : (is_sparse ? config.sparse[d].feature_name
-                                : config.ragged[d].feature_name);
-      if (feature_name != config_feature_name) continue;
-    }
+    bool is_dense = kind == FastParseExampleIndex::Kind::kDense;
+    bool is_sparse = kind == FastParseExampleIndex::Kind::kSparse;
 
     auto example_error = [feature_name](absl::string_view suffix) {
       return errors::InvalidArgument("Key: ", feature_name, ".  ", suffix);
@@ -16,11 +16,17 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_UTIL_EXAMPLE_PROTO_FAST_PARSING_H_
 #define TENSORFLOW_CORE_UTIL_EXAMPLE_PROTO_FAST_PARSING_H_
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+
 #include "tensorflow/core/example/example.pb.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/graph.pb.h"
@@ -99,6 +105,83 @@ struct FastParseExampleConfig {
   bool collect_feature_stats = false;
 };
 
+// A precomputed, immutable index over the feature names of a
+// `FastParseExampleConfig`.
+//
+// The names are placed in a collision-free ("perfect") hash table built with
+// hash-and-displace, so resolving a feature name found in an Example to its
+// dense, sparse or ragged slot in the config takes one hash computation and
+// one string comparison. Building the index costs more than parsing a small
+// batch, so kernels that parse many batches with the same feature names
+// should build it once and pass it to `FastParseExample` and
+// `FastParseSingleExample`. The index is safe to share between threads.
+class FastParseExampleIndex {
+ public:
+  enum class Kind : uint8_t { kDense, kSparse, kRagged };
+
+  // Builds an index over the given feature names. Fails if a name occurs more
+  // than once.
+  static absl::StatusOr<std::unique_ptr<FastParseExampleIndex>> Create(
+      absl::Span<const absl::string_view> dense_names,
+      absl::Span<const absl::string_view> sparse_names,
+      absl::Span<const absl::string_view> ragged_names);
+
+  // Builds an index over the feature names of `config`.
+  static absl::StatusOr<std::unique_ptr<FastParseExampleIndex>> Create(
+      const FastParseExampleConfig& config);
+
+  // Returns true if the index was built for exactly these feature names, in
+  // this order.
+  bool Matches(absl::Span<const absl::string_view> dense_names,
+               absl::Span<const absl::string_view> sparse_names,
+               absl::Span<const absl::string_view> ragged_names) const;
+
+  // Returns true if the index was built for the feature names of `config`.
+  bool Matches(const FastParseExampleConfig& config) const;
+
+  // Looks up `name`. If it is one of the indexed feature names, sets
+  // `*index` and `*kind` to its position in the config and returns true.
+  bool Find(absl::string_view name, size_t* index, Kind* kind) const {
+    if (slots_.empty()) return false;
+    const uint64_t h = Hash(name, seed_);
+    const Slot& slot = slots_[SlotOf(h, displacements_[h & bucket_mask_])];
+    if (!slot.used || slot.name != name) return false;
+    *index = slot.index;
+    *kind = slot.kind;
+    return true;
+  }
+
+ private:
+  struct Slot {
+    std::string name;
+    uint32_t index = 0;
+    Kind kind = Kind::kDense;
+    bool used = false;
+  };
+
+  FastParseExampleIndex() = default;
+
+  static uint64_t Hash(absl::string_view name, uint64_t seed);
+
+  // Returns the slot of a name with hash `h` whose bucket has displacement
+  // `displacement`. The step is odd, so as the displacement varies the name
+  // visits every slot of the power-of-two sized table.
+  size_t SlotOf(uint64_t h, uint32_t displacement) const {
+    const uint64_t start = h >> 24;
+    const uint64_t step = (h >> 44) | 1;
+    return (start + displacement * step) & slot_mask_;
+  }
+
+  uint64_t seed_ = 0;
+  uint64_t bucket_mask_ = 0;
+  uint64_t slot_mask_ = 0;
+  std::vector<uint32_t> displacements_;
+  std::vector<Slot> slots_;
+  std::vector<std::string> dense_names_;
+  std::vector<std::string> sparse_names_;
+  std::vector<std::string> ragged_names_;
+};
+
 // Statistics about the features in each example passed to
 // `FastParse[Single]Example()`.
 //
@@ -140,13 +223,27 @@ absl::Status FastParseExample(const FastParseExampleConfig& config,
                               absl::Span<const tstring> example_names,
                               thread::ThreadPool* thread_pool, Result* result);
 
-// TODO(mrry): Move the hash table construction into the config object.
+// As above, but uses a prebuilt `index`, which must have been built for the
+// feature names of `config`.
+absl::Status FastParseExample(const FastParseExampleConfig& config,
+                              const FastParseExampleIndex& index,
+                              absl::Span<const tstring> serialized,
+                              absl::Span<const tstring> example_names,
+                              thread::ThreadPool* thread_pool, Result* result);
+
 typedef FastParseExampleConfig FastParseSingleExampleConfig;
 
 absl::Status FastParseSingleExample(const FastParseSingleExampleConfig& config,
                                     absl::string_view serialized,
                                     Result* result);
 
+// As above, but uses a prebuilt `index`, which must have been built for the
+// feature names of `config`.
+absl::Status FastParseSingleExample(const FastParseSingleExampleConfig& config,
+                                    const FastParseExampleIndex& index,
+                                    absl::string_view serialized,
+                                    Result* result);
+
 // Parses a batch of serialized SequenceExample protos and converts them into
 // result according to given config.
 // Given example names have to either be empty or the same size as serialized.
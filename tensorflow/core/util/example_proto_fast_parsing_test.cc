@@ -15,12 +15,15 @@ limitations under the License.
 
 #include "tensorflow/core/util/example_proto_fast_parsing.h"
 
+#include <memory>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "tensorflow/core/example/example.pb.h"
 #include "tensorflow/core/example/feature.pb.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
 #include "tensorflow/core/platform/protobuf.h"
@@ -429,6 +432,77 @@ TEST(TestFastParseExample, Empty) {
   EXPECT_TRUE(status.ok()) << status;
 }
 
+TEST(FastParseExampleIndex, FindsEveryFeature) {
+  std::vector<string> names;
+  for (int i = 0; i < 1000; ++i) names.push_back(strings::StrCat("f", i));
+  std::vector<absl::string_view> dense(names.begin(), names.begin() + 400);
+  std::vector<absl::string_view> sparse(names.begin() + 400,
+                                        names.begin() + 700);
+  std::vector<absl::string_view> ragged(names.begin() + 700, names.end());
+  absl::StatusOr<std::unique_ptr<FastParseExampleIndex>> index =
+      FastParseExampleIndex::Create(dense, sparse, ragged);
+  TF_ASSERT_OK(index.status());
+
+  size_t d;
+  FastParseExampleIndex::Kind kind;
+  for (size_t i = 0; i < names.size(); ++i) {
+    ASSERT_TRUE((*index)->Find(names[i], &d, &kind)) << names[i];
+    if (i < 400) {
+      EXPECT_EQ(kind, FastParseExampleIndex::Kind::kDense);
+      EXPECT_EQ(d, i);
+    } else if (i < 700) {
+      EXPECT_EQ(kind, FastParseExampleIndex::Kind::kSparse);
+      EXPECT_EQ(d, i - 400);
+    } else {
+      EXPECT_EQ(kind, FastParseExampleIndex::Kind::kRagged);
+      EXPECT_EQ(d, i - 700);
+    }
+  }
+  EXPECT_FALSE((*index)->Find("f1000", &d, &kind));
+  EXPECT_FALSE((*index)->Find("", &d, &kind));
+
+  EXPECT_TRUE((*index)->Matches(dense, sparse, ragged));
+  EXPECT_FALSE((*index)->Matches(sparse, dense, ragged));
+}
+
+TEST(FastParseExampleIndex, EmptyAndDuplicateNames) {
+  absl::StatusOr<std::unique_ptr<FastParseExampleIndex>> empty =
+      FastParseExampleIndex::Create({}, {}, {});
+  TF_ASSERT_OK(empty.status());
+  size_t d;
+  FastParseExampleIndex::Kind kind;
+  EXPECT_FALSE((*empty)->Find("a", &d, &kind));
+
+  std::vector<absl::string_view> dense = {"a"};
+  std::vector<absl::string_view> sparse = {"a"};
+  EXPECT_FALSE(FastParseExampleIndex::Create(dense, sparse, {}).ok());
+}
+
+TEST(FastParseExampleIndex, ReusedAcrossBatches) {
+  FastParseExampleConfig config;
+  AddDenseFeature("bytes_list", DT_STRING, {2}, false, 2, &config);
+  AddSparseFeature("int64_list", DT_INT64, &config);
+  absl::StatusOr<std::unique_ptr<FastParseExampleIndex>> index =
+      FastParseExampleIndex::Create(config);
+  TF_ASSERT_OK(index.status());
+  EXPECT_TRUE((*index)->Matches(config));
+
+  std::vector<tstring> serialized(5, ExampleWithSomeFeatures());
+  for (int batch = 0; batch < 3; ++batch) {
+    Result with_index;
+    TF_ASSERT_OK(FastParseExample(config, **index, serialized, {}, nullptr,
+                                  &with_index));
+    Result without_index;
+    TF_ASSERT_OK(
+        FastParseExample(config, serialized, {}, nullptr, &without_index));
+    ASSERT_EQ(with_index.dense_values.size(), 1);
+    test::ExpectTensorEqual<tstring>(with_index.dense_values[0],
+                                     without_index.dense_values[0]);
+    test::ExpectTensorEqual<int64_t>(with_index.sparse_values[0],
+                                     without_index.sparse_values[0]);
+  }
+}
+
 }  // namespace
 }  // namespace example
 }  // namespace tensorflow
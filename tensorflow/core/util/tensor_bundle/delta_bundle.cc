@@ -0,0 +1,349 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/util/tensor_bundle/delta_bundle.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_slice.h"
+#include "tensorflow/core/framework/tensor_util.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/tstring.h"
+#include "tensorflow/core/protobuf/tensor_bundle.pb.h"
+#include "tensorflow/core/util/saved_tensor_slice_util.h"
+#include "tensorflow/core/util/tensor_slice_util.h"
+
+namespace tensorflow {
+
+namespace {
+
+// Copies `rows` into `val`, starting at row `begin`.
+absl::Status CopyRows(const Tensor& rows, int64_t begin, Tensor* val) {
+  Tensor dst = val->Slice(begin, begin + rows.dim_size(0));
+  if (DataTypeCanUseMemcpy(rows.dtype())) {
+    std::memcpy(const_cast<char*>(dst.tensor_data().data()),
+                rows.tensor_data().data(), rows.TotalBytes());
+  } else if (rows.dtype() == DT_STRING) {
+    // The slice of a tensor need not be aligned.
+    const auto src_strings = rows.unaligned_flat<tstring>();
+    auto dst_strings = dst.unaligned_flat<tstring>();
+    for (int64_t i = 0; i < src_strings.size(); ++i) {
+      dst_strings(i) = src_strings(i);
+    }
+  } else {
+    return errors::Unimplemented("Delta bundles do not support rows of ",
+                                 DataTypeString(rows.dtype()), " tensors");
+  }
+  return absl::OkStatus();
+}
+
+// Overwrites the rows of `val` stored by `delta` for the tensor `key`.
+absl::Status ApplyDeltaRows(BundleReader* delta, absl::string_view key,
+                            Tensor* val) {
+  DataType dtype;
+  TensorShape shape;
+  TF_RETURN_IF_ERROR(delta->LookupDtypeAndShape(key, &dtype, &shape));
+  if (dtype != val->dtype() || shape != val->shape()) {
+    return errors::InvalidArgument(
+        "The rows of tensor ", key, " in a delta bundle are of a ",
+        DataTypeString(dtype), " ", shape.DebugString(),
+        " tensor, but its base is a ", DataTypeString(val->dtype()), " ",
+        val->shape().DebugString(), " tensor");
+  }
+
+  std::vector<TensorSlice> slices;
+  TF_RETURN_IF_ERROR(delta->LookupTensorSlices(key, &slices));
+  if (!val->RefCountIsOne()) {
+    // The tensor may share its buffer, e.g. with a memory-mapped data file.
+    *val = tensor::DeepCopy(*val);
+  }
+  for (const TensorSlice& slice : slices) {
+    for (int d = 1; d < slice.dims(); ++d) {
+      if (!slice.IsFullAt(d)) {
+        return errors::Unimplemented(
+            "The delta of tensor ", key,
+            " stores a slice that is not a range of rows: ",
+            slice.DebugString());
+      }
+    }
+    const int64_t begin = slice.IsFullAt(0) ? 0 : slice.start(0);
+    const int64_t num_rows =
+        slice.IsFullAt(0) ? shape.dim_size(0) : slice.length(0);
+    TensorShape rows_shape = shape;
+    rows_shape.set_dim(0, num_rows);
+    Tensor rows(dtype, rows_shape);
+    TF_RETURN_IF_ERROR(delta->LookupSlice(key, slice, &rows));
+    TF_RETURN_IF_ERROR(CopyRows(rows, begin, val));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::Status AddTensorRows(BundleWriter* writer, absl::string_view key,
+                           const Tensor& val, const RowRanges& ranges) {
+  if (val.dims() < 1) {
+    return errors::InvalidArgument("Cannot add rows of the scalar tensor ",
+                                   key);
+  }
+  for (const auto& [begin, end] : ranges) {
+    if (begin < 0 || begin >= end || end > val.dim_size(0)) {
+      return errors::InvalidArgument("Invalid rows [", begin, ", ", end,
+                                     ") of tensor ", key, " with shape ",
+                                     val.shape().DebugString());
+    }
+    TensorSlice slice(val.dims());
+    slice.set_start(0, begin);
+    slice.set_length(0, end - begin);
+    TF_RETURN_IF_ERROR(
+        writer->AddSlice(key, val.shape(), slice, val.Slice(begin, end)));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status GatherTensorRows(const Tensor& val, const RowRanges& ranges,
+                              Tensor* rows) {
+  if (val.dims() < 1) {
+    return errors::InvalidArgument("Cannot gather rows of a scalar tensor");
+  }
+  int64_t num_rows = 0;
+  for (const auto& [begin, end] : ranges) {
+    if (begin < 0 || begin >= end || end > val.dim_size(0)) {
+      return errors::InvalidArgument("Invalid rows [", begin, ", ", end,
+                                     ") of a tensor with shape ",
+                                     val.shape().DebugString());
+    }
+    num_rows += end - begin;
+  }
+  TensorShape rows_shape = val.shape();
+  rows_shape.set_dim(0, num_rows);
+  *rows = Tensor(val.dtype(), rows_shape);
+  int64_t offset = 0;
+  for (const auto& [begin, end] : ranges) {
+    TF_RETURN_IF_ERROR(CopyRows(val.Slice(begin, end), offset, rows));
+    offset += end - begin;
+  }
+  return absl::OkStatus();
+}
+
+absl::Status AddGatheredTensorRows(BundleWriter* writer, absl::string_view key,
+                                   const TensorShape& shape, const Tensor& rows,
+                                   const RowRanges& ranges) {
+  if (shape.dims() < 1) {
+    return errors::InvalidArgument("Cannot add rows of the scalar tensor ",
+                                   key);
+  }
+  int64_t offset = 0;
+  for (const auto& [begin, end] : ranges) {
+    if (begin < 0 || begin >= end || end > shape.dim_size(0) ||
+        offset + end - begin > rows.dim_size(0)) {
+      return errors::InvalidArgument("Invalid rows [", begin, ", ", end,
+                                     ") of tensor ", key, " with shape ",
+                                     shape.DebugString());
+    }
+    TensorSlice slice(shape.dims());
+    slice.set_start(0, begin);
+    slice.set_length(0, end - begin);
+    TF_RETURN_IF_ERROR(writer->AddSlice(
+        key, shape, slice, rows.Slice(offset, offset + end - begin)));
+    offset += end - begin;
+  }
+  return absl::OkStatus();
+}
+
+LayeredBundleReader::LayeredBundleReader(Env* env, absl::string_view prefix,
+                                         BundleReader::Options options) {
+  std::unordered_set<std::string> visited;
+  std::string layer_prefix(prefix);
+  while (!layer_prefix.empty()) {
+    if (!visited.insert(layer_prefix).second) {
+      status_ = errors::DataLoss("The chain of bundles ending at ", prefix,
+                                 " has a cycle at ", layer_prefix);
+      return;
+    }
+    auto layer = std::make_unique<BundleReader>(env, layer_prefix, options);
+    if (!layer->status().ok()) {
+      status_ = layer->status();
+      return;
+    }
+    layer_prefix = layer->base_prefix();
+    layers_.push_back(std::move(layer));
+  }
+  std::reverse(layers_.begin(), layers_.end());
+}
+
+absl::Status LayeredBundleReader::ListKeys(std::vector<std::string>* keys) {
+  std::set<std::string> all_keys;
+  BundleEntryProto entry;
+  for (const std::unique_ptr<BundleReader>& layer : layers_) {
+    // As in CheckpointReader, skips the entries of the slices.
+    std::unordered_set<std::string> slice_keys;
+    layer->Seek(kHeaderEntryKey);
+    for (layer->Next(); layer->Valid(); layer->Next()) {
+      if (!entry.ParseFromArray(layer->value().data(),
+                                layer->value().size())) {
+        return errors::DataLoss("Unable to parse the entry of ",
+                                layer->key());
+      }
+      for (const TensorSliceProto& slice : entry.slices()) {
+        slice_keys.insert(checkpoint::EncodeTensorNameSlice(
+            std::string(layer->key()), TensorSlice(slice)));
+      }
+    }
+    layer->Seek(kHeaderEntryKey);
+    for (layer->Next(); layer->Valid(); layer->Next()) {
+      std::string key(layer->key());
+      if (slice_keys.count(key) == 0) all_keys.insert(std::move(key));
+    }
+    TF_RETURN_IF_ERROR(layer->status());
+  }
+  keys->assign(all_keys.begin(), all_keys.end());
+  return absl::OkStatus();
+}
+
+absl::Status LayeredBundleReader::LookupDtypeAndShape(absl::string_view key,
+                                                      DataType* dtype,
+                                                      TensorShape* shape) {
+  for (int i = layers_.size() - 1; i >= 0; --i) {
+    if (layers_[i]->Contains(key)) {
+      return layers_[i]->LookupDtypeAndShape(key, dtype, shape);
+    }
+  }
+  return errors::NotFound("Key ", key, " not found in checkpoint");
+}
+
+int LayeredBundleReader::FindFullLayer(absl::string_view key) {
+  int oldest = -1;
+  for (int i = layers_.size() - 1; i >= 0; --i) {
+    if (!layers_[i]->Contains(key)) continue;
+    std::vector<TensorSlice> slices;
+    if (!layers_[i]->LookupTensorSlices(key, &slices).ok() || slices.empty()) {
+      return i;
+    }
+    oldest = i;
+  }
+  // The tensor may be partitioned in the oldest bundle holding it.
+  return oldest;
+}
+
+absl::Status LayeredBundleReader::Lookup(absl::string_view key, Tensor* val) {
+  const int full_layer = FindFullLayer(key);
+  if (full_layer < 0) {
+    return errors::NotFound("Key ", key, " not found in checkpoint");
+  }
+  BundleReader* base = layers_[full_layer].get();
+  DataType dtype;
+  TensorShape shape;
+  TF_RETURN_IF_ERROR(base->LookupDtypeAndShape(key, &dtype, &shape));
+  *val = Tensor(dtype, shape);
+  TF_RETURN_IF_ERROR(base->Lookup(key, val));
+  for (int i = full_layer + 1; i < layers_.size(); ++i) {
+    if (layers_[i]->Contains(key)) {
+      TF_RETURN_IF_ERROR(ApplyDeltaRows(layers_[i].get(), key, val));
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status LayeredBundleReader::LookupSlice(absl::string_view key,
+                                              const TensorSlice& slice_spec,
+                                              Tensor* val) {
+  Tensor full_tensor;
+  TF_RETURN_IF_ERROR(Lookup(key, &full_tensor));
+  const TensorShape& full_shape = full_tensor.shape();
+  if (slice_spec.IsFull()) {
+    if (val->shape() != full_shape) {
+      return errors::InvalidArgument(
+          "The slice ", slice_spec.DebugString(), " of tensor ", key,
+          " cannot be copied into a ", val->shape().DebugString(), " tensor");
+    }
+    *val = full_tensor;
+    return absl::OkStatus();
+  }
+  TensorShape slice_shape;
+  TF_RETURN_IF_ERROR(slice_spec.SliceTensorShape(full_shape, &slice_shape));
+  if (val->dtype() != full_tensor.dtype() || val->shape() != slice_shape) {
+    return errors::InvalidArgument(
+        "The slice ", slice_spec.DebugString(), " of the ",
+        DataTypeString(full_tensor.dtype()), " tensor ", key,
+        " cannot be copied into a ", DataTypeString(val->dtype()), " ",
+        val->shape().DebugString(), " tensor");
+  }
+
+  const TensorSlice full_slice(full_shape.dims());
+  switch (full_tensor.dtype()) {
+#define HANDLE_COPY(T)                                                   \
+  case DataTypeToEnum<T>::value:                                         \
+    CopyDataFromTensorSliceToTensorSlice(full_shape, full_slice,         \
+                                         slice_spec,                     \
+                                         full_tensor.flat<T>().data(),   \
+                                         val->flat<T>().data());         \
+    break;
+
+    HANDLE_COPY(float)
+    HANDLE_COPY(double)
+    HANDLE_COPY(int32)
+    HANDLE_COPY(uint8)
+    HANDLE_COPY(int16)
+    HANDLE_COPY(int8)
+    HANDLE_COPY(complex64)
+    HANDLE_COPY(complex128)
+    HANDLE_COPY(int64_t)
+    HANDLE_COPY(bool)
+    HANDLE_COPY(qint32)
+    HANDLE_COPY(quint8)
+    HANDLE_COPY(qint8)
+    HANDLE_COPY(bfloat16)
+    default:
+      return errors::Unimplemented("Slicing ",
+                                   DataTypeString(full_tensor.dtype()),
+                                   " tensors of delta bundles is not "
+                                   "supported");
+  }
+#undef HANDLE_COPY
+  return absl::OkStatus();
+}
+
+absl::Status CompactDeltaBundles(Env* env, absl::string_view prefix,
+                                 absl::string_view compacted_prefix) {
+  LayeredBundleReader reader(env, prefix);
+  TF_RETURN_IF_ERROR(reader.status());
+  std::vector<std::string> keys;
+  TF_RETURN_IF_ERROR(reader.ListKeys(&keys));
+
+  BundleWriter writer(env, compacted_prefix);
+  TF_RETURN_IF_ERROR(writer.status());
+  for (const std::string& key : keys) {
+    Tensor val;
+    TF_RETURN_IF_ERROR(reader.Lookup(key, &val));
+    TF_RETURN_IF_ERROR(writer.Add(key, val));
+  }
+  return writer.Finish();
+}
+
+}  // namespace tensorflow
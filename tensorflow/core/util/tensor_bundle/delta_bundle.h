@@ -0,0 +1,126 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Incremental checkpoints on top of tensor bundles.
+//
+// A delta bundle is a regular bundle written with
+// BundleWriter::Options::base_prefix set. It holds only what changed since the
+// bundle it is based on, which may itself be a delta:
+//
+//   * tensors added with BundleWriter::Add() replace the base's tensor;
+//   * rows added with AddTensorRows() overwrite those rows of the base's
+//     tensor, which must have the same dtype and shape.
+//
+// The rows changed since the last save of a resource variable can be tracked
+// with Var::EnableDirtyRowTracking() and Var::TakeDirtyRowRanges(); the
+// SaveVariableDeltas op writes full and delta bundles of resource variables
+// that way.
+//
+// LayeredBundleReader reads the tensors of a delta bundle by layering its
+// deltas on top of the full bundle at the root of its chain, and
+// CompactDeltaBundles() rewrites such a chain as a single full bundle, e.g. in
+// the background once the chain gets long.
+
+#ifndef TENSORFLOW_CORE_UTIL_TENSOR_BUNDLE_DELTA_BUNDLE_H_
+#define TENSORFLOW_CORE_UTIL_TENSOR_BUNDLE_DELTA_BUNDLE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_slice.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
+
+namespace tensorflow {
+
+// Sorted, disjoint [begin, end) ranges of indices along the first dimension.
+using RowRanges = std::vector<std::pair<int64_t, int64_t>>;
+
+// Adds the rows `ranges` of `val` to `writer` as slices of the tensor `key`.
+// `val` must have at least one dimension.
+absl::Status AddTensorRows(BundleWriter* writer, absl::string_view key,
+                           const Tensor& val, const RowRanges& ranges);
+
+// Copies the rows `ranges` of `val` back to back into `*rows`, e.g. to
+// snapshot them while the variable holding `val` is locked. Supports the
+// dtypes that can be memcpy'd, and strings.
+absl::Status GatherTensorRows(const Tensor& val, const RowRanges& ranges,
+                              Tensor* rows);
+
+// Like AddTensorRows(), for the rows `ranges` of a tensor of shape `shape`
+// gathered into `rows` by GatherTensorRows().
+absl::Status AddGatheredTensorRows(BundleWriter* writer, absl::string_view key,
+                                   const TensorShape& shape, const Tensor& rows,
+                                   const RowRanges& ranges);
+
+// Reads the tensors of the bundle at `prefix` layered on top of the chain of
+// bundles it is a delta of. Like BundleReader, it is not thread-safe.
+class LayeredBundleReader {
+ public:
+  LayeredBundleReader(Env* env, absl::string_view prefix,
+                      BundleReader::Options options = BundleReader::Options());
+
+  // Is ok() iff all the bundles of the chain could be opened.
+  absl::Status status() const { return status_; }
+
+  // The number of bundles in the chain, including the full bundle at its root.
+  int num_layers() const { return layers_.size(); }
+
+  // Returns the keys of the tensors held by any bundle of the chain, sorted.
+  // REQUIRES: status().ok()
+  absl::Status ListKeys(std::vector<std::string>* keys);
+
+  // Looks up the dtype and shape of the newest version of the tensor `key`.
+  // REQUIRES: status().ok()
+  absl::Status LookupDtypeAndShape(absl::string_view key, DataType* dtype,
+                                   TensorShape* shape);
+
+  // Looks up the tensor `key`, applying the rows stored by the deltas to the
+  // newest full version of it. `val` is replaced by the result.
+  // REQUIRES: status().ok()
+  absl::Status Lookup(absl::string_view key, Tensor* val);
+
+  // Like Lookup(), but copies only the slice `slice_spec` of the tensor into
+  // `val`, which must be allocated with the shape of the slice. Reads the whole
+  // tensor, since its rows may come from any layer.
+  // REQUIRES: status().ok()
+  absl::Status LookupSlice(absl::string_view key, const TensorSlice& slice_spec,
+                           Tensor* val);
+
+ private:
+  // Returns the index of the newest layer from which `key` can be read in
+  // full, or -1 if no layer holds it.
+  int FindFullLayer(absl::string_view key);
+
+  // The bundles of the chain, from the root to the delta at `prefix`.
+  std::vector<std::unique_ptr<BundleReader>> layers_;
+  absl::Status status_;
+};
+
+// Writes the tensors of the bundle at `prefix`, layered on top of its chain of
+// bases, as a full bundle at `compacted_prefix`. Reads one tensor at a time.
+absl::Status CompactDeltaBundles(Env* env, absl::string_view prefix,
+                                 absl::string_view compacted_prefix);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_UTIL_TENSOR_BUNDLE_DELTA_BUNDLE_H_
@@ -0,0 +1,209 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/util/tensor_bundle/delta_bundle.h"
+
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_slice.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
+
+namespace tensorflow {
+namespace {
+
+std::string Prefix(const std::string& prefix) {
+  return io::JoinPath(testing::TmpDir(), "delta_bundle_test", prefix);
+}
+
+// Returns a [num_rows, 2] tensor whose row i holds {i + offset, i + offset}.
+Tensor Rows(int num_rows, float offset) {
+  Tensor t(DT_FLOAT, TensorShape({num_rows, 2}));
+  auto matrix = t.matrix<float>();
+  for (int i = 0; i < num_rows; ++i) {
+    matrix(i, 0) = matrix(i, 1) = i + offset;
+  }
+  return t;
+}
+
+TEST(DeltaBundleTest, LayersDeltasOnTopOfBase) {
+  Env* env = Env::Default();
+  {
+    BundleWriter writer(env, Prefix("base"));
+    TF_ASSERT_OK(writer.Add("embedding", Rows(8, 0)));
+    TF_ASSERT_OK(writer.Add("bias", test::AsTensor<float>({1, 2})));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  Tensor embedding = Rows(8, 0);
+  {
+    // Rows 1, 2 and 6 of the embedding changed, and the bias was replaced.
+    embedding.matrix<float>()(1, 0) = 10;
+    embedding.matrix<float>()(2, 1) = 20;
+    embedding.matrix<float>()(6, 0) = 60;
+    BundleWriter::Options options;
+    options.base_prefix = Prefix("base");
+    BundleWriter writer(env, Prefix("delta_1"), options);
+    TF_ASSERT_OK(AddTensorRows(&writer, "embedding", embedding,
+                               {{1, 3}, {6, 7}}));
+    TF_ASSERT_OK(writer.Add("bias", test::AsTensor<float>({3, 4})));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  {
+    embedding.matrix<float>()(2, 0) = 200;
+    BundleWriter::Options options;
+    options.base_prefix = Prefix("delta_1");
+    BundleWriter writer(env, Prefix("delta_2"), options);
+    TF_ASSERT_OK(AddTensorRows(&writer, "embedding", embedding, {{2, 3}}));
+    TF_ASSERT_OK(writer.Add("step", test::AsScalar<int64_t>(2)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+
+  LayeredBundleReader reader(env, Prefix("delta_2"));
+  TF_ASSERT_OK(reader.status());
+  EXPECT_EQ(reader.num_layers(), 3);
+  std::vector<std::string> keys;
+  TF_ASSERT_OK(reader.ListKeys(&keys));
+  EXPECT_EQ(keys, std::vector<std::string>({"bias", "embedding", "step"}));
+
+  DataType dtype;
+  TensorShape shape;
+  TF_ASSERT_OK(reader.LookupDtypeAndShape("embedding", &dtype, &shape));
+  EXPECT_EQ(dtype, DT_FLOAT);
+  EXPECT_EQ(shape, TensorShape({8, 2}));
+
+  Tensor val;
+  TF_ASSERT_OK(reader.Lookup("embedding", &val));
+  test::ExpectTensorEqual<float>(val, embedding);
+  TF_ASSERT_OK(reader.Lookup("bias", &val));
+  test::ExpectTensorEqual<float>(val, test::AsTensor<float>({3, 4}));
+  TF_ASSERT_OK(reader.Lookup("step", &val));
+  test::ExpectTensorEqual<int64_t>(val, test::AsScalar<int64_t>(2));
+  EXPECT_TRUE(absl::IsNotFound(reader.Lookup("missing", &val)));
+
+  // The compacted bundle is a full bundle.
+  TF_ASSERT_OK(CompactDeltaBundles(env, Prefix("delta_2"), Prefix("full")));
+  BundleReader full(env, Prefix("full"));
+  TF_ASSERT_OK(full.status());
+  EXPECT_TRUE(full.base_prefix().empty());
+  std::vector<TensorSlice> slices;
+  TF_ASSERT_OK(full.LookupTensorSlices("embedding", &slices));
+  EXPECT_TRUE(slices.empty());
+  TF_ASSERT_OK(full.Lookup("embedding", &val));
+  test::ExpectTensorEqual<float>(val, embedding);
+  TF_ASSERT_OK(full.Lookup("bias", &val));
+  test::ExpectTensorEqual<float>(val, test::AsTensor<float>({3, 4}));
+}
+
+TEST(DeltaBundleTest, AddsGatheredRows) {
+  Env* env = Env::Default();
+  {
+    BundleWriter writer(env, Prefix("gather_base"));
+    TF_ASSERT_OK(writer.Add("embedding", Rows(6, 0)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  const Tensor embedding = Rows(6, 10);
+  const RowRanges ranges = {{0, 1}, {3, 5}};
+  Tensor rows;
+  TF_ASSERT_OK(GatherTensorRows(embedding, ranges, &rows));
+  test::ExpectTensorEqual<float>(
+      rows, test::AsTensor<float>({10, 10, 13, 13, 14, 14}, {3, 2}));
+  EXPECT_TRUE(absl::IsInvalidArgument(
+      GatherTensorRows(embedding, {{5, 7}}, &rows)));
+  {
+    BundleWriter::Options options;
+    options.base_prefix = Prefix("gather_base");
+    BundleWriter writer(env, Prefix("gather_delta"), options);
+    TF_ASSERT_OK(AddGatheredTensorRows(&writer, "embedding",
+                                       embedding.shape(), rows, ranges));
+    TF_ASSERT_OK(writer.Finish());
+  }
+
+  LayeredBundleReader reader(env, Prefix("gather_delta"));
+  TF_ASSERT_OK(reader.status());
+  Tensor val;
+  TF_ASSERT_OK(reader.Lookup("embedding", &val));
+  Tensor expected = Rows(6, 0);
+  for (int i : {0, 3, 4}) {
+    expected.matrix<float>()(i, 0) = expected.matrix<float>()(i, 1) = i + 10;
+  }
+  test::ExpectTensorEqual<float>(val, expected);
+}
+
+TEST(DeltaBundleTest, LooksUpSlices) {
+  Env* env = Env::Default();
+  {
+    BundleWriter writer(env, Prefix("slice_base"));
+    TF_ASSERT_OK(writer.Add("embedding", Rows(4, 0)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  Tensor embedding = Rows(4, 0);
+  {
+    embedding.matrix<float>()(2, 1) = 20;
+    BundleWriter::Options options;
+    options.base_prefix = Prefix("slice_base");
+    BundleWriter writer(env, Prefix("slice_delta"), options);
+    TF_ASSERT_OK(AddTensorRows(&writer, "embedding", embedding, {{2, 3}}));
+    TF_ASSERT_OK(writer.Finish());
+  }
+
+  LayeredBundleReader reader(env, Prefix("slice_delta"));
+  TF_ASSERT_OK(reader.status());
+  // Rows 1 and 2 of the second column, partly from the delta.
+  TensorSlice slice = TensorSlice::ParseOrDie("1,2:1,1");
+  Tensor val(DT_FLOAT, TensorShape({2, 1}));
+  TF_ASSERT_OK(reader.LookupSlice("embedding", slice, &val));
+  test::ExpectTensorEqual<float>(
+      val, test::AsTensor<float>({1, 20}, TensorShape({2, 1})));
+
+  Tensor full(DT_FLOAT, TensorShape({4, 2}));
+  TF_ASSERT_OK(reader.LookupSlice("embedding", TensorSlice(2), &full));
+  test::ExpectTensorEqual<float>(full, embedding);
+
+  Tensor wrong_shape(DT_FLOAT, TensorShape({3, 1}));
+  EXPECT_TRUE(absl::IsInvalidArgument(
+      reader.LookupSlice("embedding", slice, &wrong_shape)));
+}
+
+TEST(DeltaBundleTest, RowsMustMatchTheBaseShape) {
+  Env* env = Env::Default();
+  {
+    BundleWriter writer(env, Prefix("shape_base"));
+    TF_ASSERT_OK(writer.Add("embedding", Rows(4, 0)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  {
+    BundleWriter::Options options;
+    options.base_prefix = Prefix("shape_base");
+    BundleWriter writer(env, Prefix("shape_delta"), options);
+    EXPECT_TRUE(absl::IsInvalidArgument(
+        AddTensorRows(&writer, "embedding", Rows(6, 0), {{5, 7}})));
+    TF_ASSERT_OK(AddTensorRows(&writer, "embedding", Rows(6, 0), {{4, 6}}));
+    TF_ASSERT_OK(writer.Finish());
+  }
+
+  LayeredBundleReader reader(env, Prefix("shape_delta"));
+  TF_ASSERT_OK(reader.status());
+  Tensor val;
+  EXPECT_TRUE(absl::IsInvalidArgument(reader.Lookup("embedding", &val)));
+}
+
+}  // namespace
+}  // namespace tensorflow
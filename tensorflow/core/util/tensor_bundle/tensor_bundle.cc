@@ -15,15 +15,19 @@ limitations under the License.
 
 #include "tensorflow/core/util/tensor_bundle/tensor_bundle.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "absl/base/call_once.h"
 #include "absl/synchronization/mutex.h"
 #include "xla/tsl/lib/io/buffered_file.h"
 #include "xla/tsl/util/byte_swap_array.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
@@ -428,15 +432,108 @@ absl::Status PadAlignment(tsl::BufferedWritableFile* out, int alignment,
   return status;
 }
 
+// A buffer aliasing a tensor in a memory-mapped data file. The mapping is
+// read-only, so the buffer does not own its memory and ops copy it instead of
+// updating it in place.
+class MappedTensorBuffer : public TensorBuffer {
+ public:
+  MappedTensorBuffer(std::shared_ptr<ReadOnlyMemoryRegion> region,
+                     const char* data, size_t size)
+      : TensorBuffer(const_cast<char*>(data)),
+        region_(std::move(region)),
+        size_(size) {}
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(static_cast<int64_t>(size_));
+    proto->set_allocator_name("mmap");
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+  bool GetAllocatedBytes(size_t* out_bytes) const override { return false; }
+  bool OwnsMemory() const override { return false; }
+
+ private:
+  std::shared_ptr<ReadOnlyMemoryRegion> region_;
+  const size_t size_;
+};
+
+absl::Status ChecksumMismatchError(absl::string_view prefix,
+                                   const BundleEntryProto& entry,
+                                   uint32 actual_crc32c) {
+  return errors::DataLoss(
+      "TensorBundle at ", prefix, " shard ", entry.shard_id(), " (",
+      entry.size(), " bytes): Checksum does not match: stored ",
+      strings::Printf("%08u", crc32c::Unmask(entry.crc32c())),
+      " vs. calculated on the restored bytes ", actual_crc32c);
+}
+
+// Appends the data of "val" to "out", which holds "*size" bytes, and sets the
+// offset, size and checksum of "entry" accordingly.
+absl::Status AppendTensorData(const Tensor& val, int data_alignment,
+                              tsl::BufferedWritableFile* out, int64_t* size,
+                              BundleEntryProto* entry) {
+  entry->set_offset(*size);
+
+  size_t data_bytes_written = 0;
+  uint32 crc32c = 0;
+  out->reset_crc32();
+  absl::Status status;
+  if (val.dtype() == DT_STRING) {
+    status = WriteStringTensor(val, out, &data_bytes_written, &crc32c);
+  } else if (val.dtype() == DT_VARIANT) {
+    status = WriteVariantTensor(val, out, &data_bytes_written, &crc32c);
+  } else {
+    status = WriteTensor(val, out, &data_bytes_written);
+    crc32c = out->crc32();
+  }
+  TF_RETURN_IF_ERROR(status);
+
+  entry->set_size(data_bytes_written);
+  entry->set_crc32c(crc32c::Mask(crc32c));
+  *size += data_bytes_written;
+  return PadAlignment(out, data_alignment, size);
+}
+
+absl::Status NewBufferedWritableFile(
+    Env* env, const std::string& path,
+    std::unique_ptr<tsl::BufferedWritableFile>* out) {
+  std::unique_ptr<WritableFile> wrapper;
+  TF_RETURN_IF_ERROR(env->NewWritableFile(path, &wrapper));
+  *out = std::make_unique<tsl::BufferedWritableFile>(
+      std::move(wrapper), 8 << 20 /* 8MB write buffer */);
+  return absl::OkStatus();
+}
+
 }  // namespace
 
+struct BundleWriter::DataShard {
+  int shard_id;
+  std::string path;
+  std::unique_ptr<tsl::BufferedWritableFile> out;
+
+  // Updated by Add().
+  int64_t queued_bytes = 0;
+  int num_queued_tensors = 0;
+
+  // Updated by the thread writing the shard.
+  int64_t size = 0;
+  std::vector<std::pair<std::string, BundleEntryProto>> entries;
+  absl::Status status;
+
+  // Writes the tensors queued by Add(). Destroyed first, so that the pending
+  // writes finish before the file is.
+  std::unique_ptr<thread::ThreadPool> writer;
+};
+
 BundleWriter::BundleWriter(Env* env, absl::string_view prefix,
                            const Options& options)
     : env_(env), options_(options), prefix_(prefix), out_(nullptr), size_(0) {
   status_ = env_->HasAtomicMove(prefix_, &use_temp_file_);
   if (!status_.ok()) return;
 
-  data_path_ = DataFilename(prefix_, 0, 1);
+  num_shards_ = std::max(options_.num_data_shards, 1);
+  data_path_ = DataFilename(prefix_, 0, num_shards_);
   metadata_path_ = MetaFilename(prefix_);
   if (use_temp_file_) {
     data_path_ = strings::StrCat(data_path_, ".tempstate", random::New64());
@@ -449,15 +546,33 @@ BundleWriter::BundleWriter(Env* env, absl::string_view prefix,
     return;
   }
 
-  std::unique_ptr<WritableFile> wrapper;
-  status_ = env_->NewWritableFile(data_path_, &wrapper);
+  if (num_shards_ > 1) {
+    for (int i = 0; i < num_shards_; ++i) {
+      auto shard = std::make_unique<DataShard>();
+      shard->shard_id = i;
+      shard->path = i == 0 ? data_path_ : DataFilename(prefix_, i, num_shards_);
+      if (use_temp_file_ && i > 0) {
+        shard->path =
+            strings::StrCat(shard->path, ".tempstate", random::New64());
+      }
+      status_ = NewBufferedWritableFile(env_, shard->path, &shard->out);
+      if (!status_.ok()) return;
+      shard->writer = std::make_unique<thread::ThreadPool>(
+          env_, "bundle_writer", /*num_threads=*/1);
+      VLOG(1) << "Writing to file " << shard->path;
+      shards_.push_back(std::move(shard));
+    }
+    return;
+  }
+
+  status_ = NewBufferedWritableFile(env_, data_path_, &out_);
   if (!status_.ok()) return;
-  out_ = std::make_unique<tsl::BufferedWritableFile>(
-      std::move(wrapper), 8 << 20 /* 8MB write buffer */);
 
   VLOG(1) << "Writing to file " << data_path_;
 }
 
+BundleWriter::~BundleWriter() = default;
+
 absl::Status BundleWriter::Add(absl::string_view key, const Tensor& val) {
   if (!status_.ok()) return status_;
   CHECK_NE(key, kHeaderEntryKey);
@@ -470,28 +585,37 @@ absl::Status BundleWriter::Add(absl::string_view key, const Tensor& val) {
   BundleEntryProto* entry = &entries_[key_string];
   entry->set_dtype(val.dtype());
   val.shape().AsProto(entry->mutable_shape());
-  entry->set_shard_id(0);
-  entry->set_offset(size_);
 
-  // Updates the data file.
-  size_t data_bytes_written = 0;
-  uint32 crc32c = 0;
-  out_->reset_crc32();
-  if (val.dtype() == DT_STRING) {
-    status_ = WriteStringTensor(val, out_.get(), &data_bytes_written, &crc32c);
-  } else if (val.dtype() == DT_VARIANT) {
-    status_ = WriteVariantTensor(val, out_.get(), &data_bytes_written, &crc32c);
-  } else {
-    status_ = WriteTensor(val, out_.get(), &data_bytes_written);
-    crc32c = out_->crc32();
+  if (!shards_.empty()) {
+    // Queues the tensor on the shard with the fewest bytes queued, or the
+    // fewest tensors if tied, so that every shard gets a tensor when at least
+    // as many tensors as shards are added.
+    DataShard* shard = absl::c_min_element(
+        shards_, [](const std::unique_ptr<DataShard>& a,
+                    const std::unique_ptr<DataShard>& b) {
+          return std::make_pair(a->queued_bytes, a->num_queued_tensors) <
+                 std::make_pair(b->queued_bytes, b->num_queued_tensors);
+        })->get();
+    shard->queued_bytes += val.TotalBytes();
+    ++shard->num_queued_tensors;
+    entry->set_shard_id(shard->shard_id);
+    const int data_alignment = options_.data_alignment;
+    shard->writer->Schedule([shard, key_string, val, data_alignment,
+                             shard_entry = *entry]() mutable {
+      if (!shard->status.ok()) return;
+      shard->status = AppendTensorData(val, data_alignment, shard->out.get(),
+                                       &shard->size, &shard_entry);
+      if (shard->status.ok()) {
+        shard->entries.emplace_back(key_string, std::move(shard_entry));
+      }
+    });
+    return status_;
   }
 
-  if (status_.ok()) {
-    entry->set_size(data_bytes_written);
-    entry->set_crc32c(crc32c::Mask(crc32c));
-    size_ += data_bytes_written;
-    status_ = PadAlignment(out_.get(), options_.data_alignment, &size_);
-  }
+  // Updates the data file.
+  entry->set_shard_id(0);
+  status_ = AppendTensorData(val, options_.data_alignment, out_.get(), &size_,
+                             entry);
   return status_;
 }
 
@@ -539,7 +663,9 @@ absl::Status BundleWriter::AddSlice(absl::string_view full_tensor_key,
 // TODO(zongheng): on metadata write failure or !status_.ok(), consider removing
 // the orphaned data file.
 absl::Status BundleWriter::Finish() {
-  if (out_) {
+  if (!shards_.empty()) {
+    status_.Update(FinishDataShards());
+  } else if (out_) {
     status_.Update(out_->Close());
     out_ = nullptr;
     if (status_.ok()) {
@@ -564,7 +690,13 @@ absl::Status BundleWriter::Finish() {
     table::TableBuilder builder(options, file.get());
     // Header entry.
     BundleHeaderProto header;
-    header.set_num_shards(1);
+    header.set_num_shards(num_shards_);
+    // A base in the same directory is referred to by its basename, so that
+    // the directory can be moved.
+    header.set_base_prefix(
+        io::Dirname(options_.base_prefix) == io::Dirname(prefix_)
+            ? std::string(io::Basename(options_.base_prefix))
+            : options_.base_prefix);
     header.set_endianness(BundleHeaderProto::LITTLE);
     if (!port::kLittleEndian) header.set_endianness(BundleHeaderProto::BIG);
     VersionDef* version = header.mutable_version();
@@ -591,6 +723,32 @@ absl::Status BundleWriter::Finish() {
   return absl::OkStatus();
 }
 
+absl::Status BundleWriter::FinishDataShards() {
+  absl::Status status;
+  for (const std::unique_ptr<DataShard>& shard : shards_) {
+    // Waits for the queued tensors to be written.
+    shard->writer.reset();
+    status.Update(shard->status);
+    status.Update(shard->out->Close());
+    shard->out = nullptr;
+  }
+  for (const std::unique_ptr<DataShard>& shard : shards_) {
+    if (!status.ok()) {
+      Env::Default()->DeleteFile(shard->path).IgnoreError();
+    } else if (use_temp_file_) {
+      status.Update(Env::Default()->RenameFile(
+          shard->path, DataFilename(prefix_, shard->shard_id, num_shards_)));
+    }
+  }
+  for (const std::unique_ptr<DataShard>& shard : shards_) {
+    for (auto& [key, entry] : shard->entries) {
+      entries_[key] = std::move(entry);
+    }
+  }
+  shards_.clear();
+  return status;
+}
+
 // Merging tensor bundles.
 
 // Accumulator of metadata states during a merge.
@@ -604,6 +762,7 @@ struct MergeState {
   bool seen_first_bundle = false;
   BundleHeaderProto_Endianness endianness;
   VersionDef version;
+  std::string base_prefix;
 
   // Tensor key -> BundleEntryProto.
   std::map<string, BundleEntryProto> entries;
@@ -645,7 +804,14 @@ static absl::Status MergeOneBundle(Env* env, absl::string_view prefix,
       merge_state->seen_first_bundle = true;
       merge_state->endianness = header.endianness();
       merge_state->version = header.version();
+      merge_state->base_prefix = header.base_prefix();
     } else {
+      // Validates "base_prefix": the shards of a delta bundle share its base.
+      if (merge_state->base_prefix != header.base_prefix()) {
+        return errors::InvalidArgument(
+            "Merging bundles with different base bundles: merged ",
+            merge_state->base_prefix, " vs. curr ", header.base_prefix());
+      }
       // Validates "endianness".
       if (merge_state->endianness != header.endianness()) {
         return errors::InvalidArgument(
@@ -665,6 +831,18 @@ static absl::Status MergeOneBundle(Env* env, absl::string_view prefix,
     iter->Next();
   }
 
+  // Registers the existing data files in shard order, including those that no
+  // entry refers to, e.g. the empty shards of a BundleWriter that was given
+  // fewer tensors than data shards. They are renamed along with the others, so
+  // that the merged bundle has as many data files as its header claims.
+  for (int i = 0; i < num_shards; ++i) {
+    const string data_filename = DataFilename(prefix, i, num_shards);
+    if (env->FileExists(data_filename).ok()) {
+      merge_state->shard_ids.insert(
+          {data_filename, merge_state->shard_ids.size()});
+    }
+  }
+
   // Loops through the non-header to-merge entries.
   BundleEntryProto to_merge_entry;
   for (; iter->Valid(); iter->Next()) {
@@ -755,6 +933,7 @@ absl::Status MergeBundles(Env* env, absl::Span<const tstring> prefixes,
     header.set_num_shards(merge.num_shards);
     header.set_endianness(merge.endianness);
     *header.mutable_version() = merge.version;
+    header.set_base_prefix(merge.base_prefix);
     builder.Add(kHeaderEntryKey, header.SerializeAsString());
     // All others.
     for (const auto& p : merge.entries) {
@@ -785,13 +964,15 @@ BundleReader::BundleReader(Env* env, absl::string_view prefix, Options options)
     : env_(env),
       prefix_(prefix),
       cache_(options.cache),
+      shared_tensor_store_(options.shared_tensor_store),
       metadata_(nullptr),
       table_(nullptr),
       index_cache_(nullptr),
       iter_(nullptr),
       need_to_swap_bytes_(false),
       enable_multi_threading_for_testing_(
-          options.enable_multi_threading_for_testing) {
+          options.enable_multi_threading_for_testing),
+      use_mmap_(options.use_mmap) {
   if (cache_ == nullptr) {
     // Make a cache for use just by this BundleReader.
     owned_cache_ = std::make_unique<BundleCache>(env);
@@ -836,6 +1017,12 @@ BundleReader::BundleReader(Env* env, absl::string_view prefix, Options options)
     return;
   }
   num_shards_ = header.num_shards();
+  if (!header.base_prefix().empty()) {
+    base_prefix_ =
+        header.base_prefix().find('/') == std::string::npos
+            ? io::JoinPath(io::Dirname(prefix_), header.base_prefix())
+            : header.base_prefix();
+  }
   if ((header.endianness() == BundleHeaderProto::BIG && port::kLittleEndian) ||
       (header.endianness() == BundleHeaderProto::LITTLE &&
        !port::kLittleEndian)) {
@@ -885,6 +1072,20 @@ absl::Status BundleReader::GetBundleEntryProto(absl::string_view key,
 
 absl::Status BundleReader::GetValue(const BundleEntryProto& entry,
                                     Tensor* val) {
+  if (use_mmap_ && DataTypeCanUseMemcpy(entry.dtype()) &&
+      !need_to_swap_bytes_ && entry.size() > 0) {
+    std::shared_ptr<ReadOnlyMemoryRegion> region;
+    const absl::Status status = cache_->GetMappedFile(
+        DataFilename(prefix_, entry.shard_id(), num_shards_), &region);
+    if (status.ok()) {
+      return GetMappedValue(entry, std::move(region), val);
+    }
+    // E.g. the file system does not support memory mapping. Reading the file
+    // reports the error if it cannot be read either.
+    VLOG(1) << "Failed to memory-map the data of " << prefix_
+            << ", reading it instead: " << status;
+  }
+
   Tensor* ret = val;
   const TensorShape stored_shape(TensorShape(entry.shape()));
   if (val->NumElements() == 0) {
@@ -1014,11 +1215,15 @@ absl::Status BundleReader::GetValue(const BundleEntryProto& entry,
         GetStringBackingBuffer(*ret), &actual_crc32c, need_to_swap_bytes_));
   }
   if (crc32c::Unmask(entry.crc32c()) != actual_crc32c) {
-    return errors::DataLoss(
-        "TensorBundle at ", prefix_, " shard ", entry.shard_id(), " (",
-        entry.size(), " bytes): Checksum does not match: stored ",
-        strings::Printf("%08u", crc32c::Unmask(entry.crc32c())),
-        " vs. calculated on the restored bytes ", actual_crc32c);
+    return ChecksumMismatchError(prefix_, entry, actual_crc32c);
+  }
+
+  if (shared_tensor_store_ != nullptr && DataTypeCanUseMemcpy(entry.dtype())) {
+    const Tensor restored = *ret;
+    *ret = shared_tensor_store_->Share(restored, actual_crc32c);
+    if (ret->tensor_data().data() != restored.tensor_data().data()) {
+      shared_bytes_ += ret->TotalBytes();
+    }
   }
 
   *val = *ret;
@@ -1026,6 +1231,53 @@ absl::Status BundleReader::GetValue(const BundleEntryProto& entry,
   return absl::OkStatus();
 }
 
+absl::Status BundleReader::GetMappedValue(
+    const BundleEntryProto& entry, std::shared_ptr<ReadOnlyMemoryRegion> region,
+    Tensor* val) {
+  const TensorShape stored_shape(entry.shape());
+  const size_t expected_size =
+      stored_shape.num_elements() * DataTypeSize(entry.dtype());
+  if (entry.size() != expected_size) {
+    return errors::DataLoss("Invalid size in bundle entry: key ", key(),
+                            "; stored size ", entry.size(),
+                            "; expected size ", expected_size);
+  }
+  if (entry.offset() + entry.size() > region->length()) {
+    return errors::DataLoss("TensorBundle at ", prefix_, " shard ",
+                            entry.shard_id(), " is truncated: ",
+                            region->length(), " bytes, but the tensor ends at ",
+                            entry.offset() + entry.size());
+  }
+
+  const char* data = static_cast<const char*>(region->data()) + entry.offset();
+  const uint32 actual_crc32c = crc32c::Value(data, entry.size());
+  if (crc32c::Unmask(entry.crc32c()) != actual_crc32c) {
+    return ChecksumMismatchError(prefix_, entry, actual_crc32c);
+  }
+
+  if (reinterpret_cast<uintptr_t>(data) % EIGEN_MAX_ALIGN_BYTES == 0) {
+    *val = Tensor(entry.dtype(), stored_shape,
+                  core::RefCountPtr<TensorBuffer>(new MappedTensorBuffer(
+                      std::move(region), data, entry.size())));
+    return absl::OkStatus();
+  }
+
+  // Unaligned tensors are copied, since kernels may assume aligned buffers.
+  if (val->NumElements() == 0) {
+    *val = Tensor(entry.dtype(), stored_shape);
+  }
+  std::memcpy(const_cast<char*>(val->tensor_data().data()), data,
+              entry.size());
+  if (shared_tensor_store_ != nullptr) {
+    const Tensor restored = *val;
+    *val = shared_tensor_store_->Share(restored, actual_crc32c);
+    if (val->tensor_data().data() != restored.tensor_data().data()) {
+      shared_bytes_ += val->TotalBytes();
+    }
+  }
+  return absl::OkStatus();
+}
+
 absl::Status BundleReader::Lookup(absl::string_view key, Tensor* val) {
   CHECK(val != nullptr);
   BundleEntryProto entry;
@@ -1236,17 +1488,18 @@ string BundleReader::DebugString() {
 
 BundleCache::BundleCache(Env* env) : env_(env) {}
 
+BundleCache::FileState* BundleCache::GetFileState(const std::string& name) {
+  absl::MutexLock l(&mu_);
+  auto& slot = opened_files_[name];
+  if (slot == nullptr) {
+    slot = std::make_unique<FileState>();
+  }
+  return slot.get();
+}
+
 BundleCache::FileState* BundleCache::EnsureOpened(std::string name) {
   // Get the file, opening it if necessary.
-  FileState* f;
-  {
-    absl::MutexLock l(&mu_);
-    auto& slot = opened_files_[name];
-    if (slot == nullptr) {
-      slot = std::make_unique<FileState>();
-    }
-    f = slot.get();
-  }
+  FileState* f = GetFileState(name);
 
   // Open the file or wait for a concurrent open to complete. We do not hold
   // mu_ here to avoid blocking threads reading from other files.
@@ -1264,6 +1517,86 @@ absl::Status BundleCache::GetFile(const std::string& fname,
   return f->open_status;
 }
 
+absl::Status BundleCache::GetMappedFile(
+    const std::string& fname, std::shared_ptr<ReadOnlyMemoryRegion>* region) {
+  FileState* f = GetFileState(fname);
+  // As in EnsureOpened(), mu_ is not held while mapping.
+  absl::call_once(f->map_once, [this, &fname, f] {
+    std::unique_ptr<ReadOnlyMemoryRegion> mapped;
+    f->map_status = env_->NewReadOnlyMemoryRegionFromFile(fname, &mapped);
+    f->region = std::move(mapped);
+  });
+  *region = f->region;
+  return f->map_status;
+}
+
+SharedTensorStore::SharedTensorStore(int64_t min_tensor_bytes)
+    : min_tensor_bytes_(min_tensor_bytes) {}
+
+Tensor SharedTensorStore::Share(const Tensor& tensor, uint32 crc32c) {
+  if (!DataTypeCanUseMemcpy(tensor.dtype()) ||
+      static_cast<int64_t>(tensor.TotalBytes()) < min_tensor_bytes_) {
+    return tensor;
+  }
+  const Key key(crc32c, tensor.TotalBytes());
+  std::vector<Tensor> candidates;
+  {
+    absl::MutexLock l(&mu_);
+    auto it = tensors_.find(key);
+    if (it != tensors_.end()) candidates = it->second;
+  }
+
+  // Compare the contents without holding mu_, since tensors can be large.
+  const absl::string_view data = tensor.tensor_data();
+  for (const Tensor& candidate : candidates) {
+    if (candidate.dtype() == tensor.dtype() &&
+        candidate.shape() == tensor.shape() &&
+        candidate.tensor_data() == data) {
+      absl::MutexLock l(&mu_);
+      ++num_shared_tensors_;
+      shared_bytes_ += tensor.TotalBytes();
+      return candidate;
+    }
+  }
+
+  absl::MutexLock l(&mu_);
+  tensors_[key].push_back(tensor);
+  return tensor;
+}
+
+void SharedTensorStore::Prune() {
+  absl::MutexLock l(&mu_);
+  for (auto it = tensors_.begin(); it != tensors_.end();) {
+    std::vector<Tensor>& bucket = it->second;
+    bucket.erase(
+        std::remove_if(bucket.begin(), bucket.end(),
+                       [](const Tensor& t) { return t.RefCountIsOne(); }),
+        bucket.end());
+    if (bucket.empty()) {
+      tensors_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+SharedTensorStore::Stats SharedTensorStore::stats() const {
+  absl::MutexLock l(&mu_);
+  Stats stats;
+  for (const auto& [key, bucket] : tensors_) {
+    stats.num_tensors += bucket.size();
+    stats.stored_bytes += key.second * bucket.size();
+  }
+  stats.num_shared_tensors = num_shared_tensors_;
+  stats.shared_bytes = shared_bytes_;
+  return stats;
+}
+
+SharedTensorStore& GlobalSharedTensorStore() {
+  static SharedTensorStore* store = new SharedTensorStore();
+  return *store;
+}
+
 namespace {
 inline char* AlignedMalloc(size_t size) {
   char* buffer = static_cast<char*>(port::AlignedMalloc(size, 64));
@@ -66,6 +66,7 @@ limitations under the License.
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "absl/algorithm/container.h"
@@ -123,9 +124,21 @@ class BundleWriter {
     // Alignment, in bytes, for tensor data.
     // Must be >= 1. The default size of 1 densely packs tensors.
     int data_alignment{1};
+
+    // Number of data files the tensors are spread over. If > 1, Add() only
+    // hands the tensor to the data file with the fewest bytes queued, and the
+    // data files are written and checksummed in parallel, one thread each.
+    // Finish() waits for them. The added tensors must then not be modified
+    // before Finish() returns.
+    int num_data_shards{1};
+
+    // If non-empty, the bundle is written as a delta on top of the bundle
+    // with this prefix. See BundleHeaderProto.base_prefix and delta_bundle.h.
+    std::string base_prefix;
   };
   BundleWriter(Env* env, absl::string_view prefix,
                const Options& options = Options());
+  ~BundleWriter();
 
   // Adds the tensor "val" under key "key".
   // Across calls "key" must be unique but can be added in any order.
@@ -158,6 +171,13 @@ class BundleWriter {
   absl::Status status() const { return status_; }
 
  private:
+  // A data file written in parallel. See Options::num_data_shards.
+  struct DataShard;
+
+  // Waits for the data shards to be written, then closes and renames them and
+  // adds their entries to entries_.
+  absl::Status FinishDataShards();
+
   Env* const env_;  // Not owned.
   const Options options_;
   const std::string prefix_;
@@ -166,6 +186,9 @@ class BundleWriter {
   bool use_temp_file_;
   std::unique_ptr<tsl::BufferedWritableFile> out_;
   int64_t size_;  // Number of bytes written into out_.
+  int num_shards_ = 1;
+  // Empty unless writing more than one data shard, in which case out_ is null.
+  std::vector<std::unique_ptr<DataShard>> shards_;
   std::map<std::string, BundleEntryProto> entries_;
   absl::Status status_;
 
@@ -200,6 +223,7 @@ absl::Status MergeBundles(Env* env, absl::Span<const tstring> prefixes,
                           bool allow_missing_files = false);
 
 class BundleCache;
+class SharedTensorStore;
 
 // On construction, silently attempts to read the metadata associated with
 // "prefix".  If caller intends to call any function afterwards, "status()"
@@ -217,6 +241,17 @@ class BundleReader {
 
     // For tests only.
     bool enable_multi_threading_for_testing = false;
+
+    // If supplied, restored tensors that are identical to tensors already in
+    // the store share their buffers. See SharedTensorStore.
+    SharedTensorStore* shared_tensor_store = nullptr;
+
+    // If true, the data files are memory-mapped. Tensors that need no byte
+    // swapping and whose data is suitably aligned in the file (see
+    // BundleWriter::Options::data_alignment) alias the read-only mapping
+    // instead of being copied; the others are copied from the mapping. Falls
+    // back to regular reads if the file system does not support mapping.
+    bool use_mmap = false;
   };
   BundleReader(Env* env, absl::string_view prefix, Options options);
 
@@ -226,6 +261,12 @@ class BundleReader {
   // the metadata).
   absl::Status status() const { return status_; }
 
+  // Returns the prefix of the bundle this bundle is a delta of, resolved
+  // against this bundle's directory, or the empty string if this bundle is not
+  // a delta. See delta_bundle.h.
+  // REQUIRES: status().ok()
+  const std::string& base_prefix() const { return base_prefix_; }
+
   // Queries whether the bundle contains an entry keyed by "key".  Calls Seek()
   // internally, so this call invalidates the reader's current position.
   // REQUIRES: status().ok()
@@ -306,6 +347,10 @@ class BundleReader {
   // Returns the key at the current position.
   // REQUIRES: status().ok() && Valid()
   absl::string_view key() const { return iter_->key(); }
+  // Returns the number of bytes of the tensors looked up by this reader that
+  // share their buffers with tensors in the shared tensor store.
+  int64_t shared_bytes() const { return shared_bytes_; }
+
   // Returns the raw value at the current position.
   // REQUIRES: status().ok() && Valid()
   absl::string_view value() const { return iter_->value(); }
@@ -323,6 +368,13 @@ class BundleReader {
   // Usage for "val" follows the comment of "Lookup()".
   absl::Status GetValue(const BundleEntryProto& entry, Tensor* val);
 
+  // Like GetValue(), but reads the tensor from the memory-mapped data file
+  // "region", aliasing the mapping if possible.
+  // REQUIRES: DataTypeCanUseMemcpy(entry.dtype()) && !need_to_swap_bytes_
+  absl::Status GetMappedValue(const BundleEntryProto& entry,
+                              std::shared_ptr<ReadOnlyMemoryRegion> region,
+                              Tensor* val);
+
   // Reads the slice described by "slice_spec".  The corresponding full tensor
   // has key "ful_tensor_key" and metadata proto "full_tensor_entry".
   // REQUIRES: full_tensor_entry.slices_size() > 0
@@ -334,6 +386,8 @@ class BundleReader {
   const std::string prefix_;
   std::unique_ptr<BundleCache> owned_cache_;  // may be null
   BundleCache* cache_;  // Not owned, or owned_cache_.get()
+  SharedTensorStore* shared_tensor_store_;  // Not owned, may be null.
+  int64_t shared_bytes_ = 0;
 
   absl::Status status_;
   RandomAccessFile* metadata_;  // Owned.
@@ -359,6 +413,8 @@ class BundleReader {
   friend class TensorBundleAlignmentTest;  // For testing data alignment.
 
   bool enable_multi_threading_for_testing_ = false;
+  bool use_mmap_ = false;
+  std::string base_prefix_;
 
   BundleReader(const BundleReader&) = delete;
   void operator=(const BundleReader&) = delete;
@@ -401,6 +457,12 @@ class BundleCache {
   // while the BundleCache lives.
   absl::Status GetFile(const std::string& fname, RandomAccessFile** file);
 
+  // Get a read-only memory mapping of fname, which is created on first use.
+  // The mapping lives as long as the BundleCache or the last returned
+  // reference to it.
+  absl::Status GetMappedFile(const std::string& fname,
+                             std::shared_ptr<ReadOnlyMemoryRegion>* region);
+
  private:
   // State for each opened file (opened on first read).
   struct FileState {
@@ -408,8 +470,13 @@ class BundleCache {
 
     std::unique_ptr<RandomAccessFile> file;
     absl::Status open_status;  // Records any error encountered on open
+
+    absl::once_flag map_once;  // Ensures file is mapped exactly once.
+    std::shared_ptr<ReadOnlyMemoryRegion> region;
+    absl::Status map_status;  // Records any error encountered on mapping
   };
 
+  FileState* GetFileState(const std::string& name);
   FileState* EnsureOpened(std::string name);
 
   Env* const env_;
@@ -418,6 +485,54 @@ class BundleCache {
       TF_GUARDED_BY(mu_);
 };
 
+// SharedTensorStore deduplicates the buffers of identical restored tensors,
+// e.g. the weights that are unchanged between two versions of a model loaded
+// in the same process. Tensors are matched by their checksum, size, dtype and
+// shape, and their contents are compared before a buffer is shared.
+//
+// Shared buffers must not be modified in place. Resource variables follow
+// copy-on-write semantics and copy a buffer that is shared before updating it.
+// Safe for concurrent uses by multiple threads and BundleReaders.
+class SharedTensorStore {
+ public:
+  // Tensors smaller than `min_tensor_bytes` are not stored or shared.
+  explicit SharedTensorStore(int64_t min_tensor_bytes = 4096);
+
+  // Returns a tensor equal to `tensor`, whose contents have the checksum
+  // `crc32c`. That is a stored tensor sharing its buffer if there is one, and
+  // otherwise `tensor` itself, which is then stored.
+  Tensor Share(const Tensor& tensor, uint32 crc32c);
+
+  // Drops the stored tensors that are not used outside of the store, so that
+  // their buffers are freed.
+  void Prune();
+
+  struct Stats {
+    // The number of tensors in the store and their total size.
+    int64_t num_tensors = 0;
+    int64_t stored_bytes = 0;
+    // The number of tensors returned by Share() with a previously stored
+    // buffer and their total size, i.e. the memory saved by the store.
+    int64_t num_shared_tensors = 0;
+    int64_t shared_bytes = 0;
+  };
+  Stats stats() const;
+
+ private:
+  // Tensors are bucketed by checksum and size.
+  using Key = std::pair<uint32, size_t>;
+
+  const int64_t min_tensor_bytes_;
+  mutable absl::Mutex mu_;
+  absl::flat_hash_map<Key, std::vector<Tensor>> tensors_ TF_GUARDED_BY(mu_);
+  int64_t num_shared_tensors_ TF_GUARDED_BY(mu_) = 0;
+  int64_t shared_bytes_ TF_GUARDED_BY(mu_) = 0;
+};
+
+// Returns the process-wide store shared by the restore ops. It is only used if
+// the TF_SHARE_RESTORED_TENSORS environment variable is set to true.
+SharedTensorStore& GlobalSharedTensorStore();
+
 }  // namespace tensorflow
 
 #endif  // TENSORFLOW_CORE_UTIL_TENSOR_BUNDLE_TENSOR_BUNDLE_H_
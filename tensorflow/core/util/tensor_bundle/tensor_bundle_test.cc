@@ -1151,6 +1151,111 @@ TEST(TensorBundleTest, LargeVariableLoadingTest) {
   }
 }
 
+TEST(TensorBundleTest, ParallelDataShards) {
+  Env* env = Env::Default();
+  BundleWriter::Options opts;
+  opts.num_data_shards = 3;
+  {
+    BundleWriter writer(env, Prefix("parallel"), opts);
+    TF_EXPECT_OK(writer.Add("foo_000", Constant_100x100<float>(0)));
+    TF_EXPECT_OK(writer.Add("foo_001", Constant_2x3<int32>(1)));
+    TF_EXPECT_OK(writer.Add("foo_002", Constant_2x3<tstring>("foo")));
+    TF_EXPECT_OK(writer.Add("foo_003", Constant_100x100<float>(3)));
+    TF_EXPECT_OK(writer.AddSlice("part", TensorShape({4, 3}),
+                                 TensorSlice::ParseOrDie("0,2:-"),
+                                 Constant_2x3<float>(4)));
+    TF_EXPECT_OK(writer.AddSlice("part", TensorShape({4, 3}),
+                                 TensorSlice::ParseOrDie("2,2:-"),
+                                 Constant_2x3<float>(5)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  for (int i = 0; i < opts.num_data_shards; ++i) {
+    TF_EXPECT_OK(env->FileExists(DataFilename(Prefix("parallel"), i, 3)));
+  }
+  {
+    BundleReader reader(env, Prefix("parallel"));
+    TF_ASSERT_OK(reader.status());
+    Expect<float>(&reader, "foo_000", Constant_100x100<float>(0));
+    Expect<int32>(&reader, "foo_001", Constant_2x3<int32>(1));
+    Expect<tstring>(&reader, "foo_002", Constant_2x3<tstring>("foo"));
+    Expect<float>(&reader, "foo_003", Constant_100x100<float>(3));
+    Expect<float>(&reader, "part",
+                  test::AsTensor<float>({4, 4, 4, 4, 4, 4, 5, 5, 5, 5, 5, 5},
+                                        TensorShape({4, 3})));
+  }
+
+  // A bundle with fewer tensors than data shards has empty data files, which
+  // are merged along with the others.
+  {
+    BundleWriter writer(env, Prefix("parallel_small"), opts);
+    TF_EXPECT_OK(writer.Add("bar", Constant_2x3<float>(6)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  TF_ASSERT_OK(MergeBundles(
+      env, {Prefix("parallel"), Prefix("parallel_small")},
+      Prefix("parallel_merged")));
+  for (int i = 0; i < 6; ++i) {
+    TF_EXPECT_OK(
+        env->FileExists(DataFilename(Prefix("parallel_merged"), i, 6)));
+  }
+  {
+    BundleReader reader(env, Prefix("parallel_merged"));
+    TF_ASSERT_OK(reader.status());
+    Expect<float>(&reader, "foo_003", Constant_100x100<float>(3));
+    Expect<float>(&reader, "bar", Constant_2x3<float>(6));
+  }
+}
+
+TEST(TensorBundleTest, MmapRestore) {
+  Env* env = Env::Default();
+  {
+    BundleWriter::Options opts;
+    opts.data_alignment = 64;
+    BundleWriter writer(env, Prefix("mmap_aligned"), opts);
+    TF_EXPECT_OK(writer.Add("small", Constant_2x3<int8>(1)));
+    TF_EXPECT_OK(writer.Add("large", Constant_100x100<float>(2)));
+    TF_EXPECT_OK(writer.Add("strings", Constant_2x3<tstring>("foo")));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  {
+    BundleWriter writer(env, Prefix("mmap_unaligned"));
+    TF_EXPECT_OK(writer.Add("small", Constant_2x3<int8>(1)));
+    TF_EXPECT_OK(writer.Add("large", Constant_100x100<float>(2)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+
+  BundleReader::Options options;
+  options.use_mmap = true;
+  {
+    BundleReader reader(env, Prefix("mmap_aligned"), options);
+    TF_ASSERT_OK(reader.status());
+    Tensor small, large, strings;
+    TF_ASSERT_OK(reader.Lookup("small", &small));
+    TF_ASSERT_OK(reader.Lookup("large", &large));
+    TF_ASSERT_OK(reader.Lookup("strings", &strings));
+    test::ExpectTensorEqual<int8>(small, Constant_2x3<int8>(1));
+    test::ExpectTensorEqual<float>(large, Constant_100x100<float>(2));
+    test::ExpectTensorEqual<tstring>(strings, Constant_2x3<tstring>("foo"));
+    // Aligned tensors alias the read-only mapping, which they do not own.
+    EXPECT_FALSE(small.RefCountIsOne());
+    EXPECT_FALSE(large.RefCountIsOne());
+    EXPECT_TRUE(strings.RefCountIsOne());
+  }
+  {
+    BundleReader reader(env, Prefix("mmap_unaligned"), options);
+    TF_ASSERT_OK(reader.status());
+    Tensor small, large;
+    TF_ASSERT_OK(reader.Lookup("small", &small));
+    TF_ASSERT_OK(reader.Lookup("large", &large));
+    test::ExpectTensorEqual<int8>(small, Constant_2x3<int8>(1));
+    test::ExpectTensorEqual<float>(large, Constant_100x100<float>(2));
+    // The float tensor follows the 6 bytes of the int8 tensor, so it is
+    // copied out of the mapping.
+    EXPECT_FALSE(small.RefCountIsOne());
+    EXPECT_TRUE(large.RefCountIsOne());
+  }
+}
+
 absl::Status CreateFile(Env* env, const std::string& fname) {
   std::unique_ptr<WritableFile> file;
   TF_RETURN_IF_ERROR(env->NewWritableFile(fname, &file));
@@ -1217,6 +1322,62 @@ TEST(BundleCacheTest, ConcurrentGetFile) {
   }
 }
 
+TEST(SharedTensorStoreTest, SharesIdenticalTensorsAcrossBundles) {
+  Env* env = Env::Default();
+  {
+    BundleWriter writer(env, Prefix("shared_v1"));
+    TF_EXPECT_OK(writer.Add("same", Constant_100x100<float>(1)));
+    TF_EXPECT_OK(writer.Add("changed", Constant_100x100<float>(2)));
+    TF_EXPECT_OK(writer.Add("small", Constant_2x3<float>(3)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+  {
+    BundleWriter writer(env, Prefix("shared_v2"));
+    TF_EXPECT_OK(writer.Add("same", Constant_100x100<float>(1)));
+    TF_EXPECT_OK(writer.Add("changed", Constant_100x100<float>(4)));
+    TF_EXPECT_OK(writer.Add("small", Constant_2x3<float>(3)));
+    TF_ASSERT_OK(writer.Finish());
+  }
+
+  SharedTensorStore store;
+  BundleReader::Options options;
+  options.shared_tensor_store = &store;
+  BundleReader reader_v1(env, Prefix("shared_v1"), options);
+  TF_ASSERT_OK(reader_v1.status());
+  BundleReader reader_v2(env, Prefix("shared_v2"), options);
+  TF_ASSERT_OK(reader_v2.status());
+
+  Tensor same_v1, same_v2, changed_v1, changed_v2, small_v1, small_v2;
+  TF_ASSERT_OK(reader_v1.Lookup("same", &same_v1));
+  TF_ASSERT_OK(reader_v1.Lookup("changed", &changed_v1));
+  TF_ASSERT_OK(reader_v1.Lookup("small", &small_v1));
+  TF_ASSERT_OK(reader_v2.Lookup("same", &same_v2));
+  TF_ASSERT_OK(reader_v2.Lookup("changed", &changed_v2));
+  TF_ASSERT_OK(reader_v2.Lookup("small", &small_v2));
+
+  test::ExpectTensorEqual<float>(same_v2, Constant_100x100<float>(1));
+  test::ExpectTensorEqual<float>(changed_v2, Constant_100x100<float>(4));
+  EXPECT_EQ(same_v1.tensor_data().data(), same_v2.tensor_data().data());
+  EXPECT_NE(changed_v1.tensor_data().data(), changed_v2.tensor_data().data());
+  // Tensors smaller than the minimum size are not shared.
+  EXPECT_NE(small_v1.tensor_data().data(), small_v2.tensor_data().data());
+
+  const int64_t tensor_bytes = 100 * 100 * sizeof(float);
+  EXPECT_EQ(reader_v1.shared_bytes(), 0);
+  EXPECT_EQ(reader_v2.shared_bytes(), tensor_bytes);
+  SharedTensorStore::Stats stats = store.stats();
+  EXPECT_EQ(stats.num_tensors, 3);
+  EXPECT_EQ(stats.stored_bytes, 3 * tensor_bytes);
+  EXPECT_EQ(stats.num_shared_tensors, 1);
+  EXPECT_EQ(stats.shared_bytes, tensor_bytes);
+
+  // Unloading the first version frees its changed tensor.
+  same_v1 = Tensor();
+  changed_v1 = Tensor();
+  store.Prune();
+  EXPECT_EQ(store.stats().num_tensors, 2);
+}
+
 class TensorBundleAlignmentTest : public ::testing::Test {
  protected:
   template <typename T>
@@ -0,0 +1,213 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/arena_plan_search.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace tflite {
+
+namespace {
+
+constexpr int32_t kUsedUntilTheEnd = std::numeric_limits<int32_t>::max();
+
+size_t AlignTo(size_t alignment, size_t offset) {
+  return offset % alignment == 0 ? offset
+                                 : offset + (alignment - offset % alignment);
+}
+
+bool UsesOverlap(const ArenaBufferUse& a, const ArenaBufferUse& b) {
+  return a.first_node <= b.last_node && b.first_node <= a.last_node;
+}
+
+// Returns the number of nodes using the buffers, not counting the uses until
+// the end of the graph.
+int32_t NumNodes(const std::vector<ArenaBufferUse>& buffers) {
+  int32_t num_nodes = 0;
+  for (const ArenaBufferUse& buffer : buffers) {
+    num_nodes = std::max(num_nodes, buffer.first_node + 1);
+    if (buffer.last_node != kUsedUntilTheEnd) {
+      num_nodes = std::max(num_nodes, buffer.last_node + 1);
+    }
+  }
+  return num_nodes;
+}
+
+// Returns the total size of the buffers used by each node.
+std::vector<size_t> NodeBreadths(const std::vector<ArenaBufferUse>& buffers) {
+  const int32_t num_nodes = NumNodes(buffers);
+  std::vector<size_t> breadths(num_nodes + 1, 0);
+  for (const ArenaBufferUse& buffer : buffers) {
+    breadths[buffer.first_node] += buffer.size;
+    breadths[std::min(buffer.last_node, num_nodes - 1) + 1] -= buffer.size;
+  }
+  for (int32_t node = 1; node < num_nodes; ++node) {
+    breadths[node] += breadths[node - 1];
+  }
+  breadths.pop_back();
+  return breadths;
+}
+
+std::vector<int> GreedyBySizeOrder(const std::vector<ArenaBufferUse>& buffers) {
+  std::vector<int> order(buffers.size());
+  std::iota(order.begin(), order.end(), 0);
+  auto used_by_whole_graph = [&buffers](int i) {
+    return buffers[i].first_node == 0 &&
+           buffers[i].last_node == kUsedUntilTheEnd;
+  };
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    if (used_by_whole_graph(a) != used_by_whole_graph(b)) {
+      return used_by_whole_graph(a);
+    }
+    if (used_by_whole_graph(a)) return buffers[a].tensor < buffers[b].tensor;
+    if (buffers[a].size != buffers[b].size) {
+      return buffers[a].size > buffers[b].size;
+    }
+    return buffers[a].first_node < buffers[b].first_node;
+  });
+  return order;
+}
+
+std::vector<int> GreedyByBreadthOrder(
+    const std::vector<ArenaBufferUse>& buffers) {
+  const std::vector<size_t> breadths = NodeBreadths(buffers);
+  std::vector<int32_t> nodes(breadths.size());
+  std::iota(nodes.begin(), nodes.end(), 0);
+  std::stable_sort(nodes.begin(), nodes.end(), [&breadths](int a, int b) {
+    return breadths[a] > breadths[b];
+  });
+
+  std::vector<int> order;
+  order.reserve(buffers.size());
+  std::vector<bool> ordered(buffers.size(), false);
+  std::vector<int> node_buffers;
+  for (int32_t node : nodes) {
+    node_buffers.clear();
+    for (int i = 0; i < buffers.size(); ++i) {
+      if (!ordered[i] && buffers[i].first_node <= node &&
+          node <= buffers[i].last_node) {
+        node_buffers.push_back(i);
+        ordered[i] = true;
+      }
+    }
+    std::stable_sort(node_buffers.begin(), node_buffers.end(),
+                     [&buffers](int a, int b) {
+                       return buffers[a].size > buffers[b].size;
+                     });
+    order.insert(order.end(), node_buffers.begin(), node_buffers.end());
+  }
+  return order;
+}
+
+}  // namespace
+
+size_t ArenaSizeLowerBound(const std::vector<ArenaBufferUse>& buffers) {
+  const std::vector<size_t> breadths = NodeBreadths(buffers);
+  return breadths.empty() ? 0
+                          : *std::max_element(breadths.begin(), breadths.end());
+}
+
+ArenaPlan PlaceArenaBuffers(const std::vector<ArenaBufferUse>& buffers,
+                            const std::vector<int>& order, size_t alignment) {
+  ArenaPlan plan;
+  plan.offsets.assign(buffers.size(), 0);
+  // The buffers already placed, by increasing offset.
+  std::vector<int> placed;
+  placed.reserve(buffers.size());
+  for (int i : order) {
+    const ArenaBufferUse& buffer = buffers[i];
+    if (buffer.size == 0) continue;
+    constexpr size_t kOffsetNotAssigned = std::numeric_limits<size_t>::max();
+    size_t best_offset = kOffsetNotAssigned;
+    size_t best_offset_fit = kOffsetNotAssigned;
+    size_t current_offset = 0;
+    for (int j : placed) {
+      if (!UsesOverlap(buffer, buffers[j])) continue;
+      const size_t aligned_current_offset = AlignTo(alignment, current_offset);
+      const size_t offset = plan.offsets[j];
+      if (aligned_current_offset + buffer.size <= offset &&
+          offset - aligned_current_offset < best_offset_fit) {
+        best_offset = aligned_current_offset;
+        best_offset_fit = offset - aligned_current_offset;
+      }
+      current_offset = std::max(current_offset, offset + buffers[j].size);
+      if (best_offset_fit == 0) break;
+    }
+    if (best_offset == kOffsetNotAssigned) {
+      best_offset = AlignTo(alignment, current_offset);
+    }
+    plan.offsets[i] = best_offset;
+    plan.arena_size = std::max(plan.arena_size, best_offset + buffer.size);
+    auto insertion_it = std::upper_bound(
+        placed.begin(), placed.end(), best_offset,
+        [&plan](size_t offset, int j) { return offset < plan.offsets[j]; });
+    placed.insert(insertion_it, i);
+  }
+  return plan;
+}
+
+ArenaPlan SearchArenaPlan(const std::vector<ArenaBufferUse>& buffers,
+                          size_t alignment, int64_t time_budget_us) {
+  const auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::microseconds(time_budget_us);
+  const size_t lower_bound = ArenaSizeLowerBound(buffers);
+
+  std::vector<int> best_order = GreedyBySizeOrder(buffers);
+  ArenaPlan best = PlaceArenaBuffers(buffers, best_order, alignment);
+  best.strategy = "greedy by size";
+  if (best.arena_size <= lower_bound) return best;
+
+  std::vector<int> order = GreedyByBreadthOrder(buffers);
+  ArenaPlan plan = PlaceArenaBuffers(buffers, order, alignment);
+  if (plan.arena_size < best.arena_size) {
+    best = std::move(plan);
+    best.strategy = "greedy by breadth";
+    best_order = std::move(order);
+  }
+
+  // Swaps which keep the arena size are kept too, to move across plateaus.
+  std::mt19937 rng(buffers.size());
+  std::uniform_int_distribution<int> distribution(
+      0, static_cast<int>(buffers.size()) - 1);
+  order = best_order;
+  size_t arena_size = best.arena_size;
+  while (buffers.size() > 1 && best.arena_size > lower_bound &&
+         std::chrono::steady_clock::now() < deadline) {
+    const int a = distribution(rng);
+    const int b = distribution(rng);
+    if (a == b) continue;
+    std::swap(order[a], order[b]);
+    plan = PlaceArenaBuffers(buffers, order, alignment);
+    if (plan.arena_size > arena_size) {
+      std::swap(order[a], order[b]);
+      continue;
+    }
+    arena_size = plan.arena_size;
+    if (plan.arena_size < best.arena_size) {
+      best = std::move(plan);
+      best.strategy = "local search";
+    }
+  }
+  return best;
+}
+
+}  // namespace tflite
@@ -0,0 +1,74 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_ARENA_PLAN_SEARCH_H_
+#define TENSORFLOW_LITE_ARENA_PLAN_SEARCH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tflite {
+
+// A buffer to place in an arena, which is used from the execution of
+// `first_node` to that of `last_node`, both included.
+struct ArenaBufferUse {
+  int32_t tensor;
+  size_t size;
+  int32_t first_node;
+  int32_t last_node;
+
+  bool operator==(const ArenaBufferUse& other) const {
+    return tensor == other.tensor && size == other.size &&
+           first_node == other.first_node && last_node == other.last_node;
+  }
+};
+
+// The offsets of buffers in an arena.
+struct ArenaPlan {
+  // The offset of each buffer, in the order of the buffers of the problem.
+  std::vector<size_t> offsets;
+  // The size of the arena holding all the buffers.
+  size_t arena_size = 0;
+  // The heuristic which found the plan, for logging.
+  const char* strategy = "";
+};
+
+// Returns a lower bound of the size of any arena holding `buffers`: the
+// largest total size of the buffers used by a node.
+size_t ArenaSizeLowerBound(const std::vector<ArenaBufferUse>& buffers);
+
+// Places `buffers` one after the other in the given order, each at the
+// `alignment`-aligned offset of the smallest gap it fits in among the buffers
+// already placed whose uses overlap with its own, or after them. This is what
+// SimpleMemoryArena::Allocate() does.
+ArenaPlan PlaceArenaBuffers(const std::vector<ArenaBufferUse>& buffers,
+                            const std::vector<int>& order, size_t alignment);
+
+// Returns the smallest of the plans found by placing `buffers` in the orders
+// given by several heuristics:
+//   * greedy by size: buffers used by the whole graph first, then by
+//     decreasing size, which is the order ArenaPlanner uses by default;
+//   * greedy by breadth: the buffers used by the node with the largest total
+//     size of buffers first, by decreasing size, then those of the next
+//     node, and so on;
+//   * a local search which swaps buffers in the best order found so far,
+//     keeping the swaps which do not increase the arena size, until
+//     `time_budget_us` microseconds are spent or the lower bound is reached.
+ArenaPlan SearchArenaPlan(const std::vector<ArenaBufferUse>& buffers,
+                          size_t alignment, int64_t time_budget_us);
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_ARENA_PLAN_SEARCH_H_
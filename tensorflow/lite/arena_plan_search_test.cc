@@ -0,0 +1,104 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/arena_plan_search.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace tflite {
+namespace {
+
+constexpr int32_t kUntilTheEnd = std::numeric_limits<int32_t>::max();
+
+void ExpectValidPlan(const std::vector<ArenaBufferUse>& buffers,
+                     const ArenaPlan& plan, size_t alignment) {
+  ASSERT_EQ(plan.offsets.size(), buffers.size());
+  for (int i = 0; i < buffers.size(); ++i) {
+    if (buffers[i].size == 0) continue;
+    EXPECT_EQ(plan.offsets[i] % alignment, 0);
+    EXPECT_LE(plan.offsets[i] + buffers[i].size, plan.arena_size);
+    for (int j = 0; j < i; ++j) {
+      if (buffers[j].size == 0 ||
+          buffers[i].last_node < buffers[j].first_node ||
+          buffers[j].last_node < buffers[i].first_node) {
+        continue;
+      }
+      const bool disjoint =
+          plan.offsets[i] + buffers[i].size <= plan.offsets[j] ||
+          plan.offsets[j] + buffers[j].size <= plan.offsets[i];
+      EXPECT_TRUE(disjoint) << "buffers " << i << " and " << j << " overlap";
+    }
+  }
+}
+
+TEST(ArenaPlanSearchTest, LowerBound) {
+  const std::vector<ArenaBufferUse> buffers = {
+      {0, 16, 0, kUntilTheEnd},
+      {1, 32, 0, 1},
+      {2, 64, 1, 2},
+      {3, 8, 2, 3},
+  };
+  // Node 1 uses buffers 0, 1 and 2.
+  EXPECT_EQ(ArenaSizeLowerBound(buffers), 16 + 32 + 64);
+  EXPECT_EQ(ArenaSizeLowerBound({}), 0);
+}
+
+TEST(ArenaPlanSearchTest, PlacesBuffersInGaps) {
+  const std::vector<ArenaBufferUse> buffers = {
+      {0, 64, 0, 1},
+      {1, 64, 0, 3},
+      {2, 32, 2, 3},
+  };
+  const ArenaPlan plan = PlaceArenaBuffers(buffers, {0, 1, 2}, 16);
+  ExpectValidPlan(buffers, plan, 16);
+  // Buffer 2 reuses the memory of buffer 0.
+  EXPECT_EQ(plan.offsets[2], plan.offsets[0]);
+  EXPECT_EQ(plan.arena_size, 128);
+}
+
+TEST(ArenaPlanSearchTest, FindsSmallerPlanThanGreedyBySize) {
+  const std::vector<ArenaBufferUse> buffers = {
+      {0, 80, 2, 3}, {1, 64, 0, 1}, {2, 64, 0, 2},
+      {3, 48, 1, 1}, {4, 80, 0, 2},
+  };
+  const ArenaPlan greedy = PlaceArenaBuffers(buffers, {4, 0, 1, 2, 3}, 16);
+  ExpectValidPlan(buffers, greedy, 16);
+  EXPECT_EQ(greedy.arena_size, 272);
+
+  const ArenaPlan plan =
+      SearchArenaPlan(buffers, 16, /*time_budget_us=*/10000000);
+  ExpectValidPlan(buffers, plan, 16);
+  EXPECT_EQ(plan.arena_size, ArenaSizeLowerBound(buffers));
+  EXPECT_EQ(plan.arena_size, 256);
+}
+
+TEST(ArenaPlanSearchTest, StopsAtTheLowerBound) {
+  const std::vector<ArenaBufferUse> buffers = {
+      {0, 64, 0, 0},
+      {1, 64, 1, 1},
+      {2, 64, 2, 2},
+  };
+  const ArenaPlan plan =
+      SearchArenaPlan(buffers, 64, /*time_budget_us=*/1000000000);
+  ExpectValidPlan(buffers, plan, 64);
+  EXPECT_EQ(plan.arena_size, 64);
+}
+
+}  // namespace
+}  // namespace tflite
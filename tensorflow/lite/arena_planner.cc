@@ -18,13 +18,17 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstdint>
+#include <iterator>
 #include <limits>
 #include <memory>
+#include <numeric>
 #include <utility>
 #include <vector>
 
+#include "tensorflow/lite/arena_plan_search.h"
 #include "tensorflow/lite/core/c/common.h"
 #include "tensorflow/lite/graph_info.h"
+#include "tensorflow/lite/minimal_logging.h"
 #include "tensorflow/lite/simple_memory_arena.h"
 
 namespace tflite {
@@ -33,6 +37,7 @@ constexpr int32_t kLastActiveNodeUndefined =
     std::numeric_limits<int32_t>::max();
 constexpr int32_t kNodeNotAssigned = std::numeric_limits<int32_t>::max();
 constexpr int32_t kScalarTensorBytes = 4;
+constexpr int kDefaultCachedArenaPlans = 4;
 
 ArenaPlanner::ArenaPlanner(TfLiteContext* context,
                            std::unique_ptr<GraphInfo> graph_info,
@@ -302,6 +307,10 @@ TfLiteStatus ArenaPlanner::PlanAllocations() {
   // Go through the graph in execution order.
   for (size_t i = 0; i < num_execution_nodes; ++i) {
     const TfLiteNode& node = graph_info_->node(i);
+    // Nodes executed concurrently must not reuse each other's memory, so the
+    // tensors of a node live as long as all of them run.
+    const auto [first_concurrent_node, last_concurrent_node] =
+        graph_info_->concurrent_execution_nodes(i);
 
     // First queue output tensors for allocation.
     TfLiteIntArray* node_outputs = node.outputs;
@@ -310,7 +319,7 @@ TfLiteStatus ArenaPlanner::PlanAllocations() {
       if (tensor_index == kTfLiteOptionalTensor) continue;
       //  Don't allocate output tensors here for shared memory parts.
       nodes_to_tensors_[i].insert(tensor_index);
-      TF_LITE_ENSURE_STATUS(allocate(i, tensor_index));
+      TF_LITE_ENSURE_STATUS(allocate(first_concurrent_node, tensor_index));
     }
 
     // Then update the ref-counts of the node's inputs, and if necessary queue
@@ -325,7 +334,8 @@ TfLiteStatus ArenaPlanner::PlanAllocations() {
           tensor_index = FindSharedTensor(tensor_index);
           --refcounts[tensor_index];
           if (refcounts[tensor_index] == 0) {
-            TF_LITE_ENSURE_STATUS(deallocate(i, tensor_index));
+            TF_LITE_ENSURE_STATUS(
+                deallocate(last_concurrent_node, tensor_index));
           }
         }
       }
@@ -349,13 +359,15 @@ TfLiteStatus ArenaPlanner::ExecuteAllocations(int first_node, int last_node) {
   for (size_t i = first_node;
        i <= static_cast<size_t>(last_node) && i < num_execution_nodes; ++i) {
     const TfLiteNode& node = graph_info_->node(i);
+    const auto [first_concurrent_node, last_concurrent_node] =
+        graph_info_->concurrent_execution_nodes(i);
     TfLiteIntArray* node_temporaries = node.temporaries;
     for (int j = 0; j < node_temporaries->size; ++j) {
       int tensor_index = node_temporaries->data[j];
-      alloc_node_[tensor_index] = i;
+      alloc_node_[tensor_index] = first_concurrent_node;
       nodes_to_tensors_[i].insert(tensor_index);
       if (!preserve_all_tensors_) {
-        dealloc_node_[tensor_index] = i;
+        dealloc_node_[tensor_index] = last_concurrent_node;
       }
     }
   }
@@ -509,6 +521,12 @@ TfLiteStatus ArenaPlanner::CalculateAllocations(
     last_active_node_ = last_node;
     return kTfLiteOk;
   }
+  // Plans for the whole graph may be searched for and cached.
+  const bool use_cached_plan =
+      (plan_search_time_budget_us_ > 0 || plan_cache_size_ > 0) &&
+      first_node == 0 && first_node < last_active_node_ &&
+      last_node + 1 >= static_cast<int>(graph_info_->num_execution_nodes());
+  std::vector<int32_t> tensors_to_place;
   if (first_node < last_active_node_) {
     arena_.ResetAllocs();
     last_active_node_ = first_node;
@@ -541,6 +559,10 @@ TfLiteStatus ArenaPlanner::CalculateAllocations(
       }
     }
     if (tensor.allocation_type == kTfLiteArenaRw) {
+      if (use_cached_plan) {
+        tensors_to_place.push_back(tensor_index);
+        continue;
+      }
       TF_LITE_ENSURE_STATUS(
           arena_.Allocate(context_, tensor_alignment_, tensor.bytes,
                           tensor_index, alloc_node_[tensor_index],
@@ -559,10 +581,87 @@ TfLiteStatus ArenaPlanner::CalculateAllocations(
       }
     }
   }
+  if (use_cached_plan) {
+    TF_LITE_ENSURE_STATUS(AllocateWithCachedPlan(tensors_to_place));
+  }
   last_active_node_ = last_node;
   return kTfLiteOk;
 }
 
+TfLiteStatus ArenaPlanner::AllocateWithCachedPlan(
+    const std::vector<int32_t>& tensors) {
+  const TfLiteTensor* all_tensors = graph_info_->tensors();
+  std::vector<ArenaBufferUse> buffers;
+  buffers.reserve(tensors.size());
+  for (int32_t tensor_index : tensors) {
+    buffers.push_back({tensor_index, all_tensors[tensor_index].bytes,
+                       alloc_node_[tensor_index], dealloc_node_[tensor_index]});
+  }
+  std::vector<int> input_shapes;
+  for (int tensor_index : graph_info_->inputs()) {
+    const TfLiteIntArray* dims = tensor_index == kTfLiteOptionalTensor
+                                     ? nullptr
+                                     : all_tensors[tensor_index].dims;
+    if (dims == nullptr) {
+      input_shapes.push_back(-1);
+      continue;
+    }
+    input_shapes.push_back(dims->size);
+    input_shapes.insert(input_shapes.end(), dims->data,
+                        dims->data + dims->size);
+  }
+
+  auto cached_plan =
+      std::find_if(cached_plans_.begin(), cached_plans_.end(),
+                   [&](const CachedArenaPlan& cached) {
+                     return cached.input_shapes == input_shapes &&
+                            cached.buffers == buffers;
+                   });
+  if (cached_plan != cached_plans_.end()) {
+    // Make it the most recently used plan.
+    std::rotate(cached_plan, std::next(cached_plan), cached_plans_.end());
+  } else {
+    ArenaPlan plan;
+    size_t lower_bound = 0;
+    if (plan_search_time_budget_us_ > 0) {
+      plan = SearchArenaPlan(buffers, tensor_alignment_,
+                             plan_search_time_budget_us_);
+      lower_bound = ArenaSizeLowerBound(buffers);
+      TFLITE_LOG_PROD(TFLITE_LOG_VERBOSE,
+                      "Arena plan found by %s: %zu bytes for %zu tensors, "
+                      "the lower bound is %zu bytes.",
+                      plan.strategy, plan.arena_size, buffers.size(),
+                      lower_bound);
+    } else {
+      // `tensors` are already in the order of CreateTensorAllocationVector().
+      std::vector<int> order(buffers.size());
+      std::iota(order.begin(), order.end(), 0);
+      plan = PlaceArenaBuffers(buffers, order, tensor_alignment_);
+    }
+    const size_t max_cached_plans = plan_cache_size_ > 0
+                                        ? plan_cache_size_
+                                        : kDefaultCachedArenaPlans;
+    if (cached_plans_.size() >= max_cached_plans) {
+      cached_plans_.erase(cached_plans_.begin(),
+                          cached_plans_.end() - (max_cached_plans - 1));
+    }
+    cached_plans_.push_back({std::move(input_shapes), std::move(buffers),
+                             std::move(plan), lower_bound});
+  }
+  cached_plan = std::prev(cached_plans_.end());
+
+  arena_size_lower_bound_ = cached_plan->lower_bound;
+  const std::vector<size_t>& offsets = cached_plan->plan.offsets;
+  for (int i = 0; i < static_cast<int>(tensors.size()); ++i) {
+    const int32_t tensor_index = tensors[i];
+    TF_LITE_ENSURE_STATUS(arena_.AllocateAt(
+        context_, offsets[i], all_tensors[tensor_index].bytes, tensor_index,
+        alloc_node_[tensor_index], dealloc_node_[tensor_index],
+        &allocs_[tensor_index]));
+  }
+  return kTfLiteOk;
+}
+
 bool AreTensorsAllocatedInSameArena(int32_t root_tensor_index,
                                     int32_t tensor_index,
                                     const TfLiteTensor* tensors) {
@@ -22,6 +22,7 @@ limitations under the License.
 #include <unordered_set>
 #include <vector>
 
+#include "tensorflow/lite/arena_plan_search.h"
 #include "tensorflow/lite/core/c/common.h"
 #include "tensorflow/lite/graph_info.h"
 #include "tensorflow/lite/memory_planner.h"
@@ -72,6 +73,23 @@ class ArenaPlanner : public MemoryPlanner {
   // Returns the base arena location for a given allocation type.
   std::intptr_t BasePointer(TfLiteAllocationType type);
 
+  // If `time_budget_us` is positive, the offsets of the tensors of the
+  // non-persistent arena are chosen by SearchArenaPlan() instead of greedily
+  // when planning the whole graph, spending at most that long searching. The
+  // plans are cached for the last few shapes of the inputs of the graph.
+  void SetPlanSearchTimeBudget(int64_t time_budget_us) {
+    plan_search_time_budget_us_ = time_budget_us;
+  }
+
+  // If `size` is positive, the offsets of the tensors of the non-persistent
+  // arena are cached for the `size` most recently used shapes of the inputs
+  // of the graph, whether they were placed greedily or searched for.
+  void SetPlanCacheSize(int size) { plan_cache_size_ = size; }
+
+  // Returns the lower bound of the size of the non-persistent arena computed
+  // by the last plan search, or 0.
+  size_t GetArenaSizeLowerBound() const { return arena_size_lower_bound_; }
+
  private:
   // Check whether the input tensor's memory may be shared the output tensor.
   // tensor_changed: true if the output tensor modifies the tensor data. For
@@ -104,6 +122,11 @@ class ArenaPlanner : public MemoryPlanner {
   TfLiteStatus CalculateAllocations(int first_node, int last_node,
                                     std::vector<int32_t>* tensors_allocated);
 
+  // Reserve space in the non-persistent arena for `tensors` at the offsets
+  // cached for the current input shapes, or else found by SearchArenaPlan()
+  // or PlaceArenaBuffers() and then cached.
+  TfLiteStatus AllocateWithCachedPlan(const std::vector<int32_t>& tensors);
+
   // Assign absolute memory location to a tensor, based on its relative
   // position inside the corresponding arena buffer.
   TfLiteStatus ResolveTensorAllocation(int32_t tensor_index,
@@ -166,6 +189,23 @@ class ArenaPlanner : public MemoryPlanner {
 
   // Store number of references to each tensor.
   std::vector<int> refcounts_;
+
+  // See SetPlanSearchTimeBudget() and SetPlanCacheSize().
+  int64_t plan_search_time_budget_us_ = 0;
+  size_t arena_size_lower_bound_ = 0;
+  int plan_cache_size_ = 0;
+
+  // A plan found for given input shapes, which is reused as long as the
+  // tensors to place are the same.
+  struct CachedArenaPlan {
+    // The rank and dimensions of each input, -1 for optional ones.
+    std::vector<int> input_shapes;
+    std::vector<ArenaBufferUse> buffers;
+    ArenaPlan plan;
+    size_t lower_bound;
+  };
+  // The cached plans, least recently used first.
+  std::vector<CachedArenaPlan> cached_plans_;
 };
 
 }  // namespace tflite
@@ -330,6 +330,78 @@ TEST_F(ArenaPlannerTest, SimpleGraph) {
   EXPECT_EQ(GetOffset(1), 4);
 }
 
+TEST_F(ArenaPlannerTest, SimpleGraphWithPlanSearch) {
+  TestGraph graph({0, 1},
+                  {
+                      /* in, out, tmp */
+                      {{0, 1}, {2}, {}},     // First op
+                      {{2, 0}, {4, 5}, {}},  // Second op
+                      {{4, 5}, {3}, {}}      // Third op
+                  },
+                  {3});
+  SetGraph(&graph);
+  Execute(0, graph.nodes().size() - 1);
+  size_t greedy_arena_size, arena_size, persistent_arena_size;
+  planner_->GetAllocInfo(&greedy_arena_size, &persistent_arena_size);
+
+  SetGraph(&graph);
+  planner_->SetPlanSearchTimeBudget(/*time_budget_us=*/10000);
+  Execute(0, graph.nodes().size() - 1);
+  planner_->GetAllocInfo(&arena_size, &persistent_arena_size);
+  EXPECT_LE(arena_size, greedy_arena_size);
+  EXPECT_GT(planner_->GetArenaSizeLowerBound(), 0);
+  EXPECT_GE(arena_size, planner_->GetArenaSizeLowerBound());
+  // Tensors used by the same op do not overlap.
+  EXPECT_TRUE(GetOffsetAfter(4) <= GetOffset(5) ||
+              GetOffsetAfter(5) <= GetOffset(4));
+  EXPECT_TRUE(GetOffsetAfter(0) <= GetOffset(2) ||
+              GetOffsetAfter(2) <= GetOffset(0));
+
+  // Planning again for the same shapes reuses the plan.
+  const std::ptrdiff_t offset_of_3 = GetOffset(3);
+  ResetAllocations();
+  Execute(0, graph.nodes().size() - 1);
+  EXPECT_EQ(GetOffset(3), offset_of_3);
+}
+
+TEST_F(ArenaPlannerTest, SimpleGraphWithPlanCache) {
+  TestGraph graph({0, 1},
+                  {
+                      /* in, out, tmp */
+                      {{0, 1}, {2}, {}},     // First op
+                      {{2, 0}, {4, 5}, {}},  // Second op
+                      {{4, 5}, {3}, {}}      // Third op
+                  },
+                  {3});
+  std::vector<TfLiteTensor>& tensors = *graph.tensors();
+  auto plan_offsets = [&](bool use_cache) {
+    if (!use_cache) SetGraph(&graph);
+    ResetAllocations();
+    Execute(0, graph.nodes().size() - 1);
+    std::vector<std::ptrdiff_t> offsets;
+    for (int i = 0; i < tensors.size(); ++i) {
+      offsets.push_back(GetOffset(i));
+    }
+    return offsets;
+  };
+  const std::vector<std::ptrdiff_t> greedy_offsets = plan_offsets(false);
+  tensors[2].bytes += 64;
+  const std::vector<std::ptrdiff_t> larger_greedy_offsets =
+      plan_offsets(false);
+  tensors[2].bytes -= 64;
+
+  // Cached plans place the tensors where the greedy planner does, for every
+  // shape, including when the least recently used plan was evicted.
+  SetGraph(&graph);
+  planner_->SetPlanCacheSize(1);
+  EXPECT_EQ(plan_offsets(true), greedy_offsets);
+  EXPECT_EQ(plan_offsets(true), greedy_offsets);
+  tensors[2].bytes += 64;
+  EXPECT_EQ(plan_offsets(true), larger_greedy_offsets);
+  tensors[2].bytes -= 64;
+  EXPECT_EQ(plan_offsets(true), greedy_offsets);
+}
+
 TEST_F(ArenaPlannerTest, AllocsCorrectlyReset) {
   TestGraph graph({0, 1},
                   {
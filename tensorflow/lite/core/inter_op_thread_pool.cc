@@ -0,0 +1,113 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/core/inter_op_thread_pool.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>   // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/external_cpu_backend_context.h"
+
+namespace tflite {
+
+namespace {
+
+thread_local ExternalCpuBackendContext* current_cpu_backend_context = nullptr;
+thread_local bool in_parallel_for = false;
+
+}  // namespace
+
+InterOpThreadPool::InterOpThreadPool(int num_threads) {
+  for (int i = 1; i < num_threads; ++i) {
+    cpu_backend_contexts_.push_back(
+        std::make_unique<ExternalCpuBackendContext>());
+  }
+  for (auto& cpu_backend_context : cpu_backend_contexts_) {
+    workers_.emplace_back(&InterOpThreadPool::WorkerLoop, this,
+                          cpu_backend_context.get());
+  }
+}
+
+InterOpThreadPool::~InterOpThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  work_available_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+void InterOpThreadPool::ParallelFor(int num_tasks,
+                                    const std::function<void(int)>& fn) {
+  if (num_tasks <= 0) return;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    fn_ = &fn;
+    num_tasks_ = num_tasks;
+    next_task_.store(0, std::memory_order_relaxed);
+    if (num_tasks > 1) {
+      num_busy_workers_ = static_cast<int>(workers_.size());
+      ++generation_;
+    }
+  }
+  if (num_tasks > 1) work_available_.notify_all();
+  RunTasks();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  work_done_.wait(lock, [this] { return num_busy_workers_ == 0; });
+  fn_ = nullptr;
+}
+
+TfLiteExternalContext* InterOpThreadPool::CurrentThreadCpuBackendContext() {
+  return current_cpu_backend_context;
+}
+
+bool InterOpThreadPool::InParallelFor() { return in_parallel_for; }
+
+void InterOpThreadPool::WorkerLoop(
+    ExternalCpuBackendContext* cpu_backend_context) {
+  current_cpu_backend_context = cpu_backend_context;
+  int64_t seen_generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      work_available_.wait(lock, [this, seen_generation] {
+        return shutdown_ || generation_ != seen_generation;
+      });
+      if (shutdown_) return;
+      seen_generation = generation_;
+    }
+    RunTasks();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--num_busy_workers_ == 0) work_done_.notify_one();
+    }
+  }
+}
+
+void InterOpThreadPool::RunTasks() {
+  in_parallel_for = true;
+  for (int task = next_task_.fetch_add(1); task < num_tasks_;
+       task = next_task_.fetch_add(1)) {
+    (*fn_)(task);
+  }
+  in_parallel_for = false;
+}
+
+}  // namespace tflite
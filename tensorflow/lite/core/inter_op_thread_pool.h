@@ -0,0 +1,91 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_CORE_INTER_OP_THREAD_POOL_H_
+#define TENSORFLOW_LITE_CORE_INTER_OP_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>   // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/external_cpu_backend_context.h"
+
+namespace tflite {
+
+// A fixed set of threads on which the nodes of a subgraph that do not depend on
+// each other are executed concurrently, see
+// `InterpreterOptions::SetInterOpParallelism()`.
+//
+// The CPU backend context of the interpreter is not thread-safe, so each
+// worker thread has its own one, which kernels get from
+// `TfLiteContext::GetExternalContext()` while running on that thread.
+//
+// WARNING: This is an experimental API and subject to change.
+class InterOpThreadPool {
+ public:
+  // Creates a pool running tasks on `num_threads` threads, including the one
+  // calling `ParallelFor()`.
+  explicit InterOpThreadPool(int num_threads);
+  ~InterOpThreadPool();
+
+  InterOpThreadPool(const InterOpThreadPool&) = delete;
+  InterOpThreadPool& operator=(const InterOpThreadPool&) = delete;
+
+  int num_threads() const { return static_cast<int>(workers_.size()) + 1; }
+
+  // Calls `fn(task)` for every task in [0, num_tasks) on the threads of the
+  // pool, and returns once all the calls returned. Calls must not be
+  // concurrent, nor be made from within `fn`.
+  void ParallelFor(int num_tasks, const std::function<void(int)>& fn);
+
+  // Returns the CPU backend context of the current thread if it is a worker
+  // thread of a pool, or nullptr.
+  static TfLiteExternalContext* CurrentThreadCpuBackendContext();
+
+  // Whether the current thread is running a task of `ParallelFor()`.
+  static bool InParallelFor();
+
+ private:
+  void WorkerLoop(ExternalCpuBackendContext* cpu_backend_context);
+  void RunTasks();
+
+  std::vector<std::unique_ptr<ExternalCpuBackendContext>>
+      cpu_backend_contexts_;
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  // Signaled when a new `ParallelFor()` starts or the pool shuts down.
+  std::condition_variable work_available_;
+  // Signaled when the last worker finished the tasks of a `ParallelFor()`.
+  std::condition_variable work_done_;
+  int64_t generation_ = 0;
+  int num_busy_workers_ = 0;
+  bool shutdown_ = false;
+
+  // The tasks of the current `ParallelFor()`. Written under `mutex_` before
+  // `generation_` is bumped.
+  const std::function<void(int)>* fn_ = nullptr;
+  int num_tasks_ = 0;
+  std::atomic<int> next_task_{0};
+};
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_CORE_INTER_OP_THREAD_POOL_H_
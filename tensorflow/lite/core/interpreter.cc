@@ -32,6 +32,7 @@ limitations under the License.
 #include "tensorflow/lite/core/api/error_reporter.h"
 #include "tensorflow/lite/core/api/profiler.h"
 #include "tensorflow/lite/core/c/c_api_types.h"
+#include "tensorflow/lite/core/inter_op_thread_pool.h"
 #include "tensorflow/lite/core/signature_runner.h"
 #include "tensorflow/lite/core/subgraph.h"
 #include "tensorflow/lite/external_cpu_backend_context.h"
@@ -497,9 +498,19 @@ TfLiteStatus Interpreter::ApplyOptionsImpl(InterpreterOptions* options) {
   }
   options_ = std::make_unique<InterpreterOptions>(*options);
 
+  const int inter_op_parallelism = options_->GetInterOpParallelism();
+  if (inter_op_parallelism <= 1) {
+    inter_op_thread_pool_.reset();
+  } else if (!inter_op_thread_pool_ ||
+             inter_op_thread_pool_->num_threads() != inter_op_parallelism) {
+    inter_op_thread_pool_ =
+        std::make_unique<InterOpThreadPool>(inter_op_parallelism);
+  }
+
   // Set InterpreterOptions object to SubGraph.
   for (auto& subgraph : subgraphs_) {
     subgraph->SetOptions(options_.get());
+    subgraph->SetInterOpThreadPool(inter_op_thread_pool_.get());
   }
   return kTfLiteOk;
 }
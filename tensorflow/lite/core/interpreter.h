@@ -47,6 +47,7 @@ limitations under the License.
 #include "tensorflow/lite/core/api/profiler.h"
 #include "tensorflow/lite/core/async/async_signature_runner.h"
 #include "tensorflow/lite/core/c/common.h"  // IWYU pragma: export
+#include "tensorflow/lite/core/inter_op_thread_pool.h"
 #include "tensorflow/lite/core/signature_runner.h"
 #include "tensorflow/lite/core/subgraph.h"
 #include "tensorflow/lite/experimental/resource/initialization_status.h"
@@ -1016,6 +1017,10 @@ class Interpreter {
   // InterpreterOptions object which is being used.
   std::unique_ptr<InterpreterOptions> options_;
 
+  // Runs the independent nodes of the subgraphs concurrently if
+  // `InterpreterOptions::SetInterOpParallelism()` asked for it.
+  std::unique_ptr<InterOpThreadPool> inter_op_thread_pool_;
+
   // Stores control edges that are encoded in the metadata of the model. Updated
   // in SetMetadata; model_control_dependencies_.empty() means that there were
   // no control dependencies encoded in the metadata, or that we were unable to
@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/lite/core/signature_runner.h"
 
 #include <cstdint>
+#include <cstring>
 #include <map>
 #include <vector>
 
@@ -23,6 +24,7 @@ limitations under the License.
 #include "tensorflow/lite/core/c/c_api_types.h"
 #include "tensorflow/lite/core/subgraph.h"
 #include "tensorflow/lite/internal/signature_def.h"
+#include "tensorflow/lite/util.h"
 
 namespace tflite {
 namespace impl {
@@ -140,6 +142,140 @@ TfLiteStatus SignatureRunner::Invoke() {
   return kTfLiteOk;
 }
 
+bool SignatureRunner::HasDynamicBatch() {
+  for (const char* input_name : input_names_) {
+    const TfLiteTensor* tensor = input_tensor(input_name);
+    if (tensor->dims_signature == nullptr ||
+        tensor->dims_signature->size == 0 ||
+        tensor->dims_signature->data[0] != -1) {
+      return false;
+    }
+  }
+  return !input_names_.empty();
+}
+
+TfLiteStatus SignatureRunner::GetBatchRequestInputBytes(
+    std::vector<size_t>* input_bytes) {
+  input_bytes->clear();
+  const bool dynamic_batch = HasDynamicBatch();
+  for (const char* input_name : input_names_) {
+    const TfLiteTensor* tensor = input_tensor(input_name);
+    if (tensor->type == kTfLiteString) {
+      subgraph_->ReportError("Batch requests don't support string input %s.",
+                             input_name);
+      return kTfLiteError;
+    }
+    if (!dynamic_batch) {
+      input_bytes->push_back(tensor->bytes);
+      continue;
+    }
+    // An example is the tensor without its batch dimension.
+    size_t example_bytes;
+    TF_LITE_ENSURE_STATUS(
+        GetSizeOfType(subgraph_->context(), tensor->type, &example_bytes));
+    for (int d = 1; d < tensor->dims->size; ++d) {
+      example_bytes *= tensor->dims->data[d];
+    }
+    input_bytes->push_back(example_bytes);
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus SignatureRunner::InvokeBatch(
+    const std::vector<SignatureRunnerBatchRequest*>& requests) {
+  if (requests.empty()) return kTfLiteOk;
+  for (SignatureRunnerBatchRequest* request : requests) {
+    if (request->inputs.size() != input_names_.size()) {
+      subgraph_->ReportError("A batch request has %zu inputs, expected %zu.",
+                             request->inputs.size(), input_names_.size());
+      return kTfLiteError;
+    }
+    request->outputs.resize(output_names_.size());
+  }
+  for (const char* input_name : input_names_) {
+    if (input_tensor(input_name)->type == kTfLiteString) {
+      subgraph_->ReportError("Batch requests don't support string input %s.",
+                             input_name);
+      return kTfLiteError;
+    }
+  }
+
+  if (!HasDynamicBatch()) {
+    for (SignatureRunnerBatchRequest* request : requests) {
+      for (size_t i = 0; i < input_names_.size(); ++i) {
+        TfLiteTensor* tensor = input_tensor(input_names_[i]);
+        if (request->inputs[i].size() != tensor->bytes ||
+            tensor->data.raw == nullptr) {
+          subgraph_->ReportError(
+              "Input %s of a batch request has %zu bytes, expected %zu.",
+              input_names_[i], request->inputs[i].size(), tensor->bytes);
+          return kTfLiteError;
+        }
+        std::memcpy(tensor->data.raw, request->inputs[i].data(),
+                    tensor->bytes);
+      }
+      TF_LITE_ENSURE_STATUS(Invoke());
+      for (size_t i = 0; i < output_names_.size(); ++i) {
+        const TfLiteTensor* tensor = output_tensor(output_names_[i]);
+        request->outputs[i].assign(tensor->data.raw,
+                                   tensor->data.raw + tensor->bytes);
+      }
+    }
+    return kTfLiteOk;
+  }
+
+  // Resizes the batch dimension only, and only if it changes, so that a
+  // steady stream of full batches doesn't re-prepare the graph.
+  const int batch_size = static_cast<int>(requests.size());
+  bool resized = false;
+  for (const char* input_name : input_names_) {
+    const TfLiteTensor* tensor = input_tensor(input_name);
+    if (tensor->dims->size > 0 && tensor->dims->data[0] == batch_size) {
+      continue;
+    }
+    std::vector<int> new_size(tensor->dims->data,
+                              tensor->dims->data + tensor->dims->size);
+    new_size[0] = batch_size;
+    TF_LITE_ENSURE_STATUS(ResizeInputTensor(input_name, new_size));
+    resized = true;
+  }
+  if (resized) TF_LITE_ENSURE_STATUS(AllocateTensors());
+
+  for (size_t i = 0; i < input_names_.size(); ++i) {
+    TfLiteTensor* tensor = input_tensor(input_names_[i]);
+    const size_t example_bytes = tensor->bytes / batch_size;
+    for (int b = 0; b < batch_size; ++b) {
+      const std::vector<uint8_t>& input = requests[b]->inputs[i];
+      if (input.size() != example_bytes || tensor->data.raw == nullptr) {
+        subgraph_->ReportError(
+            "Input %s of a batch request has %zu bytes, expected %zu.",
+            input_names_[i], input.size(), example_bytes);
+        return kTfLiteError;
+      }
+      std::memcpy(tensor->data.raw + b * example_bytes, input.data(),
+                  example_bytes);
+    }
+  }
+
+  TF_LITE_ENSURE_STATUS(Invoke());
+
+  for (size_t i = 0; i < output_names_.size(); ++i) {
+    const TfLiteTensor* tensor = output_tensor(output_names_[i]);
+    if (tensor->dims->size == 0 || tensor->dims->data[0] != batch_size) {
+      subgraph_->ReportError(
+          "Output %s doesn't have a batch dimension of %d examples.",
+          output_names_[i], batch_size);
+      return kTfLiteError;
+    }
+    const size_t example_bytes = tensor->bytes / batch_size;
+    for (int b = 0; b < batch_size; ++b) {
+      const char* example = tensor->data.raw + b * example_bytes;
+      requests[b]->outputs[i].assign(example, example + example_bytes);
+    }
+  }
+  return kTfLiteOk;
+}
+
 TfLiteStatus SignatureRunner::SetCustomAllocationForInputTensor(
     const char* input_name, const TfLiteCustomAllocation& allocation,
     int64_t flags) {
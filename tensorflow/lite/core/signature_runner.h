@@ -43,6 +43,18 @@ class SignatureRunnerJNIHelper;  // Class for friend declarations.
 class TensorHandle;              // Class for friend declarations.
 
 namespace impl {
+/// The data of one request of `SignatureRunner::InvokeBatch`: a single example
+/// of every input and output of the signature, i.e. the data of the tensor
+/// without its batch (first) dimension.
+///
+/// WARNING: This is an experimental API and subject to change.
+struct SignatureRunnerBatchRequest {
+  /// The data of each input, in the order of `input_names()`.
+  std::vector<std::vector<uint8_t>> inputs;
+  /// Filled with the data of each output, in the order of `output_names()`.
+  std::vector<std::vector<uint8_t>> outputs;
+};
+
 /// SignatureRunner class for running TFLite models using SignatureDef.
 ///
 /// Usage:
@@ -161,6 +173,41 @@ class SignatureRunner {
   /// signature in dependency order).
   TfLiteStatus Invoke();
 
+  /// \brief Runs several independent requests, ideally with one invocation.
+  ///
+  /// If every input has a dynamic batch dimension, i.e. its first dimension is
+  /// `-1` in `dims_signature`, the inputs are resized to a batch of
+  /// `requests.size()` examples (the other dimensions are kept), the inputs
+  /// of the requests are stacked along the batch dimension, the signature is
+  /// invoked once and the outputs are split back into the requests. Every
+  /// output must then have the batch as its first dimension.
+  /// Otherwise, the signature is invoked once per request, each request
+  /// holding the data of the whole input tensors with their current shapes.
+  ///
+  /// Changing the batch size re-prepares the graph, so callers should favor a
+  /// small set of batch sizes. String tensors are not supported.
+  ///
+  /// Returns an error if the size of an input of a request doesn't match its
+  /// tensor; the outputs of the requests are then unspecified.
+  ///
+  /// WARNING: This is an experimental API and subject to change.
+  TfLiteStatus InvokeBatch(
+      const std::vector<SignatureRunnerBatchRequest*>& requests);
+
+  /// Returns whether every input has a dynamic batch dimension, i.e. whether
+  /// `InvokeBatch` runs its requests with a single invocation.
+  ///
+  /// WARNING: This is an experimental API and subject to change.
+  bool HasDynamicBatch();
+
+  /// Fills `input_bytes` with the size in bytes of each input of a request of
+  /// `InvokeBatch` given the current input shapes, in the order of
+  /// `input_names()`. Returns an error for inputs `InvokeBatch` doesn't
+  /// support.
+  ///
+  /// WARNING: This is an experimental API and subject to change.
+  TfLiteStatus GetBatchRequestInputBytes(std::vector<size_t>* input_bytes);
+
   /// Attempts to cancel in flight invocation if any.
   /// This will not affect calls to `Invoke` that happened after this.
   /// Non blocking and thread safe.
@@ -24,6 +24,8 @@ limitations under the License.
 #include <cstring>
 #include <iterator>
 #include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <numeric>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -42,6 +44,7 @@ limitations under the License.
 #include "tensorflow/lite/core/c/builtin_op_data.h"
 #include "tensorflow/lite/core/c/c_api_types.h"
 #include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/inter_op_thread_pool.h"
 #include "tensorflow/lite/experimental/resource/initialization_status.h"
 #include "tensorflow/lite/experimental/resource/resource_base.h"
 #include "tensorflow/lite/graph_info.h"
@@ -49,6 +52,7 @@ limitations under the License.
 #include "tensorflow/lite/memory_planner.h"
 #include "tensorflow/lite/minimal_logging.h"
 #include "tensorflow/lite/profiling/telemetry/telemetry.h"
+#include "tensorflow/lite/profiling/time.h"
 #include "tensorflow/lite/schema/schema_generated.h"
 #include "tensorflow/lite/util.h"
 #ifdef TFLITE_USE_SIMPLE_MEMORY_PLANNER
@@ -246,6 +250,13 @@ class InterpreterInfo : public GraphInfo {
     return subgraph_->variables();
   }
 
+  std::pair<size_t, size_t> concurrent_execution_nodes(
+      size_t index) const override {
+    const auto [first, last] = subgraph_->GetConcurrentExecutionPlanRange(
+        static_cast<int>(index));
+    return {first, last};
+  }
+
  public:
   Subgraph* subgraph_;
 };
@@ -624,6 +635,14 @@ TfLiteStatus Subgraph::ReplaceNodeSubsetsWithDelegateKernels(
 
 TfLiteExternalContext* Subgraph::GetExternalContext(
     TfLiteExternalContextType type) {
+  if (type == kTfLiteCpuBackendContext) {
+    // Kernels running on a worker thread of the inter-op thread pool must not
+    // share the CPU backend context of the interpreter.
+    if (TfLiteExternalContext* worker_context =
+            InterOpThreadPool::CurrentThreadCpuBackendContext()) {
+      return worker_context;
+    }
+  }
   if (static_cast<int>(type) >= 0 && type < kTfLiteMaxExternalContexts) {
     return external_contexts_[type];
   }
@@ -1127,12 +1146,16 @@ TfLiteStatus Subgraph::AddNodeWithParameters(
   node.outputs = ConvertVectorToTfLiteIntArray(outputs);
   node.intermediates = ConvertVectorToTfLiteIntArray(intermediates);
   node.temporaries = TfLiteIntArrayCreate(0);
+  const uint64_t init_start_us = profiling::time::NowMicros();
   if (init_data) {
     node.user_data = OpInit(*registration, init_data, init_data_size);
   } else {
     node.user_data = OpInit(
         *registration, static_cast<const char*>(builtin_data_deleter.get()), 0);
   }
+  node_init_time_us_.resize(nodes_and_registration_.size());
+  node_init_time_us_[new_node_index] =
+      profiling::time::NowMicros() - init_start_us;
 
   node.builtin_data = builtin_data_deleter.release();
 
@@ -1494,6 +1517,55 @@ TfLiteStatus Subgraph::MayAllocateOpOutput(TfLiteNode* node) {
   return kTfLiteOk;
 }
 
+namespace {
+
+void AppendToSignature(const void* data, size_t size,
+                       std::vector<char>* signature) {
+  const char* bytes = static_cast<const char*>(data);
+  signature->insert(signature->end(), bytes, bytes + size);
+}
+
+}  // namespace
+
+void Subgraph::GetNodePrepareSignature(const TfLiteNode& node,
+                                       std::vector<char>* signature) const {
+  signature->clear();
+  if (node.delegate != nullptr || node.might_have_side_effect) return;
+  const TfLiteIntArray* tensor_arrays[] = {node.inputs, node.outputs,
+                                           node.temporaries};
+  for (const TfLiteIntArray* tensor_indices : tensor_arrays) {
+    const int num_tensors = tensor_indices ? tensor_indices->size : 0;
+    AppendToSignature(&num_tensors, sizeof(num_tensors), signature);
+    for (int i = 0; i < num_tensors; ++i) {
+      const int tensor_index = tensor_indices->data[i];
+      AppendToSignature(&tensor_index, sizeof(tensor_index), signature);
+      if (tensor_index == kTfLiteOptionalTensor) continue;
+      const TfLiteTensor& tensor = tensors_[tensor_index];
+      // Persistent arena tensors may hold state computed by the kernel since
+      // it was prepared, and the shapes of dynamic tensors are only known once
+      // the node is invoked.
+      if (tensor.allocation_type == kTfLiteArenaRwPersistent ||
+          tensor.allocation_type == kTfLiteDynamic || tensor.is_variable) {
+        signature->clear();
+        return;
+      }
+      AppendToSignature(&tensor.type, sizeof(tensor.type), signature);
+      AppendToSignature(&tensor.bytes, sizeof(tensor.bytes), signature);
+      const int rank = tensor.dims ? tensor.dims->size : -1;
+      AppendToSignature(&rank, sizeof(rank), signature);
+      if (rank > 0) {
+        AppendToSignature(tensor.dims->data, rank * sizeof(int), signature);
+      }
+      // Kernels read the data of these tensors, computed by the nodes they
+      // are the outputs of, when preparing.
+      if (tensor.allocation_type == kTfLitePersistentRo &&
+          tensor.data.raw != nullptr) {
+        AppendToSignature(tensor.data.raw, tensor.bytes, signature);
+      }
+    }
+  }
+}
+
 TfLiteStatus Subgraph::PrepareOpsStartingAt(
     int first_execution_plan_index, const std::vector<int>& execution_plan,
     int* last_execution_plan_index_prepared) {
@@ -1504,39 +1576,144 @@ TfLiteStatus Subgraph::PrepareOpsStartingAt(
     has_dynamic_tensors_ =
         HasDynamicTensorImpl(context_, outputs(), &dynamic_tensor_index_);
   }
+  // Nodes prepared for the same shapes are not prepared again.
+  const bool skip_unchanged_nodes =
+      options_ && options_->GetShapePlanCacheSize() > 0;
+  if (skip_unchanged_nodes &&
+      node_prepare_signatures_.size() < nodes_and_registration_.size()) {
+    node_prepare_signatures_.resize(nodes_and_registration_.size());
+  }
+  // Nodes which may be executed concurrently may be prepared concurrently.
+  const bool prepare_in_parallel =
+      inter_op_thread_pool_ != nullptr && options_ &&
+      options_->GetPrepareInParallel() &&
+      &execution_plan == &execution_plan_ &&
+      !InterOpThreadPool::InParallelFor();
+  node_prepare_time_us_.resize(nodes_and_registration_.size());
+  std::vector<char> prepare_signature;
+  std::vector<int> nodes_to_prepare;
+  std::vector<TfLiteStatus> statuses;
   for (int execution_plan_index = first_execution_plan_index;
        execution_plan_index < execution_plan.size(); execution_plan_index++) {
-    int node_index = execution_plan[execution_plan_index];
-    TfLiteNode& node = nodes_and_registration_[node_index].first;
-    const TfLiteRegistration& registration =
-        nodes_and_registration_[node_index].second;
-    EnsureTensorsVectorCapacity();
-#ifdef TF_LITE_TENSORFLOW_PROFILER
-    tflite::OnTfLiteOpPrepare(GetTFLiteOpName(registration), subgraph_index_,
-                              node_index);
-#endif  // TF_LITE_TENSORFLOW_PROFILER
-    const TfLiteStatus op_prepare_status = OpPrepare(registration, &node);
-    if (op_prepare_status != kTfLiteOk &&
-        op_prepare_status != kTfLiteOutputShapeNotKnown) {
-      ReportOpError(&context_, node, registration, node_index,
-                    "failed to prepare");
-      return op_prepare_status;
+    // The nodes from `execution_plan_index` to `last_execution_plan_index`
+    // are prepared together.
+    int last_execution_plan_index = execution_plan_index;
+    if (prepare_in_parallel) {
+      const std::pair<int, int> range =
+          GetConcurrentExecutionPlanRange(execution_plan_index);
+      if (range.first == execution_plan_index) {
+        last_execution_plan_index = range.second;
+      }
     }
+    EnsureTensorsVectorCapacity(last_execution_plan_index -
+                                execution_plan_index + 1);
+    nodes_to_prepare.clear();
+    for (int i = execution_plan_index; i <= last_execution_plan_index; ++i) {
+      const int node_index = execution_plan[i];
+      if (skip_unchanged_nodes) {
+        GetNodePrepareSignature(nodes_and_registration_[node_index].first,
+                                &prepare_signature);
+        if (!prepare_signature.empty() &&
+            prepare_signature == node_prepare_signatures_[node_index]) {
+          continue;
+        }
+      }
+      nodes_to_prepare.push_back(node_index);
+    }
+    PrepareNodes(nodes_to_prepare, &statuses);
 
-    *last_execution_plan_index_prepared = execution_plan_index;
+    int task = 0;
+    for (; execution_plan_index <= last_execution_plan_index;
+         execution_plan_index++) {
+      const int node_index = execution_plan[execution_plan_index];
+      TfLiteNode& node = nodes_and_registration_[node_index].first;
+      const TfLiteRegistration& registration =
+          nodes_and_registration_[node_index].second;
+      if (task == nodes_to_prepare.size() ||
+          nodes_to_prepare[task] != node_index) {
+        // The node was not prepared again since its shapes did not change.
+        *last_execution_plan_index_prepared = execution_plan_index;
+        continue;
+      }
+      const TfLiteStatus op_prepare_status = statuses[task++];
+      if (op_prepare_status != kTfLiteOk &&
+          op_prepare_status != kTfLiteOutputShapeNotKnown) {
+        ReportOpError(&context_, node, registration, node_index,
+                      "failed to prepare");
+        return op_prepare_status;
+      }
+      if (skip_unchanged_nodes) {
+        if (op_prepare_status == kTfLiteOk) {
+          GetNodePrepareSignature(node, &node_prepare_signatures_[node_index]);
+        } else {
+          node_prepare_signatures_[node_index].clear();
+        }
+      }
 
-    // Discontinue if the node has dynamic outputs. Note that we don't
-    // stop for dynamic temporary tensors since they won't affect the
-    // sizes of other tensors in the graph.
-    if (HasDynamicTensor(context_, node.outputs, &dynamic_tensor_index_) ||
-        op_prepare_status == kTfLiteOutputShapeNotKnown) {
-      has_dynamic_tensors_ = true;
-      return kTfLiteOk;
+      *last_execution_plan_index_prepared = execution_plan_index;
+
+      // Discontinue if the node has dynamic outputs. Note that we don't
+      // stop for dynamic temporary tensors since they won't affect the
+      // sizes of other tensors in the graph. The nodes prepared after it are
+      // prepared again once it is invoked.
+      if (HasDynamicTensor(context_, node.outputs, &dynamic_tensor_index_) ||
+          op_prepare_status == kTfLiteOutputShapeNotKnown) {
+        has_dynamic_tensors_ = true;
+        return kTfLiteOk;
+      }
     }
+    execution_plan_index = last_execution_plan_index;
   }
   return kTfLiteOk;
 }
 
+void Subgraph::PrepareNodes(const std::vector<int>& node_indices,
+                            std::vector<TfLiteStatus>* statuses) {
+  statuses->assign(node_indices.size(), kTfLiteOk);
+  auto prepare = [this, &node_indices, statuses](int task) {
+    const int node_index = node_indices[task];
+    auto& [node, registration] = nodes_and_registration_[node_index];
+#ifdef TF_LITE_TENSORFLOW_PROFILER
+    tflite::OnTfLiteOpPrepare(GetTFLiteOpName(registration), subgraph_index_,
+                              node_index);
+#endif  // TF_LITE_TENSORFLOW_PROFILER
+    const uint64_t start_us = profiling::time::NowMicros();
+    (*statuses)[task] = OpPrepare(registration, &node);
+    node_prepare_time_us_[node_index] =
+        profiling::time::NowMicros() - start_us;
+  };
+  if (node_indices.size() <= 1) {
+    for (int task = 0; task < node_indices.size(); ++task) {
+      prepare(task);
+    }
+    return;
+  }
+  if (parallel_prepare_mutex_ == nullptr) {
+    parallel_prepare_mutex_ = std::make_unique<std::mutex>();
+  }
+  // The kernels read `context_.tensors` and `context_.tensors_size` while
+  // others add tensors: these are only updated once all nodes are prepared,
+  // and `tensors_` has capacity for the added tensors, see
+  // EnsureTensorsVectorCapacity().
+  preparing_in_parallel_ = true;
+  inter_op_thread_pool_->ParallelFor(node_indices.size(), prepare);
+  preparing_in_parallel_ = false;
+  context_.tensors = tensors_.data();
+  context_.tensors_size = tensors_.size();
+}
+
+uint64_t Subgraph::GetNodeInitTimeUs(int node_index) const {
+  return node_index >= 0 && node_index < node_init_time_us_.size()
+             ? node_init_time_us_[node_index]
+             : 0;
+}
+
+uint64_t Subgraph::GetNodePrepareTimeUs(int node_index) const {
+  return node_index >= 0 && node_index < node_prepare_time_us_.size()
+             ? node_prepare_time_us_[node_index]
+             : 0;
+}
+
 TfLiteStatus Subgraph::PrepareOpsAndTensors() {
   // Prepare original execution plan if any applied delegate wants it.
   // If any of the delegates is immutable, this won't be triggered
@@ -1561,6 +1738,11 @@ TfLiteStatus Subgraph::PrepareOpsAndTensors() {
         last_original_exec_plan_index_prepared + 1;
   }
 
+  bool plan_changed = false;
+  if (next_execution_plan_index_to_prepare_ == 0) {
+    ScheduleInterOpGroups(&plan_changed);
+  }
+
   int last_exec_plan_index_prepared = 0;
   TF_LITE_ENSURE_STATUS(
       PrepareOpsStartingAt(next_execution_plan_index_to_prepare_,
@@ -1571,11 +1753,21 @@ TfLiteStatus Subgraph::PrepareOpsAndTensors() {
 #ifdef TFLITE_USE_SIMPLE_MEMORY_PLANNER
     memory_planner_.reset(new SimplePlanner(&context_, CreateGraphInfo()));
 #else
-    memory_planner_ = std::make_unique<ArenaPlanner>(
+    auto arena_planner = std::make_unique<ArenaPlanner>(
         &context_, CreateGraphInfo(), ShouldPreserveAllTensors(),
         kDefaultTensorAlignment, subgraph_index_);
+    if (options_) {
+      arena_planner->SetPlanSearchTimeBudget(
+          options_->GetMemoryPlanSearchTimeBudget());
+      arena_planner->SetPlanCacheSize(options_->GetShapePlanCacheSize());
+    }
+    memory_planner_ = std::move(arena_planner);
 #endif
     memory_planner_->PlanAllocations();
+  } else if (plan_changed) {
+    // The lifetimes of the tensors depend on the execution plan and on which
+    // nodes are executed concurrently.
+    TF_LITE_ENSURE_STATUS(memory_planner_->PlanAllocations());
   }
 
   // Execute arena allocations.
@@ -1632,6 +1824,44 @@ TfLiteStatus Subgraph::Invoke() {
   telemetry::TelemetryReportEvent(&context_, "Invoke", status);
   return status;
 }
+
+TfLiteStatus Subgraph::EnsureNodeInputsAreReadable(
+    const TfLiteNode& node, const TfLiteRegistration& registration) {
+  for (int i = 0; i < node.inputs->size; ++i) {
+    int tensor_index = node.inputs->data[i];
+    if (tensor_index == kTfLiteOptionalTensor) {
+      continue;
+    }
+    TfLiteTensor* tensor = &tensors_[tensor_index];
+    if (tensor->delegate && tensor->delegate != node.delegate &&
+        tensor->data_is_stale) {
+      TF_LITE_ENSURE_STATUS(EnsureTensorDataIsReadable(tensor_index));
+    }
+    if (tensor->data.raw == nullptr && tensor->bytes > 0 &&
+        tensor->allocation_type != kTfLiteNonCpu) {
+      if (registration.builtin_code == kTfLiteBuiltinReshape && i == 1 &&
+          tensor->dims->size != 1) {
+        // In general, having a tensor here with no buffer will be an error.
+        // However, for the reshape operator, the second input tensor is
+        // sometimes only used for the shape, not for the data. Thus, null
+        // buffer is ok in this situation.
+        // The situation where null buffer is not ok for reshape operator is
+        // only when there are 2 inputs given to the node and the one
+        // corresponding to the shape (i == 1) is a vector that contains all
+        // dimensions. See `GetOutputShape()` function in
+        // `tensorflow/lite/kernels/reshape.cc`
+        continue;
+      } else {
+        // In all other cases, we need to return an error as otherwise we will
+        // trigger a null pointer dereference (likely).
+        ReportError("Input tensor %d lacks data", tensor_index);
+        return kTfLiteError;
+      }
+    }
+  }
+  return kTfLiteOk;
+}
+
 TfLiteStatus Subgraph::InvokeImpl() {
   if (!consistent_) {
     ReportError("Invoke called on model that is not consistent.");
@@ -1652,6 +1882,20 @@ TfLiteStatus Subgraph::InvokeImpl() {
       tflite::OnTfLiteSubgraphInvoke(name_.c_str(), subgraph_index_);
 #endif  // TF_LITE_TENSORFLOW_PROFILER
 
+  // Nested invocations, e.g. of the body of a WHILE op executed concurrently
+  // with other nodes, are executed sequentially.
+  if (inter_op_thread_pool_ != nullptr && !inter_op_groups_.empty() &&
+      inter_op_group_of_node_.size() == execution_plan_.size() &&
+      !has_dynamic_tensors_ &&
+      next_execution_plan_index_to_prepare_ == execution_plan_.size() &&
+      !InterOpThreadPool::InParallelFor()) {
+    status = InvokeInterOpParallel();
+#ifdef TF_LITE_TENSORFLOW_PROFILER
+    tflite::OnTfLiteSubgraphInvokeEnd(trace_subgraph);
+#endif  // TF_LITE_TENSORFLOW_PROFILER
+    return status;
+  }
+
   // Invocations are always done in node order.
   // Note that calling Invoke repeatedly will cause the original memory plan to
   // be reused, unless either ResizeInputTensor() or AllocateTensors() has been
@@ -1686,38 +1930,7 @@ TfLiteStatus Subgraph::InvokeImpl() {
     TFLITE_SCOPED_TAGGED_OPERATOR_PROFILE(
         profile_op ? profiler_.get() : nullptr, op_name, node_index);
 
-    for (int i = 0; i < node.inputs->size; ++i) {
-      int tensor_index = node.inputs->data[i];
-      if (tensor_index == kTfLiteOptionalTensor) {
-        continue;
-      }
-      TfLiteTensor* tensor = &tensors_[tensor_index];
-      if (tensor->delegate && tensor->delegate != node.delegate &&
-          tensor->data_is_stale) {
-        TF_LITE_ENSURE_STATUS(EnsureTensorDataIsReadable(tensor_index));
-      }
-      if (tensor->data.raw == nullptr && tensor->bytes > 0 &&
-          tensor->allocation_type != kTfLiteNonCpu) {
-        if (registration.builtin_code == kTfLiteBuiltinReshape && i == 1 &&
-            tensor->dims->size != 1) {
-          // In general, having a tensor here with no buffer will be an error.
-          // However, for the reshape operator, the second input tensor is
-          // sometimes only used for the shape, not for the data. Thus, null
-          // buffer is ok in this situation.
-          // The situation where null buffer is not ok for reshape operator is
-          // only when there are 2 inputs given to the node and the one
-          // corresponding to the shape (i == 1) is a vector that contains all
-          // dimensions. See `GetOutputShape()` function in
-          // `tensorflow/lite/kernels/reshape.cc`
-          continue;
-        } else {
-          // In all other cases, we need to return an error as otherwise we will
-          // trigger a null pointer dereference (likely).
-          ReportError("Input tensor %d lacks data", tensor_index);
-          return kTfLiteError;
-        }
-      }
-    }
+    TF_LITE_ENSURE_STATUS(EnsureNodeInputsAreReadable(node, registration));
     // Allocate dynamic tensors which memory is required to be allocated
     // before executing the node.
     MayAllocateOpOutput(&node);
@@ -1774,6 +1987,179 @@ TfLiteStatus Subgraph::InvokeImpl() {
   return status;
 }
 
+TfLiteStatus Subgraph::InvokeInterOpParallel() {
+  std::vector<TfLiteStatus> statuses;
+  std::vector<uint64_t> elapsed_us;
+  for (const std::pair<int, int>& group : inter_op_groups_) {
+    // Not a structured binding, which lambdas cannot capture before C++20.
+    const int first = group.first;
+    const int last = group.second;
+    for (int i = first; i <= last; ++i) {
+      auto& [node, registration] = nodes_and_registration_[execution_plan_[i]];
+      TF_LITE_ENSURE_STATUS(EnsureNodeInputsAreReadable(node, registration));
+      // Allocate dynamic tensors which memory is required to be allocated
+      // before executing the node.
+      MayAllocateOpOutput(&node);
+    }
+
+    if (check_cancelled_func_ != nullptr &&
+        check_cancelled_func_(cancellation_data_)) {
+      ReportError("Client requested cancel during Invoke()");
+      return kTfLiteError;
+    }
+
+    if (continue_invocation_ && !continue_invocation_->test_and_set()) {
+      // `Cancel` is called and cancellation flag is flipped.
+      ReportError("Client requested cancel during Invoke()");
+      return kTfLiteCancelled;
+    }
+
+    EnsureTensorsVectorCapacity();
+    const int num_nodes = last - first + 1;
+    if (num_nodes == 1) {
+      const int node_index = execution_plan_[first];
+      auto& [node, registration] = nodes_and_registration_[node_index];
+      const char* op_name = nullptr;
+      if (profiler_) op_name = GetTFLiteOpName(registration);
+      bool profile_op =
+          !(node.delegate != nullptr &&
+            (node.delegate->flags & kTfLiteDelegateFlagsPerOperatorProfiling));
+      TFLITE_SCOPED_TAGGED_OPERATOR_PROFILE(
+          profile_op ? profiler_.get() : nullptr, op_name, node_index);
+      if (auto s = OpInvoke(registration, &node); s != kTfLiteOk) {
+        auto err = ReportOpError(&context_, node, registration, node_index,
+                                 "failed to invoke");
+        return s == kTfLiteCancelled ? s : err;
+      }
+      MaybeReleaseDynamicTensors(node, node_index);
+      continue;
+    }
+
+    // The profiler is not thread-safe, so the time spent in each op is
+    // measured on the thread running it and reported once all ops are done.
+    statuses.assign(num_nodes, kTfLiteOk);
+    elapsed_us.assign(num_nodes, 0);
+    inter_op_thread_pool_->ParallelFor(num_nodes, [&](int task) {
+      auto& [node, registration] =
+          nodes_and_registration_[execution_plan_[first + task]];
+      const uint64_t start_us = profiling::time::NowMicros();
+      statuses[task] = OpInvoke(registration, &node);
+      elapsed_us[task] = profiling::time::NowMicros() - start_us;
+    });
+    for (int task = 0; task < num_nodes; ++task) {
+      const int node_index = execution_plan_[first + task];
+      auto& [node, registration] = nodes_and_registration_[node_index];
+      if (profiler_) {
+        profiler_->AddEvent(GetTFLiteOpName(registration),
+                            Profiler::EventType::OPERATOR_INVOKE_EVENT,
+                            elapsed_us[task], node_index, subgraph_index_);
+      }
+      if (statuses[task] != kTfLiteOk) {
+        auto err = ReportOpError(&context_, node, registration, node_index,
+                                 "failed to invoke");
+        return statuses[task] == kTfLiteCancelled ? statuses[task] : err;
+      }
+    }
+    for (int i = first; i <= last; ++i) {
+      const int node_index = execution_plan_[i];
+      MaybeReleaseDynamicTensors(nodes_and_registration_[node_index].first,
+                                 node_index);
+    }
+  }
+  return kTfLiteOk;
+}
+
+void Subgraph::ScheduleInterOpGroups(bool* plan_changed) {
+  *plan_changed = false;
+  if (inter_op_thread_pool_ == nullptr) {
+    *plan_changed = !inter_op_groups_.empty();
+    inter_op_groups_.clear();
+    inter_op_group_of_node_.clear();
+    return;
+  }
+
+  // The nodes each node must run after, in addition to its data dependencies.
+  std::unordered_map<int, std::vector<int>> control_predecessors;
+  if (control_edges_ != nullptr) {
+    for (const auto& [from, to] : *control_edges_) {
+      control_predecessors[to].push_back(from);
+    }
+  }
+
+  // The level of a node is greater than that of the nodes it depends on, so
+  // the nodes of a level do not depend on each other. Nodes which must run
+  // alone get a level of their own, after that of all preceding nodes.
+  const int num_nodes = execution_plan_.size();
+  std::vector<int> tensor_level(tensors_.size(), -1);
+  std::vector<int> node_level(nodes_and_registration_.size(), -1);
+  std::vector<int> levels(num_nodes);
+  int max_level = -1;
+  int min_level = 0;
+  for (int i = 0; i < num_nodes; ++i) {
+    const int node_index = execution_plan_[i];
+    const TfLiteNode& node = nodes_and_registration_[node_index].first;
+    int level = min_level;
+    bool runs_alone = node.might_have_side_effect || node.delegate != nullptr;
+    for (int tensor_index : TfLiteIntArrayView(node.inputs)) {
+      if (tensor_index == kTfLiteOptionalTensor) continue;
+      level = std::max(level, tensor_level[tensor_index] + 1);
+      runs_alone |= tensors_[tensor_index].is_variable;
+    }
+    for (int tensor_index : TfLiteIntArrayView(node.outputs)) {
+      if (tensor_index == kTfLiteOptionalTensor) continue;
+      runs_alone |= tensors_[tensor_index].is_variable;
+    }
+    if (auto it = control_predecessors.find(node_index);
+        it != control_predecessors.end()) {
+      for (int predecessor : it->second) {
+        level = std::max(level, node_level[predecessor] + 1);
+      }
+    }
+    if (runs_alone) {
+      level = std::max(level, max_level + 1);
+      min_level = level + 1;
+    }
+    for (int tensor_index : TfLiteIntArrayView(node.outputs)) {
+      if (tensor_index == kTfLiteOptionalTensor) continue;
+      tensor_level[tensor_index] = level;
+    }
+    node_level[node_index] = level;
+    levels[i] = level;
+    max_level = std::max(max_level, level);
+  }
+
+  std::vector<int> order(num_nodes);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&levels](int a, int b) { return levels[a] < levels[b]; });
+  std::vector<int> execution_plan(num_nodes);
+  std::vector<std::pair<int, int>> groups;
+  std::vector<int> group_of_node(num_nodes);
+  for (int i = 0; i < num_nodes; ++i) {
+    execution_plan[i] = execution_plan_[order[i]];
+    if (i == 0 || levels[order[i]] != levels[order[i - 1]]) {
+      groups.emplace_back(i, i);
+    }
+    groups.back().second = i;
+    group_of_node[i] = groups.size() - 1;
+  }
+
+  *plan_changed =
+      execution_plan != execution_plan_ || groups != inter_op_groups_;
+  execution_plan_ = std::move(execution_plan);
+  inter_op_groups_ = std::move(groups);
+  inter_op_group_of_node_ = std::move(group_of_node);
+}
+
+std::pair<int, int> Subgraph::GetConcurrentExecutionPlanRange(
+    int execution_plan_index) const {
+  if (inter_op_group_of_node_.size() != execution_plan_.size() ||
+      execution_plan_index >= inter_op_group_of_node_.size()) {
+    return {execution_plan_index, execution_plan_index};
+  }
+  return inter_op_groups_[inter_op_group_of_node_[execution_plan_index]];
+}
+
 TfLiteStatus Subgraph::ResizeTensor(TfLiteContext* context,
                                     TfLiteTensor* tensor,
                                     TfLiteIntArray* new_size) {
@@ -1823,6 +2209,11 @@ TfLiteStatus Subgraph::ResizeTensor(TfLiteContext* context,
 }
 
 void Subgraph::ReportErrorImpl(const char* format, va_list args) {
+  if (preparing_in_parallel_) {
+    std::lock_guard<std::mutex> lock(*parallel_prepare_mutex_);
+    error_reporter_->Report(format, args);
+    return;
+  }
   error_reporter_->Report(format, args);
 }
 
@@ -1851,6 +2242,19 @@ void Subgraph::ReportError(const char* format, ...) {
 
 TfLiteStatus Subgraph::AddTensors(int tensors_to_add,
                                   int* first_new_tensor_index) {
+  std::unique_lock<std::mutex> lock;
+  if (preparing_in_parallel_) {
+    lock = std::unique_lock<std::mutex>(*parallel_prepare_mutex_);
+    // The nodes being prepared on other threads hold pointers to tensors,
+    // so `tensors_` must not be reallocated.
+    if (tensors_to_add > 0 &&
+        tensors_.size() + tensors_to_add > tensors_.capacity()) {
+      error_reporter_->Report(
+          "Cannot add %d tensors while preparing nodes in parallel.",
+          tensors_to_add);
+      return kTfLiteError;
+    }
+  }
   const size_t base_index = tensors_.size();
   if (first_new_tensor_index) *first_new_tensor_index = base_index;
   if (tensors_to_add < 0) return kTfLiteError;
@@ -1859,6 +2263,10 @@ TfLiteStatus Subgraph::AddTensors(int tensors_to_add,
     memset(&tensors_[i], 0, sizeof(tensors_[i]));
     tensors_[i].buffer_handle = kTfLiteNullBufferHandle;
   }
+  // The nodes being prepared on other threads read `context_`, so it is
+  // updated by PrepareNodes() once they all are prepared. `context_.tensors`
+  // already points to the new tensors since `tensors_` was not reallocated.
+  if (preparing_in_parallel_) return kTfLiteOk;
   context_.tensors = tensors_.data();
   context_.tensors_size = tensors_.size();
   return kTfLiteOk;
@@ -2022,8 +2430,10 @@ TfLiteStatus Subgraph::ResizeTensorImpl(TfLiteTensor* tensor,
       tensor->allocation_type == kTfLitePersistentRo ||
       tensor->allocation_type == kTfLiteCustom ||
       tensor->allocation_type == kTfLiteNonCpu) {
-    tensor_resized_since_op_invoke_ |=
-        TfLiteIntArrayEqual(tensor->dims, new_size) == 0;
+    // Only set the flag, as nodes executed concurrently may resize tensors.
+    if (!TfLiteIntArrayEqual(tensor->dims, new_size)) {
+      tensor_resized_since_op_invoke_ = true;
+    }
     if (tensor->type != kTfLiteString && tensor->type != kTfLiteResource &&
         tensor->type != kTfLiteVariant) {
       size_t bytes_required;
@@ -2203,6 +2613,8 @@ TfLiteStatus Subgraph::UndoAllDelegates() {
                                        execution_plan_[execution_plan_index]);
   }
   nodes_and_registration_.resize(max_retained_node_index + 1);
+  // The inputs of the nodes may have been changed back.
+  node_prepare_signatures_.clear();
 
   // Reset all the is_delegation_skippable_ flags in subgraphs.
   for (auto& subgraph : *subgraphs_) {
@@ -2407,8 +2819,9 @@ bool Subgraph::IsFullyDelegated() const {
   return true;
 }
 
-void Subgraph::EnsureTensorsVectorCapacity() {
-  const size_t required_capacity = tensors_.size() + kTensorsCapacityHeadroom;
+void Subgraph::EnsureTensorsVectorCapacity(int num_nodes) {
+  const size_t required_capacity =
+      tensors_.size() + num_nodes * kTensorsCapacityHeadroom;
   if (required_capacity > tensors_.capacity()) {
     // Whenever it's required to increase the vector capacity, make it at
     // least twice bigger. The behavior is consistent with the default
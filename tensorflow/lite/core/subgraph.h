@@ -22,6 +22,7 @@ limitations under the License.
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT(build/c++11)
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -46,6 +47,8 @@ limitations under the License.
 
 namespace tflite {
 
+class InterOpThreadPool;
+
 #ifndef DOXYGEN_SKIP
 class SingleOpModel;  // Class for friend declarations.
 
@@ -453,6 +456,36 @@ class Subgraph {
   // WARNING: This is an experimental API and subject to change.
   const InterpreterOptions* GetOptions() const { return options_; }
 
+  // WARNING: This is an experimental API and subject to change.
+  // Executes the nodes that do not depend on each other concurrently on
+  // `pool`, which is owned by the Interpreter and may be nullptr to disable
+  // it. Takes effect on the next `AllocateTensors()`.
+  void SetInterOpThreadPool(InterOpThreadPool* pool) {
+    inter_op_thread_pool_ = pool;
+  }
+
+  // WARNING: This is an experimental API and subject to change.
+  // Returns the range [first, last] of execution plan indices of the nodes
+  // that may be executed concurrently with the node at
+  // `execution_plan_index`.
+  std::pair<int, int> GetConcurrentExecutionPlanRange(
+      int execution_plan_index) const;
+
+  // WARNING: This is an experimental API and subject to change.
+  // Returns how long the last call to the init, resp. prepare, function of
+  // the kernel of node `node_index` took, in microseconds, or 0 if it was
+  // not called.
+  uint64_t GetNodeInitTimeUs(int node_index) const;
+  uint64_t GetNodePrepareTimeUs(int node_index) const;
+
+  // WARNING: This is an experimental API and subject to change.
+  // Returns the number of nodes of the execution plan which are prepared.
+  // Nodes after a node with dynamic outputs are only prepared once that node
+  // is invoked.
+  int GetNumPreparedNodes() const {
+    return next_execution_plan_index_to_prepare_;
+  }
+
   // WARNING: This is an experimental API and subject to change.
   // True if all intermediates tensors should be preserved for debugging.
   bool ShouldPreserveAllTensors() const {
@@ -744,6 +777,23 @@ class Subgraph {
   // Does not report invoke status through profiler.
   TfLiteStatus InvokeImpl();
 
+  // Invokes the groups of independent nodes computed by
+  // `ScheduleInterOpGroups()` one after the other, running the nodes of each
+  // group concurrently on `inter_op_thread_pool_`.
+  // REQUIRES: all the nodes are prepared and there are no dynamic tensors.
+  TfLiteStatus InvokeInterOpParallel();
+
+  // Reorders the execution plan so that the nodes that do not depend on each
+  // other are contiguous, and fills `inter_op_groups_` with them. Nodes that
+  // may have side effects, delegated nodes and nodes using variable tensors
+  // are put in groups of their own. Sets `*plan_changed` if the execution plan
+  // or the groups changed.
+  void ScheduleInterOpGroups(bool* plan_changed);
+
+  // Checks that the inputs of `node` can be read before invoking it.
+  TfLiteStatus EnsureNodeInputsAreReadable(
+      const TfLiteNode& node, const TfLiteRegistration& registration);
+
   // Allow a delegate to look at the graph and modify the graph to handle
   // parts of the graph themselves. After this is called, the graph may
   // contain new nodes that replace 1 more nodes.
@@ -909,10 +959,17 @@ class Subgraph {
   void CleanupNode(int node_index);
 
   // Ensures that `tensors_` has at least `kTensorsCapacityHeadroom` extra
-  // capacity. Calling this function may invalidate existing pointers to
-  // tensors. After calling this function, adding `kTensorsCapacityHeadroom`
-  // more tensors won't invalidate the pointer to existing tensors.
-  void EnsureTensorsVectorCapacity();
+  // capacity for each of `num_nodes` nodes. Calling this function may
+  // invalidate existing pointers to tensors. After calling this function,
+  // adding `kTensorsCapacityHeadroom` more tensors per node won't invalidate
+  // the pointer to existing tensors.
+  void EnsureTensorsVectorCapacity(int num_nodes = 1);
+
+  // Calls the prepare function of the kernels of `node_indices`, which do
+  // not depend on each other, concurrently if there are several of them, and
+  // sets `statuses` to what they return.
+  void PrepareNodes(const std::vector<int>& node_indices,
+                    std::vector<TfLiteStatus>* statuses);
 
   // Ensures the memory required is planned and allocated.
   TfLiteStatus EnsureMemoryAllocations();
@@ -946,6 +1003,13 @@ class Subgraph {
   bool OpMightHaveSideEffect(const TfLiteNode* node,
                              const TfLiteRegistration* registration) const;
 
+  // Sets `signature` to the indices, types, sizes and shapes of the inputs,
+  // outputs and temporaries of `node`, and the data of its persistent
+  // read-only tensors, which is what a kernel reads when preparing. Clears it
+  // if the node must be prepared whether they changed or not.
+  void GetNodePrepareSignature(const TfLiteNode& node,
+                               std::vector<char>* signature) const;
+
   // Returns new GraphInfo object based on the current Subgraph.
   std::unique_ptr<GraphInfo> CreateGraphInfo();
 
@@ -1179,6 +1243,32 @@ class Subgraph {
   // `InterpreterOptions` object which is being used and owned by Interpreter.
   InterpreterOptions* options_;
 
+  // The pool on which independent nodes are executed concurrently, or nullptr.
+  // Owned by the Interpreter.
+  InterOpThreadPool* inter_op_thread_pool_ = nullptr;
+
+  // Whether nodes are being prepared concurrently, in which case the context
+  // functions which change the subgraph are serialized by
+  // `parallel_prepare_mutex_`.
+  bool preparing_in_parallel_ = false;
+  std::unique_ptr<std::mutex> parallel_prepare_mutex_;
+
+  // See GetNodeInitTimeUs() and GetNodePrepareTimeUs().
+  std::vector<uint64_t> node_init_time_us_;
+  std::vector<uint64_t> node_prepare_time_us_;
+
+  // Contiguous ranges [first, last] of execution plan indices of nodes that
+  // do not depend on each other, in execution order, and the index of the
+  // range of each execution plan index. Empty unless `inter_op_thread_pool_`
+  // is set.
+  std::vector<std::pair<int, int>> inter_op_groups_;
+  std::vector<int> inter_op_group_of_node_;
+
+  // The signature of each node when it was last prepared, see
+  // `InterpreterOptions::SetShapePlanCacheSize()`. Empty for the nodes which
+  // are not prepared or must always be.
+  std::vector<std::vector<char>> node_prepare_signatures_;
+
   // Control edges (i.e., dependencies between nodes in addition to their data
   // dependencies); can be nullptr. Will be initialized from metadata associated
   // with the owning interpreter; the pointee is owned by the owning
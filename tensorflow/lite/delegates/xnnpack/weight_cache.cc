@@ -36,6 +36,11 @@ limitations under the License.
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
+
+#ifdef TFLITE_HAVE_CPUINFO
+#include "include/cpuinfo.h"
+#endif
 
 #include "xnnpack.h"  // from @XNNPACK
 #include "flatbuffers/flatbuffer_builder.h"  // from @flatbuffers
@@ -68,6 +73,9 @@ namespace tflite::xnnpack {
 namespace {
 constexpr size_t kMinAlignment = 128;
 
+// Size of the chunks copied when publishing a cache file.
+constexpr size_t kPublishChunkSize = 1 << 20;
+
 // Checks if the given path is a special value to use an in-memory cache.
 bool IsInMemoryCachePath(const char* path) {
   // Use strncmp to check for the prefix.
@@ -127,8 +135,95 @@ bool FileExists(const char* path) {
   return access(path, F_OK) != -1;
 }
 
+// Mixes `value` into the `hash` (FNV-1a on 64 bit words).
+uint64_t HashCombine(uint64_t hash, uint64_t value) {
+  return (hash ^ value) * 0x100000001b3ull;
+}
+
+constexpr uint64_t kHashSeed = 0xcbf29ce484222325ull;
+
+// Checks if a cache for the given path is built in a temporary file rather than
+// in place, see `WeightCacheBuilder::Start`.
+bool IsBuiltInTemporaryFile(const std::string& path) {
+#if defined(_MSC_VER)
+  return IsInMemoryCachePath(path);
+#else
+  return true;
+#endif
+}
+
+// Returns a path next to `path` which is unique to this process.
+std::string ProcessUniquePath(const std::string& path, const char* suffix) {
+#if defined(_MSC_VER)
+  return path + suffix;
+#else
+  return path + "." + std::to_string(getpid()) + suffix;
+#endif
+}
+
 }  // namespace
 
+uint64_t GetCpuFeaturesFingerprint() {
+  uint64_t fingerprint = kHashSeed;
+#ifdef TFLITE_HAVE_CPUINFO
+  if (!cpuinfo_initialize()) {
+    return fingerprint;
+  }
+  const bool features[] = {
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+      cpuinfo_has_x86_sse4_1(),     cpuinfo_has_x86_avx(),
+      cpuinfo_has_x86_fma3(),       cpuinfo_has_x86_f16c(),
+      cpuinfo_has_x86_avx2(),       cpuinfo_has_x86_avx512f(),
+      cpuinfo_has_x86_avx512bw(),   cpuinfo_has_x86_avx512vl(),
+      cpuinfo_has_x86_avx512vnni(), cpuinfo_has_x86_avx512vbmi(),
+      cpuinfo_has_x86_avx512fp16(), cpuinfo_has_x86_avxvnni(),
+#elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+      cpuinfo_has_arm_neon(),       cpuinfo_has_arm_neon_fp16_arith(),
+      cpuinfo_has_arm_neon_dot(),   cpuinfo_has_arm_neon_bf16(),
+      cpuinfo_has_arm_i8mm(),       cpuinfo_has_arm_sve(),
+      cpuinfo_has_arm_sve2(),
+#endif
+      false,
+  };
+  for (const bool feature : features) {
+    fingerprint = HashCombine(fingerprint, feature);
+  }
+#endif
+  return fingerprint;
+}
+
+uint64_t GetModelFingerprint(const void* data, const size_t size) {
+  const uint8_t* const bytes = static_cast<const uint8_t*>(data);
+  uint64_t fingerprint = HashCombine(kHashSeed, size);
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, bytes + i, sizeof(word));
+    fingerprint = HashCombine(fingerprint, word);
+  }
+  for (; i < size; ++i) {
+    fingerprint = HashCombine(fingerprint, bytes[i]);
+  }
+  return fingerprint;
+}
+
+std::string GetWeightCacheFilePath(const std::string& directory,
+                                   const void* model_data,
+                                   const size_t model_size) {
+  uint64_t key = GetModelFingerprint(model_data, model_size);
+  key = HashCombine(key, GetModelFingerprint(
+                             xnn_experimental_get_build_identifier_data(),
+                             xnn_experimental_get_build_identifier_size()));
+  key = HashCombine(key, GetCpuFeaturesFingerprint());
+  char name[64];
+  snprintf(name, sizeof(name), "xnnpack_weights_%016llx.cache",
+           static_cast<unsigned long long>(key));  // NOLINT(runtime/int)
+  if (directory.empty() || directory.back() == '/') {
+    return directory + name;
+  }
+  return directory + "/" + name;
+}
+
 void swap(MMapHandle& a, MMapHandle& b) {
   using std::swap;
   swap(a.size_, b.size_);
@@ -247,12 +342,25 @@ WeightCacheBuilder& WeightCacheBuilder::operator=(WeightCacheBuilder&& other) {
 bool WeightCacheBuilder::Start(const char* path) {
   XNNPACK_RETURN_CHECK(!IsStarted());
   file_path_ = path;
+  XNNPACK_RETURN_CHECK(!file_path_.empty(), "no cache file path provided.");
 
   if (IsInMemoryCachePath(file_path_)) {
     fd_ = CreateInMemoryFileDescriptor("XNNPack in-memory weight cache");
   } else {
+#if defined(_MSC_VER)
+    // Open files cannot be unlinked: the cache is built in place.
     fd_ = FileDescriptor::Open(file_path_.c_str(), O_CREAT | O_TRUNC | O_RDWR,
                                0644);
+#else
+    // Build in a private file so that other processes never see a partial
+    // cache. It is unlinked right away so that it doesn't outlive the build.
+    const std::string build_path = ProcessUniquePath(file_path_, ".build");
+    fd_ = FileDescriptor::Open(build_path.c_str(), O_CREAT | O_TRUNC | O_RDWR,
+                               0644);
+    if (fd_.IsValid()) {
+      unlink(build_path.c_str());
+    }
+#endif
   }
   XNNPACK_RETURN_CHECK(fd_.IsValid(), "could not open file ('%s'): %s.",
                        file_path_.c_str(), strerror(errno));
@@ -370,6 +478,7 @@ bool WeightCacheBuilder::StopBuildStep() {
   memcpy(header.xnnpack_build_identifier,
          xnn_experimental_get_build_identifier_data(),
          xnn_experimental_get_build_identifier_size());
+  header.cpu_features_fingerprint = GetCpuFeaturesFingerprint();
   header.buffer_list_offset = fd_.GetPos();
   header.buffer_list_size = builder.GetSize();
 
@@ -386,6 +495,7 @@ bool WeightCacheBuilder::StopBuildStep() {
                        strerror(errno));
   XNNPACK_RETURN_CHECK(fd_.Write(&header, sizeof(header)),
                        "cannot write cache header to %s.", file_path_.c_str());
+  XNNPACK_RETURN_CHECK(Publish());
 
   TFLITE_LOG_PROD(tflite::TFLITE_LOG_VERBOSE,
                   "XNNPack weight cache: written to '%s'.", file_path_.c_str());
@@ -393,6 +503,49 @@ bool WeightCacheBuilder::StopBuildStep() {
   return true;
 }
 
+bool WeightCacheBuilder::Publish() const {
+#if defined(_MSC_VER)
+  return true;
+#else
+  if (IsInMemoryCachePath(file_path_)) {
+    return true;
+  }
+  // The copy is written next to the destination for the rename to be atomic.
+  const std::string publish_path = ProcessUniquePath(file_path_, ".publish");
+  FileDescriptor publish_fd = FileDescriptor::Open(
+      publish_path.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+  XNNPACK_RETURN_CHECK(publish_fd.IsValid(), "could not open file ('%s'): %s.",
+                       publish_path.c_str(), strerror(errno));
+  ScopeGuard remove_on_error([&publish_path] { unlink(publish_path.c_str()); });
+
+  const off_t size = fd_.SetPosFromEnd(0);
+  XNNPACK_RETURN_CHECK(size != -1 && fd_.SetPos(0) != -1,
+                       "could not move in the file: %s", strerror(errno));
+  std::vector<uint8_t> chunk(kPublishChunkSize);
+  for (off_t copied = 0; copied < size;) {
+    const size_t chunk_size =
+        std::min<size_t>(kPublishChunkSize, size - copied);
+    XNNPACK_RETURN_CHECK(fd_.Read(chunk.data(), chunk_size) &&
+                             publish_fd.Write(chunk.data(), chunk_size),
+                         "could not copy the cache to '%s': %s.",
+                         publish_path.c_str(), strerror(errno));
+    copied += chunk_size;
+  }
+  // Make sure that the data is on disk before the file is visible under its
+  // final name.
+  XNNPACK_RETURN_CHECK(fsync(publish_fd.Value()) == 0,
+                       "could not sync '%s': %s.", publish_path.c_str(),
+                       strerror(errno));
+  publish_fd.Close();
+  XNNPACK_RETURN_CHECK(rename(publish_path.c_str(), file_path_.c_str()) == 0,
+                       "could not rename '%s' to '%s': %s.",
+                       publish_path.c_str(), file_path_.c_str(),
+                       strerror(errno));
+  remove_on_error.Deactivate();
+  return true;
+#endif
+}
+
 MMapWeightCacheProvider::MMapWeightCacheProvider(
     MMapWeightCacheProvider&& other) {
   *this = std::move(other);
@@ -441,9 +594,10 @@ bool MMapWeightCacheProvider::LoadOrStartBuild(const char* path) {
 bool MMapWeightCacheProvider::StartBuild(const char* path) {
   SetFilePath(path);
   building_run_ = builder_.Start(path);
-  if (IsInMemoryCachePath(file_path_)) {
+  if (IsBuiltInTemporaryFile(file_path_)) {
     // Duplicate the file descriptor to avoid loosing the temporary file when
-    // the builder is reset.
+    // the builder is reset. This process keeps mapping the file it built, the
+    // published copies are for the next ones.
     temporary_file_descriptor_ = builder_.GetFileDescriptor().Duplicate();
   }
   return building_run_;
@@ -496,6 +650,11 @@ bool MMapWeightCacheProvider::Load() {
                        "XNNPack weight cache: incompatible XNNPack version. "
                        "Cache needs to be built again.");
 
+  XNNPACK_RETURN_CHECK(
+      header.cpu_features_fingerprint == GetCpuFeaturesFingerprint(),
+      "XNNPack weight cache: built for different CPU features. "
+      "Cache needs to be built again.");
+
   XNNPACK_RETURN_CHECK(header.buffer_list_offset < mmap_handle.size(),
                        "invalid offset for buffer list descriptor.");
 
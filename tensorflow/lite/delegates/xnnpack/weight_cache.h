@@ -55,13 +55,31 @@ inline constexpr char kInMemoryCachePath[] = ":memory";
 // When reading a cache file, the cache should be rejected if `version`
 // doesn't match `kVersion`.
 struct XNNPackCacheHeader {
-  enum : uint64_t { kInvalidHeader = 0, kVersion = 1 };
+  enum : uint64_t { kInvalidHeader = 0, kVersion = 2 };
   uint64_t version;
   uint8_t xnnpack_build_identifier[32];
+  // XNNPack picks its packing layouts from the CPU features, see
+  // `GetCpuFeaturesFingerprint`.
+  uint64_t cpu_features_fingerprint;
   uint64_t buffer_list_offset;
   uint64_t buffer_list_size;
 };
 
+// Returns a fingerprint of the CPU features which XNNPack selects its kernels,
+// and so the layout of the packed weights, from.
+uint64_t GetCpuFeaturesFingerprint();
+
+// Returns a fingerprint of the `size` bytes of the model at `data`.
+uint64_t GetModelFingerprint(const void* data, size_t size);
+
+// Returns the path of the weight cache file of the given model in `directory`.
+//
+// The file name is keyed by the model, XNNPack build and CPU features
+// fingerprints so that processes running the same model on the same host share
+// the same file while a stale or foreign file is never looked up.
+std::string GetWeightCacheFilePath(const std::string& directory,
+                                   const void* model_data, size_t model_size);
+
 struct PackIdentifier {
   enum { kNoId = SIZE_MAX };
   uint64_t pack_algorithm_id = kNoId;
@@ -166,6 +184,11 @@ class MMapHandle {
 
 // Provides storage to write the packed buffers to and saves those to disk.
 //
+// The cache is built in a private unlinked file and published to its path
+// with an atomic rename at the end of each build step. Other processes
+// therefore only ever map complete cache files, and the file they map is never
+// modified afterwards.
+//
 // WARNING: the interface in this file is still under experimentation and WILL
 // CHANGE. Do not rely on it.
 class WeightCacheBuilder {
@@ -215,7 +238,7 @@ class WeightCacheBuilder {
   BufferLocation Append(PackIdentifier pack_id, const void* data,
                         uint64_t size);
 
-  // Writes the flatbuffer to disk.
+  // Writes the flatbuffer to disk and publishes the cache file.
   [[nodiscard /*Writing the weight cache can fail.*/]]
   bool StopBuildStep();
 
@@ -253,6 +276,11 @@ class WeightCacheBuilder {
   uint8_t* data() const { return data_.get(); }
 
  private:
+  // Copies the cache built so far to `file_path_`, atomically replacing any
+  // existing file.
+  [[nodiscard /*Publishing the weight cache can fail.*/]]
+  bool Publish() const;
+
   std::unique_ptr<uint8_t[]> data_ = nullptr;
   cache::schema::BufferListT schema_;
   size_t capacity_ = 0;
@@ -264,7 +292,8 @@ class WeightCacheBuilder {
   // cache. To ensure a smooth reloading, we need to ensure that the file header
   // is correct. This flag lets us know if that has happened.
   bool first_write_done_ = false;
-  // Temporary file descriptor to write the weights to disk immediately.
+  // Temporary file descriptor to write the weights to disk immediately. Unless
+  // the cache is in memory, the file is unlinked and published by `Publish`.
   FileDescriptor fd_;
   std::string file_path_;
 
@@ -444,8 +473,8 @@ class MMapWeightCacheProvider {
   // The offset to the first buffer data in the MMap allocation.
   size_t mmap_buffer_base_offset_;
 
-  // Can hold a file descriptor when building a temporary cache to prevent it
-  // from being deleted.
+  // Holds the file descriptor of the temporary file the cache is built in to
+  // prevent it from being deleted.
   FileDescriptor temporary_file_descriptor_;
 
   // Used to build the cache.
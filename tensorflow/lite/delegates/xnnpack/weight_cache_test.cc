@@ -582,6 +582,62 @@ TEST(WeightCacheBuilderTest, MultipleStepBuild) {
   EXPECT_THAT(GetBufferData(buffer3), ElementsAreArray(payload3));
 }
 
+TEST(WeightCacheBuilderTest, PublishedFilesAreNotModified) {
+  using std::size;
+
+  const std::string payload1 = "This is some data in the file.";
+  const PackIdentifier dummy_id1{1, 2, 3};
+  const std::string payload2 = "Other data in the file.";
+  const PackIdentifier dummy_id2{2, 3, 4};
+
+  TempFileDesc tmp_file{TempFileDesc::kAutoClose};
+
+  WeightCacheBuilder builder;
+  ASSERT_TRUE(builder.Start(tmp_file.GetCPath()));
+  ASSERT_TRUE(builder.StartBuildStep());
+  (void)builder.Append(dummy_id1, payload1.c_str(), size(payload1));
+  ASSERT_TRUE(builder.StopBuildStep());
+
+  MMapHandle first_handle;
+  ASSERT_TRUE(first_handle.Map(tmp_file.GetCPath()));
+  const std::vector<uint8_t> first_data(first_handle.begin(),
+                                        first_handle.end());
+
+  ASSERT_TRUE(builder.StartBuildStep());
+  (void)builder.Append(dummy_id2, payload2.c_str(), size(payload2));
+  ASSERT_TRUE(builder.StopBuildStep());
+
+  // The second step published a new file rather than updating the first one.
+  EXPECT_THAT(first_handle, ElementsAreArray(first_data));
+  MMapHandle second_handle;
+  ASSERT_TRUE(second_handle.Map(tmp_file.GetCPath()));
+  EXPECT_GT(second_handle.size(), first_handle.size());
+  const XNNPackCacheHeader& header =
+      *reinterpret_cast<const XNNPackCacheHeader*>(second_handle.data());
+  EXPECT_EQ(header.version, XNNPackCacheHeader::kVersion);
+  EXPECT_EQ(header.cpu_features_fingerprint, GetCpuFeaturesFingerprint());
+  const cache::schema::BufferList* const packed_weights =
+      cache::schema::GetBufferList(second_handle.data() +
+                                   header.buffer_list_offset);
+  ASSERT_NE(packed_weights, nullptr);
+  ASSERT_NE(packed_weights->buffers(), nullptr);
+  EXPECT_EQ(packed_weights->buffers()->size(), 2);
+}
+
+TEST(WeightCacheFilePathTest, IsKeyedByModel) {
+  const std::string model_1 = GenerateRandomString(1000);
+  const std::string model_2 = model_1 + "x";
+  const std::string path_1 =
+      GetWeightCacheFilePath("/tmp", model_1.data(), model_1.size());
+  EXPECT_EQ(path_1.rfind("/tmp/", 0), 0) << path_1;
+  EXPECT_EQ(path_1, GetWeightCacheFilePath("/tmp/", model_1.data(),
+                                           model_1.size()));
+  EXPECT_NE(path_1, GetWeightCacheFilePath("/tmp", model_2.data(),
+                                           model_2.size()));
+  EXPECT_NE(GetModelFingerprint(model_1.data(), model_1.size()),
+            GetModelFingerprint(model_2.data(), model_2.size()));
+}
+
 struct FakeContext {
   // Adds a new tensor and it's backing buffer to the context.
   //
@@ -861,6 +917,24 @@ TEST_F(LoadMMapWeightCacheProviderTest, LookUpSucceeds) {
               ElementsAreArray(reference_2.buffer));
 }
 
+TEST_F(LoadMMapWeightCacheProviderTest, RejectsOtherCpuFeatures) {
+  {
+    MMapWeightCacheProvider loader;
+    EXPECT_TRUE(loader.Load(tmp_file.GetPath()));
+  }
+  XNNPackCacheHeader header;
+  {
+    const FileDescriptor fd = FileDescriptor::Open(tmp_file.GetCPath(), O_RDWR);
+    ASSERT_TRUE(fd.IsValid());
+    ASSERT_TRUE(fd.Read(&header, sizeof(header)));
+    header.cpu_features_fingerprint ^= 1;
+    ASSERT_NE(fd.SetPos(0), -1);
+    ASSERT_TRUE(fd.Write(&header, sizeof(header)));
+  }
+  MMapWeightCacheProvider loader;
+  EXPECT_FALSE(loader.Load(tmp_file.GetPath()));
+}
+
 TEST(MMapWeightCacheProviderTest, XnnpackCApiJourney) {
   using std::size;
   TempFileDesc temp_fd(TempFileDesc::kAutoClose);
@@ -70,6 +70,14 @@ class GraphInfo {
 
   // Returns the indices of the variable tensors.
   virtual const std::vector<int>& variables() const = 0;
+
+  // Returns the range [first, last] of execution plan indices of the nodes
+  // that may be executed concurrently with the node at execution plan index
+  // `index`. The tensors used by any of these nodes must not share memory.
+  virtual std::pair<size_t, size_t> concurrent_execution_nodes(
+      size_t index) const {
+    return {index, index};
+  }
 };
 
 // Represents a subset of nodes in a TensorFlow Lite graph.
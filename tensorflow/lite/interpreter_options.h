@@ -118,6 +118,88 @@ class InterpreterOptions {
     return experimental_shlo_composite_inlining_;
   }
 
+  // Sets the number of threads, including the one calling `Invoke()`, on which
+  // the nodes of a subgraph that do not depend on each other are executed
+  // concurrently. Nodes that may have side effects, delegated nodes and nodes
+  // using variable tensors are always executed alone. Values less than 2
+  // disable inter-op parallelism, which is the default.
+  //
+  // This is independent of `Interpreter::SetNumThreads()`, which sets the
+  // number of threads used within each op.
+  //
+  // WARNING: This is an experimental API and subject to change.
+  void SetInterOpParallelism(int num_threads) {
+    experimental_inter_op_parallelism_ = num_threads;
+  }
+
+  // Returns the number of threads set with `SetInterOpParallelism()`.
+  //
+  // WARNING: This is an experimental API and subject to change.
+  int GetInterOpParallelism() const {
+    return experimental_inter_op_parallelism_;
+  }
+
+  // If positive, the memory planner tries several heuristics to place the
+  // intermediate tensors in the smallest arena, spending at most that many
+  // microseconds searching each time the tensors are allocated for new input
+  // shapes. The plans are reused for the same shapes. Zero, the default,
+  // places tensors greedily by decreasing size.
+  //
+  // WARNING: This is an experimental API and subject to change.
+  void SetMemoryPlanSearchTimeBudget(int time_budget_us) {
+    experimental_memory_plan_search_time_budget_us_ = time_budget_us;
+  }
+
+  // Returns the time budget set with `SetMemoryPlanSearchTimeBudget()`.
+  //
+  // WARNING: This is an experimental API and subject to change.
+  int GetMemoryPlanSearchTimeBudget() const {
+    return experimental_memory_plan_search_time_budget_us_;
+  }
+
+  // If positive, `AllocateTensors()` following `ResizeInputTensor()` is made
+  // cheaper for inputs whose shapes keep changing between a few values:
+  //  * the memory plans of the last `size` input shapes are kept, and reused
+  //    when the inputs have one of these shapes again;
+  //  * nodes whose inputs and outputs have the same shapes as when they were
+  //    last prepared are not prepared again. Delegated nodes, nodes with side
+  //    effects and nodes with persistent or dynamic tensors are always
+  //    prepared.
+  // Zero, the default, plans memory and prepares all nodes every time.
+  //
+  // WARNING: This is an experimental API and subject to change.
+  void SetShapePlanCacheSize(int size) {
+    experimental_shape_plan_cache_size_ = size;
+  }
+
+  // Returns the size set with `SetShapePlanCacheSize()`.
+  //
+  // WARNING: This is an experimental API and subject to change.
+  int GetShapePlanCacheSize() const {
+    return experimental_shape_plan_cache_size_;
+  }
+
+  // If true and `SetInterOpParallelism()` is greater than 1, the nodes which
+  // do not depend on each other are prepared concurrently on the inter-op
+  // threads by `AllocateTensors()`. Delegated nodes and nodes with side
+  // effects are prepared alone, as when they are invoked.
+  //
+  // This only shortens the preparation of builtin and custom kernels. Weights
+  // packed by a delegate, e.g. by XNNPACK when it is applied, are still packed
+  // one delegated partition at a time.
+  //
+  // WARNING: This is an experimental API and subject to change.
+  void SetPrepareInParallel(bool value) {
+    experimental_prepare_in_parallel_ = value;
+  }
+
+  // Returns the value set with `SetPrepareInParallel()`.
+  //
+  // WARNING: This is an experimental API and subject to change.
+  bool GetPrepareInParallel() const {
+    return experimental_prepare_in_parallel_;
+  }
+
  private:
   bool experimental_preserve_all_tensors_ = false;
   bool experimental_ensure_dynamic_tensors_are_released_ = false;
@@ -125,6 +207,10 @@ class InterpreterOptions {
   bool experimental_disable_delegate_clustering_ = false;
   bool experimental_cache_constant_cast_op_ = false;
   bool experimental_shlo_composite_inlining_ = false;
+  int experimental_inter_op_parallelism_ = 0;
+  int experimental_memory_plan_search_time_budget_us_ = 0;
+  int experimental_shape_plan_cache_size_ = 0;
+  bool experimental_prepare_in_parallel_ = false;
 };
 
 }  // namespace tflite
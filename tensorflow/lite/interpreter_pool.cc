@@ -0,0 +1,151 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/interpreter_pool.h"
+
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <utility>
+
+#include "tensorflow/lite/core/api/error_reporter.h"
+#include "tensorflow/lite/core/api/op_resolver.h"
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+#include "tensorflow/lite/interpreter.h"
+#include "tensorflow/lite/interpreter_builder.h"
+#include "tensorflow/lite/model_builder.h"
+
+namespace tflite {
+
+InterpreterPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(other.pool_), interpreter_(other.interpreter_) {
+  other.pool_ = nullptr;
+  other.interpreter_ = nullptr;
+}
+
+InterpreterPool::Lease& InterpreterPool::Lease::operator=(
+    Lease&& other) noexcept {
+  if (this != &other) {
+    if (interpreter_ != nullptr) pool_->Release(interpreter_);
+    pool_ = other.pool_;
+    interpreter_ = other.interpreter_;
+    other.pool_ = nullptr;
+    other.interpreter_ = nullptr;
+  }
+  return *this;
+}
+
+InterpreterPool::Lease::~Lease() {
+  if (interpreter_ != nullptr) pool_->Release(interpreter_);
+}
+
+std::unique_ptr<InterpreterPool> InterpreterPool::Create(
+    const FlatBufferModel& model, const OpResolver& op_resolver,
+    const InterpreterPoolOptions& options, ErrorReporter* error_reporter) {
+  if (options.num_interpreters < 1) {
+    TF_LITE_REPORT_ERROR(error_reporter,
+                         "An interpreter pool needs at least one interpreter, "
+                         "%d requested.",
+                         options.num_interpreters);
+    return nullptr;
+  }
+  std::unique_ptr<InterpreterPool> pool(new InterpreterPool());
+  if (options.use_xnnpack) {
+    pool->weights_cache_.reset(TfLiteXNNPackDelegateWeightsCacheCreate());
+    if (pool->weights_cache_ == nullptr) {
+      TF_LITE_REPORT_ERROR(error_reporter,
+                           "Failed to create the XNNPACK weights cache.");
+      return nullptr;
+    }
+  }
+
+  for (int i = 0; i < options.num_interpreters; ++i) {
+    InterpreterBuilder builder(model, op_resolver);
+    if (builder.SetNumThreads(options.num_threads) != kTfLiteOk) {
+      TF_LITE_REPORT_ERROR(error_reporter, "Invalid number of threads: %d.",
+                           options.num_threads);
+      return nullptr;
+    }
+    if (options.use_xnnpack) {
+      // The first delegate packs the weights into the cache, and the others
+      // look them up.
+      TfLiteXNNPackDelegateOptions xnnpack_options = options.xnnpack_options;
+      xnnpack_options.num_threads = options.num_threads;
+      xnnpack_options.weights_cache = pool->weights_cache_.get();
+      pool->delegates_.emplace_back(
+          TfLiteXNNPackDelegateCreate(&xnnpack_options),
+          TfLiteXNNPackDelegateDelete);
+      if (pool->delegates_.back() == nullptr) {
+        TF_LITE_REPORT_ERROR(error_reporter,
+                             "Failed to create the XNNPACK delegate.");
+        return nullptr;
+      }
+      builder.AddDelegate(pool->delegates_.back().get());
+    }
+    std::unique_ptr<Interpreter> interpreter;
+    if (builder(&interpreter) != kTfLiteOk || interpreter == nullptr) {
+      TF_LITE_REPORT_ERROR(error_reporter,
+                           "Failed to build interpreter %d of the pool.", i);
+      return nullptr;
+    }
+    if (interpreter->AllocateTensors() != kTfLiteOk) {
+      TF_LITE_REPORT_ERROR(error_reporter,
+                           "Failed to allocate the tensors of interpreter %d "
+                           "of the pool.",
+                           i);
+      return nullptr;
+    }
+    pool->available_.push_back(interpreter.get());
+    pool->interpreters_.push_back(std::move(interpreter));
+  }
+
+  // All the interpreters are built, so the packed weights can be trimmed to
+  // their size and frozen.
+  if (pool->weights_cache_ != nullptr &&
+      !TfLiteXNNPackDelegateWeightsCacheFinalizeHard(
+          pool->weights_cache_.get())) {
+    TF_LITE_REPORT_ERROR(error_reporter,
+                         "Failed to finalize the XNNPACK weights cache.");
+    return nullptr;
+  }
+  return pool;
+}
+
+InterpreterPool::~InterpreterPool() = default;
+
+InterpreterPool::Lease InterpreterPool::Acquire() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  released_.wait(lock, [this] { return !available_.empty(); });
+  Interpreter* interpreter = available_.back();
+  available_.pop_back();
+  return Lease(this, interpreter);
+}
+
+InterpreterPool::Lease InterpreterPool::TryAcquire() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (available_.empty()) return Lease();
+  Interpreter* interpreter = available_.back();
+  available_.pop_back();
+  return Lease(this, interpreter);
+}
+
+void InterpreterPool::Release(Interpreter* interpreter) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    available_.push_back(interpreter);
+  }
+  released_.notify_one();
+}
+
+}  // namespace tflite
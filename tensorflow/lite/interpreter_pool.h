@@ -0,0 +1,146 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_INTERPRETER_POOL_H_
+#define TENSORFLOW_LITE_INTERPRETER_POOL_H_
+
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "tensorflow/lite/core/api/error_reporter.h"
+#include "tensorflow/lite/core/api/op_resolver.h"
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+#include "tensorflow/lite/interpreter.h"
+#include "tensorflow/lite/model_builder.h"
+#include "tensorflow/lite/stderr_reporter.h"
+
+namespace tflite {
+
+/// Options of an `InterpreterPool`.
+///
+/// WARNING: This is an experimental API and subject to change.
+struct InterpreterPoolOptions {
+  /// The number of interpreters, i.e. of inferences which can run
+  /// concurrently.
+  int num_interpreters = 1;
+  /// The number of threads used by each interpreter and its XNNPACK delegate.
+  int num_threads = 1;
+  /// Whether to apply an XNNPACK delegate to each interpreter. The delegates
+  /// share a single copy of the packed weights.
+  bool use_xnnpack = true;
+  /// The options of the XNNPACK delegates. `num_threads` and `weights_cache`
+  /// are overridden.
+  TfLiteXNNPackDelegateOptions xnnpack_options =
+      TfLiteXNNPackDelegateOptionsDefault();
+};
+
+/// A fixed set of interpreters of the same model, to serve it from several
+/// threads. An `Interpreter` is not thread-safe, so each thread acquires one
+/// from the pool for the duration of an inference.
+///
+/// The interpreters share what is read-only once they are built:
+///  * the model, including the data of its constant tensors, which is not
+///    copied, so the model must outlive the pool;
+///  * the weights packed by XNNPACK, which are packed once by the first
+///    interpreter and then reused by the others.
+/// Each interpreter has its own activations arena and kernel state.
+///
+/// Example:
+///
+/// <pre><code>
+/// auto pool = InterpreterPool::Create(*model, resolver, options);
+/// ...
+/// // On any thread:
+/// InterpreterPool::Lease interpreter = pool->Acquire();
+/// interpreter->typed_input_tensor<float>(0)[0] = 1.0f;
+/// interpreter->Invoke();
+/// </code></pre>
+///
+/// WARNING: This is an experimental API and subject to change.
+class InterpreterPool {
+ public:
+  /// Exclusive use of an interpreter of the pool, which is given back to the
+  /// pool when the lease is destroyed. The pool must outlive it.
+  class Lease {
+   public:
+    Lease() = default;
+    Lease(Lease&& other) noexcept;
+    Lease& operator=(Lease&& other) noexcept;
+    ~Lease();
+
+    /// Whether the lease holds an interpreter.
+    explicit operator bool() const { return interpreter_ != nullptr; }
+
+    Interpreter* get() const { return interpreter_; }
+    Interpreter* operator->() const { return interpreter_; }
+    Interpreter& operator*() const { return *interpreter_; }
+
+   private:
+    friend class InterpreterPool;
+    Lease(InterpreterPool* pool, Interpreter* interpreter)
+        : pool_(pool), interpreter_(interpreter) {}
+
+    InterpreterPool* pool_ = nullptr;
+    Interpreter* interpreter_ = nullptr;
+  };
+
+  /// Builds `options.num_interpreters` interpreters of `model` with
+  /// `op_resolver` and allocates their tensors. Returns nullptr and reports
+  /// the error to `error_reporter` if any of them fails.
+  static std::unique_ptr<InterpreterPool> Create(
+      const FlatBufferModel& model, const OpResolver& op_resolver,
+      const InterpreterPoolOptions& options,
+      ErrorReporter* error_reporter = DefaultErrorReporter());
+
+  ~InterpreterPool();
+
+  InterpreterPool(const InterpreterPool&) = delete;
+  InterpreterPool& operator=(const InterpreterPool&) = delete;
+
+  /// Returns an interpreter which is not used by any other thread, waiting
+  /// for one to be released if they are all in use.
+  Lease Acquire();
+
+  /// Returns an interpreter which is not used by any other thread, or an
+  /// empty lease if they are all in use.
+  Lease TryAcquire();
+
+  /// The number of interpreters of the pool.
+  int size() const { return static_cast<int>(interpreters_.size()); }
+
+ private:
+  InterpreterPool() = default;
+
+  void Release(Interpreter* interpreter);
+
+  // Destroyed in reverse order: the interpreters before the delegates they
+  // use, and the delegates before the weights they share.
+  std::unique_ptr<TfLiteXNNPackDelegateWeightsCache,
+                  decltype(&TfLiteXNNPackDelegateWeightsCacheDelete)>
+      weights_cache_{nullptr, TfLiteXNNPackDelegateWeightsCacheDelete};
+  std::vector<Interpreter::TfLiteDelegatePtr> delegates_;
+  std::vector<std::unique_ptr<Interpreter>> interpreters_;
+
+  std::mutex mutex_;
+  // Signaled when an interpreter is released.
+  std::condition_variable released_;
+  // The interpreters which are not leased.
+  std::vector<Interpreter*> available_;
+};
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_INTERPRETER_POOL_H_
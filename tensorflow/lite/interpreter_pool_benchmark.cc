@@ -0,0 +1,90 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+// Measures the throughput of a model served from 1 to 64 threads by an
+// InterpreterPool with one interpreter per thread, e.g.:
+//
+//   interpreter_pool_benchmark --graph=/path/to/model.tflite
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"  // from @com_google_benchmark
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/kernels/register.h"
+#include "tensorflow/lite/interpreter_pool.h"
+#include "tensorflow/lite/model_builder.h"
+#include "tensorflow/lite/tools/command_line_flags.h"
+
+namespace tflite {
+namespace {
+
+std::unique_ptr<FlatBufferModel>& Model() {
+  static auto* model = new std::unique_ptr<FlatBufferModel>();
+  return *model;
+}
+
+// Runs inferences on all the threads, each one on an interpreter of the same
+// pool. The pool is rebuilt with one interpreter per thread by the first
+// thread before the threads start, and is replaced by the next run.
+void BM_InterpreterPool(benchmark::State& state) {
+  static auto* pool = new std::unique_ptr<InterpreterPool>();
+  if (state.thread_index() == 0) {
+    pool->reset();
+    InterpreterPoolOptions options;
+    options.num_interpreters = state.threads();
+    options.use_xnnpack = state.range(0) != 0;
+    *pool = InterpreterPool::Create(
+        *Model(), ops::builtin::BuiltinOpResolverWithoutDefaultDelegates(),
+        options);
+  }
+  for (auto _ : state) {
+    if (*pool == nullptr) {
+      state.SkipWithError("Failed to create the interpreter pool.");
+      break;
+    }
+    InterpreterPool::Lease interpreter = (*pool)->Acquire();
+    if (interpreter->Invoke() != kTfLiteOk) {
+      state.SkipWithError("Failed to invoke the interpreter.");
+      break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_InterpreterPool)
+    ->ArgName("xnnpack")
+    ->Arg(0)
+    ->Arg(1)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace tflite
+
+int main(int argc, char** argv) {
+  std::string graph = "tensorflow/lite/testdata/conv_huge_im2col.bin";
+  const std::vector<tflite::Flag> flags = {
+      tflite::Flag::CreateFlag("graph", &graph, "The model to serve."),
+  };
+  if (!tflite::Flags::Parse(&argc, const_cast<const char**>(argv), flags)) {
+    return 1;
+  }
+  tflite::Model() = tflite::FlatBufferModel::BuildFromFile(graph.c_str());
+  if (tflite::Model() == nullptr) return 1;
+
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,115 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/interpreter_pool.h"
+
+#include <algorithm>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/kernels/register.h"
+#include "tensorflow/lite/model_builder.h"
+
+namespace tflite {
+namespace {
+
+// testdata/add.bin computes (x + x) + x.
+std::unique_ptr<FlatBufferModel> LoadAddModel() {
+  return FlatBufferModel::BuildFromFile("tensorflow/lite/testdata/add.bin");
+}
+
+// Runs the model on an interpreter of `pool` and checks its output.
+void InvokeAndCheck(InterpreterPool* pool, float value) {
+  InterpreterPool::Lease interpreter = pool->Acquire();
+  ASSERT_TRUE(interpreter);
+  TfLiteTensor* input = interpreter->input_tensor(0);
+  const int num_elements = input->bytes / sizeof(float);
+  std::fill_n(input->data.f, num_elements, value);
+  ASSERT_EQ(interpreter->Invoke(), kTfLiteOk);
+  const float* output = interpreter->typed_output_tensor<float>(0);
+  for (int i = 0; i < num_elements; ++i) {
+    ASSERT_EQ(output[i], 3 * value);
+  }
+}
+
+TEST(InterpreterPoolTest, RunsConcurrently) {
+  auto model = LoadAddModel();
+  ASSERT_TRUE(model);
+  for (const bool use_xnnpack : {false, true}) {
+    InterpreterPoolOptions options;
+    options.num_interpreters = 4;
+    options.use_xnnpack = use_xnnpack;
+    auto pool = InterpreterPool::Create(
+        *model, ops::builtin::BuiltinOpResolverWithoutDefaultDelegates(),
+        options);
+    ASSERT_TRUE(pool);
+    EXPECT_EQ(pool->size(), 4);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+      threads.emplace_back([&pool, t] {
+        for (int i = 0; i < 20; ++i) {
+          InvokeAndCheck(pool.get(), t * 100 + i);
+        }
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  }
+}
+
+TEST(InterpreterPoolTest, LeasesAreExclusive) {
+  auto model = LoadAddModel();
+  ASSERT_TRUE(model);
+  InterpreterPoolOptions options;
+  options.num_interpreters = 2;
+  auto pool = InterpreterPool::Create(
+      *model, ops::builtin::BuiltinOpResolverWithoutDefaultDelegates(),
+      options);
+  ASSERT_TRUE(pool);
+
+  InterpreterPool::Lease first = pool->TryAcquire();
+  InterpreterPool::Lease second = pool->TryAcquire();
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(second);
+  EXPECT_NE(first.get(), second.get());
+  EXPECT_FALSE(pool->TryAcquire());
+
+  // Moving a lease keeps the interpreter leased.
+  InterpreterPool::Lease moved = std::move(first);
+  EXPECT_FALSE(first);
+  EXPECT_FALSE(pool->TryAcquire());
+
+  moved = InterpreterPool::Lease();
+  InterpreterPool::Lease third = pool->TryAcquire();
+  ASSERT_TRUE(third);
+  EXPECT_NE(third.get(), second.get());
+}
+
+TEST(InterpreterPoolTest, NeedsAnInterpreter) {
+  auto model = LoadAddModel();
+  ASSERT_TRUE(model);
+  InterpreterPoolOptions options;
+  options.num_interpreters = 0;
+  ops::builtin::BuiltinOpResolverWithoutDefaultDelegates resolver;
+  EXPECT_EQ(InterpreterPool::Create(*model, resolver, options), nullptr);
+}
+
+}  // namespace
+}  // namespace tflite
@@ -20,6 +20,8 @@ limitations under the License.
 #include <stdlib.h>
 #include <string.h>
 
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
 #include <map>
 #include <memory>
 #include <string>
@@ -39,6 +41,7 @@ limitations under the License.
 #include "tensorflow/lite/external_cpu_backend_context.h"
 #include "tensorflow/lite/interpreter_options.h"
 #include "tensorflow/lite/interpreter_test_util.h"
+#include "tensorflow/lite/signature_runner.h"
 #include "tensorflow/lite/kernels/kernel_util.h"
 #include "tensorflow/lite/string_util.h"
 #include "tensorflow/lite/testing/util.h"
@@ -1129,6 +1132,243 @@ TEST(BasicInterpreter, ReleaseDynamicTensors) {
   ASSERT_EQ(interpreter.tensor(3)->bytes, sizeof(float) * 6 * 6);
 }
 
+TEST(BasicInterpreter, InterOpParallelism) {
+  // Assemble a graph with two independent branches, neg(x) + neg(x) and
+  // neg(y), added together.
+  Interpreter interpreter;
+  interpreter.AddTensors(6);
+  interpreter.SetInputs({0, 1});
+  interpreter.SetOutputs({5});
+  TfLiteQuantizationParams quant;
+  for (int i = 0; i < 6; ++i) {
+    interpreter.SetTensorParametersReadWrite(/*tensor_index=*/i,
+                                             /*type=*/kTfLiteFloat32,
+                                             /*name=*/"", /*dims=*/{3},
+                                             /*quantization=*/quant);
+  }
+  TfLiteRegistration* neg_op = tflite::ops::builtin::Register_NEG();
+  TfLiteRegistration* add_op = tflite::ops::builtin::Register_ADD();
+  auto add_params = [] {
+    auto* params =
+        reinterpret_cast<TfLiteAddParams*>(malloc(sizeof(TfLiteAddParams)));
+    params->activation = kTfLiteActNone;
+    return params;
+  };
+  interpreter.AddNodeWithParameters({0}, {2}, nullptr, 0, nullptr, neg_op);
+  interpreter.AddNodeWithParameters({2, 2}, {3}, nullptr, 0, add_params(),
+                                    add_op);
+  interpreter.AddNodeWithParameters({1}, {4}, nullptr, 0, nullptr, neg_op);
+  interpreter.AddNodeWithParameters({3, 4}, {5}, nullptr, 0, add_params(),
+                                    add_op);
+
+  InterpreterOptions options;
+  options.SetInterOpParallelism(2);
+  interpreter.ApplyOptions(&options);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+
+  // Both negations run first, concurrently.
+  EXPECT_THAT(interpreter.execution_plan(), ElementsAre(0, 2, 1, 3));
+  Subgraph& subgraph = interpreter.primary_subgraph();
+  EXPECT_EQ(subgraph.GetConcurrentExecutionPlanRange(0),
+            std::make_pair(0, 1));
+  EXPECT_EQ(subgraph.GetConcurrentExecutionPlanRange(1),
+            std::make_pair(0, 1));
+  EXPECT_EQ(subgraph.GetConcurrentExecutionPlanRange(2),
+            std::make_pair(2, 2));
+  EXPECT_NE(interpreter.tensor(2)->data.raw, interpreter.tensor(4)->data.raw);
+
+  for (int run = 0; run < 3; ++run) {
+    float* x = interpreter.typed_tensor<float>(0);
+    float* y = interpreter.typed_tensor<float>(1);
+    for (int i = 0; i < 3; ++i) {
+      x[i] = i + run;
+      y[i] = 10 * i;
+    }
+    ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+    const float* output = interpreter.typed_tensor<float>(5);
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_EQ(output[i], -2.0f * (i + run) - 10 * i);
+    }
+  }
+}
+
+// The number of calls to the prepare function of the op of
+// GetConcurrentPrepareNegRegistration() running at once, the most of them
+// which ran at once, and how many ran off `prepare_calling_thread`.
+std::atomic<int> num_running_prepares{0};
+std::atomic<int> max_running_prepares{0};
+std::atomic<int> num_prepares_off_calling_thread{0};
+std::thread::id prepare_calling_thread;
+
+// Negation whose prepare waits, for a few seconds at most, for another node to
+// be prepared concurrently, then adds a temporary tensor like conv's im2col.
+TfLiteRegistration GetConcurrentPrepareNegRegistration() {
+  TfLiteRegistration reg = {nullptr, nullptr, nullptr, nullptr};
+  reg.prepare = [](TfLiteContext* context, TfLiteNode* node) {
+    if (std::this_thread::get_id() != prepare_calling_thread) {
+      ++num_prepares_off_calling_thread;
+    }
+    const int running = ++num_running_prepares;
+    int max_running = max_running_prepares.load();
+    while (running > max_running &&
+           !max_running_prepares.compare_exchange_weak(max_running, running)) {
+    }
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (max_running_prepares.load() < 2 &&
+           std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::yield();
+    }
+
+    const TfLiteTensor* input;
+    TF_LITE_ENSURE_OK(context, GetInputSafe(context, node, 0, &input));
+    TfLiteTensor* output;
+    TF_LITE_ENSURE_OK(context, GetOutputSafe(context, node, 0, &output));
+    int temporary;
+    TF_LITE_ENSURE_OK(context, context->AddTensors(context, 1, &temporary));
+    TfLiteIntArrayFree(node->temporaries);
+    node->temporaries = TfLiteIntArrayCreate(1);
+    node->temporaries->data[0] = temporary;
+    TfLiteTensor* tmp = &context->tensors[temporary];
+    tmp->type = kTfLiteFloat32;
+    tmp->allocation_type = kTfLiteArenaRw;
+    TF_LITE_ENSURE_OK(context,
+                      context->ResizeTensor(context, tmp,
+                                            TfLiteIntArrayCopy(input->dims)));
+    --num_running_prepares;
+    return context->ResizeTensor(context, output,
+                                 TfLiteIntArrayCopy(input->dims));
+  };
+  reg.invoke = [](TfLiteContext* context, TfLiteNode* node) {
+    const TfLiteTensor* input;
+    TF_LITE_ENSURE_OK(context, GetInputSafe(context, node, 0, &input));
+    TfLiteTensor* output;
+    TF_LITE_ENSURE_OK(context, GetOutputSafe(context, node, 0, &output));
+    for (int i = 0; i < NumElements(input); ++i) {
+      output->data.f[i] = -input->data.f[i];
+    }
+    return kTfLiteOk;
+  };
+  return reg;
+}
+
+TEST(BasicInterpreter, PrepareInParallel) {
+  // Assemble a graph with two independent negations, x to a and y to b,
+  // added together.
+  Interpreter interpreter;
+  interpreter.AddTensors(5);
+  interpreter.SetInputs({0, 1});
+  interpreter.SetOutputs({4});
+  TfLiteQuantizationParams quant;
+  for (int i = 0; i < 5; ++i) {
+    interpreter.SetTensorParametersReadWrite(/*tensor_index=*/i,
+                                             /*type=*/kTfLiteFloat32,
+                                             /*name=*/"", /*dims=*/{3},
+                                             /*quantization=*/quant);
+  }
+  TfLiteRegistration neg_op = GetConcurrentPrepareNegRegistration();
+  TfLiteRegistration* add_op = tflite::ops::builtin::Register_ADD();
+  auto* add_params =
+      reinterpret_cast<TfLiteAddParams*>(malloc(sizeof(TfLiteAddParams)));
+  add_params->activation = kTfLiteActNone;
+  interpreter.AddNodeWithParameters({0}, {2}, nullptr, 0, nullptr, &neg_op);
+  interpreter.AddNodeWithParameters({1}, {3}, nullptr, 0, nullptr, &neg_op);
+  interpreter.AddNodeWithParameters({2, 3}, {4}, nullptr, 0, add_params,
+                                    add_op);
+
+  InterpreterOptions options;
+  options.SetInterOpParallelism(2);
+  options.SetPrepareInParallel(true);
+  interpreter.ApplyOptions(&options);
+  prepare_calling_thread = std::this_thread::get_id();
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  Subgraph& subgraph = interpreter.primary_subgraph();
+  EXPECT_EQ(subgraph.GetNumPreparedNodes(), 3);
+
+  // The negations were prepared at the same time, one of them on a worker
+  // thread, and the temporaries they added are visible once they are done.
+  EXPECT_EQ(max_running_prepares.load(), 2);
+  EXPECT_GE(num_prepares_off_calling_thread.load(), 1);
+  EXPECT_EQ(interpreter.tensors_size(), 7);
+  EXPECT_EQ(subgraph.context()->tensors_size, 7);
+
+  for (int i = 0; i < 3; ++i) {
+    interpreter.typed_tensor<float>(0)[i] = i;
+    interpreter.typed_tensor<float>(1)[i] = 10 * i;
+  }
+  ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+  const float* output = interpreter.typed_tensor<float>(4);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(output[i], -11.0f * i);
+  }
+}
+
+TEST(BasicInterpreter, ShapePlanCacheSkipsUnchangedNodes) {
+  // Assemble a graph with two independent copies, x to a and y to b.
+  Interpreter interpreter;
+  interpreter.AddTensors(4);
+  interpreter.SetInputs({0, 1});
+  interpreter.SetOutputs({2, 3});
+  TfLiteQuantizationParams quant;
+  for (int i = 0; i < 4; ++i) {
+    interpreter.SetTensorParametersReadWrite(/*tensor_index=*/i,
+                                             /*type=*/kTfLiteFloat32,
+                                             /*name=*/"", /*dims=*/{2},
+                                             /*quantization=*/quant);
+  }
+  // The number of times the copy of each input was prepared.
+  static int num_prepares[2];
+  num_prepares[0] = num_prepares[1] = 0;
+  TfLiteRegistration copy_op = {nullptr, nullptr, nullptr, nullptr};
+  copy_op.prepare = [](TfLiteContext* context, TfLiteNode* node) {
+    const TfLiteTensor& input = context->tensors[node->inputs->data[0]];
+    ++num_prepares[node->inputs->data[0]];
+    return context->ResizeTensor(context,
+                                 &context->tensors[node->outputs->data[0]],
+                                 TfLiteIntArrayCopy(input.dims));
+  };
+  copy_op.invoke = [](TfLiteContext* context, TfLiteNode* node) {
+    const TfLiteTensor& input = context->tensors[node->inputs->data[0]];
+    TfLiteTensor& output = context->tensors[node->outputs->data[0]];
+    memcpy(output.data.raw, input.data.raw, input.bytes);
+    return kTfLiteOk;
+  };
+  interpreter.AddNodeWithParameters({0}, {2}, nullptr, 0, nullptr, &copy_op);
+  interpreter.AddNodeWithParameters({1}, {3}, nullptr, 0, nullptr, &copy_op);
+
+  InterpreterOptions options;
+  options.SetShapePlanCacheSize(2);
+  interpreter.ApplyOptions(&options);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ(num_prepares[0], 1);
+  EXPECT_EQ(num_prepares[1], 1);
+
+  // Only the copy of x is prepared again when x is resized.
+  for (int size : {4, 2, 4}) {
+    ASSERT_EQ(interpreter.ResizeInputTensor(0, {size}), kTfLiteOk);
+    ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+    EXPECT_EQ(interpreter.tensor(2)->bytes, sizeof(float) * size);
+    EXPECT_EQ(interpreter.tensor(3)->bytes, sizeof(float) * 2);
+    for (int i = 0; i < size; ++i) {
+      interpreter.typed_tensor<float>(0)[i] = i;
+    }
+    interpreter.typed_tensor<float>(1)[0] = 5;
+    interpreter.typed_tensor<float>(1)[1] = 6;
+    ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+    for (int i = 0; i < size; ++i) {
+      EXPECT_EQ(interpreter.typed_tensor<float>(2)[i], i);
+    }
+    EXPECT_EQ(interpreter.typed_tensor<float>(3)[1], 6);
+  }
+  EXPECT_EQ(num_prepares[0], 4);
+  EXPECT_EQ(num_prepares[1], 1);
+
+  ASSERT_EQ(interpreter.ResizeInputTensor(1, {3}), kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ(num_prepares[0], 4);
+  EXPECT_EQ(num_prepares[1], 2);
+}
+
 TEST(InterpreterTensorsCapacityTest, TestWithinHeadroom) {
   Interpreter interpreter;
   ASSERT_EQ(interpreter.AddTensors(Interpreter::kTensorsReservedCapacity),
@@ -2365,5 +2605,99 @@ TEST_F(InterpreterTest, SingleSignature_validate_get_tensor) {
       nullptr);
 }
 
+
+// Returns the bytes of `values`.
+std::vector<uint8_t> ToBytes(const std::vector<float>& values) {
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(values.data());
+  return std::vector<uint8_t>(data, data + values.size() * sizeof(float));
+}
+
+// Returns the floats of `bytes`.
+std::vector<float> ToFloats(const std::vector<uint8_t>& bytes) {
+  std::vector<float> values(bytes.size() / sizeof(float));
+  memcpy(values.data(), bytes.data(), values.size() * sizeof(float));
+  return values;
+}
+
+class InvokeBatchTest : public InterpreterTest {
+ protected:
+  // Builds a signature negating an input of `dims`, with the given
+  // `dims_signature` if any.
+  SignatureRunner* BuildNegSignature(const std::vector<int>& dims,
+                                     const std::vector<int>* dims_signature) {
+    interpreter_->AddTensors(2);
+    interpreter_->SetInputs({0});
+    interpreter_->SetOutputs({1});
+    for (int i = 0; i < 2; ++i) {
+      interpreter_->SetTensorParametersReadWrite(
+          i, kTfLiteFloat32, "", dims, TfLiteQuantizationParams(),
+          /*is_variable=*/false, dims_signature);
+    }
+    interpreter_->AddNodeWithParameters({0}, {1}, nullptr, 0, nullptr,
+                                        ops::builtin::Register_NEG());
+    BuildSignature("serve", {{"x", 0}}, {{"y", 1}});
+    SignatureRunner* runner = interpreter_->GetSignatureRunner("serve");
+    if (runner != nullptr && runner->AllocateTensors() != kTfLiteOk) {
+      return nullptr;
+    }
+    return runner;
+  }
+};
+
+TEST_F(InvokeBatchTest, StacksRequestsAlongDynamicBatch) {
+  const std::vector<int> dims_signature = {-1, 2};
+  SignatureRunner* runner = BuildNegSignature({1, 2}, &dims_signature);
+  ASSERT_NE(runner, nullptr);
+
+  std::vector<SignatureRunnerBatchRequest> requests(3);
+  std::vector<SignatureRunnerBatchRequest*> request_ptrs;
+  for (int r = 0; r < 3; ++r) {
+    requests[r].inputs = {ToBytes({1.0f * r, 10.0f * r})};
+    request_ptrs.push_back(&requests[r]);
+  }
+  ASSERT_EQ(runner->InvokeBatch(request_ptrs), kTfLiteOk);
+  // A single invocation with a batch of 3 examples.
+  EXPECT_EQ(runner->input_tensor("x")->dims->data[0], 3);
+  for (int r = 0; r < 3; ++r) {
+    ASSERT_EQ(requests[r].outputs.size(), 1);
+    EXPECT_THAT(ToFloats(requests[r].outputs[0]),
+                ElementsAre(-1.0f * r, -10.0f * r));
+  }
+
+  // A smaller batch shrinks the batch dimension.
+  request_ptrs.pop_back();
+  ASSERT_EQ(runner->InvokeBatch(request_ptrs), kTfLiteOk);
+  EXPECT_EQ(runner->input_tensor("x")->dims->data[0], 2);
+  EXPECT_THAT(ToFloats(requests[1].outputs[0]),
+              ElementsAre(-1.0f, -10.0f));
+}
+
+TEST_F(InvokeBatchTest, InvokesEachRequestWithoutDynamicBatch) {
+  SignatureRunner* runner = BuildNegSignature({2}, nullptr);
+  ASSERT_NE(runner, nullptr);
+
+  std::vector<SignatureRunnerBatchRequest> requests(2);
+  requests[0].inputs = {ToBytes({1.0f, 2.0f})};
+  requests[1].inputs = {ToBytes({3.0f, 4.0f})};
+  ASSERT_EQ(runner->InvokeBatch({&requests[0], &requests[1]}), kTfLiteOk);
+  EXPECT_EQ(runner->input_tensor("x")->dims->data[0], 2);
+  EXPECT_THAT(ToFloats(requests[0].outputs[0]),
+              ElementsAre(-1.0f, -2.0f));
+  EXPECT_THAT(ToFloats(requests[1].outputs[0]),
+              ElementsAre(-3.0f, -4.0f));
+}
+
+TEST_F(InvokeBatchTest, RejectsInputsOfTheWrongSize) {
+  const std::vector<int> dims_signature = {-1, 2};
+  SignatureRunner* runner = BuildNegSignature({1, 2}, &dims_signature);
+  ASSERT_NE(runner, nullptr);
+
+  SignatureRunnerBatchRequest request;
+  request.inputs = {ToBytes({1.0f, 2.0f, 3.0f})};
+  EXPECT_EQ(runner->InvokeBatch({&request}), kTfLiteError);
+  request.inputs.clear();
+  EXPECT_EQ(runner->InvokeBatch({&request}), kTfLiteError);
+}
+
 }  // namespace
 }  // namespace tflite
@@ -23,6 +23,7 @@ limitations under the License.
 #include "tensorflow/lite/kernels/cpu_backend_gemm_custom_gemv.h"
 #include "tensorflow/lite/kernels/cpu_backend_gemm_params.h"
 #include "tensorflow/lite/kernels/cpu_backend_gemm_ruy.h"
+#include "tensorflow/lite/kernels/cpu_backend_gemm_x86_vnni.h"
 
 #ifndef TFLITE_WITH_RUY
 #include "tensorflow/lite/kernels/cpu_backend_gemm_eigen.h"
@@ -52,6 +53,10 @@ namespace cpu_backend_gemm {
 //
 // Use --define=tflite_with_ruy=true or --define=tflite_with_ruy=false to
 // override the default.
+//
+// With --define=tflite_with_x86_vnni=true, int8 Gemms on x86-64 CPUs with
+// AVX-512 VNNI or AVX-VNNI go to the kernels of cpu_backend_gemm_x86_vnni.h
+// instead, except where ruy is required (see below).
 
 #if !defined(TFLITE_WITH_RUY) && defined(TFLITE_X86_PLATFORM)
 /* GEMM dispatch implementation for x86.
@@ -157,6 +162,15 @@ void Gemm(const MatrixParams<LhsScalar>& lhs_params, const LhsScalar* lhs_data,
                                                        params, context);
     return;
   }
+  // Dedicated x86 VNNI kernels, matrix*vector cases included, when compiled
+  // in and supported by the CPU, for Gemms deep enough for them to beat ruy.
+  if (detail::X86VnniGemm<LhsScalar, RhsScalar, AccumScalar, DstScalar,
+                          quantization_flavor>::Run(lhs_params, lhs_data,
+                                                    rhs_params, rhs_data,
+                                                    dst_params, dst_data,
+                                                    params, context)) {
+    return;
+  }
   // If we did not choose to force usage of ruy above, then we may now consider
   // using custom GEMV code for the matrix*vector cases.
   const bool try_custom_gemv = (dst_params.cols == 1);
@@ -0,0 +1,205 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_LITE_KERNELS_CPU_BACKEND_GEMM_X86_VNNI_H_
+#define TENSORFLOW_LITE_KERNELS_CPU_BACKEND_GEMM_X86_VNNI_H_
+
+// Int8 Gemm paths for x86-64 CPUs with the VNNI dot-product instructions,
+// either AVX-512 VNNI or AVX-VNNI. They are only compiled in with
+// --define=tflite_with_x86_vnni=true, which defines TFLITE_WITH_X86_VNNI, and
+// are then selected at runtime on CPUs supporting them, regardless of the
+// `tflite_with_ruy` setting, for all but shallow Gemms. Results are bit-exact
+// with the ruy path.
+
+#include <cstdint>
+
+#include "tensorflow/lite/kernels/cpu_backend_context.h"
+#include "tensorflow/lite/kernels/cpu_backend_gemm_params.h"
+
+#if defined(TFLITE_WITH_X86_VNNI) && (defined(__x86_64__) || defined(_M_X64))
+#define TFLITE_X86_VNNI_GEMM
+#endif
+
+#ifdef TFLITE_X86_VNNI_GEMM
+#include <algorithm>
+#include <vector>
+
+#include "ruy/profiler/instrumentation.h"  // from @ruy
+#include "tensorflow/lite/kernels/cpu_backend_threadpool.h"
+#include "tensorflow/lite/kernels/internal/common.h"
+#include "tensorflow/lite/kernels/internal/optimized/cpu_check.h"
+#include "tensorflow/lite/kernels/internal/optimized/x86_vnni_gemm.h"
+#endif
+
+namespace tflite {
+namespace cpu_backend_gemm {
+namespace detail {
+
+// Either performs the requested Gemm with the VNNI kernels and returns true,
+// or immediately returns false. Only the int8 -> int8 case is supported.
+template <typename LhsScalar, typename RhsScalar, typename AccumScalar,
+          typename DstScalar, QuantizationFlavor quantization_flavor>
+struct X86VnniGemm {
+  static bool Run(
+      const MatrixParams<LhsScalar>& lhs_params, const LhsScalar* lhs_data,
+      const MatrixParams<RhsScalar>& rhs_params, const RhsScalar* rhs_data,
+      const MatrixParams<DstScalar>& dst_params, DstScalar* dst_data,
+      const GemmParams<AccumScalar, DstScalar, quantization_flavor>& params,
+      CpuBackendContext* context) {
+    return false;
+  }
+};
+
+#ifdef TFLITE_X86_VNNI_GEMM
+
+using X86VnniKernel = void (*)(const x86_vnni::Int8GemmParams&, int, int);
+
+// Runs the kernel on the rows [row_start, row_end) of `params`, which may
+// describe a range of columns of the whole Gemm.
+class X86VnniGemmTask : public cpu_backend_threadpool::Task {
+ public:
+  X86VnniGemmTask(X86VnniKernel kernel, const x86_vnni::Int8GemmParams& params,
+                  int row_start, int row_end)
+      : kernel_(kernel),
+        params_(params),
+        row_start_(row_start),
+        row_end_(row_end) {}
+
+  void Run() override { kernel_(params_, row_start_, row_end_); }
+
+ private:
+  X86VnniKernel kernel_;
+  x86_vnni::Int8GemmParams params_;
+  int row_start_;
+  int row_end_;
+};
+
+template <QuantizationFlavor quantization_flavor>
+struct X86VnniGemm<std::int8_t, std::int8_t, std::int32_t, std::int8_t,
+                   quantization_flavor> {
+  // Row and column granularity of the kernels' inner loops, used to split work
+  // between threads.
+  static constexpr int kKernelRows = 4;
+  static constexpr int kKernelCols = 4;
+  // The kernels consume the depth 32 values at a time and handle the rest with
+  // a slower tail, so their throughput collapses below one such block, e.g.
+  // from 23 to 9 GOPS at depth 16 with 64 rows on AVX-512 VNNI. ruy handles
+  // these shapes better.
+  static constexpr int kMinDepth = 32;
+  // Minimum number of multiply-adds worth handing to another thread.
+  static constexpr std::int64_t kMinMulAddsPerThread = 64 * 1024;
+
+  static bool Run(
+      const MatrixParams<std::int8_t>& lhs_params, const std::int8_t* lhs_data,
+      const MatrixParams<std::int8_t>& rhs_params, const std::int8_t* rhs_data,
+      const MatrixParams<std::int8_t>& dst_params, std::int8_t* dst_data,
+      const GemmParams<std::int32_t, std::int8_t, quantization_flavor>& params,
+      CpuBackendContext* context) {
+    if (lhs_params.cols < kMinDepth) {
+      return false;
+    }
+    X86VnniKernel kernel;
+    if (DetectX86Avx512Vnni()) {
+      kernel = x86_vnni::Avx512VnniGemmInt8;
+    } else if (DetectX86AvxVnni()) {
+      kernel = x86_vnni::AvxVnniGemmInt8;
+    } else {
+      return false;
+    }
+    // The kernels move the RHS to the unsigned range that vpdpbusd expects,
+    // which is only compensated for with a symmetric LHS, as TFLite's int8
+    // filters are.
+    if (lhs_params.zero_point != 0) {
+      return false;
+    }
+    ruy::profiler::ScopeLabel label("cpu_backend_gemm::Gemm: X86Vnni");
+
+    x86_vnni::Int8GemmParams vnni_params;
+    vnni_params.lhs_data = lhs_data;
+    vnni_params.rhs_data = rhs_data;
+    vnni_params.dst_data = dst_data;
+    vnni_params.rows = dst_params.rows;
+    vnni_params.depth = lhs_params.cols;
+    vnni_params.cols = dst_params.cols;
+    vnni_params.rhs_zero_point = rhs_params.zero_point;
+    vnni_params.dst_zero_point = dst_params.zero_point;
+    vnni_params.bias = params.bias;
+    if (quantization_flavor ==
+        QuantizationFlavor::kIntegerWithPerRowMultiplier) {
+      vnni_params.multiplier_fixedpoint =
+          params.multiplier_fixedpoint_perchannel;
+      vnni_params.multiplier_exponent = params.multiplier_exponent_perchannel;
+      vnni_params.per_row_multiplier = true;
+    } else {
+      vnni_params.multiplier_fixedpoint = &params.multiplier_fixedpoint;
+      vnni_params.multiplier_exponent = &params.multiplier_exponent;
+    }
+    vnni_params.clamp_min = params.clamp_min;
+    vnni_params.clamp_max = params.clamp_max;
+
+    const int rows = dst_params.rows;
+    const int cols = dst_params.cols;
+    const std::int64_t mul_adds = static_cast<std::int64_t>(rows) *
+                                  static_cast<std::int64_t>(cols) *
+                                  lhs_params.cols;
+    int thread_count = static_cast<int>(std::min<std::int64_t>(
+        context->max_num_threads(), mul_adds / kMinMulAddsPerThread));
+    // Rows are split unless there are too few of them to keep the threads
+    // busy, as in the early convolutions of image models.
+    const int row_blocks = CeilQuotient(rows, kKernelRows);
+    const int col_blocks = CeilQuotient(cols, kKernelCols);
+    const bool split_cols =
+        row_blocks < thread_count && col_blocks > row_blocks;
+    thread_count = std::min(thread_count, split_cols ? col_blocks : row_blocks);
+    if (thread_count <= 1) {
+      kernel(vnni_params, 0, rows);
+      return true;
+    }
+
+    std::vector<X86VnniGemmTask> tasks;
+    tasks.reserve(thread_count);
+    if (split_cols) {
+      const int cols_per_thread =
+          RoundUp<kKernelCols>(CeilQuotient(cols, thread_count));
+      for (int col_start = 0; col_start < cols;
+           col_start += cols_per_thread) {
+        x86_vnni::Int8GemmParams task_params = vnni_params;
+        task_params.rhs_data +=
+            static_cast<std::int64_t>(col_start) * vnni_params.depth;
+        task_params.dst_data += static_cast<std::int64_t>(col_start) * rows;
+        task_params.cols = std::min(cols_per_thread, cols - col_start);
+        tasks.emplace_back(kernel, task_params, 0, rows);
+      }
+    } else {
+      const int rows_per_thread =
+          RoundUp<kKernelRows>(CeilQuotient(rows, thread_count));
+      for (int row_start = 0; row_start < rows;
+           row_start += rows_per_thread) {
+        tasks.emplace_back(kernel, vnni_params, row_start,
+                           std::min(rows, row_start + rows_per_thread));
+      }
+    }
+    cpu_backend_threadpool::Execute(tasks.size(), tasks.data(), context);
+    return true;
+  }
+};
+
+#endif  // TFLITE_X86_VNNI_GEMM
+
+}  // namespace detail
+}  // namespace cpu_backend_gemm
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_KERNELS_CPU_BACKEND_GEMM_X86_VNNI_H_
@@ -0,0 +1,367 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include <stdint.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "benchmark/benchmark.h"  // from @com_google_benchmark
+#include "tensorflow/lite/kernels/cpu_backend_context.h"
+#include "tensorflow/lite/kernels/cpu_backend_gemm.h"
+#include "tensorflow/lite/kernels/cpu_backend_gemm_params.h"
+#include "tensorflow/lite/kernels/cpu_backend_gemm_ruy.h"
+#include "tensorflow/lite/kernels/internal/optimized/cpu_check.h"
+#include "tensorflow/lite/kernels/internal/optimized/x86_vnni_gemm.h"
+
+// The kernels are only built with --define=tflite_with_x86_vnni=true.
+#if defined(TFLITE_WITH_X86_VNNI) && (defined(__x86_64__) || defined(_M_X64))
+
+namespace tflite {
+namespace {
+
+using cpu_backend_gemm::GemmParams;
+using cpu_backend_gemm::MatrixParams;
+using cpu_backend_gemm::Order;
+using cpu_backend_gemm::QuantizationFlavor;
+using x86_vnni::Int8GemmParams;
+
+// kGemm is cpu_backend_gemm::Gemm, which picks a VNNI kernel when it can.
+enum class Kernel { kRuy, kAvx512Vnni, kAvxVnni, kGemm };
+
+bool KernelSupported(Kernel kernel) {
+  switch (kernel) {
+    case Kernel::kRuy:
+      return true;
+    case Kernel::kAvx512Vnni:
+      return DetectX86Avx512Vnni();
+    case Kernel::kAvxVnni:
+      return DetectX86AvxVnni();
+    case Kernel::kGemm:
+      return DetectX86Avx512Vnni() || DetectX86AvxVnni();
+  }
+  return false;
+}
+
+// Owns the data of a random int8 Gemm.
+struct Int8Gemm {
+  Int8Gemm(int rows, int depth, int cols, bool per_row_multiplier,
+           bool with_bias, std::mt19937* random) {
+    std::uniform_int_distribution<int> int8_dist(-128, 127);
+    lhs.resize(rows * depth);
+    rhs.resize(depth * cols);
+    dst.resize(rows * cols);
+    for (auto& v : lhs) v = int8_dist(*random);
+    for (auto& v : rhs) v = int8_dist(*random);
+    params.lhs_data = lhs.data();
+    params.rhs_data = rhs.data();
+    params.dst_data = dst.data();
+    params.rows = rows;
+    params.depth = depth;
+    params.cols = cols;
+    params.rhs_zero_point = int8_dist(*random);
+    params.dst_zero_point = int8_dist(*random);
+    if (with_bias) {
+      std::uniform_int_distribution<int32_t> bias_dist(-50000, 50000);
+      bias.resize(rows);
+      for (auto& v : bias) v = bias_dist(*random);
+      params.bias = bias.data();
+    }
+    // Multipliers in [2^30, 2^31) with exponents scaling the accumulators of
+    // this depth roughly to the int8 range.
+    std::uniform_int_distribution<int32_t> multiplier_dist(1 << 30,
+                                                           (1u << 31) - 1);
+    const int max_exponent = -std::min(20, 10 + depth / 256);
+    std::uniform_int_distribution<int> exponent_dist(max_exponent - 4,
+                                                     max_exponent);
+    multiplier_fixedpoint.resize(per_row_multiplier ? rows : 1);
+    multiplier_exponent.resize(per_row_multiplier ? rows : 1);
+    for (auto& v : multiplier_fixedpoint) v = multiplier_dist(*random);
+    for (auto& v : multiplier_exponent) v = exponent_dist(*random);
+    params.multiplier_fixedpoint = multiplier_fixedpoint.data();
+    params.multiplier_exponent = multiplier_exponent.data();
+    params.per_row_multiplier = per_row_multiplier;
+  }
+
+  std::vector<int8_t> lhs;
+  std::vector<int8_t> rhs;
+  std::vector<int8_t> dst;
+  std::vector<int32_t> bias;
+  std::vector<int32_t> multiplier_fixedpoint;
+  std::vector<int> multiplier_exponent;
+  Int8GemmParams params;
+};
+
+// Runs `params` with ruy or, if `dispatch` is set, with cpu_backend_gemm::Gemm.
+template <QuantizationFlavor quantization_flavor>
+void RunCpuBackendGemm(const Int8GemmParams& params, bool dispatch,
+                       CpuBackendContext* context) {
+  MatrixParams<int8_t> lhs_params;
+  lhs_params.order = Order::kRowMajor;
+  lhs_params.rows = params.rows;
+  lhs_params.cols = params.depth;
+  MatrixParams<int8_t> rhs_params;
+  rhs_params.order = Order::kColMajor;
+  rhs_params.rows = params.depth;
+  rhs_params.cols = params.cols;
+  rhs_params.zero_point = params.rhs_zero_point;
+  MatrixParams<int8_t> dst_params;
+  dst_params.order = Order::kColMajor;
+  dst_params.rows = params.rows;
+  dst_params.cols = params.cols;
+  dst_params.zero_point = params.dst_zero_point;
+  GemmParams<int32_t, int8_t, quantization_flavor> gemm_params;
+  gemm_params.bias = params.bias;
+  if (quantization_flavor ==
+      QuantizationFlavor::kIntegerWithPerRowMultiplier) {
+    gemm_params.multiplier_fixedpoint_perchannel =
+        params.multiplier_fixedpoint;
+    gemm_params.multiplier_exponent_perchannel = params.multiplier_exponent;
+  } else {
+    gemm_params.multiplier_fixedpoint = params.multiplier_fixedpoint[0];
+    gemm_params.multiplier_exponent = params.multiplier_exponent[0];
+  }
+  gemm_params.clamp_min = params.clamp_min;
+  gemm_params.clamp_max = params.clamp_max;
+  if (dispatch) {
+    cpu_backend_gemm::Gemm(lhs_params, params.lhs_data, rhs_params,
+                           params.rhs_data, dst_params, params.dst_data,
+                           gemm_params, context);
+    return;
+  }
+  cpu_backend_gemm::detail::GemmImplUsingRuy<
+      int8_t, int8_t, int32_t, int8_t,
+      quantization_flavor>::Run(lhs_params, params.lhs_data, rhs_params,
+                                params.rhs_data, dst_params, params.dst_data,
+                                gemm_params, context);
+}
+
+void RunKernel(Kernel kernel, const Int8GemmParams& params, int row_start,
+               int row_end, CpuBackendContext* context) {
+  switch (kernel) {
+    case Kernel::kRuy:
+    case Kernel::kGemm: {
+      const bool dispatch = kernel == Kernel::kGemm;
+      if (params.per_row_multiplier) {
+        RunCpuBackendGemm<QuantizationFlavor::kIntegerWithPerRowMultiplier>(
+            params, dispatch, context);
+      } else {
+        RunCpuBackendGemm<QuantizationFlavor::kIntegerWithUniformMultiplier>(
+            params, dispatch, context);
+      }
+      break;
+    }
+    case Kernel::kAvx512Vnni:
+      x86_vnni::Avx512VnniGemmInt8(params, row_start, row_end);
+      break;
+    case Kernel::kAvxVnni:
+      x86_vnni::AvxVnniGemmInt8(params, row_start, row_end);
+      break;
+  }
+}
+
+// Straightforward implementation of the Int8GemmParams contract.
+std::vector<int8_t> ReferenceGemm(const Int8GemmParams& params) {
+  std::vector<int8_t> dst(params.rows * params.cols);
+  for (int col = 0; col < params.cols; ++col) {
+    for (int row = 0; row < params.rows; ++row) {
+      int32_t acc = params.bias != nullptr ? params.bias[row] : 0;
+      for (int d = 0; d < params.depth; ++d) {
+        acc += params.lhs_data[row * params.depth + d] *
+               (params.rhs_data[col * params.depth + d] -
+                params.rhs_zero_point);
+      }
+      const int channel = params.per_row_multiplier ? row : 0;
+      const int total_shift = 31 - params.multiplier_exponent[channel];
+      int64_t result =
+          static_cast<int64_t>(acc) * params.multiplier_fixedpoint[channel];
+      result = (result + (int64_t{1} << (total_shift - 1))) >> total_shift;
+      result = std::min<int64_t>(
+          std::max<int64_t>(result, std::numeric_limits<int32_t>::lowest()),
+          std::numeric_limits<int32_t>::max());
+      result += params.dst_zero_point;
+      result = std::min<int64_t>(std::max<int64_t>(result, params.clamp_min),
+                                 params.clamp_max);
+      dst[col * params.rows + row] = static_cast<int8_t>(result);
+    }
+  }
+  return dst;
+}
+
+class X86VnniGemmTest : public ::testing::TestWithParam<Kernel> {
+ protected:
+  void SetUp() override {
+    if (!KernelSupported(GetParam())) {
+      GTEST_SKIP() << "Kernel not supported on this CPU";
+    }
+  }
+
+  void Check(int rows, int depth, int cols, bool per_row_multiplier,
+             bool with_bias) {
+    Int8Gemm gemm(rows, depth, cols, per_row_multiplier, with_bias,
+                  &random_);
+    const std::vector<int8_t> expected = ReferenceGemm(gemm.params);
+    RunKernel(GetParam(), gemm.params, 0, rows, &context_);
+    EXPECT_EQ(gemm.dst, expected)
+        << rows << "x" << depth << "x" << cols
+        << (per_row_multiplier ? " per-row" : " uniform")
+        << (with_bias ? " with bias" : " without bias");
+  }
+
+  std::mt19937 random_;
+  CpuBackendContext context_;
+};
+
+TEST_P(X86VnniGemmTest, MatchesReferenceOnAllShapeRemainders) {
+  // Covers the row block and panel remainders and the depth tails of both
+  // kernels.
+  for (int rows : {1, 3, 4, 7, 16, 17, 64, 67, 130}) {
+    for (int depth : {1, 5, 31, 32, 33, 64, 65, 100, 300}) {
+      for (int cols : {1, 3, 4, 5, 9}) {
+        Check(rows, depth, cols, /*per_row_multiplier=*/(rows + cols) % 2,
+              /*with_bias=*/depth % 2);
+      }
+    }
+  }
+}
+
+TEST_P(X86VnniGemmTest, MatchesReferenceOnModelShapes) {
+  // Fully-connected.
+  Check(1024, 1024, 1, /*per_row_multiplier=*/true, /*with_bias=*/true);
+  Check(1000, 1280, 8, /*per_row_multiplier=*/false, /*with_bias=*/true);
+  // 1x1 and 3x3 convolutions, through im2col.
+  Check(64, 576, 196, /*per_row_multiplier=*/true, /*with_bias=*/true);
+  Check(32, 27, 300, /*per_row_multiplier=*/true, /*with_bias=*/false);
+}
+
+TEST_P(X86VnniGemmTest, ClampsAndSaturates) {
+  Int8Gemm gemm(37, 70, 6, /*per_row_multiplier=*/true, /*with_bias=*/true,
+                &random_);
+  gemm.params.clamp_min = -20;
+  gemm.params.clamp_max = 90;
+  // Large multipliers saturate the int32 result before the zero point.
+  for (int& exponent : gemm.multiplier_exponent) exponent = 10;
+  const std::vector<int8_t> expected = ReferenceGemm(gemm.params);
+  RunKernel(GetParam(), gemm.params, 0, gemm.params.rows, &context_);
+  EXPECT_EQ(gemm.dst, expected);
+}
+
+TEST_P(X86VnniGemmTest, SplitRowRangesMatchWholeRange) {
+  Int8Gemm gemm(150, 200, 7, /*per_row_multiplier=*/true, /*with_bias=*/true,
+                &random_);
+  const std::vector<int8_t> expected = ReferenceGemm(gemm.params);
+  // Same splits as the threaded path: multiples of 4 rows, last one shorter.
+  for (int row_start = 0; row_start < gemm.params.rows; row_start += 52) {
+    RunKernel(GetParam(), gemm.params, row_start,
+              std::min(gemm.params.rows, row_start + 52), &context_);
+  }
+  EXPECT_EQ(gemm.dst, expected);
+}
+
+TEST_P(X86VnniGemmTest, MatchesRuy) {
+  for (bool per_row_multiplier : {false, true}) {
+    Int8Gemm gemm(67, 129, 13, per_row_multiplier, /*with_bias=*/true,
+                  &random_);
+    RunKernel(Kernel::kRuy, gemm.params, 0, gemm.params.rows, &context_);
+    const std::vector<int8_t> ruy_dst = gemm.dst;
+    std::fill(gemm.dst.begin(), gemm.dst.end(), 0);
+    RunKernel(GetParam(), gemm.params, 0, gemm.params.rows, &context_);
+    EXPECT_EQ(gemm.dst, ruy_dst);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(X86VnniGemmTest, X86VnniGemmTest,
+                         ::testing::Values(Kernel::kAvx512Vnni,
+                                           Kernel::kAvxVnni));
+
+TEST(X86VnniCpuBackendGemmTest, MultiThreadedGemmMatchesRuy) {
+  if (!KernelSupported(Kernel::kGemm)) {
+    GTEST_SKIP() << "No VNNI kernel supported on this CPU";
+  }
+  std::mt19937 random;
+  CpuBackendContext context;
+  for (int num_threads : {1, 2, 4}) {
+    context.SetMaxNumThreads(num_threads);
+    // Split by rows, split by columns as there are few rows, matrix*vector,
+    // and shallow enough to be left to ruy.
+    for (const auto& [rows, depth, cols] :
+         std::vector<std::tuple<int, int, int>>{{256, 576, 196},
+                                                {130, 100, 7},
+                                                {8, 288, 3136},
+                                                {3, 40, 1000},
+                                                {1024, 1024, 1},
+                                                {64, 16, 300}}) {
+      for (bool per_row_multiplier : {false, true}) {
+        Int8Gemm gemm(rows, depth, cols, per_row_multiplier,
+                      /*with_bias=*/true, &random);
+        RunKernel(Kernel::kRuy, gemm.params, 0, rows, &context);
+        const std::vector<int8_t> ruy_dst = gemm.dst;
+        std::fill(gemm.dst.begin(), gemm.dst.end(), 0);
+        RunKernel(Kernel::kGemm, gemm.params, 0, rows, &context);
+        EXPECT_EQ(gemm.dst, ruy_dst)
+            << rows << "x" << depth << "x" << cols << " on " << num_threads
+            << " threads";
+      }
+    }
+  }
+}
+
+// Single-threaded throughput of the kernels against ruy, on int8 shapes of
+// fully-connected layers and of convolutions after im2col. Run with
+// --benchmark_filter=BM_X86VnniGemm.
+void BM_X86VnniGemm(benchmark::State& state) {
+  const Kernel kernel = static_cast<Kernel>(state.range(0));
+  if (!KernelSupported(kernel)) {
+    state.SkipWithError("Kernel not supported on this CPU");
+    return;
+  }
+  const int rows = state.range(1);
+  const int depth = state.range(2);
+  const int cols = state.range(3);
+  std::mt19937 random;
+  Int8Gemm gemm(rows, depth, cols, /*per_row_multiplier=*/true,
+                /*with_bias=*/true, &random);
+  CpuBackendContext context;
+  context.SetMaxNumThreads(1);
+  for (auto _ : state) {
+    RunKernel(kernel, gemm.params, 0, rows, &context);
+    benchmark::DoNotOptimize(gemm.dst.data());
+  }
+  state.SetItemsProcessed(state.iterations() * 2 *
+                          static_cast<int64_t>(rows) * depth * cols);
+}
+
+void X86VnniGemmShapes(benchmark::internal::Benchmark* b) {
+  for (int kernel : {static_cast<int>(Kernel::kRuy),
+                     static_cast<int>(Kernel::kAvx512Vnni),
+                     static_cast<int>(Kernel::kAvxVnni)}) {
+    b->Args({kernel, 1024, 1024, 1});
+    b->Args({kernel, 1024, 1024, 8});
+    b->Args({kernel, 64, 576, 3136});
+    b->Args({kernel, 256, 2304, 196});
+    b->Args({kernel, 32, 27, 12544});
+    b->Args({kernel, 64, 32, 3136});
+  }
+}
+
+BENCHMARK(BM_X86VnniGemm)->Apply(X86VnniGemmShapes);
+
+}  // namespace
+}  // namespace tflite
+
+#endif  // defined(TFLITE_WITH_X86_VNNI) && x86-64
@@ -31,10 +31,12 @@ limitations under the License.
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <cstring>
 
 #include "tensorflow/lite/c/c_api_types.h"
 #include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/kernels/embedding_lookup_util.h"
 #include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
 #include "tensorflow/lite/kernels/kernel_util.h"
 
@@ -43,6 +45,22 @@ namespace ops {
 namespace builtin {
 namespace embedding_lookup {
 
+struct OpData {
+  // Temporary holding a looked up row of an int4 table unpacked to int8.
+  int unpacked_row_index;
+};
+
+void* Init(TfLiteContext* context, const char* buffer, size_t length) {
+  auto* op_data = new OpData();
+  context->AddTensors(context, /*tensors_to_add=*/1,
+                      &op_data->unpacked_row_index);
+  return op_data;
+}
+
+void Free(TfLiteContext* context, void* buffer) {
+  delete reinterpret_cast<OpData*>(buffer);
+}
+
 TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE_EQ(context, NumInputs(node), 2);
   TF_LITE_ENSURE_EQ(context, NumOutputs(node), 1);
@@ -75,15 +93,22 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
                                   value->type == kTfLiteInt8 ||
                                   value->type == kTfLiteInt4);
       TF_LITE_ENSURE(context, output->type == kTfLiteFloat32);
-      // Per-axis quantization must have quantized_dimension == 0 and correct
-      // sizes for scale and zero_point.
-      TF_LITE_ENSURE(context, qparams->quantized_dimension == 0);
-      const int row_size = SizeOfDimension(value, 0);
-      TF_LITE_ENSURE(context, qparams->scale->size == row_size);
-      TF_LITE_ENSURE(context, qparams->zero_point->size == row_size);
+      TF_LITE_ENSURE_OK(context,
+                        CheckPerAxisTableQuantization(context, value));
     }
   }
 
+  if (value->type == kTfLiteInt4) {
+    auto* op_data = reinterpret_cast<OpData*>(node->user_data);
+    TfLiteIntArrayFree(node->temporaries);
+    node->temporaries = TfLiteIntArrayCreate(1);
+    node->temporaries->data[0] = op_data->unpacked_row_index;
+    TfLiteTensor* unpacked_row;
+    TF_LITE_ENSURE_OK(context,
+                      GetTemporarySafe(context, node, 0, &unpacked_row));
+    TF_LITE_ENSURE_OK(context, ResizeUnpackedRow(context, value, unpacked_row));
+  }
+
   TfLiteTensor* output;
   TF_LITE_ENSURE_OK(context, GetOutputSafe(context, node, 0, &output));
   TfLiteIntArray* output_size = TfLiteIntArrayCreate(NumDimensions(value));
@@ -137,11 +162,22 @@ TfLiteStatus EvalHybrid(TfLiteContext* context, TfLiteNode* node,
     col_size *= SizeOfDimension(value, i);
   }
 
+  const int num_lookups = SizeOfDimension(lookup, 0);
   float* output_ptr = GetTensorData<float>(output);
-  const int8_t* value_ptr = GetTensorData<int8_t>(value);
   const int32_t* lookup_data = GetTensorData<int32_t>(lookup);
+  const HybridTableScales scales = GetHybridTableScales(value);
+  int8_t* unpacked_row = nullptr;
+  if (value->type == kTfLiteInt4) {
+    TfLiteTensor* unpacked_row_tensor;
+    TF_LITE_ENSURE_OK(context,
+                      GetTemporarySafe(context, node, 0, &unpacked_row_tensor));
+    unpacked_row = GetTensorData<int8_t>(unpacked_row_tensor);
+  }
 
-  for (int i = 0; i < SizeOfDimension(lookup, 0); i++) {
+  // Rows are dequantized by accumulating into the zeroed output, which lets
+  // EMBEDDING_LOOKUP_SPARSE share the vectorized dequantization.
+  std::fill_n(output_ptr, static_cast<int64_t>(num_lookups) * col_size, 0.0f);
+  for (int i = 0; i < num_lookups; i++) {
     int idx = lookup_data[i];
     if (idx >= row_size || idx < 0) {
       TF_LITE_KERNEL_LOG(context,
@@ -149,37 +185,10 @@ TfLiteStatus EvalHybrid(TfLiteContext* context, TfLiteNode* node,
                          "Got %d, and bounds are [0, %d]",
                          idx, row_size - 1);
       return kTfLiteError;
-    } else {
-      // Dequantize embedding values.
-      // TODO(alanchiao): refactor scalar multiply into separate function
-      // for ease of adding a neon equivalent if ever necessary.
-      double scaling_factor = value->params.scale;
-      if (value->quantization.type == kTfLiteAffineQuantization) {
-        const auto qparams = static_cast<const TfLiteAffineQuantization*>(
-            value->quantization.params);
-        if (qparams->scale->size > 1) {
-          // get this row's scale for per-axis quantization
-          scaling_factor = qparams->scale->data[idx];
-        }
-      }
-
-      if (value->type == kTfLiteInt4) {
-        for (int j = 0; j < col_size; j++) {
-          int i8_idx = j + idx * col_size;
-          int i4_idx = i8_idx / 2;
-          bool even = i8_idx % 2 == 0;
-          int8_t i4_val = value_ptr[i4_idx];
-          int8_t i8_val =
-              even ? static_cast<int8_t>(i4_val << 4) >> 4 : i4_val >> 4;
-          output_ptr[j + i * col_size] = i8_val * scaling_factor;
-        }
-      } else {
-        for (int j = 0; j < col_size; j++) {
-          output_ptr[j + i * col_size] =
-              value_ptr[j + idx * col_size] * scaling_factor;
-        }
-      }
     }
+    DequantizeRowAndAccumulate(value, scales, idx, col_size,
+                               /*multiplier=*/1.0f, unpacked_row,
+                               output_ptr + static_cast<int64_t>(i) * col_size);
   }
 
   return kTfLiteOk;
@@ -213,7 +222,8 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
 }  // namespace embedding_lookup
 
 TfLiteRegistration* Register_EMBEDDING_LOOKUP() {
-  static TfLiteRegistration r = {nullptr, nullptr, embedding_lookup::Prepare,
+  static TfLiteRegistration r = {embedding_lookup::Init, embedding_lookup::Free,
+                                 embedding_lookup::Prepare,
                                  embedding_lookup::Eval};
   return &r;
 }
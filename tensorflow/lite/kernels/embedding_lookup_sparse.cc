@@ -35,7 +35,9 @@ limitations under the License.
 //     Tensor[2]: Dense shape, int32.
 //     Tensor[3]: Weights to use for aggregation, float.
 //     Tensor[4]: Params, a matrix of multi-dimensional items,
-//                dim.size >= 2, float.
+//                dim.size >= 2, float, or int8 or int4 with symmetric
+//                per-tensor, per-row or per-channel quantization, in which
+//                case the rows are dequantized while they are combined.
 //
 // Output:
 //   A (dense) tensor representing the combined embeddings for the sparse ids.
@@ -69,6 +71,7 @@ limitations under the License.
 
 #include "tensorflow/lite/core/c/builtin_op_data.h"
 #include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/kernels/embedding_lookup_util.h"
 #include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
 #include "tensorflow/lite/kernels/internal/tensor_utils.h"
 #include "tensorflow/lite/kernels/kernel_util.h"
@@ -80,6 +83,22 @@ namespace builtin {
 
 namespace {
 
+struct OpData {
+  // Temporary holding a looked up row of an int4 table unpacked to int8.
+  int unpacked_row_index;
+};
+
+void* Init(TfLiteContext* context, const char* buffer, size_t length) {
+  auto* op_data = new OpData();
+  context->AddTensors(context, /*tensors_to_add=*/1,
+                      &op_data->unpacked_row_index);
+  return op_data;
+}
+
+void Free(TfLiteContext* context, void* buffer) {
+  delete reinterpret_cast<OpData*>(buffer);
+}
+
 TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   TF_LITE_ENSURE_EQ(context, NumInputs(node), 5);
   TF_LITE_ENSURE_EQ(context, NumOutputs(node), 1);
@@ -112,6 +131,37 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
   const TfLiteTensor* value;
   TF_LITE_ENSURE_OK(context, GetInputSafe(context, node, 4, &value));
   TF_LITE_ENSURE(context, NumDimensions(value) >= 2);
+  if (value->type == kTfLiteInt8 || value->type == kTfLiteInt4) {
+    // Only symmetric quantization is supported for hybrid tables.
+    TF_LITE_ENSURE_EQ(context, value->quantization.type,
+                      kTfLiteAffineQuantization);
+    const auto* qparams = static_cast<const TfLiteAffineQuantization*>(
+        value->quantization.params);
+    TF_LITE_ENSURE(context, qparams->scale != nullptr);
+    TF_LITE_ENSURE(context, qparams->zero_point != nullptr);
+    for (int i = 0; i < qparams->zero_point->size; i++) {
+      TF_LITE_ENSURE_EQ(context, qparams->zero_point->data[i], 0);
+    }
+    if (qparams->scale->size > 1 || qparams->zero_point->size > 1) {
+      TF_LITE_ENSURE_OK(
+          context,
+          embedding_lookup::CheckPerAxisTableQuantization(context, value));
+    }
+  } else {
+    TF_LITE_ENSURE_TYPES_EQ(context, value->type, kTfLiteFloat32);
+  }
+
+  if (value->type == kTfLiteInt4) {
+    auto* op_data = reinterpret_cast<OpData*>(node->user_data);
+    TfLiteIntArrayFree(node->temporaries);
+    node->temporaries = TfLiteIntArrayCreate(1);
+    node->temporaries->data[0] = op_data->unpacked_row_index;
+    TfLiteTensor* unpacked_row;
+    TF_LITE_ENSURE_OK(context,
+                      GetTemporarySafe(context, node, 0, &unpacked_row));
+    TF_LITE_ENSURE_OK(context, embedding_lookup::ResizeUnpackedRow(
+                                   context, value, unpacked_row));
+  }
 
   // Mark the output as a dynamic tensor.
   TfLiteTensor* output;
@@ -201,10 +251,26 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
 
   float* output_ptr = GetTensorData<float>(output);
   const float* weights_ptr = GetTensorData<float>(weights);
-  const float* value_ptr = GetTensorData<float>(value);
   // Makes sure reallocation was successful.
   TF_LITE_ENSURE(context, output_ptr != nullptr);
 
+  // Hybrid tables are dequantized straight into the weighted sums, without
+  // materializing float rows.
+  const bool is_hybrid =
+      value->type == kTfLiteInt8 || value->type == kTfLiteInt4;
+  const float* value_ptr = is_hybrid ? nullptr : GetTensorData<float>(value);
+  embedding_lookup::HybridTableScales scales;
+  int8_t* unpacked_row = nullptr;
+  if (is_hybrid) {
+    scales = embedding_lookup::GetHybridTableScales(value);
+  }
+  if (value->type == kTfLiteInt4) {
+    TfLiteTensor* unpacked_row_tensor;
+    TF_LITE_ENSURE_OK(context,
+                      GetTemporarySafe(context, node, 0, &unpacked_row_tensor));
+    unpacked_row = GetTensorData<int8_t>(unpacked_row_tensor);
+  }
+
   std::fill_n(output_ptr, output_size, 0.0f);
 
   // Keep track of the current bucket for aggregation/combination.
@@ -249,10 +315,20 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
 
     // Add element to aggregation.
     ++num_elements;
-    const int example_embedding_offset = idx * embedding_size;
     const float w = weights_ptr[i];
     current_squares_weight += w * w;
     current_total_weight += w;
+    if (is_hybrid) {
+      // Skip buckets outside of the output, like the float path does.
+      if (current_output_offset >= 0 &&
+          current_output_offset + embedding_size <= output_size) {
+        embedding_lookup::DequantizeRowAndAccumulate(
+            value, scales, idx, embedding_size, w, unpacked_row,
+            &output_ptr[current_output_offset]);
+      }
+      continue;
+    }
+    const int example_embedding_offset = idx * embedding_size;
     for (int k = 0; k < embedding_size; k++) {
       // only index if indices are valid
       if (current_output_offset + k < 0) continue;
@@ -275,7 +351,7 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
 }  // namespace
 
 TfLiteRegistration* Register_EMBEDDING_LOOKUP_SPARSE() {
-  static TfLiteRegistration r = {nullptr, nullptr, Prepare, Eval};
+  static TfLiteRegistration r = {Init, Free, Prepare, Eval};
   return &r;
 }
 
@@ -39,12 +39,23 @@ class EmbeddingLookupSparseOpModel : public SingleOpModel {
                                std::initializer_list<int> lookup_shape,
                                std::initializer_list<int> indices_shape,
                                std::initializer_list<int> dense_shape_shape,
-                               std::initializer_list<int> value_shape) {
+                               std::initializer_list<int> value_shape,
+                               TensorType value_type = TensorType_FLOAT32,
+                               const std::vector<float>& value_scales = {},
+                               int value_quantized_dimension = 0) {
     lookup_ = AddInput(TensorType_INT32);
     indices_ = AddInput(TensorType_INT32);
     dense_shape_ = AddInput(TensorType_INT32);
     weights_ = AddInput(TensorType_FLOAT32);
-    value_ = AddInput(TensorType_FLOAT32);
+    if (value_type == TensorType_FLOAT32) {
+      value_ = AddInput(TensorType_FLOAT32);
+    } else {
+      // Symmetric per-row or per-channel quantized table.
+      value_ = AddInput({value_type, value_shape, 0, 0, 0, 0, true,
+                         value_scales,
+                         std::vector<int64_t>(value_scales.size(), 0),
+                         value_quantized_dimension});
+    }
     output_ = AddOutput(TensorType_FLOAT32);
     SetBuiltinOp(BuiltinOperator_EMBEDDING_LOOKUP_SPARSE,
                  BuiltinOptions_EmbeddingLookupSparseOptions,
@@ -78,6 +89,11 @@ class EmbeddingLookupSparseOpModel : public SingleOpModel {
     }
   }
 
+  // Quantizes `data` with the scales of the hybrid table.
+  void SetQuantizedValues(const std::vector<float>& data) {
+    PerChannelSymmetricQuantizeAndPopulate(value_, data);
+  }
+
   std::vector<float> GetOutput() { return ExtractVector<float>(output_); }
 
  private:
@@ -157,5 +173,57 @@ TEST(EmbeddingLookupSparseOpTest, Indices3DTest) {
               })));
 }
 
+TEST(EmbeddingLookupSparseOpTest, HybridInt8PerRowTestMean) {
+  EmbeddingLookupSparseOpModel m(CombinerType_MEAN, {3}, {3, 2}, {2},
+                                 {4, 3, 2}, TensorType_INT8,
+                                 {0.21 / 127, 1.21 / 127, 2.21 / 127,
+                                  3.21 / 127});
+  m.SetInput({1, 3, 0}, {0, 0, 2, 0, 2, 1}, {3, 2}, {1.0, 2.0, 4.0});
+  std::vector<float> values;
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 3; j++) {
+      for (int k = 0; k < 2; k++) {
+        values.push_back(i + j / 10.0f + k / 100.0f);
+      }
+    }
+  }
+  m.SetQuantizedValues(values);
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+  EXPECT_THAT(m.GetOutput(),
+              ElementsAreArray(ArrayFloatNear(
+                  {
+                      1.00, 1.01, 1.10, 1.11, 1.20, 1.21,  // Row 1
+                      0.00, 0.00, 0.00, 0.00, 0.00, 0.00,  // -
+                      1.00, 1.01, 1.10, 1.11, 1.20, 1.21,  // 2 * Row 3 + 4 *
+                                                           // Row 0
+                  },
+                  /*max_abs_err=*/0.02)));
+}
+
+TEST(EmbeddingLookupSparseOpTest, HybridInt4PerChannelTest) {
+  EmbeddingLookupSparseOpModel m(CombinerType_SUM, {3}, {3, 2}, {2},
+                                 {4, 3, 2}, TensorType_INT4, {0.5, 0.25},
+                                 /*value_quantized_dimension=*/2);
+  m.SetInput({1, 3, 0}, {0, 0, 2, 0, 2, 1}, {3, 2}, {1.0, 2.0, 4.0});
+  // Values which are exactly representable with the scale of their channel.
+  std::vector<float> values;
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 3; j++) {
+      values.push_back((i + j - 2) * 0.5f);
+      values.push_back((i + j - 2) * 0.25f);
+    }
+  }
+  m.SetQuantizedValues(values);
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+  EXPECT_THAT(m.GetOutput(),
+              ElementsAreArray(ArrayFloatNear({
+                  -0.5, -0.25, 0.0, 0.0, 0.5, 0.25,  // Row 1
+                  0.0, 0.0, 0.0, 0.0, 0.0, 0.0,      // -
+                  -3.0, -1.5, 0.0, 0.0, 3.0, 1.5,    // 2 * Row 3 + 4 * Row 0
+              })));
+}
+
 }  // namespace
 }  // namespace tflite
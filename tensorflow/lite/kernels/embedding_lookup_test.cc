@@ -42,7 +42,8 @@ class BaseEmbeddingLookupOpModel : public SingleOpModel {
       std::initializer_list<int> weight_shape,
       TensorType weight_type = TensorType_FLOAT32,
       TensorType output_type = TensorType_FLOAT32,
-      const std::vector<float>& per_channel_quantization_scales = {}) {
+      const std::vector<float>& per_channel_quantization_scales = {},
+      int quantized_dimension = 0) {
     input_ = AddInput(TensorType_INT32);
     if (per_channel_quantization_scales.empty()) {
       weight_ = AddInput(weight_type);
@@ -51,7 +52,8 @@ class BaseEmbeddingLookupOpModel : public SingleOpModel {
           per_channel_quantization_scales.size(), 0);
       weight_ = AddInput({weight_type, weight_shape, 0, 0, 0, 0, true,
                           per_channel_quantization_scales,
-                          per_channel_quantization_offsets, 0});
+                          per_channel_quantization_offsets,
+                          quantized_dimension});
     }
     output_ = AddOutput(output_type);
     SetBuiltinOp(BuiltinOperator_EMBEDDING_LOOKUP, BuiltinOptions_NONE, 0);
@@ -129,12 +131,13 @@ class PerAxisHybridEmbeddingLookupOpModel : public BaseEmbeddingLookupOpModel {
       std::initializer_list<int> index_shape,
       std::initializer_list<int> weight_shape,
       const std::vector<float>& per_channel_quantization_scales,
-      TensorType type)
+      TensorType type, int quantized_dimension = 0)
       : BaseEmbeddingLookupOpModel(index_shape, weight_shape, type,
                                    TensorType_FLOAT32,
-                                   per_channel_quantization_scales) {}
+                                   per_channel_quantization_scales,
+                                   quantized_dimension) {}
 
-  void SetSignedWeight(std::initializer_list<float> data) {
+  void SetSignedWeight(const std::vector<float>& data) {
     PerChannelSymmetricQuantizeAndPopulate(weight_, data);
   }
 };
@@ -456,5 +459,56 @@ TEST(PerAxisHybridEmbeddingLookupHybridOpTest, PerAxisSimple4DTestInt4) {
           kTestTolerance)));
 }
 
+TEST(PerAxisHybridEmbeddingLookupHybridOpTest, PerChannel3DTestInt8) {
+  const std::vector<float> scales = {0.01, 0.02, 0.03, 0.04};
+  PerAxisHybridEmbeddingLookupOpModel m({3}, {3, 2, 4}, scales,
+                                        TensorType_INT8,
+                                        /*quantized_dimension=*/2);
+  m.SetInput({1, 0, 2});
+  // Values which are exactly representable with the scale of their channel.
+  auto value = [&scales](int row, int j) {
+    return (row * 8 + j - 10) * scales[j % 4];
+  };
+  std::vector<float> weight;
+  for (int row = 0; row < 3; ++row) {
+    for (int j = 0; j < 8; ++j) {
+      weight.push_back(value(row, j));
+    }
+  }
+  m.SetSignedWeight(weight);
+
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+  std::vector<float> expected;
+  for (int row : {1, 0, 2}) {
+    for (int j = 0; j < 8; ++j) {
+      expected.push_back(value(row, j));
+    }
+  }
+  EXPECT_THAT(m.GetOutput<float>(),
+              ElementsAreArray(ArrayFloatNear(expected)));
+}
+
+TEST(PerAxisHybridEmbeddingLookupHybridOpTest, PerChannelOddRowsTestInt4) {
+  // Rows of 3 values, so that every other row starts in the middle of a byte.
+  PerAxisHybridEmbeddingLookupOpModel m({3}, {3, 3}, {0.5, 0.25, 0.1},
+                                        TensorType_INT4,
+                                        /*quantized_dimension=*/1);
+  m.SetInput({2, 0, 1});
+  m.SetSignedWeight({
+      -2.0, -0.75, -0.2,  // Row 0
+      -0.5, 0.0,   0.1,   // Row 1
+      1.0,  0.75,  0.4,   // Row 2
+  });
+
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+
+  EXPECT_THAT(m.GetOutput<float>(), ElementsAreArray(ArrayFloatNear({
+                                        1.0, 0.75, 0.4,    // Row 2
+                                        -2.0, -0.75, -0.2,  // Row 0
+                                        -0.5, 0.0, 0.1,    // Row 1
+                                    })));
+}
+
 }  // namespace
 }  // namespace tflite
@@ -0,0 +1,137 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_KERNELS_EMBEDDING_LOOKUP_UTIL_H_
+#define TENSORFLOW_LITE_KERNELS_EMBEDDING_LOOKUP_UTIL_H_
+
+#include <stdint.h>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/kernels/internal/portable_tensor_utils.h"
+#include "tensorflow/lite/kernels/internal/tensor_ctypes.h"
+#include "tensorflow/lite/kernels/kernel_util.h"
+
+// Helpers shared by the hybrid paths of EMBEDDING_LOOKUP and
+// EMBEDDING_LOOKUP_SPARSE, which look up rows of an int8 or int4 table with
+// symmetric quantization and dequantize them straight into float outputs.
+
+namespace tflite {
+namespace ops {
+namespace builtin {
+namespace embedding_lookup {
+
+// Scales of a hybrid table: a single scale, one scale per row, or one scale
+// per channel of the embeddings (the last dimension of the table), repeating
+// along the other dimensions of a row.
+struct HybridTableScales {
+  float scale = 1.0f;
+  const float* row_scales = nullptr;
+  const float* channel_scales = nullptr;
+  int num_channels = 0;
+};
+
+// Per-axis quantization of a table must be along the rows
+// (quantized_dimension == 0) or the channels of the embeddings (the last
+// dimension), with matching sizes for scale and zero_point.
+inline TfLiteStatus CheckPerAxisTableQuantization(TfLiteContext* context,
+                                                  const TfLiteTensor* value) {
+  const auto* qparams = static_cast<const TfLiteAffineQuantization*>(
+      value->quantization.params);
+  const int quantized_dimension = qparams->quantized_dimension;
+  TF_LITE_ENSURE(context, quantized_dimension == 0 ||
+                              quantized_dimension == NumDimensions(value) - 1);
+  const int num_scales = SizeOfDimension(value, quantized_dimension);
+  TF_LITE_ENSURE_EQ(context, qparams->scale->size, num_scales);
+  TF_LITE_ENSURE_EQ(context, qparams->zero_point->size, num_scales);
+  return kTfLiteOk;
+}
+
+inline HybridTableScales GetHybridTableScales(const TfLiteTensor* value) {
+  HybridTableScales scales;
+  scales.scale = value->params.scale;
+  if (value->quantization.type == kTfLiteAffineQuantization) {
+    const auto* qparams = static_cast<const TfLiteAffineQuantization*>(
+        value->quantization.params);
+    if (qparams->scale->size > 1) {
+      if (qparams->quantized_dimension == 0) {
+        scales.row_scales = qparams->scale->data;
+      } else {
+        scales.channel_scales = qparams->scale->data;
+        scales.num_channels = qparams->scale->size;
+      }
+    }
+  }
+  return scales;
+}
+
+// Requests the temporary `unpacked_row`, one row of an int4 `value` table
+// unpacked to int8.
+inline TfLiteStatus ResizeUnpackedRow(TfLiteContext* context,
+                                      const TfLiteTensor* value,
+                                      TfLiteTensor* unpacked_row) {
+  int row_size = 1;
+  for (int i = 1; i < NumDimensions(value); i++) {
+    row_size *= SizeOfDimension(value, i);
+  }
+  unpacked_row->type = kTfLiteInt8;
+  unpacked_row->allocation_type = kTfLiteArenaRw;
+  TfLiteIntArray* unpacked_row_size = TfLiteIntArrayCreate(1);
+  unpacked_row_size->data[0] = row_size;
+  return context->ResizeTensor(context, unpacked_row, unpacked_row_size);
+}
+
+// Adds row `idx` of the hybrid `value` table, holding `row_size` values,
+// dequantized and multiplied by `multiplier` to `output`. Int4 rows are first
+// unpacked into `unpacked_row`, which may be null for int8 tables.
+inline void DequantizeRowAndAccumulate(const TfLiteTensor* value,
+                                       const HybridTableScales& scales,
+                                       int idx, int row_size, float multiplier,
+                                       int8_t* unpacked_row, float* output) {
+  const int8_t* value_ptr = GetTensorData<int8_t>(value);
+  const int64_t row_offset = static_cast<int64_t>(idx) * row_size;
+  const int8_t* row;
+  if (value->type == kTfLiteInt4) {
+    // Rows of odd size start in the high nibble of every other byte.
+    const int8_t* packed_row = value_ptr + row_offset / 2;
+    int j = 0;
+    if (row_offset % 2 != 0 && row_size > 0) {
+      unpacked_row[j++] = *packed_row++ >> 4;
+    }
+    tensor_utils::UnpackDenseInt4IntoInt8(packed_row, row_size - j,
+                                          unpacked_row + j);
+    row = unpacked_row;
+  } else {
+    row = value_ptr + row_offset;
+  }
+
+  if (scales.channel_scales != nullptr) {
+    for (int j = 0; j < row_size; j += scales.num_channels) {
+      tensor_utils::VectorPerChannelScaleMultiplyAccumulate(
+          row + j, scales.channel_scales, scales.num_channels, multiplier,
+          output + j);
+    }
+  } else {
+    const float scale =
+        scales.row_scales != nullptr ? scales.row_scales[idx] : scales.scale;
+    tensor_utils::VectorScalarMultiplyAccumulate(row, row_size,
+                                                 scale * multiplier, output);
+  }
+}
+
+}  // namespace embedding_lookup
+}  // namespace builtin
+}  // namespace ops
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_KERNELS_EMBEDDING_LOOKUP_UTIL_H_
@@ -0,0 +1,225 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include "tensorflow/lite/kernels/internal/optimized/x86_vnni_gemm.h"
+
+namespace tflite {
+namespace x86_vnni {
+namespace {
+
+// The LHS is processed by panels of rows small enough to stay in cache while
+// all the RHS columns stream through them.
+constexpr int kPanelRows = 64;
+
+// vpdpbusd multiplies unsigned by signed bytes. The RHS is moved to the
+// unsigned range by flipping its sign bits, i.e. adding 128, which is then
+// subtracted along with the RHS zero point using the LHS row sums.
+constexpr int32_t kRhsShift = 128;
+
+inline __mmask64 DepthMask(int remaining_depth) {
+  const __mmask64 all_ones = ~static_cast<__mmask64>(0);
+  return remaining_depth >= 64 ? all_ones
+                               : ~(all_ones << remaining_depth);
+}
+
+// Adds up the int32 lanes of each of a, b, c and d.
+inline __m128i ReduceAdd4(__m512i a, __m512i b, __m512i c, __m512i d) {
+  const __m256i a256 = _mm256_add_epi32(_mm512_castsi512_si256(a),
+                                        _mm512_extracti64x4_epi64(a, 1));
+  const __m256i b256 = _mm256_add_epi32(_mm512_castsi512_si256(b),
+                                        _mm512_extracti64x4_epi64(b, 1));
+  const __m256i c256 = _mm256_add_epi32(_mm512_castsi512_si256(c),
+                                        _mm512_extracti64x4_epi64(c, 1));
+  const __m256i d256 = _mm256_add_epi32(_mm512_castsi512_si256(d),
+                                        _mm512_extracti64x4_epi64(d, 1));
+  const __m256i ab = _mm256_hadd_epi32(a256, b256);
+  const __m256i cd = _mm256_hadd_epi32(c256, d256);
+  const __m256i abcd = _mm256_hadd_epi32(ab, cd);
+  return _mm_add_epi32(_mm256_castsi256_si128(abcd),
+                       _mm256_extracti128_si256(abcd, 1));
+}
+
+template <int kRows>
+inline void StoreSums(const __m512i* acc, int32_t* dst) {
+  for (int r = 0; r < kRows; ++r) {
+    dst[r] = _mm512_reduce_add_epi32(acc[r]);
+  }
+}
+
+template <>
+inline void StoreSums<4>(const __m512i* acc, int32_t* dst) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                   ReduceAdd4(acc[0], acc[1], acc[2], acc[3]));
+}
+
+// Computes, for the `num_rows` rows starting at `row`, what to add to the
+// accumulators of the shifted RHS: the bias, minus the contribution of the RHS
+// shift and zero point.
+void ComputeRowOffsets(const Int8GemmParams& params, int row, int num_rows,
+                       int32_t* row_offsets) {
+  const __m512i ones = _mm512_set1_epi8(1);
+  const int32_t rhs_offset = kRhsShift + params.rhs_zero_point;
+  for (int r = 0; r < num_rows; ++r) {
+    const int8_t* lhs =
+        params.lhs_data + static_cast<int64_t>(row + r) * params.depth;
+    __m512i sum = _mm512_setzero_si512();
+    for (int d = 0; d < params.depth; d += 64) {
+      const __m512i lhs_v =
+          _mm512_maskz_loadu_epi8(DepthMask(params.depth - d), lhs + d);
+      sum = _mm512_dpbusd_epi32(sum, ones, lhs_v);
+    }
+    const int32_t bias = params.bias != nullptr ? params.bias[row + r] : 0;
+    row_offsets[r] = bias - rhs_offset * _mm512_reduce_add_epi32(sum);
+  }
+}
+
+// Computes the raw accumulators of a kRows x kCols block of the destination,
+// column by column into `acc_out` with a stride of kPanelRows.
+template <int kRows, int kCols>
+void ComputeBlock(const Int8GemmParams& params, int row, int col,
+                  int32_t* acc_out) {
+  const int depth = params.depth;
+  const int8_t* lhs = params.lhs_data + static_cast<int64_t>(row) * depth;
+  const int8_t* rhs = params.rhs_data + static_cast<int64_t>(col) * depth;
+  const __m512i sign_bits = _mm512_set1_epi8(static_cast<char>(0x80));
+  __m512i acc[kCols][kRows];
+  for (int c = 0; c < kCols; ++c) {
+    for (int r = 0; r < kRows; ++r) {
+      acc[c][r] = _mm512_setzero_si512();
+    }
+  }
+  for (int d = 0; d < depth; d += 64) {
+    // Masked-out LHS bytes are 0, so the RHS bytes they meet do not matter.
+    const __mmask64 mask = DepthMask(depth - d);
+    __m512i lhs_v[kRows];
+    for (int r = 0; r < kRows; ++r) {
+      lhs_v[r] = _mm512_maskz_loadu_epi8(mask, lhs + r * depth + d);
+    }
+    for (int c = 0; c < kCols; ++c) {
+      const __m512i rhs_v = _mm512_xor_si512(
+          _mm512_maskz_loadu_epi8(mask, rhs + c * depth + d), sign_bits);
+      for (int r = 0; r < kRows; ++r) {
+        acc[c][r] = _mm512_dpbusd_epi32(acc[c][r], rhs_v, lhs_v[r]);
+      }
+    }
+  }
+  for (int c = 0; c < kCols; ++c) {
+    StoreSums<kRows>(acc[c], acc_out + c * kPanelRows);
+  }
+}
+
+// Vector version of ApplyOutputStage's multiplication.
+inline __m512i MultiplyByQuantizedMultiplier(__m512i x, __m512i multiplier,
+                                             __m512i exponent) {
+  const __m512i total_shift = _mm512_sub_epi32(_mm512_set1_epi32(31), exponent);
+  const __m512i low_32_bits = _mm512_set1_epi64(0xffffffff);
+  const __m512i one = _mm512_set1_epi64(1);
+  const __m512i int32_min =
+      _mm512_set1_epi64(std::numeric_limits<int32_t>::lowest());
+  const __m512i int32_max =
+      _mm512_set1_epi64(std::numeric_limits<int32_t>::max());
+  __m512i result[2];
+  // The even 32-bit lanes, then the odd ones, as 64-bit lanes.
+  for (int i = 0; i < 2; ++i) {
+    const int bits = 32 * i;
+    const __m512i product =
+        _mm512_mul_epi32(_mm512_srli_epi64(x, bits),
+                         _mm512_srli_epi64(multiplier, bits));
+    const __m512i shift =
+        _mm512_and_si512(_mm512_srli_epi64(total_shift, bits), low_32_bits);
+    const __m512i round = _mm512_sllv_epi64(one, _mm512_sub_epi64(shift, one));
+    result[i] =
+        _mm512_srav_epi64(_mm512_add_epi64(product, round), shift);
+    result[i] =
+        _mm512_min_epi64(_mm512_max_epi64(result[i], int32_min), int32_max);
+  }
+  return _mm512_mask_blend_epi32(0xaaaa, result[0],
+                                 _mm512_slli_epi64(result[1], 32));
+}
+
+// Applies the output stage to the accumulators of the `num_rows` rows starting
+// at `row` of a destination column, and stores them to `dst`.
+void StoreColumn(const Int8GemmParams& params, int row, int num_rows,
+                 const int32_t* acc, const int32_t* row_offsets, int8_t* dst) {
+  const __m512i dst_zero_point = _mm512_set1_epi32(params.dst_zero_point);
+  const __m512i clamp_min = _mm512_set1_epi32(params.clamp_min);
+  const __m512i clamp_max = _mm512_set1_epi32(params.clamp_max);
+  for (int r = 0; r < num_rows; r += 16) {
+    const __mmask16 mask =
+        num_rows - r >= 16 ? 0xffff : (1u << (num_rows - r)) - 1;
+    __m512i x =
+        _mm512_add_epi32(_mm512_maskz_loadu_epi32(mask, acc + r),
+                         _mm512_maskz_loadu_epi32(mask, row_offsets + r));
+    __m512i multiplier;
+    __m512i exponent;
+    if (params.per_row_multiplier) {
+      multiplier = _mm512_maskz_loadu_epi32(
+          mask, params.multiplier_fixedpoint + row + r);
+      exponent =
+          _mm512_maskz_loadu_epi32(mask, params.multiplier_exponent + row + r);
+    } else {
+      multiplier = _mm512_set1_epi32(params.multiplier_fixedpoint[0]);
+      exponent = _mm512_set1_epi32(params.multiplier_exponent[0]);
+    }
+    x = MultiplyByQuantizedMultiplier(x, multiplier, exponent);
+    x = _mm512_add_epi32(x, dst_zero_point);
+    x = _mm512_min_epi32(_mm512_max_epi32(x, clamp_min), clamp_max);
+    _mm512_mask_cvtepi32_storeu_epi8(dst + r, mask, x);
+  }
+}
+
+template <int kCols>
+void ComputeColumns(const Int8GemmParams& params, int row, int num_rows,
+                    int col, const int32_t* row_offsets) {
+  int32_t acc[kCols * kPanelRows];
+  int r = 0;
+  for (; r + 4 <= num_rows; r += 4) {
+    ComputeBlock<4, kCols>(params, row + r, col, acc + r);
+  }
+  for (; r < num_rows; ++r) {
+    ComputeBlock<1, kCols>(params, row + r, col, acc + r);
+  }
+  for (int c = 0; c < kCols; ++c) {
+    StoreColumn(params, row, num_rows, acc + c * kPanelRows, row_offsets,
+                params.dst_data + static_cast<int64_t>(col + c) * params.rows +
+                    row);
+  }
+}
+
+}  // namespace
+
+void Avx512VnniGemmInt8(const Int8GemmParams& params, int row_start,
+                        int row_end) {
+  int32_t row_offsets[kPanelRows];
+  for (int row = row_start; row < row_end; row += kPanelRows) {
+    const int num_rows = std::min(kPanelRows, row_end - row);
+    ComputeRowOffsets(params, row, num_rows, row_offsets);
+    int col = 0;
+    for (; col + 4 <= params.cols; col += 4) {
+      ComputeColumns<4>(params, row, num_rows, col, row_offsets);
+    }
+    for (; col < params.cols; ++col) {
+      ComputeColumns<1>(params, row, num_rows, col, row_offsets);
+    }
+  }
+}
+
+}  // namespace x86_vnni
+}  // namespace tflite
@@ -0,0 +1,252 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "tensorflow/lite/kernels/internal/optimized/x86_vnni_gemm.h"
+
+// Same structure as avx512_vnni_gemm.cc, on 256-bit registers. AVX2 has no
+// masked byte loads, so the depth not filling a whole vector is copied to
+// zero-padded buffers.
+
+namespace tflite {
+namespace x86_vnni {
+namespace {
+
+constexpr int kPanelRows = 64;
+
+constexpr int32_t kRhsShift = 128;
+
+// Adds up the int32 lanes of each of a, b, c and d.
+inline __m128i ReduceAdd4(__m256i a, __m256i b, __m256i c, __m256i d) {
+  const __m256i ab = _mm256_hadd_epi32(a, b);
+  const __m256i cd = _mm256_hadd_epi32(c, d);
+  const __m256i abcd = _mm256_hadd_epi32(ab, cd);
+  return _mm_add_epi32(_mm256_castsi256_si128(abcd),
+                       _mm256_extracti128_si256(abcd, 1));
+}
+
+inline int32_t ReduceAdd(__m256i a) {
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(a),
+                              _mm256_extracti128_si256(a, 1));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(sum);
+}
+
+template <int kRows>
+inline void StoreSums(const __m256i* acc, int32_t* dst) {
+  for (int r = 0; r < kRows; ++r) {
+    dst[r] = ReduceAdd(acc[r]);
+  }
+}
+
+template <>
+inline void StoreSums<4>(const __m256i* acc, int32_t* dst) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                   ReduceAdd4(acc[0], acc[1], acc[2], acc[3]));
+}
+
+void ComputeRowOffsets(const Int8GemmParams& params, int row, int num_rows,
+                       int32_t* row_offsets) {
+  const __m256i ones = _mm256_set1_epi8(1);
+  const int32_t rhs_offset = kRhsShift + params.rhs_zero_point;
+  for (int r = 0; r < num_rows; ++r) {
+    const int8_t* lhs =
+        params.lhs_data + static_cast<int64_t>(row + r) * params.depth;
+    __m256i sum = _mm256_setzero_si256();
+    int d = 0;
+    for (; d + 32 <= params.depth; d += 32) {
+      const __m256i lhs_v =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + d));
+      sum = _mm256_dpbusd_avx_epi32(sum, ones, lhs_v);
+    }
+    int32_t row_sum = ReduceAdd(sum);
+    for (; d < params.depth; ++d) {
+      row_sum += lhs[d];
+    }
+    const int32_t bias = params.bias != nullptr ? params.bias[row + r] : 0;
+    row_offsets[r] = bias - rhs_offset * row_sum;
+  }
+}
+
+template <int kRows, int kCols>
+inline void Accumulate(const int8_t* lhs, int lhs_stride, const int8_t* rhs,
+                       int rhs_stride, __m256i (&acc)[kCols][kRows]) {
+  const __m256i sign_bits = _mm256_set1_epi8(static_cast<char>(0x80));
+  __m256i lhs_v[kRows];
+  for (int r = 0; r < kRows; ++r) {
+    lhs_v[r] = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(lhs + r * lhs_stride));
+  }
+  for (int c = 0; c < kCols; ++c) {
+    const __m256i rhs_v = _mm256_xor_si256(
+        _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(rhs + c * rhs_stride)),
+        sign_bits);
+    for (int r = 0; r < kRows; ++r) {
+      acc[c][r] = _mm256_dpbusd_avx_epi32(acc[c][r], rhs_v, lhs_v[r]);
+    }
+  }
+}
+
+template <int kRows, int kCols>
+void ComputeBlock(const Int8GemmParams& params, int row, int col,
+                  int32_t* acc_out) {
+  const int depth = params.depth;
+  const int8_t* lhs = params.lhs_data + static_cast<int64_t>(row) * depth;
+  const int8_t* rhs = params.rhs_data + static_cast<int64_t>(col) * depth;
+  __m256i acc[kCols][kRows];
+  for (int c = 0; c < kCols; ++c) {
+    for (int r = 0; r < kRows; ++r) {
+      acc[c][r] = _mm256_setzero_si256();
+    }
+  }
+  int d = 0;
+  for (; d + 32 <= depth; d += 32) {
+    Accumulate<kRows, kCols>(lhs + d, depth, rhs + d, depth, acc);
+  }
+  if (d < depth) {
+    // Zero-padded LHS bytes make the padding of the RHS irrelevant.
+    int8_t lhs_tail[kRows][32] = {};
+    int8_t rhs_tail[kCols][32];
+    for (int r = 0; r < kRows; ++r) {
+      memcpy(lhs_tail[r], lhs + r * depth + d, depth - d);
+    }
+    for (int c = 0; c < kCols; ++c) {
+      memcpy(rhs_tail[c], rhs + c * depth + d, depth - d);
+    }
+    Accumulate<kRows, kCols>(lhs_tail[0], 32, rhs_tail[0], 32, acc);
+  }
+  for (int c = 0; c < kCols; ++c) {
+    StoreSums<kRows>(acc[c], acc_out + c * kPanelRows);
+  }
+}
+
+// Arithmetic right shift of 64-bit lanes, which AVX2 lacks.
+inline __m256i ShiftRightArithmetic64(__m256i x, __m256i shift) {
+  const __m256i sign = _mm256_cmpgt_epi64(_mm256_setzero_si256(), x);
+  return _mm256_xor_si256(_mm256_srlv_epi64(_mm256_xor_si256(x, sign), shift),
+                          sign);
+}
+
+// Vector version of ApplyOutputStage's multiplication.
+inline __m256i MultiplyByQuantizedMultiplier(__m256i x, __m256i multiplier,
+                                             __m256i exponent) {
+  const __m256i total_shift = _mm256_sub_epi32(_mm256_set1_epi32(31), exponent);
+  const __m256i low_32_bits = _mm256_set1_epi64x(0xffffffff);
+  const __m256i one = _mm256_set1_epi64x(1);
+  const __m256i int32_min =
+      _mm256_set1_epi64x(std::numeric_limits<int32_t>::lowest());
+  const __m256i int32_max =
+      _mm256_set1_epi64x(std::numeric_limits<int32_t>::max());
+  __m256i result[2];
+  // The even 32-bit lanes, then the odd ones, as 64-bit lanes.
+  for (int i = 0; i < 2; ++i) {
+    const int bits = 32 * i;
+    const __m256i product =
+        _mm256_mul_epi32(_mm256_srli_epi64(x, bits),
+                         _mm256_srli_epi64(multiplier, bits));
+    const __m256i shift =
+        _mm256_and_si256(_mm256_srli_epi64(total_shift, bits), low_32_bits);
+    const __m256i round = _mm256_sllv_epi64(one, _mm256_sub_epi64(shift, one));
+    result[i] =
+        ShiftRightArithmetic64(_mm256_add_epi64(product, round), shift);
+    result[i] = _mm256_blendv_epi8(result[i], int32_max,
+                                   _mm256_cmpgt_epi64(result[i], int32_max));
+    result[i] = _mm256_blendv_epi8(result[i], int32_min,
+                                   _mm256_cmpgt_epi64(int32_min, result[i]));
+  }
+  return _mm256_blend_epi32(result[0], _mm256_slli_epi64(result[1], 32), 0xaa);
+}
+
+void StoreColumn(const Int8GemmParams& params, int row, int num_rows,
+                 const int32_t* acc, const int32_t* row_offsets, int8_t* dst) {
+  const __m256i dst_zero_point = _mm256_set1_epi32(params.dst_zero_point);
+  const __m256i clamp_min = _mm256_set1_epi32(params.clamp_min);
+  const __m256i clamp_max = _mm256_set1_epi32(params.clamp_max);
+  int r = 0;
+  for (; r + 8 <= num_rows; r += 8) {
+    __m256i x = _mm256_add_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + r)),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row_offsets + r)));
+    __m256i multiplier;
+    __m256i exponent;
+    if (params.per_row_multiplier) {
+      multiplier = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+          params.multiplier_fixedpoint + row + r));
+      exponent = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+          params.multiplier_exponent + row + r));
+    } else {
+      multiplier = _mm256_set1_epi32(params.multiplier_fixedpoint[0]);
+      exponent = _mm256_set1_epi32(params.multiplier_exponent[0]);
+    }
+    x = MultiplyByQuantizedMultiplier(x, multiplier, exponent);
+    x = _mm256_add_epi32(x, dst_zero_point);
+    x = _mm256_min_epi32(_mm256_max_epi32(x, clamp_min), clamp_max);
+    // Values are in the int8 range: narrowing with saturation is exact.
+    const __m256i packed = _mm256_packs_epi16(_mm256_packs_epi32(x, x),
+                                              _mm256_setzero_si256());
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + r),
+                     _mm_unpacklo_epi32(_mm256_castsi256_si128(packed),
+                                        _mm256_extracti128_si256(packed, 1)));
+  }
+  for (; r < num_rows; ++r) {
+    dst[r] = ApplyOutputStage(params, row + r, acc[r] + row_offsets[r]);
+  }
+}
+
+template <int kCols>
+void ComputeColumns(const Int8GemmParams& params, int row, int num_rows,
+                    int col, const int32_t* row_offsets) {
+  int32_t acc[kCols * kPanelRows];
+  int r = 0;
+  for (; r + 4 <= num_rows; r += 4) {
+    ComputeBlock<4, kCols>(params, row + r, col, acc + r);
+  }
+  for (; r < num_rows; ++r) {
+    ComputeBlock<1, kCols>(params, row + r, col, acc + r);
+  }
+  for (int c = 0; c < kCols; ++c) {
+    StoreColumn(params, row, num_rows, acc + c * kPanelRows, row_offsets,
+                params.dst_data + static_cast<int64_t>(col + c) * params.rows +
+                    row);
+  }
+}
+
+}  // namespace
+
+void AvxVnniGemmInt8(const Int8GemmParams& params, int row_start,
+                     int row_end) {
+  int32_t row_offsets[kPanelRows];
+  for (int row = row_start; row < row_end; row += kPanelRows) {
+    const int num_rows = std::min(kPanelRows, row_end - row);
+    ComputeRowOffsets(params, row, num_rows, row_offsets);
+    int col = 0;
+    for (; col + 4 <= params.cols; col += 4) {
+      ComputeColumns<4>(params, row, num_rows, col, row_offsets);
+    }
+    for (; col < params.cols; ++col) {
+      ComputeColumns<1>(params, row, num_rows, col, row_offsets);
+    }
+  }
+}
+
+}  // namespace x86_vnni
+}  // namespace tflite
@@ -19,6 +19,16 @@ limitations under the License.
 #include <sys/auxv.h>
 #endif
 
+#if defined(__x86_64__) || defined(_M_X64)
+#include <cstdint>
+#ifdef _MSC_VER
+#include <immintrin.h>
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
 namespace tflite {
 
 namespace {
@@ -37,6 +47,75 @@ bool DetectDotprodByLinuxAuxvMethod() {
 }
 #endif
 
+#if defined(__x86_64__) || defined(_M_X64)
+struct X86CpuidRegisters {
+  uint32_t eax = 0;
+  uint32_t ebx = 0;
+  uint32_t ecx = 0;
+  uint32_t edx = 0;
+};
+
+X86CpuidRegisters X86Cpuid(uint32_t leaf, uint32_t subleaf) {
+  X86CpuidRegisters regs;
+#ifdef _MSC_VER
+  int info[4];
+  __cpuidex(info, leaf, subleaf);
+  regs.eax = info[0];
+  regs.ebx = info[1];
+  regs.ecx = info[2];
+  regs.edx = info[3];
+#else
+  __cpuid_count(leaf, subleaf, regs.eax, regs.ebx, regs.ecx, regs.edx);
+#endif
+  return regs;
+}
+
+// Returns the XCR0 register, telling which register states the OS saves and
+// restores on context switches.
+uint64_t X86GetXcr0() {
+#ifdef _MSC_VER
+  return _xgetbv(0);
+#else
+  uint32_t eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+// Returns true if the CPU supports AVX2 and the OS saves the YMM registers.
+// If `zmm` is set, also requires AVX-512 F and BW and the saving of the
+// AVX-512 registers.
+bool X86HasAvx2(bool zmm) {
+  if (X86Cpuid(0, 0).eax < 7) {
+    return false;
+  }
+  // CPUID.1:ECX.OSXSAVE[bit 27] and CPUID.1:ECX.AVX[bit 28].
+  const uint32_t kOsxsaveAndAvx = (1u << 27) | (1u << 28);
+  if ((X86Cpuid(1, 0).ecx & kOsxsaveAndAvx) != kOsxsaveAndAvx) {
+    return false;
+  }
+  // XMM and YMM state, plus opmask, ZMM_Hi256 and Hi16_ZMM state for zmm.
+  const uint64_t xcr0_mask = zmm ? 0xe6 : 0x06;
+  if ((X86GetXcr0() & xcr0_mask) != xcr0_mask) {
+    return false;
+  }
+  // CPUID.7.0:EBX.AVX2[bit 5], and AVX512F[bit 16] and AVX512BW[bit 30].
+  const uint32_t ebx_mask = zmm ? (1u << 5) | (1u << 16) | (1u << 30) : 1u << 5;
+  return (X86Cpuid(7, 0).ebx & ebx_mask) == ebx_mask;
+}
+
+bool DetectX86Avx512VnniByCpuid() {
+  // CPUID.7.0:ECX.AVX512_VNNI[bit 11].
+  return X86HasAvx2(/*zmm=*/true) && (X86Cpuid(7, 0).ecx & (1u << 11)) != 0;
+}
+
+bool DetectX86AvxVnniByCpuid() {
+  // CPUID.7.1:EAX.AVX_VNNI[bit 4], subleaf 1 being reported by CPUID.7.0:EAX.
+  return X86HasAvx2(/*zmm=*/false) && X86Cpuid(7, 0).eax >= 1 &&
+         (X86Cpuid(7, 1).eax & (1u << 4)) != 0;
+}
+#endif
+
 }  // namespace
 
 bool DetectArmNeonDotprod() {
@@ -47,4 +126,24 @@ bool DetectArmNeonDotprod() {
 #endif
 }
 
+// CPUID is expensive, especially under virtualization, so the x86 results are
+// computed once.
+bool DetectX86Avx512Vnni() {
+#if defined(__x86_64__) || defined(_M_X64)
+  static const bool has_avx512_vnni = DetectX86Avx512VnniByCpuid();
+  return has_avx512_vnni;
+#else
+  return false;
+#endif
+}
+
+bool DetectX86AvxVnni() {
+#if defined(__x86_64__) || defined(_M_X64)
+  static const bool has_avx_vnni = DetectX86AvxVnniByCpuid();
+  return has_avx_vnni;
+#else
+  return false;
+#endif
+}
+
 }  // namespace tflite
@@ -27,12 +27,27 @@ namespace tflite {
 // On other architectures, returns false unconditionally.
 bool DetectArmNeonDotprod();
 
+// On x86-64, returns true if the AVX-512 VNNI extension is present, along with
+// AVX-512 F and BW, and the OS saves the AVX-512 register state.
+// On other architectures, returns false unconditionally.
+bool DetectX86Avx512Vnni();
+
+// On x86-64, returns true if the AVX-VNNI extension (the VEX-encoded VNNI
+// instructions on 256-bit registers) is present, along with AVX2, and the OS
+// saves the AVX register state.
+// On other architectures, returns false unconditionally.
+bool DetectX86AvxVnni();
+
 struct CpuFlags {
   bool neon_dotprod = false;
+  bool x86_avx512_vnni = false;
+  bool x86_avx_vnni = false;
 };
 
 inline void GetCpuFlags(CpuFlags* cpu_flags) {
   cpu_flags->neon_dotprod = DetectArmNeonDotprod();
+  cpu_flags->x86_avx512_vnni = DetectX86Avx512Vnni();
+  cpu_flags->x86_avx_vnni = DetectX86AvxVnni();
 }
 
 }  // namespace tflite
@@ -2342,6 +2342,69 @@ void NeonVectorScalarMultiply(const int8_t* vector, const int v_size,
   }
 }
 
+namespace {
+
+// Converts sixteen int8 values to four vectors of four floats.
+inline float32x4x4_t Int8x16ToFloat32x4x4(const int8x16_t v_i8x16) {
+  const int16x8_t v0_i16x8 = vmovl_s8(vget_low_s8(v_i8x16));
+  const int16x8_t v1_i16x8 = vmovl_s8(vget_high_s8(v_i8x16));
+  float32x4x4_t v_f32x4x4;
+  v_f32x4x4.val[0] = vcvtq_f32_s32(vmovl_s16(vget_low_s16(v0_i16x8)));
+  v_f32x4x4.val[1] = vcvtq_f32_s32(vmovl_s16(vget_high_s16(v0_i16x8)));
+  v_f32x4x4.val[2] = vcvtq_f32_s32(vmovl_s16(vget_low_s16(v1_i16x8)));
+  v_f32x4x4.val[3] = vcvtq_f32_s32(vmovl_s16(vget_high_s16(v1_i16x8)));
+  return v_f32x4x4;
+}
+
+}  // namespace
+
+void NeonVectorScalarMultiplyAccumulate(const int8_t* vector, const int v_size,
+                                        const float scale, float* result) {
+  // Unlike NeonVectorScalarMultiply, no alignment is required so that rows of
+  // embedding tables of any width can be dequantized in place.
+  const int postamble_start =
+      RoundDownVectors<kInt8ValuesPerNeonVector>(v_size);
+  const float32x4_t scale_f32x4 = vdupq_n_f32(scale);
+  int v = 0;
+  for (; v < postamble_start; v += kInt8ValuesPerNeonVector) {
+    const float32x4x4_t v_f32x4x4 = Int8x16ToFloat32x4x4(vld1q_s8(vector + v));
+    for (int i = 0; i < 4; ++i) {
+      float* result_ptr = result + v + 4 * i;
+      vst1q_f32(result_ptr, vmlaq_f32(vld1q_f32(result_ptr),
+                                      v_f32x4x4.val[i], scale_f32x4));
+    }
+  }
+
+  // Postamble loop.
+  for (; TFLITE_UNLIKELY(v < v_size); v++) {
+    result[v] += scale * vector[v];
+  }
+}
+
+void NeonVectorPerChannelScaleMultiplyAccumulate(
+    const int8_t* vector, const float* per_channel_scale, const int v_size,
+    const float scale, float* result) {
+  const int postamble_start =
+      RoundDownVectors<kInt8ValuesPerNeonVector>(v_size);
+  const float32x4_t scale_f32x4 = vdupq_n_f32(scale);
+  int v = 0;
+  for (; v < postamble_start; v += kInt8ValuesPerNeonVector) {
+    const float32x4x4_t v_f32x4x4 = Int8x16ToFloat32x4x4(vld1q_s8(vector + v));
+    for (int i = 0; i < 4; ++i) {
+      float* result_ptr = result + v + 4 * i;
+      const float32x4_t channel_scale_f32x4 =
+          vmulq_f32(vld1q_f32(per_channel_scale + v + 4 * i), scale_f32x4);
+      vst1q_f32(result_ptr, vmlaq_f32(vld1q_f32(result_ptr),
+                                      v_f32x4x4.val[i], channel_scale_f32x4));
+    }
+  }
+
+  // Postamble loop.
+  for (; TFLITE_UNLIKELY(v < v_size); v++) {
+    result[v] += scale * per_channel_scale[v] * vector[v];
+  }
+}
+
 // TODO(b/185850916): Consider changing the rounding stragey from "ties to away"
 // to "ties to even" since vcvtnq_s32_f32 is generally more available.
 inline int32x4_t RoundToNearest(const float32x4_t input) {
@@ -148,6 +148,17 @@ void NeonSub1Vector(const int16_t* vector, int v_size, int16_t* result);
 void NeonVectorScalarMultiply(const int8_t* vector, int v_size, float scale,
                               float* result);
 
+// Multiply all elements of vector with a scalar and accumulate the result.
+void NeonVectorScalarMultiplyAccumulate(const int8_t* vector, int v_size,
+                                        float scale, float* result);
+
+// Multiply all elements of vector with their per-channel scale and a scalar,
+// and accumulate the result.
+void NeonVectorPerChannelScaleMultiplyAccumulate(const int8_t* vector,
+                                                 const float* per_channel_scale,
+                                                 int v_size, float scale,
+                                                 float* result);
+
 // Check if all entries of a vector are zero.
 bool NeonIsZeroVector(const float* vector, int v_size);
 
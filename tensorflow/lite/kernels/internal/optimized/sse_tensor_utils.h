@@ -283,6 +283,20 @@ void VectorScalarMultiply(const int8_t* vector, int v_size, float scale,
   NEON_OR_PORTABLE(VectorScalarMultiply, vector, v_size, scale, result);
 }
 
+void VectorScalarMultiplyAccumulate(const int8_t* vector, int v_size,
+                                    float scale, float* result) {
+  NEON_OR_PORTABLE(VectorScalarMultiplyAccumulate, vector, v_size, scale,
+                   result);
+}
+
+void VectorPerChannelScaleMultiplyAccumulate(const int8_t* vector,
+                                             const float* per_channel_scale,
+                                             int v_size, float scale,
+                                             float* result) {
+  NEON_OR_PORTABLE(VectorPerChannelScaleMultiplyAccumulate, vector,
+                   per_channel_scale, v_size, scale, result);
+}
+
 void SymmetricQuantizeFloats(const float* values, const int size,
                              int8_t* quantized_values, float* min_value,
                              float* max_value, float* scaling_factor) {
@@ -0,0 +1,85 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_X86_VNNI_GEMM_H_
+#define TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_X86_VNNI_GEMM_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+// Int8 GEMM kernels built on the vpdpbusd dot-product instruction of x86-64
+// CPUs, in its AVX-512 VNNI and AVX-VNNI flavors. Each flavor lives in its own
+// translation unit, compiled for the matching instruction set, so callers must
+// check DetectX86Avx512Vnni() or DetectX86AvxVnni() from cpu_check.h first.
+
+namespace tflite {
+namespace x86_vnni {
+
+// dst = clamp(dst_zero_point + multiplier * (lhs * (rhs - rhs_zero_point) +
+// bias)), with the same arithmetic as ruy, so results are bit-exact with the
+// ruy path of cpu_backend_gemm.
+struct Int8GemmParams {
+  // Row-major [rows, depth] matrix, with a zero point of 0.
+  const int8_t* lhs_data = nullptr;
+  // Column-major [depth, cols] matrix.
+  const int8_t* rhs_data = nullptr;
+  // Column-major [rows, cols] matrix.
+  int8_t* dst_data = nullptr;
+  int rows = 0;
+  int depth = 0;
+  int cols = 0;
+  int32_t rhs_zero_point = 0;
+  int32_t dst_zero_point = 0;
+  // If not nullptr, one value per row.
+  const int32_t* bias = nullptr;
+  // One value per row if per_row_multiplier is set, a single one otherwise.
+  const int32_t* multiplier_fixedpoint = nullptr;
+  const int* multiplier_exponent = nullptr;
+  bool per_row_multiplier = false;
+  int32_t clamp_min = std::numeric_limits<int8_t>::lowest();
+  int32_t clamp_max = std::numeric_limits<int8_t>::max();
+};
+
+// Computes the rows [row_start, row_end) of the destination. Rows are
+// independent, so disjoint row ranges may run on separate threads.
+void Avx512VnniGemmInt8(const Int8GemmParams& params, int row_start,
+                        int row_end);
+void AvxVnniGemmInt8(const Int8GemmParams& params, int row_start, int row_end);
+
+// Scalar output stage, for rows not filling a whole vector: `acc` is the
+// accumulator of `row` with bias and zero points already accounted for.
+inline int8_t ApplyOutputStage(const Int8GemmParams& params, int row,
+                               int32_t acc) {
+  const int channel = params.per_row_multiplier ? row : 0;
+  // As ruy's MultiplyByQuantizedMultiplier: a single rounding, ties upward.
+  const int total_shift = 31 - params.multiplier_exponent[channel];
+  const int64_t round = static_cast<int64_t>(1) << (total_shift - 1);
+  int64_t result =
+      (static_cast<int64_t>(acc) * params.multiplier_fixedpoint[channel] +
+       round) >>
+      total_shift;
+  result = std::min<int64_t>(
+      std::max<int64_t>(result, std::numeric_limits<int32_t>::lowest()),
+      std::numeric_limits<int32_t>::max());
+  result += params.dst_zero_point;
+  result = std::min<int64_t>(std::max<int64_t>(result, params.clamp_min),
+                             params.clamp_max);
+  return static_cast<int8_t>(result);
+}
+
+}  // namespace x86_vnni
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_KERNELS_INTERNAL_OPTIMIZED_X86_VNNI_GEMM_H_
@@ -470,6 +470,22 @@ void ReductionSumVector(const int8_t* input_vector, int32_t* output_vector,
 void VectorScalarMultiply(const int8_t* vector, int v_size, float scale,
                           float* result);
 
+// Multiply all elements of vector with a scalar and accumulate the result:
+//   result[v] += scale * vector[v]
+// Dequantizes and accumulates rows of symmetric per-row quantized tables.
+void VectorScalarMultiplyAccumulate(const int8_t* vector, int v_size,
+                                    float scale, float* result);
+
+// Multiply all elements of vector with their per-channel scale and a scalar,
+// and accumulate the result:
+//   result[v] += scale * per_channel_scale[v] * vector[v]
+// Dequantizes and accumulates rows of symmetric tables quantized along their
+// last dimension.
+void VectorPerChannelScaleMultiplyAccumulate(const int8_t* vector,
+                                             const float* per_channel_scale,
+                                             int v_size, float scale,
+                                             float* result);
+
 // Layer norm for each batch.
 void MeanStddevNormalization(const float* input_vector, float* output_vector,
                              int v_size, int n_batch);
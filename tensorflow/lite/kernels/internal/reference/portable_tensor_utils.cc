@@ -760,6 +760,22 @@ void PortableVectorScalarMultiply(const int8_t* vector, const int v_size,
   }
 }
 
+void PortableVectorScalarMultiplyAccumulate(const int8_t* vector,
+                                            const int v_size, const float scale,
+                                            float* result) {
+  for (int v = 0; v < v_size; ++v) {
+    *result++ += scale * *vector++;
+  }
+}
+
+void PortableVectorPerChannelScaleMultiplyAccumulate(
+    const int8_t* vector, const float* per_channel_scale, const int v_size,
+    const float scale, float* result) {
+  for (int v = 0; v < v_size; ++v) {
+    *result++ += scale * *per_channel_scale++ * *vector++;
+  }
+}
+
 void PortableMeanStddevNormalization(const float* __restrict__ input_vector,
                                      float* __restrict__ output_vector,
                                      int v_size, int n_batch) {
@@ -294,6 +294,19 @@ void VectorScalarMultiply(const int8_t* vector, int v_size, float scale,
   PortableVectorScalarMultiply(vector, v_size, scale, result);
 }
 
+void VectorScalarMultiplyAccumulate(const int8_t* vector, int v_size,
+                                    float scale, float* result) {
+  PortableVectorScalarMultiplyAccumulate(vector, v_size, scale, result);
+}
+
+void VectorPerChannelScaleMultiplyAccumulate(const int8_t* vector,
+                                             const float* per_channel_scale,
+                                             int v_size, float scale,
+                                             float* result) {
+  PortableVectorPerChannelScaleMultiplyAccumulate(vector, per_channel_scale,
+                                                  v_size, scale, result);
+}
+
 void ReductionSumVector(const float* input_vector, float* output_vector,
                         int output_size, int reduction_size) {
   PortableReductionSumVector(input_vector, output_vector, output_size,
@@ -207,6 +207,13 @@ void PortableSub1Vector(const int16_t* vector, int v_size, int16_t* result);
 void PortableVectorScalarMultiply(const int8_t* vector, int v_size, float scale,
                                   float* result);
 
+void PortableVectorScalarMultiplyAccumulate(const int8_t* vector, int v_size,
+                                            float scale, float* result);
+
+void PortableVectorPerChannelScaleMultiplyAccumulate(
+    const int8_t* vector, const float* per_channel_scale, int v_size,
+    float scale, float* result);
+
 // Reduce-sum on a vector:
 // input_vector: pointer to input vector.
 // output_vector: pointer to vector.
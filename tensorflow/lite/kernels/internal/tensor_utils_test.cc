@@ -78,6 +78,38 @@ TEST(uKernels, VectorScalarMultiply) {
                    0.6,  0.7,  0.8,  0.9,  1.0,  1.1,  1.2,  1.3,  1.4})));
 }
 
+TEST(uKernels, VectorScalarMultiplyAccumulate) {
+  constexpr int kVectorSize = 29;
+  // Starts at an odd offset to check unaligned rows.
+  static int8_t input[kVectorSize + 1];
+  std::vector<float> output(kVectorSize);
+  std::vector<float> expected(kVectorSize);
+  for (int i = 0; i < kVectorSize; ++i) {
+    input[i + 1] = static_cast<int8_t>(i - 14);
+    output[i] = i;
+    expected[i] = i + 0.1f * (i - 14);
+  }
+  VectorScalarMultiplyAccumulate(input + 1, kVectorSize, 0.1f, output.data());
+  EXPECT_THAT(output, ElementsAreArray(ArrayFloatNear(expected)));
+}
+
+TEST(uKernels, VectorPerChannelScaleMultiplyAccumulate) {
+  constexpr int kVectorSize = 29;
+  static int8_t input[kVectorSize + 1];
+  std::vector<float> per_channel_scale(kVectorSize);
+  std::vector<float> output(kVectorSize);
+  std::vector<float> expected(kVectorSize);
+  for (int i = 0; i < kVectorSize; ++i) {
+    input[i + 1] = static_cast<int8_t>(i - 14);
+    per_channel_scale[i] = 0.01f * (i + 1);
+    output[i] = -i;
+    expected[i] = -i + 2.0f * 0.01f * (i + 1) * (i - 14);
+  }
+  VectorPerChannelScaleMultiplyAccumulate(input + 1, per_channel_scale.data(),
+                                          kVectorSize, 2.0f, output.data());
+  EXPECT_THAT(output, ElementsAreArray(ArrayFloatNear(expected)));
+}
+
 #define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
 
 // Test if a float array if full of zero values.
@@ -16,9 +16,12 @@ limitations under the License.
 #define TENSORFLOW_LITE_PROFILING_BUFFERED_PROFILER_H_
 
 #include <cstdint>
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include "tensorflow/lite/core/api/profiler.h"
+#include "tensorflow/lite/profiling/perf_counters.h"
 #include "tensorflow/lite/profiling/profile_buffer.h"
 
 namespace tflite {
@@ -116,6 +119,16 @@ class BufferedProfiler : public tflite::Profiler {
                      event_metadata2);
   }
 
+  // Records the hardware counters of the calling thread around operator
+  // invocations, see PerfCounters. Must be called on the thread which invokes
+  // the interpreter. Returns false if the counters are unavailable.
+  bool EnablePerfCounters() {
+    std::unique_ptr<PerfCounters> perf_counters = PerfCounters::Create();
+    if (!perf_counters) return false;
+    buffer_.SetPerfCounters(std::move(perf_counters));
+    return true;
+  }
+
   void StartProfiling() { buffer_.SetEnabled(true); }
   void StopProfiling() { buffer_.SetEnabled(false); }
   void Reset() { buffer_.Reset(); }
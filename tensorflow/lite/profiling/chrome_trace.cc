@@ -0,0 +1,138 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/profiling/chrome_trace.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "tensorflow/lite/core/api/profiler.h"
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/core/subgraph.h"
+#include "tensorflow/lite/profiling/op_cost.h"
+#include "tensorflow/lite/profiling/perf_counters.h"
+#include "tensorflow/lite/profiling/profile_buffer.h"
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+std::string JsonEscape(const std::string& value) {
+  std::string escaped;
+  escaped.reserve(value.size());
+  for (const char c : value) {
+    switch (c) {
+      case '"':
+        escaped += "\\\"";
+        break;
+      case '\\':
+        escaped += "\\\\";
+        break;
+      case '\n':
+        escaped += "\\n";
+        break;
+      case '\t':
+        escaped += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char unicode[8];
+          snprintf(unicode, sizeof(unicode), "\\u%04x", c);
+          escaped += unicode;
+        } else {
+          escaped += c;
+        }
+    }
+  }
+  return escaped;
+}
+
+const char* GetCategory(Profiler::EventType event_type) {
+  switch (event_type) {
+    case Profiler::EventType::OPERATOR_INVOKE_EVENT:
+      return "op";
+    case Profiler::EventType::DELEGATE_OPERATOR_INVOKE_EVENT:
+    case Profiler::EventType::DELEGATE_PROFILED_OPERATOR_INVOKE_EVENT:
+      return "delegate_op";
+    default:
+      return "runtime";
+  }
+}
+
+}  // namespace
+
+void ChromeTraceBuilder::AddEvents(
+    const std::vector<const ProfileEvent*>& events,
+    const tflite::Interpreter& interpreter) {
+  for (const ProfileEvent* event : events) {
+    // Events added with their duration only can't be placed in the timeline.
+    if (event == nullptr || event->begin_timestamp_us == 0) continue;
+    std::stringstream json;
+    json << "{\"name\":\"" << JsonEscape(event->tag) << "\",\"cat\":\""
+         << GetCategory(event->event_type) << "\",\"ph\":\"X\",\"ts\":"
+         << event->begin_timestamp_us << ",\"dur\":" << event->elapsed_time
+         << ",\"pid\":0,\"tid\":" << event->extra_event_metadata;
+    if (event->event_type == Profiler::EventType::OPERATOR_INVOKE_EVENT) {
+      const int64_t node_index = event->event_metadata;
+      json << ",\"args\":{\"node_index\":" << node_index;
+      const Subgraph* subgraph =
+          interpreter.subgraph(event->extra_event_metadata);
+      const auto* node_and_reg =
+          subgraph ? subgraph->node_and_registration(node_index) : nullptr;
+      if (node_and_reg != nullptr) {
+        const OpCost cost =
+            EstimateOpCost(*subgraph->context(), node_and_reg->first,
+                           node_and_reg->second);
+        json << ",\"bytes_read\":" << cost.bytes_read
+             << ",\"bytes_written\":" << cost.bytes_written
+             << ",\"flops\":" << cost.flops;
+      }
+      const HardwareCounters counters =
+          event->end_hw_counters - event->begin_hw_counters;
+      if (counters.cycles > 0) {
+        json << ",\"cycles\":" << counters.cycles
+             << ",\"instructions\":" << counters.instructions
+             << ",\"cache_references\":" << counters.cache_references
+             << ",\"cache_misses\":" << counters.cache_misses;
+      }
+      json << "}";
+    }
+    json << "}";
+    events_.push_back(json.str());
+  }
+}
+
+std::string ChromeTraceBuilder::ToJson() const {
+  std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for (size_t i = 0; i < events_.size(); ++i) {
+    if (i > 0) json += ",\n";
+    json += events_[i];
+  }
+  json += "]}\n";
+  return json;
+}
+
+bool ChromeTraceBuilder::WriteToFile(const std::string& path) const {
+  std::ofstream file(path, std::ios::out | std::ios::trunc);
+  if (!file) return false;
+  file << ToJson();
+  return static_cast<bool>(file);
+}
+
+}  // namespace profiling
+}  // namespace tflite
@@ -0,0 +1,58 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_PROFILING_CHROME_TRACE_H_
+#define TENSORFLOW_LITE_PROFILING_CHROME_TRACE_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/profiling/profile_buffer.h"
+
+namespace tflite {
+namespace profiling {
+
+// Collects profile events into a trace in the Chrome Trace Event Format, which
+// can be opened in chrome://tracing or https://ui.perfetto.dev. Each subgraph
+// is shown as a thread. The operator events carry their estimated memory
+// traffic and arithmetic (see EstimateOpCost) and, if recorded, their hardware
+// counters as arguments.
+//
+// WARNING: This is an experimental API and subject to change.
+class ChromeTraceBuilder {
+ public:
+  // Adds the events which have a begin timestamp. `interpreter` must be the
+  // one which produced the events.
+  void AddEvents(const std::vector<const ProfileEvent*>& events,
+                 const tflite::Interpreter& interpreter);
+
+  // Returns the trace as a JSON object.
+  std::string ToJson() const;
+
+  // Writes the JSON trace to `path`. Returns false on failure.
+  bool WriteToFile(const std::string& path) const;
+
+  size_t size() const { return events_.size(); }
+
+ private:
+  // The events, each one serialized as a JSON object.
+  std::vector<std::string> events_;
+};
+
+}  // namespace profiling
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_PROFILING_CHROME_TRACE_H_
@@ -0,0 +1,60 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/profiling/chrome_trace.h"
+
+#include <cstdint>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/profiling/buffered_profiler.h"
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+TEST(ChromeTraceBuilderTest, Empty) {
+  ChromeTraceBuilder trace;
+  EXPECT_EQ(trace.ToJson(),
+            "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[]}\n");
+}
+
+TEST(ChromeTraceBuilderTest, AddsTimedEvents) {
+  Interpreter interpreter;
+  BufferedProfiler profiler(16);
+  profiler.StartProfiling();
+  const uint32_t handle =
+      profiler.BeginEvent("Allocate\"Tensors\"",
+                          Profiler::EventType::DEFAULT, 0, 0);
+  profiler.EndEvent(handle);
+  // Events without a begin timestamp are skipped.
+  profiler.AddEvent("Untimed", Profiler::EventType::DEFAULT, 10, 0, 0);
+  profiler.StopProfiling();
+
+  ChromeTraceBuilder trace;
+  trace.AddEvents(profiler.GetProfileEvents(), interpreter);
+  EXPECT_EQ(trace.size(), 1);
+  const std::string json = trace.ToJson();
+  EXPECT_NE(json.find("\"name\":\"Allocate\\\"Tensors\\\"\""),
+            std::string::npos)
+      << json;
+  EXPECT_NE(json.find("\"cat\":\"runtime\",\"ph\":\"X\""), std::string::npos)
+      << json;
+  EXPECT_EQ(json.find("Untimed"), std::string::npos) << json;
+}
+
+}  // namespace
+}  // namespace profiling
+}  // namespace tflite
@@ -218,11 +218,15 @@ TfLiteStatus GenerateModelRuntimeInfo(const tflite::Interpreter& interpreter,
                           << node_index;
         return status;
       }
+      runtime_node->set_init_time_us(subgraph.GetNodeInitTimeUs(node_index));
+      runtime_node->set_prepare_time_us(
+          subgraph.GetNodePrepareTimeUs(node_index));
     }
 
     // Save the execution plan to runtime subgraph.
     runtime_subgraph->mutable_execution_plan()->Add(
         subgraph.execution_plan().begin(), subgraph.execution_plan().end());
+    runtime_subgraph->set_num_prepared_nodes(subgraph.GetNumPreparedNodes());
   }
 
   std::ofstream ofs(std::string(output_file_path),
@@ -351,6 +351,14 @@ TEST(MODEL_RUNTIME_INFO_TEST, PadAndConv2DNoDelegate) {
 
   ASSERT_TRUE(AreModelRuntimeDetailsEqual(model_runtime_details,
                                           expected_model_runtime_details));
+
+  // All the nodes were initialized and prepared.
+  const RuntimeSubgraph& subgraph = model_runtime_details.subgraphs(0);
+  EXPECT_EQ(subgraph.num_prepared_nodes(), subgraph.execution_plan_size());
+  for (const Node& node : subgraph.nodes()) {
+    EXPECT_TRUE(node.has_init_time_us());
+    EXPECT_TRUE(node.has_prepare_time_us());
+  }
 }
 
 TEST(MODEL_RUNTIME_INFO_TEST, PadAndConv2DWithXnnpackDelegate) {
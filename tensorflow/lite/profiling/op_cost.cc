@@ -0,0 +1,167 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/profiling/op_cost.h"
+
+#include <cstdint>
+
+#include "tensorflow/lite/builtin_ops.h"
+#include "tensorflow/lite/core/c/builtin_op_data.h"
+#include "tensorflow/lite/core/c/common.h"
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+// Returns the tensor of the `index`-th entry of `indices`, or nullptr if it is
+// missing or optional.
+const TfLiteTensor* GetTensor(const TfLiteContext& context,
+                              const TfLiteIntArray* indices, int index) {
+  if (indices == nullptr || index >= indices->size) return nullptr;
+  const int tensor_index = indices->data[index];
+  if (tensor_index < 0 || tensor_index >= context.tensors_size) return nullptr;
+  return &context.tensors[tensor_index];
+}
+
+int64_t NumElements(const TfLiteTensor* tensor) {
+  if (tensor == nullptr || tensor->dims == nullptr) return 0;
+  int64_t count = 1;
+  for (int i = 0; i < tensor->dims->size; ++i) {
+    count *= tensor->dims->data[i];
+  }
+  return count;
+}
+
+// Returns the `index`-th dimension of `tensor`, negative indices counting from
+// the last one, or 0 if it doesn't exist.
+int64_t Dim(const TfLiteTensor* tensor, int index) {
+  if (tensor == nullptr || tensor->dims == nullptr) return 0;
+  if (index < 0) index += tensor->dims->size;
+  if (index < 0 || index >= tensor->dims->size) return 0;
+  return tensor->dims->data[index];
+}
+
+int64_t EstimateFlops(const TfLiteContext& context, const TfLiteNode& node,
+                      int32_t builtin_code) {
+  const TfLiteTensor* input = GetTensor(context, node.inputs, 0);
+  const TfLiteTensor* output = GetTensor(context, node.outputs, 0);
+  const int64_t output_elements = NumElements(output);
+  switch (builtin_code) {
+    case kTfLiteBuiltinConv2d: {
+      // Filter: [output_depth, filter_height, filter_width, input_depth].
+      const TfLiteTensor* filter = GetTensor(context, node.inputs, 1);
+      return 2 * output_elements * Dim(filter, 1) * Dim(filter, 2) *
+             Dim(filter, 3);
+    }
+    case kTfLiteBuiltinConv3d: {
+      // Filter: [depth, height, width, input_depth, output_depth].
+      const TfLiteTensor* filter = GetTensor(context, node.inputs, 1);
+      return 2 * output_elements * Dim(filter, 0) * Dim(filter, 1) *
+             Dim(filter, 2) * Dim(filter, 3);
+    }
+    case kTfLiteBuiltinDepthwiseConv2d: {
+      // Filter: [1, filter_height, filter_width, output_depth].
+      const TfLiteTensor* filter = GetTensor(context, node.inputs, 1);
+      return 2 * output_elements * Dim(filter, 1) * Dim(filter, 2);
+    }
+    case kTfLiteBuiltinTransposeConv: {
+      // Inputs: output shape, filter [output_depth, filter_height,
+      // filter_width, input_depth] and input.
+      const TfLiteTensor* filter = GetTensor(context, node.inputs, 1);
+      const TfLiteTensor* conv_input = GetTensor(context, node.inputs, 2);
+      return 2 * NumElements(conv_input) * Dim(filter, 0) * Dim(filter, 1) *
+             Dim(filter, 2);
+    }
+    case kTfLiteBuiltinFullyConnected: {
+      // Weights: [num_units, input_depth].
+      const TfLiteTensor* weights = GetTensor(context, node.inputs, 1);
+      return 2 * output_elements * Dim(weights, -1);
+    }
+    case kTfLiteBuiltinBatchMatmul: {
+      const auto* params =
+          static_cast<const TfLiteBatchMatMulParams*>(node.builtin_data);
+      const bool adj_x = params != nullptr && params->adj_x;
+      return 2 * output_elements * Dim(input, adj_x ? -2 : -1);
+    }
+    case kTfLiteBuiltinAveragePool2d:
+    case kTfLiteBuiltinMaxPool2d:
+    case kTfLiteBuiltinL2Pool2d: {
+      const auto* params =
+          static_cast<const TfLitePoolParams*>(node.builtin_data);
+      if (params == nullptr) return 0;
+      return output_elements * params->filter_height * params->filter_width;
+    }
+    case kTfLiteBuiltinSoftmax:
+    case kTfLiteBuiltinLogSoftmax:
+      // Max, exponential and normalization.
+      return 3 * output_elements;
+    case kTfLiteBuiltinMean:
+    case kTfLiteBuiltinSum:
+    case kTfLiteBuiltinReduceMax:
+    case kTfLiteBuiltinReduceMin:
+    case kTfLiteBuiltinReduceProd:
+    case kTfLiteBuiltinL2Normalization:
+      return NumElements(input);
+    case kTfLiteBuiltinAdd:
+    case kTfLiteBuiltinSub:
+    case kTfLiteBuiltinMul:
+    case kTfLiteBuiltinDiv:
+    case kTfLiteBuiltinMaximum:
+    case kTfLiteBuiltinMinimum:
+    case kTfLiteBuiltinSquaredDifference:
+    case kTfLiteBuiltinPow:
+    case kTfLiteBuiltinRelu:
+    case kTfLiteBuiltinRelu6:
+    case kTfLiteBuiltinReluN1To1:
+    case kTfLiteBuiltinLeakyRelu:
+    case kTfLiteBuiltinPrelu:
+    case kTfLiteBuiltinLogistic:
+    case kTfLiteBuiltinTanh:
+    case kTfLiteBuiltinHardSwish:
+    case kTfLiteBuiltinGelu:
+    case kTfLiteBuiltinElu:
+    case kTfLiteBuiltinExp:
+    case kTfLiteBuiltinLog:
+    case kTfLiteBuiltinSqrt:
+    case kTfLiteBuiltinRsqrt:
+    case kTfLiteBuiltinSquare:
+    case kTfLiteBuiltinAbs:
+    case kTfLiteBuiltinNeg:
+      return output_elements;
+    default:
+      return 0;
+  }
+}
+
+}  // namespace
+
+OpCost EstimateOpCost(const TfLiteContext& context, const TfLiteNode& node,
+                      const TfLiteRegistration& registration) {
+  OpCost cost;
+  for (int i = 0; node.inputs != nullptr && i < node.inputs->size; ++i) {
+    if (const TfLiteTensor* tensor = GetTensor(context, node.inputs, i)) {
+      cost.bytes_read += tensor->bytes;
+    }
+  }
+  for (int i = 0; node.outputs != nullptr && i < node.outputs->size; ++i) {
+    if (const TfLiteTensor* tensor = GetTensor(context, node.outputs, i)) {
+      cost.bytes_written += tensor->bytes;
+    }
+  }
+  cost.flops = EstimateFlops(context, node, registration.builtin_code);
+  return cost;
+}
+
+}  // namespace profiling
+}  // namespace tflite
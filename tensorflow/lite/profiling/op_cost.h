@@ -0,0 +1,55 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_PROFILING_OP_COST_H_
+#define TENSORFLOW_LITE_PROFILING_OP_COST_H_
+
+#include <cstdint>
+
+#include "tensorflow/lite/core/c/common.h"
+
+namespace tflite {
+namespace profiling {
+
+// The estimated cost of one invocation of a node.
+struct OpCost {
+  // Bytes of the input tensors, including the constant ones like weights.
+  int64_t bytes_read = 0;
+  // Bytes of the output tensors.
+  int64_t bytes_written = 0;
+  // Floating point or integer arithmetic operations, a multiply-add counting
+  // as two. 0 if the op has no cost function.
+  int64_t flops = 0;
+
+  OpCost& operator+=(const OpCost& other) {
+    bytes_read += other.bytes_read;
+    bytes_written += other.bytes_written;
+    flops += other.flops;
+    return *this;
+  }
+};
+
+// Estimates the cost of invoking `node` with the current shapes of its
+// tensors. The memory traffic assumes that each tensor is read or written
+// exactly once, so it is an upper bound of the traffic to the main memory when
+// the tensors fit in the caches. The arithmetic is only estimated for the
+// builtin ops which dominate the inference time of most models, e.g.
+// convolutions, matrix multiplications, pooling and element-wise ops.
+OpCost EstimateOpCost(const TfLiteContext& context, const TfLiteNode& node,
+                      const TfLiteRegistration& registration);
+
+}  // namespace profiling
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_PROFILING_OP_COST_H_
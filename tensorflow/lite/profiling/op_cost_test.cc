@@ -0,0 +1,130 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/profiling/op_cost.h"
+
+#include <initializer_list>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/builtin_ops.h"
+#include "tensorflow/lite/core/c/builtin_op_data.h"
+#include "tensorflow/lite/core/c/common.h"
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+// Owns float tensors of the given shapes and a node using them.
+class OpCostTest : public ::testing::Test {
+ protected:
+  ~OpCostTest() override {
+    for (TfLiteTensor& tensor : tensors_) TfLiteIntArrayFree(tensor.dims);
+    TfLiteIntArrayFree(node_.inputs);
+    TfLiteIntArrayFree(node_.outputs);
+  }
+
+  int AddTensor(std::initializer_list<int> shape) {
+    TfLiteTensor tensor = {};
+    tensor.type = kTfLiteFloat32;
+    tensor.dims = TfLiteIntArrayCreate(shape.size());
+    tensor.bytes = sizeof(float);
+    int i = 0;
+    for (int dim : shape) {
+      tensor.dims->data[i++] = dim;
+      tensor.bytes *= dim;
+    }
+    tensors_.push_back(tensor);
+    return tensors_.size() - 1;
+  }
+
+  OpCost Estimate(int32_t builtin_code, const std::vector<int>& inputs,
+                  const std::vector<int>& outputs,
+                  void* builtin_data = nullptr) {
+    node_.inputs = TfLiteIntArrayCreate(inputs.size());
+    for (int i = 0; i < inputs.size(); ++i) node_.inputs->data[i] = inputs[i];
+    node_.outputs = TfLiteIntArrayCreate(outputs.size());
+    for (int i = 0; i < outputs.size(); ++i) {
+      node_.outputs->data[i] = outputs[i];
+    }
+    node_.builtin_data = builtin_data;
+    context_.tensors = tensors_.data();
+    context_.tensors_size = tensors_.size();
+    TfLiteRegistration registration = {};
+    registration.builtin_code = builtin_code;
+    return EstimateOpCost(context_, node_, registration);
+  }
+
+  std::vector<TfLiteTensor> tensors_;
+  TfLiteContext context_ = {};
+  TfLiteNode node_ = {};
+};
+
+TEST_F(OpCostTest, Conv2d) {
+  const int input = AddTensor({1, 8, 8, 3});
+  const int filter = AddTensor({16, 3, 3, 3});
+  const int bias = AddTensor({16});
+  const int output = AddTensor({1, 8, 8, 16});
+  const OpCost cost =
+      Estimate(kTfLiteBuiltinConv2d, {input, filter, bias}, {output});
+  EXPECT_EQ(cost.bytes_read, (8 * 8 * 3 + 16 * 3 * 3 * 3 + 16) * 4);
+  EXPECT_EQ(cost.bytes_written, 8 * 8 * 16 * 4);
+  EXPECT_EQ(cost.flops, 2 * (8 * 8 * 16) * (3 * 3 * 3));
+}
+
+TEST_F(OpCostTest, FullyConnectedWithoutBias) {
+  const int input = AddTensor({2, 32});
+  const int weights = AddTensor({10, 32});
+  const int output = AddTensor({2, 10});
+  const OpCost cost =
+      Estimate(kTfLiteBuiltinFullyConnected, {input, weights, -1}, {output});
+  EXPECT_EQ(cost.bytes_read, (2 * 32 + 10 * 32) * 4);
+  EXPECT_EQ(cost.bytes_written, 2 * 10 * 4);
+  EXPECT_EQ(cost.flops, 2 * 2 * 10 * 32);
+}
+
+TEST_F(OpCostTest, BatchMatMulWithAdjointLhs) {
+  const int lhs = AddTensor({4, 7, 5});
+  const int rhs = AddTensor({4, 7, 6});
+  const int output = AddTensor({4, 5, 6});
+  TfLiteBatchMatMulParams params = {};
+  params.adj_x = true;
+  const OpCost cost =
+      Estimate(kTfLiteBuiltinBatchMatmul, {lhs, rhs}, {output}, &params);
+  EXPECT_EQ(cost.flops, 2 * (4 * 5 * 6) * 7);
+}
+
+TEST_F(OpCostTest, MaxPool) {
+  const int input = AddTensor({1, 8, 8, 4});
+  const int output = AddTensor({1, 4, 4, 4});
+  TfLitePoolParams params = {};
+  params.filter_height = 2;
+  params.filter_width = 2;
+  const OpCost cost =
+      Estimate(kTfLiteBuiltinMaxPool2d, {input}, {output}, &params);
+  EXPECT_EQ(cost.flops, 4 * 4 * 4 * 2 * 2);
+}
+
+TEST_F(OpCostTest, UnknownOpOnlyHasTraffic) {
+  const int input = AddTensor({3, 5});
+  const int output = AddTensor({5, 3});
+  const OpCost cost = Estimate(kTfLiteBuiltinTranspose, {input}, {output});
+  EXPECT_EQ(cost.bytes_read, 15 * 4);
+  EXPECT_EQ(cost.bytes_written, 15 * 4);
+  EXPECT_EQ(cost.flops, 0);
+}
+
+}  // namespace
+}  // namespace profiling
+}  // namespace tflite
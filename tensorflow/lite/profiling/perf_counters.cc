@@ -0,0 +1,114 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/profiling/perf_counters.h"
+
+#include <cstdint>
+#include <memory>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif  // defined(__linux__)
+
+#include "tensorflow/lite/minimal_logging.h"
+
+namespace tflite {
+namespace profiling {
+
+#if defined(__linux__)
+
+namespace {
+
+int OpenCounter(uint64_t config, int group_fd) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = config;
+  attr.disabled = group_fd == -1 ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  // Counts the calling thread on any CPU.
+  return syscall(__NR_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1, group_fd,
+                 /*flags=*/0);
+}
+
+}  // namespace
+
+std::unique_ptr<PerfCounters> PerfCounters::Create() {
+  // The order matches the layout of the group read in Read().
+  static constexpr uint64_t kConfigs[kNumCounters] = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES};
+  std::unique_ptr<PerfCounters> counters(new PerfCounters());
+  for (int i = 0; i < kNumCounters; ++i) {
+    counters->fds_[i] = OpenCounter(kConfigs[i], counters->fds_[0]);
+    if (counters->fds_[i] == -1) {
+      TFLITE_LOG_PROD_ONCE(TFLITE_LOG_WARNING,
+                           "Hardware performance counters are unavailable: %s",
+                           std::strerror(errno));
+      return nullptr;
+    }
+  }
+  ioctl(counters->fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(counters->fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return counters;
+}
+
+PerfCounters::~PerfCounters() {
+  for (int fd : fds_) {
+    if (fd != -1) close(fd);
+  }
+}
+
+HardwareCounters PerfCounters::Read() const {
+  // With PERF_FORMAT_GROUP the leader returns the number of counters followed
+  // by their values.
+  uint64_t buffer[1 + kNumCounters] = {};
+  HardwareCounters values;
+  if (read(fds_[0], buffer, sizeof(buffer)) != sizeof(buffer) ||
+      buffer[0] != kNumCounters) {
+    return values;
+  }
+  values.cycles = buffer[1];
+  values.instructions = buffer[2];
+  values.cache_references = buffer[3];
+  values.cache_misses = buffer[4];
+  return values;
+}
+
+#else  // defined(__linux__)
+
+std::unique_ptr<PerfCounters> PerfCounters::Create() {
+  TFLITE_LOG_PROD_ONCE(
+      TFLITE_LOG_WARNING,
+      "Hardware performance counters are only supported on Linux.");
+  return nullptr;
+}
+
+PerfCounters::~PerfCounters() = default;
+
+HardwareCounters PerfCounters::Read() const { return HardwareCounters(); }
+
+#endif  // defined(__linux__)
+
+}  // namespace profiling
+}  // namespace tflite
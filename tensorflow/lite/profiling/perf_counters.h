@@ -0,0 +1,84 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_PROFILING_PERF_COUNTERS_H_
+#define TENSORFLOW_LITE_PROFILING_PERF_COUNTERS_H_
+
+#include <cstdint>
+#include <memory>
+
+namespace tflite {
+namespace profiling {
+
+// Values of the hardware counters read by PerfCounters.
+struct HardwareCounters {
+  uint64_t cycles = 0;
+  uint64_t instructions = 0;
+  uint64_t cache_references = 0;
+  uint64_t cache_misses = 0;
+
+  HardwareCounters operator-(const HardwareCounters& other) const {
+    HardwareCounters result;
+    result.cycles = cycles - other.cycles;
+    result.instructions = instructions - other.instructions;
+    result.cache_references = cache_references - other.cache_references;
+    result.cache_misses = cache_misses - other.cache_misses;
+    return result;
+  }
+
+  HardwareCounters& operator+=(const HardwareCounters& other) {
+    cycles += other.cycles;
+    instructions += other.instructions;
+    cache_references += other.cache_references;
+    cache_misses += other.cache_misses;
+    return *this;
+  }
+};
+
+// Counts the CPU cycles, retired instructions, last level cache references and
+// cache misses of the thread which created it, in user space only.
+// Work done by other threads, e.g. the worker threads of a multi-threaded
+// kernel, isn't counted.
+// It is only supported on Linux, and only if the kernel allows perf_event_open
+// (see /proc/sys/kernel/perf_event_paranoid), so callers must tolerate Create()
+// returning nullptr.
+//
+// WARNING: This is an experimental API and subject to change.
+class PerfCounters {
+ public:
+  // Returns nullptr if the counters aren't available.
+  static std::unique_ptr<PerfCounters> Create();
+
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  // Returns the current values of the counters. The values only make sense
+  // relative to another reading on the same thread.
+  HardwareCounters Read() const;
+
+ private:
+  static constexpr int kNumCounters = 4;
+
+  PerfCounters() = default;
+
+  // File descriptors of the counters, the first one being the group leader.
+  int fds_[kNumCounters] = {-1, -1, -1, -1};
+};
+
+}  // namespace profiling
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_PROFILING_PERF_COUNTERS_H_
@@ -0,0 +1,56 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/profiling/perf_counters.h"
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+namespace tflite {
+namespace profiling {
+namespace {
+
+TEST(PerfCountersTest, CountsWork) {
+  std::unique_ptr<PerfCounters> counters = PerfCounters::Create();
+  if (!counters) {
+    GTEST_SKIP() << "Hardware performance counters are unavailable.";
+  }
+  const HardwareCounters begin = counters->Read();
+  volatile int sum = 0;
+  for (int i = 0; i < 100000; ++i) sum += i;
+  const HardwareCounters delta = counters->Read() - begin;
+  EXPECT_GT(delta.cycles, 0);
+  EXPECT_GT(delta.instructions, 100000);
+  EXPECT_LE(delta.cache_misses, delta.cache_references);
+}
+
+TEST(PerfCountersTest, Arithmetic) {
+  HardwareCounters a;
+  a.cycles = 10;
+  a.instructions = 20;
+  HardwareCounters b;
+  b.cycles = 4;
+  b.instructions = 5;
+  const HardwareCounters difference = a - b;
+  EXPECT_EQ(difference.cycles, 6);
+  EXPECT_EQ(difference.instructions, 15);
+  a += b;
+  EXPECT_EQ(a.cycles, 14);
+  EXPECT_EQ(a.instructions, 25);
+}
+
+}  // namespace
+}  // namespace profiling
+}  // namespace tflite
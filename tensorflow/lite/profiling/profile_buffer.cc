@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/lite/logger.h"
 #include "tensorflow/lite/minimal_logging.h"
 #include "tensorflow/lite/profiling/memory_info.h"
+#include "tensorflow/lite/profiling/perf_counters.h"
 #include "tensorflow/lite/profiling/time.h"
 
 namespace tflite {
@@ -46,6 +47,10 @@ uint32_t ProfileBuffer::BeginEvent(const char* tag,
   event_buffer_[index].elapsed_time = 0;
   if (event_type != Profiler::EventType::OPERATOR_INVOKE_EVENT) {
     event_buffer_[index].begin_mem_usage = memory::GetMemoryUsage();
+  } else if (perf_counters_) {
+    event_buffer_[index].begin_hw_counters = perf_counters_->Read();
+  } else {
+    event_buffer_[index].begin_hw_counters = HardwareCounters();
   }
   current_index_++;
   return index;
@@ -70,6 +75,10 @@ void ProfileBuffer::EndEvent(uint32_t event_handle,
   if (event_buffer_[event_index].event_type !=
       Profiler::EventType::OPERATOR_INVOKE_EVENT) {
     event_buffer_[event_index].end_mem_usage = memory::GetMemoryUsage();
+  } else if (perf_counters_) {
+    event_buffer_[event_index].end_hw_counters = perf_counters_->Read();
+  } else {
+    event_buffer_[event_index].end_hw_counters = HardwareCounters();
   }
   if (event_metadata1) {
     event_buffer_[event_index].event_metadata = *event_metadata1;
@@ -109,6 +118,8 @@ void ProfileBuffer::AddEvent(const char* tag,
   event_buffer_[index].extra_event_metadata = event_metadata2;
   event_buffer_[index].begin_timestamp_us = 0;
   event_buffer_[index].elapsed_time = elapsed_time;
+  event_buffer_[index].begin_hw_counters = HardwareCounters();
+  event_buffer_[index].end_hw_counters = HardwareCounters();
   current_index_++;
 }
 
@@ -18,12 +18,14 @@ limitations under the License.
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "tensorflow/lite/core/api/profiler.h"
 #include "tensorflow/lite/profiling/memory_info.h"
+#include "tensorflow/lite/profiling/perf_counters.h"
 #include "tensorflow/lite/profiling/time.h"
 
 namespace tflite {
@@ -50,6 +52,11 @@ struct ProfileEvent {
   // The memory usage when the event ends.
   memory::MemoryUsage end_mem_usage;
 
+  // The hardware counters when the event begins and ends. Only recorded for
+  // OPERATOR_INVOKE_EVENT when the buffer has perf counters.
+  HardwareCounters begin_hw_counters;
+  HardwareCounters end_hw_counters;
+
   // The field containing the type of event. This must be one of the event types
   // in EventType.
   EventType event_type;
@@ -83,6 +90,13 @@ class ProfileBuffer {
   // Sets the enabled state of buffer to |enabled|
   void SetEnabled(bool enabled) { enabled_ = enabled; }
 
+  // Reads `perf_counters` when operator invoke events begin and end. They must
+  // have been created on the thread which invokes the operators.
+  void SetPerfCounters(std::unique_ptr<PerfCounters> perf_counters) {
+    perf_counters_ = std::move(perf_counters);
+  }
+  bool HasPerfCounters() const { return perf_counters_ != nullptr; }
+
   // Sets the end timestamp for event for the handle to current time.
   // If the buffer is disabled or previous event has been overwritten this
   // operation has not effect.
@@ -119,6 +133,7 @@ class ProfileBuffer {
   uint32_t current_index_;
   std::vector<ProfileEvent> event_buffer_;
   const bool allow_dynamic_expansion_;
+  std::unique_ptr<PerfCounters> perf_counters_;
 };
 
 }  // namespace profiling
@@ -15,15 +15,22 @@ limitations under the License.
 
 #include "tensorflow/lite/profiling/profile_summarizer.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "tensorflow/core/util/stats_calculator.h"
 #include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/core/api/profiler.h"
+#include "tensorflow/lite/core/subgraph.h"
 #include "tensorflow/lite/interpreter.h"
 #include "tensorflow/lite/profiling/memory_info.h"
+#include "tensorflow/lite/profiling/op_cost.h"
+#include "tensorflow/lite/profiling/perf_counters.h"
 #include "tensorflow/lite/profiling/profile_buffer.h"
 #include "tensorflow/lite/profiling/profile_summary_formatter.h"
 
@@ -144,6 +151,26 @@ void ProfileSummarizer::ProcessProfiles(
 
       stats_calculator->AddNodeStats(node_name_in_stats, type_in_stats,
                                      node_num, node_exec_time, 0 /*memory */);
+
+      const Subgraph* subgraph = interpreter.subgraph(subgraph_index);
+      const auto* node_and_reg =
+          subgraph ? subgraph->node_and_registration(node_index) : nullptr;
+      if (node_and_reg != nullptr) {
+        OpCostStats& op_stats =
+            op_cost_stats_[{static_cast<uint32_t>(subgraph_index),
+                            static_cast<uint32_t>(node_index)}];
+        if (op_stats.num_runs == 0) {
+          op_stats.name = node_name_in_stats;
+          op_stats.type = type_in_stats;
+        }
+        ++op_stats.num_runs;
+        op_stats.total_us += node_exec_time;
+        op_stats.cost += EstimateOpCost(*subgraph->context(),
+                                        node_and_reg->first,
+                                        node_and_reg->second);
+        op_stats.hw_counters += event->end_hw_counters -
+                                event->begin_hw_counters;
+      }
     } else if (event->event_type ==
                Profiler::EventType::DELEGATE_OPERATOR_INVOKE_EVENT) {
       const std::string node_name(event->tag);
@@ -210,6 +237,61 @@ void ProfileSummarizer::ProcessProfiles(
   SetSubgraphNameMap(interpreter);
 }
 
+std::string ProfileSummarizer::GetOpCostSummary() const {
+  std::vector<const OpCostStats*> ops;
+  bool has_hw_counters = false;
+  for (const auto& entry : op_cost_stats_) {
+    ops.push_back(&entry.second);
+    has_hw_counters |= entry.second.hw_counters.cycles > 0;
+  }
+  std::stable_sort(ops.begin(), ops.end(),
+                   [](const OpCostStats* a, const OpCostStats* b) {
+                     return a->total_us > b->total_us;
+                   });
+
+  std::stringstream stream;
+  char line[256];
+  stream << "============================== Op cost estimates "
+            "==============================\n";
+  snprintf(line, sizeof(line), "%-32s %10s %10s %10s %9s %9s %8s",
+           "[node type]", "[avg us]", "[MB read]", "[MB write]", "[GB/s]",
+           "[GFLOP/s]", "[FLOP/B]");
+  stream << line;
+  if (has_hw_counters) {
+    snprintf(line, sizeof(line), " %6s %7s", "[IPC]", "[miss%]");
+    stream << line;
+  }
+  stream << "\t[Name]\n";
+  for (const OpCostStats* op : ops) {
+    const double runs = op->num_runs;
+    const double total_bytes = op->cost.bytes_read + op->cost.bytes_written;
+    // Bytes (or FLOPs) per microsecond are MB/s, hence the division by 1e3.
+    const double us = std::max<int64_t>(op->total_us, 1);
+    snprintf(line, sizeof(line),
+             "%-32.32s %10.1f %10.3f %10.3f %9.2f %9.2f %8.2f",
+             op->type.c_str(), op->total_us / runs,
+             op->cost.bytes_read / runs / 1e6,
+             op->cost.bytes_written / runs / 1e6, total_bytes / us / 1e3,
+             op->cost.flops / us / 1e3,
+             total_bytes > 0 ? op->cost.flops / total_bytes : 0.0);
+    stream << line;
+    if (has_hw_counters) {
+      const HardwareCounters& counters = op->hw_counters;
+      snprintf(line, sizeof(line), " %6.2f %7.2f",
+               counters.cycles > 0
+                   ? static_cast<double>(counters.instructions) /
+                         counters.cycles
+                   : 0.0,
+               counters.cache_references > 0
+                   ? 100.0 * counters.cache_misses / counters.cache_references
+                   : 0.0);
+      stream << line;
+    }
+    stream << "\t" << op->name << "\n";
+  }
+  return stream.str();
+}
+
 tensorflow::StatsCalculator* ProfileSummarizer::GetStatsCalculator(
     uint32_t subgraph_index) {
   if (stats_calculator_map_.count(subgraph_index) == 0) {
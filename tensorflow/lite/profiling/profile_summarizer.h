@@ -20,10 +20,13 @@ limitations under the License.
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "tensorflow/core/util/stats_calculator.h"
 #include "tensorflow/lite/core/interpreter.h"
+#include "tensorflow/lite/profiling/op_cost.h"
+#include "tensorflow/lite/profiling/perf_counters.h"
 #include "tensorflow/lite/profiling/profile_buffer.h"
 #include "tensorflow/lite/profiling/profile_summary_formatter.h"
 
@@ -54,6 +57,14 @@ class ProfileSummarizer {
         stats_calculator_map_, *delegate_stats_calculator_, subgraph_name_map_);
   }
 
+  // Returns a table of the operators, slowest first, with their estimated
+  // memory traffic and arithmetic per run (see EstimateOpCost), the bandwidth
+  // and FLOP/s derived from their average run time, and their instructions per
+  // cycle and cache miss rate if hardware counters were recorded.
+  //
+  // WARNING: This is an experimental API and subject to change.
+  std::string GetOpCostSummary() const;
+
   tensorflow::StatsCalculator* GetStatsCalculator(uint32_t subgraph_index);
 
   bool HasProfiles() {
@@ -76,6 +87,19 @@ class ProfileSummarizer {
 
   std::map<uint32_t, std::string> subgraph_name_map_;
 
+  // Totals of an operator over all the processed runs.
+  struct OpCostStats {
+    std::string name;
+    std::string type;
+    int64_t num_runs = 0;
+    int64_t total_us = 0;
+    OpCost cost;
+    HardwareCounters hw_counters;
+  };
+
+  // Keyed by subgraph index and node index.
+  std::map<std::pair<uint32_t, uint32_t>, OpCostStats> op_cost_stats_;
+
   void SetSubgraphNameMap(const tflite::Interpreter& interpreter) {
     subgraph_name_map_.clear();
     for (int subgraph_index = 0; subgraph_index < interpreter.subgraphs_size();
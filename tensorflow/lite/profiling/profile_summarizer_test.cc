@@ -127,6 +127,23 @@ TEST(ProfileSummarizerTest, Interpreter) {
   ASSERT_TRUE(output.find("Invoke") == std::string::npos) << output;  // NOLINT
 }
 
+TEST(ProfileSummarizerTest, OpCostSummary) {
+  BufferedProfiler profiler(1024);
+  SimpleOpModel m;
+  m.Init(RegisterSimpleOp);
+  auto interpreter = m.GetInterpreter();
+  interpreter->SetProfiler(&profiler);
+  profiler.StartProfiling();
+  m.SetInputs(1, 2);
+  ASSERT_EQ(m.Invoke(), kTfLiteOk);
+  profiler.StopProfiling();
+  ProfileSummarizer summarizer;
+  summarizer.ProcessProfiles(profiler.GetProfileEvents(), *interpreter);
+  auto output = summarizer.GetOpCostSummary();
+  ASSERT_TRUE(output.find("[GB/s]") != std::string::npos) << output;
+  ASSERT_TRUE(output.find("SimpleOpEval") != std::string::npos) << output;
+}
+
 TEST(ProfileSummarizerTest, InterpreterPlusProfilingDetails) {
   BufferedProfiler profiler(1024);
   SimpleOpModel m;
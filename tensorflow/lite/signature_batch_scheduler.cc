@@ -0,0 +1,129 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/signature_batch_scheduler.h"
+
+#include <algorithm>
+#include <chrono>              // NOLINT(build/c++11)
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <cstddef>
+#include <memory>
+#include <mutex>   // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/signature_runner.h"
+
+namespace tflite {
+
+std::unique_ptr<SignatureBatchScheduler> SignatureBatchScheduler::Create(
+    SignatureRunner* runner, const SignatureBatchSchedulerOptions& options) {
+  if (runner == nullptr || options.max_batch_size < 1 ||
+      options.batch_timeout_micros < 0 || options.max_enqueued_requests < 0) {
+    return nullptr;
+  }
+  std::vector<size_t> input_bytes;
+  if (runner->GetBatchRequestInputBytes(&input_bytes) != kTfLiteOk) {
+    return nullptr;
+  }
+  std::unique_ptr<SignatureBatchScheduler> scheduler(
+      new SignatureBatchScheduler(runner, options, std::move(input_bytes)));
+  scheduler->thread_ = std::thread([s = scheduler.get()] { s->Run(); });
+  return scheduler;
+}
+
+SignatureBatchScheduler::~SignatureBatchScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  enqueued_.notify_all();
+  thread_.join();
+}
+
+TfLiteStatus SignatureBatchScheduler::Schedule(
+    SignatureRunnerBatchRequest* request, DoneCallback done) {
+  // InvokeBatch() fails the whole batch on a malformed request, so such a
+  // request is rejected before it is batched with others.
+  if (request->inputs.size() != input_bytes_.size()) return kTfLiteError;
+  for (size_t i = 0; i < input_bytes_.size(); ++i) {
+    if (request->inputs[i].size() != input_bytes_[i]) return kTfLiteError;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (options_.max_enqueued_requests > 0 &&
+        queue_.size() >= static_cast<size_t>(options_.max_enqueued_requests)) {
+      return kTfLiteError;
+    }
+    queue_.push_back(
+        {request, std::move(done), std::chrono::steady_clock::now()});
+  }
+  enqueued_.notify_one();
+  return kTfLiteOk;
+}
+
+TfLiteStatus SignatureBatchScheduler::Invoke(
+    SignatureRunnerBatchRequest* request) {
+  std::mutex mutex;
+  std::condition_variable finished;
+  bool done = false;
+  TfLiteStatus status = kTfLiteError;
+  TF_LITE_ENSURE_STATUS(Schedule(request, [&](TfLiteStatus batch_status) {
+    std::lock_guard<std::mutex> lock(mutex);
+    status = batch_status;
+    done = true;
+    finished.notify_one();
+  }));
+  std::unique_lock<std::mutex> lock(mutex);
+  finished.wait(lock, [&] { return done; });
+  return status;
+}
+
+void SignatureBatchScheduler::Run() {
+  const size_t max_batch_size = options_.max_batch_size;
+  std::vector<Task> batch;
+  std::vector<SignatureRunnerBatchRequest*> requests;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    enqueued_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+    if (queue_.empty()) return;
+    // Waits for a full batch until the oldest request times out. Stopping
+    // flushes the queue without waiting.
+    const auto deadline =
+        queue_.front().enqueue_time +
+        std::chrono::microseconds(options_.batch_timeout_micros);
+    enqueued_.wait_until(lock, deadline, [this, max_batch_size] {
+      return stopping_ || queue_.size() >= max_batch_size;
+    });
+
+    const size_t batch_size = std::min(queue_.size(), max_batch_size);
+    batch.clear();
+    requests.clear();
+    for (size_t i = 0; i < batch_size; ++i) {
+      requests.push_back(queue_.front().request);
+      batch.push_back(std::move(queue_.front()));
+      queue_.pop_front();
+    }
+    lock.unlock();
+    const TfLiteStatus status = runner_->InvokeBatch(requests);
+    for (Task& task : batch) {
+      task.done(status);
+    }
+    lock.lock();
+  }
+}
+
+}  // namespace tflite
@@ -0,0 +1,136 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_LITE_SIGNATURE_BATCH_SCHEDULER_H_
+#define TENSORFLOW_LITE_SIGNATURE_BATCH_SCHEDULER_H_
+
+#include <chrono>              // NOLINT(build/c++11)
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>   // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/signature_runner.h"
+
+namespace tflite {
+
+/// Options of a `SignatureBatchScheduler`.
+///
+/// WARNING: This is an experimental API and subject to change.
+struct SignatureBatchSchedulerOptions {
+  /// The maximum number of requests run together by one
+  /// `SignatureRunner::InvokeBatch`.
+  int max_batch_size = 8;
+  /// How long the oldest waiting request waits for the batch to fill up
+  /// before the batch runs anyway, in microseconds.
+  int64_t batch_timeout_micros = 1000;
+  /// The maximum number of waiting requests. Requests scheduled beyond it are
+  /// rejected, so that callers can shed load. 0 means no limit.
+  int max_enqueued_requests = 1024;
+};
+
+/// Serves requests from many threads with a single `SignatureRunner` by
+/// grouping them into batches, like TensorFlow's `BasicBatchScheduler`.
+///
+/// A dedicated thread takes the waiting requests in arrival order and runs
+/// them with `SignatureRunner::InvokeBatch` as soon as `max_batch_size` of
+/// them are waiting, or when the oldest one has waited for
+/// `batch_timeout_micros`. The timeout bounds the latency added to a request
+/// when the traffic is too low to fill batches.
+///
+/// Example:
+///
+/// <pre><code>
+/// auto scheduler = SignatureBatchScheduler::Create(runner, options);
+/// ...
+/// // On any thread:
+/// SignatureRunnerBatchRequest request;
+/// request.inputs = {...};
+/// if (scheduler->Invoke(&request) == kTfLiteOk) {
+///   // Use request.outputs.
+/// }
+/// </code></pre>
+///
+/// WARNING: This is an experimental API and subject to change.
+class SignatureBatchScheduler {
+ public:
+  /// Called on the batching thread with the status of the batch of the
+  /// request once its outputs are filled.
+  using DoneCallback = std::function<void(TfLiteStatus)>;
+
+  /// Starts the batching thread. `runner` must have allocated its tensors,
+  /// must outlive the scheduler and must not be used by anything else while
+  /// the scheduler exists. Returns nullptr if `options` are invalid or if
+  /// `runner` has inputs `InvokeBatch` doesn't support.
+  static std::unique_ptr<SignatureBatchScheduler> Create(
+      SignatureRunner* runner, const SignatureBatchSchedulerOptions& options);
+
+  /// Runs the waiting requests, then stops the batching thread.
+  ~SignatureBatchScheduler();
+
+  SignatureBatchScheduler(const SignatureBatchScheduler&) = delete;
+  SignatureBatchScheduler& operator=(const SignatureBatchScheduler&) = delete;
+
+  /// Enqueues `request`, which must stay valid until `done` is called.
+  /// Returns kTfLiteError without calling `done` if the queue is full or if
+  /// the inputs of `request` don't match the signature, so that a malformed
+  /// request doesn't fail the requests batched with it.
+  TfLiteStatus Schedule(SignatureRunnerBatchRequest* request,
+                        DoneCallback done);
+
+  /// Enqueues `request` and waits for its batch to run. Returns the status of
+  /// the batch, or kTfLiteError if `Schedule` rejects the request.
+  TfLiteStatus Invoke(SignatureRunnerBatchRequest* request);
+
+ private:
+  struct Task {
+    SignatureRunnerBatchRequest* request;
+    DoneCallback done;
+    std::chrono::steady_clock::time_point enqueue_time;
+  };
+
+  SignatureBatchScheduler(SignatureRunner* runner,
+                          const SignatureBatchSchedulerOptions& options,
+                          std::vector<size_t> input_bytes)
+      : runner_(runner),
+        options_(options),
+        input_bytes_(std::move(input_bytes)) {}
+
+  // The loop of the batching thread.
+  void Run();
+
+  SignatureRunner* const runner_;
+  const SignatureBatchSchedulerOptions options_;
+  // The size in bytes of each input of a request.
+  const std::vector<size_t> input_bytes_;
+
+  std::mutex mutex_;
+  // Signaled when a request is enqueued or the scheduler stops.
+  std::condition_variable enqueued_;
+  std::deque<Task> queue_;
+  bool stopping_ = false;
+
+  std::thread thread_;
+};
+
+}  // namespace tflite
+
+#endif  // TENSORFLOW_LITE_SIGNATURE_BATCH_SCHEDULER_H_
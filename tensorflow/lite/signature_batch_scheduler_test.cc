@@ -0,0 +1,171 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/lite/signature_batch_scheduler.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/lite/core/c/common.h"
+#include "tensorflow/lite/core/kernels/builtin_op_kernels.h"
+#include "tensorflow/lite/interpreter_test_util.h"
+#include "tensorflow/lite/signature_runner.h"
+
+namespace tflite {
+namespace {
+
+class SignatureBatchSchedulerTest : public InterpreterTest {
+ protected:
+  // Builds a signature negating an input of shape [batch, 2].
+  SignatureRunner* BuildNegSignature() {
+    const std::vector<int> dims_signature = {-1, 2};
+    interpreter_->AddTensors(2);
+    interpreter_->SetInputs({0});
+    interpreter_->SetOutputs({1});
+    for (int i = 0; i < 2; ++i) {
+      interpreter_->SetTensorParametersReadWrite(
+          i, kTfLiteFloat32, "", {1, 2}, TfLiteQuantizationParams(),
+          /*is_variable=*/false, &dims_signature);
+    }
+    interpreter_->AddNodeWithParameters({0}, {1}, nullptr, 0, nullptr,
+                                        ops::builtin::Register_NEG());
+    BuildSignature("serve", {{"x", 0}}, {{"y", 1}});
+    SignatureRunner* runner = interpreter_->GetSignatureRunner("serve");
+    if (runner != nullptr && runner->AllocateTensors() != kTfLiteOk) {
+      return nullptr;
+    }
+    return runner;
+  }
+
+  static SignatureRunnerBatchRequest MakeRequest(float x0, float x1) {
+    const float values[2] = {x0, x1};
+    SignatureRunnerBatchRequest request;
+    request.inputs.emplace_back(sizeof(values));
+    std::memcpy(request.inputs[0].data(), values, sizeof(values));
+    return request;
+  }
+
+  static float Output(const SignatureRunnerBatchRequest& request, int index) {
+    float value;
+    std::memcpy(&value, request.outputs[0].data() + index * sizeof(float),
+                sizeof(float));
+    return value;
+  }
+};
+
+TEST_F(SignatureBatchSchedulerTest, ServesConcurrentRequests) {
+  SignatureRunner* runner = BuildNegSignature();
+  ASSERT_NE(runner, nullptr);
+  SignatureBatchSchedulerOptions options;
+  options.max_batch_size = 4;
+  auto scheduler = SignatureBatchScheduler::Create(runner, options);
+  ASSERT_NE(scheduler, nullptr);
+
+  std::atomic<int> num_failures(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&scheduler, &num_failures, t] {
+      for (int i = 0; i < 20; ++i) {
+        SignatureRunnerBatchRequest request = MakeRequest(t, i);
+        if (scheduler->Invoke(&request) != kTfLiteOk ||
+            Output(request, 0) != -t || Output(request, 1) != -i) {
+          ++num_failures;
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_failures, 0);
+}
+
+TEST_F(SignatureBatchSchedulerTest, RejectsRequestsWhenFull) {
+  SignatureRunner* runner = BuildNegSignature();
+  ASSERT_NE(runner, nullptr);
+  SignatureBatchSchedulerOptions options;
+  // Requests wait for a batch which never fills up.
+  options.max_batch_size = 100;
+  options.batch_timeout_micros = 60 * 1000 * 1000;
+  options.max_enqueued_requests = 2;
+  auto scheduler = SignatureBatchScheduler::Create(runner, options);
+  ASSERT_NE(scheduler, nullptr);
+
+  std::vector<SignatureRunnerBatchRequest> requests = {
+      MakeRequest(1, 2), MakeRequest(3, 4), MakeRequest(5, 6)};
+  std::atomic<int> num_done(0);
+  auto done = [&num_done](TfLiteStatus status) {
+    EXPECT_EQ(status, kTfLiteOk);
+    ++num_done;
+  };
+  EXPECT_EQ(scheduler->Schedule(&requests[0], done), kTfLiteOk);
+  EXPECT_EQ(scheduler->Schedule(&requests[1], done), kTfLiteOk);
+  EXPECT_EQ(scheduler->Schedule(&requests[2], done), kTfLiteError);
+
+  // Destroying the scheduler runs the waiting requests.
+  scheduler.reset();
+  EXPECT_EQ(num_done, 2);
+  EXPECT_EQ(Output(requests[1], 0), -3);
+  EXPECT_EQ(Output(requests[1], 1), -4);
+}
+
+TEST_F(SignatureBatchSchedulerTest, RejectsOnlyMalformedRequests) {
+  SignatureRunner* runner = BuildNegSignature();
+  ASSERT_NE(runner, nullptr);
+  SignatureBatchSchedulerOptions options;
+  options.max_batch_size = 3;
+  options.batch_timeout_micros = 60 * 1000 * 1000;
+  auto scheduler = SignatureBatchScheduler::Create(runner, options);
+  ASSERT_NE(scheduler, nullptr);
+
+  std::vector<SignatureRunnerBatchRequest> requests = {
+      MakeRequest(1, 2), MakeRequest(3, 4), MakeRequest(5, 6)};
+  // An extra float, and a missing input.
+  SignatureRunnerBatchRequest too_long = MakeRequest(7, 8);
+  too_long.inputs[0].resize(3 * sizeof(float));
+  SignatureRunnerBatchRequest no_inputs;
+  std::atomic<int> num_done(0);
+  auto done = [&num_done](TfLiteStatus status) {
+    EXPECT_EQ(status, kTfLiteOk);
+    ++num_done;
+  };
+  EXPECT_EQ(scheduler->Schedule(&requests[0], done), kTfLiteOk);
+  EXPECT_EQ(scheduler->Schedule(&too_long, done), kTfLiteError);
+  EXPECT_EQ(scheduler->Schedule(&requests[1], done), kTfLiteOk);
+  EXPECT_EQ(scheduler->Invoke(&no_inputs), kTfLiteError);
+  // Fills the batch, which runs the well-formed requests together.
+  EXPECT_EQ(scheduler->Invoke(&requests[2]), kTfLiteOk);
+
+  scheduler.reset();
+  EXPECT_EQ(num_done, 2);
+  for (int r = 0; r < 3; ++r) {
+    EXPECT_EQ(Output(requests[r], 0), -(2 * r + 1));
+    EXPECT_EQ(Output(requests[r], 1), -(2 * r + 2));
+  }
+}
+
+TEST_F(SignatureBatchSchedulerTest, RejectsInvalidOptions) {
+  SignatureRunner* runner = BuildNegSignature();
+  ASSERT_NE(runner, nullptr);
+  SignatureBatchSchedulerOptions options;
+  options.max_batch_size = 0;
+  EXPECT_EQ(SignatureBatchScheduler::Create(runner, options), nullptr);
+}
+
+}  // namespace
+}  // namespace tflite
@@ -27,6 +27,7 @@ limitations under the License.
 
 namespace tflite {
 using SignatureRunner = ::tflite::impl::SignatureRunner;
+using SignatureRunnerBatchRequest = ::tflite::impl::SignatureRunnerBatchRequest;
 }  // namespace tflite
 
 #endif  // TENSORFLOW_LITE_SIGNATURE_RUNNER_H_
@@ -63,6 +63,10 @@ limitations under the License.
 #include "tensorflow/lite/tools/model_loader.h"
 #include "tensorflow/lite/tools/utils.h"
 
+#ifndef TFLITE_WITHOUT_XNNPACK
+#include "tensorflow/lite/delegates/xnnpack/weight_cache.h"
+#endif  // !defined(TFLITE_WITHOUT_XNNPACK)
+
 void RegisterSelectedOps(::tflite::MutableOpResolver* resolver);
 
 // Version with Weak linker attribute doing nothing: if someone links this
@@ -514,6 +518,16 @@ TfLiteStatus BenchmarkInterpreterRunner::Invoke() {
   }
 }
 
+TfLiteStatus BenchmarkInterpreterRunner::InvokeBatch(
+    const std::vector<SignatureRunnerBatchRequest*>& requests) {
+  if (signature_runner_ == nullptr) {
+    TFLITE_LOG(ERROR) << "Batched requests need a signature, see "
+                         "--signature_to_run_for.";
+    return kTfLiteError;
+  }
+  return signature_runner_->InvokeBatch(requests);
+}
+
 const std::vector<int>& BenchmarkInterpreterRunner::execution_plan() const {
   if (signature_runner_ != nullptr) {
     return subgraph_->execution_plan();
@@ -568,6 +582,8 @@ BenchmarkParams BenchmarkTfLiteModel::DefaultParams() {
   default_params.AddParam("graph", BenchmarkParam::Create<std::string>(""));
   default_params.AddParam("signature_to_run_for",
                           BenchmarkParam::Create<std::string>(""));
+  default_params.AddParam("batch_requests",
+                          BenchmarkParam::Create<int32_t>(0));
   default_params.AddParam("list_signatures",
                           BenchmarkParam::Create<bool>(false));
   default_params.AddParam("input_layer",
@@ -589,6 +605,12 @@ BenchmarkParams BenchmarkTfLiteModel::DefaultParams() {
       BenchmarkParam::Create<std::string>(kOpProfilingOutputModeStdout));
   default_params.AddParam("op_profiling_output_file",
                           BenchmarkParam::Create<std::string>(""));
+  default_params.AddParam("op_profiling_cost_summary",
+                          BenchmarkParam::Create<bool>(false));
+  default_params.AddParam("op_profiling_perf_counters",
+                          BenchmarkParam::Create<bool>(false));
+  default_params.AddParam("op_profiling_chrome_trace_file",
+                          BenchmarkParam::Create<std::string>(""));
   default_params.AddParam("max_profiling_buffer_entries",
                           BenchmarkParam::Create<int32_t>(1024));
   default_params.AddParam("allow_dynamic_profiling_buffer_increase",
@@ -611,6 +633,12 @@ BenchmarkParams BenchmarkTfLiteModel::DefaultParams() {
                           BenchmarkParam::Create<bool>(false));
   default_params.AddParam("enable_builtin_cast_constant_cache",
                           BenchmarkParam::Create<bool>(false));
+  default_params.AddParam("inter_op_parallelism",
+                          BenchmarkParam::Create<int32_t>(0));
+  default_params.AddParam("prepare_in_parallel",
+                          BenchmarkParam::Create<bool>(false));
+  default_params.AddParam("xnnpack_weight_cache_dir",
+                          BenchmarkParam::Create<std::string>(""));
   default_params.AddParam("output_filepath",
                           BenchmarkParam::Create<std::string>(""));
   default_params.AddParam("output_proto_filepath",
@@ -638,6 +666,8 @@ BenchmarkTfLiteModel::BenchmarkTfLiteModel(BenchmarkParams params)
 void BenchmarkTfLiteModel::CleanUp() {
   // Free up any pre-allocated tensor data during PrepareInputData.
   inputs_data_.clear();
+  batch_request_ptrs_.clear();
+  batch_requests_.clear();
 }
 
 BenchmarkTfLiteModel::~BenchmarkTfLiteModel() {
@@ -686,6 +716,15 @@ std::vector<Flag> BenchmarkTfLiteModel::GetFlags() {
           "'stdout', 'csv' and 'proto'."),
       CreateFlag<std::string>("op_profiling_output_file", &params_,
                               "Output file for op profiling results."),
+      CreateFlag<bool>("op_profiling_cost_summary", &params_,
+                       "Log the estimated memory traffic and FLOP/s of each "
+                       "op."),
+      CreateFlag<bool>("op_profiling_perf_counters", &params_,
+                       "Record the cycles, instructions and cache misses of "
+                       "each op with the Linux perf_event hardware counters."),
+      CreateFlag<std::string>("op_profiling_chrome_trace_file", &params_,
+                              "Output file for a Chrome trace of the op "
+                              "invocations."),
       CreateFlag<int32_t>("max_profiling_buffer_entries", &params_,
                           "max initial profiling buffer entries"),
       CreateFlag<bool>("allow_dynamic_profiling_buffer_increase", &params_,
@@ -720,6 +759,19 @@ std::vector<Flag> BenchmarkTfLiteModel::GetFlags() {
           "enable_builtin_cast_constant_cache", &params_,
           "Cache the output of the builtin cast operation when its input "
           "is a constant tensor."),
+      CreateFlag<int32_t>(
+          "inter_op_parallelism", &params_,
+          "The number of threads running independent nodes concurrently. 0 "
+          "or 1 runs the nodes one after another."),
+      CreateFlag<bool>(
+          "prepare_in_parallel", &params_,
+          "Prepare independent nodes concurrently on the inter-op threads "
+          "when allocating tensors. Requires inter_op_parallelism > 1."),
+      CreateFlag<std::string>(
+          "xnnpack_weight_cache_dir", &params_,
+          "Directory of the XNNPACK weight cache files, keyed by the model, "
+          "XNNPACK build and CPU features. Overrides "
+          "--xnnpack_weight_cache_file_path."),
       CreateFlag<std::string>(
           "output_filepath", &params_,
           "File path to export outputs layer as binary data."),
@@ -747,7 +799,12 @@ std::vector<Flag> BenchmarkTfLiteModel::GetFlags() {
           "default signature will be used."),
       CreateFlag<bool>("list_signatures", &params_,
                        "Displays all signatures present in the model and then "
-                       "terminates the program.")};
+                       "terminates the program."),
+      CreateFlag<int32_t>(
+          "batch_requests", &params_,
+          "If positive, each inference serves this many requests with "
+          "SignatureRunner::InvokeBatch, stacked along the batch dimension if "
+          "the signature has a dynamic one.")};
 
   flags.insert(flags.end(), specific_flags.begin(), specific_flags.end());
 
@@ -766,6 +823,8 @@ void BenchmarkTfLiteModel::LogParams() {
                       /*verbose*/ true);
   LOG_BENCHMARK_PARAM(bool, "list_signatures",
                       "List signatures from the provided model", false);
+  LOG_BENCHMARK_PARAM(int32_t, "batch_requests", "Batched requests per run",
+                      verbose);
   LOG_BENCHMARK_PARAM(std::string, "input_layer", "Input layers", verbose);
   LOG_BENCHMARK_PARAM(std::string, "input_layer_shape", "Input shapes",
                       verbose);
@@ -783,6 +842,12 @@ void BenchmarkTfLiteModel::LogParams() {
                       "Op profiling output mode.", verbose);
   LOG_BENCHMARK_PARAM(std::string, "op_profiling_output_file",
                       "Op profiling output file.", verbose);
+  LOG_BENCHMARK_PARAM(bool, "op_profiling_cost_summary",
+                      "Op profiling cost summary", verbose);
+  LOG_BENCHMARK_PARAM(bool, "op_profiling_perf_counters",
+                      "Op profiling hardware counters", verbose);
+  LOG_BENCHMARK_PARAM(std::string, "op_profiling_chrome_trace_file",
+                      "Op profiling Chrome trace file", verbose);
   LOG_BENCHMARK_PARAM(int32_t, "max_profiling_buffer_entries",
                       "Max initial profiling buffer entries", verbose);
   LOG_BENCHMARK_PARAM(bool, "allow_dynamic_profiling_buffer_increase",
@@ -806,6 +871,12 @@ void BenchmarkTfLiteModel::LogParams() {
                       "Disable delegate clustering", verbose);
   LOG_BENCHMARK_PARAM(bool, "enable_builtin_cast_constant_cache",
                       "Constant CAST output cache", verbose);
+  LOG_BENCHMARK_PARAM(int32_t, "inter_op_parallelism",
+                      "Inter-op parallelism", verbose);
+  LOG_BENCHMARK_PARAM(bool, "prepare_in_parallel",
+                      "Prepare independent nodes in parallel", verbose);
+  LOG_BENCHMARK_PARAM(std::string, "xnnpack_weight_cache_dir",
+                      "XNNPACK weight cache directory", verbose);
   LOG_BENCHMARK_PARAM(std::string, "output_filepath",
                       "File path to export outputs layer to", verbose);
   LOG_BENCHMARK_PARAM(std::string, "output_proto_filepath",
@@ -990,10 +1061,55 @@ TfLiteStatus BenchmarkTfLiteModel::PrepareInputData() {
     }
     inputs_data_.push_back(std::move(t_data));
   }
+  if (params_.Get<int32_t>("batch_requests") > 0) {
+    TF_LITE_ENSURE_STATUS(PrepareBatchRequests());
+  }
+  return kTfLiteOk;
+}
+
+TfLiteStatus BenchmarkTfLiteModel::PrepareBatchRequests() {
+  SignatureRunner* signature_runner = interpreter_runner_->signature_runner();
+  if (signature_runner == nullptr) {
+    TFLITE_LOG(ERROR) << "--batch_requests needs a signature, see "
+                         "--signature_to_run_for.";
+    return kTfLiteError;
+  }
+  // Each request takes the first example of the input data, or all of it if
+  // the signature has no dynamic batch dimension.
+  const bool batched = signature_runner->HasDynamicBatch();
+  const std::vector<const char*>& input_names = signature_runner->input_names();
+  const std::vector<const char*>& subgraph_input_names =
+      signature_runner->subgraph_input_names();
+  SignatureRunnerBatchRequest example;
+  example.inputs.resize(input_names.size());
+  for (size_t j = 0; j < subgraph_input_names.size(); ++j) {
+    const TfLiteTensor* t =
+        signature_runner->input_tensor(subgraph_input_names[j]);
+    size_t bytes = inputs_data_[j].bytes;
+    if (batched && t->dims->data[0] > 0) bytes /= t->dims->data[0];
+    const uint8_t* data =
+        static_cast<const uint8_t*>(inputs_data_[j].data.get());
+    const auto it = std::find_if(
+        input_names.begin(), input_names.end(), [&](const char* name) {
+          return std::string(name) == subgraph_input_names[j];
+        });
+    example.inputs[it - input_names.begin()].assign(data, data + bytes);
+  }
+  const int num_requests = params_.Get<int32_t>("batch_requests");
+  batch_requests_.assign(num_requests, example);
+  for (SignatureRunnerBatchRequest& request : batch_requests_) {
+    batch_request_ptrs_.push_back(&request);
+  }
+  TFLITE_LOG(INFO) << "Each inference runs " << num_requests
+                   << (batched ? " requests stacked into one batch."
+                               : " requests one after another, as the "
+                                 "signature has no dynamic batch dimension.");
   return kTfLiteOk;
 }
 
 TfLiteStatus BenchmarkTfLiteModel::ResetInputsAndOutputs() {
+  // Batched requests hold their own copy of the input data.
+  if (!batch_request_ptrs_.empty()) return kTfLiteOk;
   const std::vector<int>& runner_inputs = interpreter_runner_->inputs();
   // Set the values of the input tensors from inputs_data_.
   for (int j = 0; j < runner_inputs.size(); ++j) {
@@ -1035,6 +1151,8 @@ TfLiteStatus BenchmarkTfLiteModel::InitInterpreter() {
       params_.Get<bool>("disable_delegate_clustering"));
   options.SetCacheConstantCastOp(
       params_.Get<bool>("enable_builtin_cast_constant_cache"));
+  options.SetInterOpParallelism(params_.Get<int32_t>("inter_op_parallelism"));
+  options.SetPrepareInParallel(params_.Get<bool>("prepare_in_parallel"));
 
   tflite::InterpreterBuilder builder(*model_, *resolver, &options);
   if (builder.SetNumThreads(num_threads) != kTfLiteOk) {
@@ -1065,6 +1183,9 @@ TfLiteStatus BenchmarkTfLiteModel::InitInterpreter() {
 
 TfLiteStatus BenchmarkTfLiteModel::Init() {
   TF_LITE_ENSURE_STATUS(LoadModel());
+  const std::string weight_cache_path = GetXnnpackWeightCachePath();
+  const bool weight_cache_existed =
+      !weight_cache_path.empty() && std::ifstream(weight_cache_path).good();
   TF_LITE_ENSURE_STATUS(InitInterpreter());
 
   if (params_.Get<bool>("list_signatures")) {
@@ -1108,9 +1229,15 @@ TfLiteStatus BenchmarkTfLiteModel::Init() {
 
   interpreter_->SetAllowFp16PrecisionForFp32(params_.Get<bool>("allow_fp16"));
 
+  std::string signature_key = params_.Get<std::string>("signature_to_run_for");
+  // Batched requests run through a signature, the only one by default.
+  if (signature_key.empty() && params_.Get<int32_t>("batch_requests") > 0 &&
+      interpreter_->signature_keys().size() == 1) {
+    signature_key = *interpreter_->signature_keys()[0];
+  }
   std::pair<TfLiteStatus, std::unique_ptr<BenchmarkInterpreterRunner>>
-      status_and_runner = BenchmarkInterpreterRunner::Create(
-          interpreter_.get(), params_.Get<std::string>("signature_to_run_for"));
+      status_and_runner =
+          BenchmarkInterpreterRunner::Create(interpreter_.get(), signature_key);
 
   TF_LITE_ENSURE_STATUS(status_and_runner.first);
   interpreter_runner_ = std::move(status_and_runner.second);
@@ -1239,6 +1366,19 @@ TfLiteStatus BenchmarkTfLiteModel::Init() {
     return kTfLiteError;
   }
 
+  // Compare the initialization time of a run which loads the packed weights
+  // with one which packs them.
+  if (!weight_cache_path.empty()) {
+    if (weight_cache_existed) {
+      TFLITE_LOG(INFO) << "XNNPACK packed weights loaded from "
+                       << weight_cache_path;
+    } else {
+      TFLITE_LOG(INFO) << "XNNPACK weights packed and saved to "
+                       << weight_cache_path
+                       << ", the next runs will load them.";
+    }
+  }
+
   AddOwnedListener(
       std::unique_ptr<BenchmarkListener>(new RuyProfileListener()));
 
@@ -1248,6 +1388,24 @@ TfLiteStatus BenchmarkTfLiteModel::Init() {
   return kTfLiteOk;
 }
 
+std::string BenchmarkTfLiteModel::GetXnnpackWeightCachePath() {
+  if (!params_.HasParam("use_xnnpack") || !params_.Get<bool>("use_xnnpack")) {
+    return "";
+  }
+#ifndef TFLITE_WITHOUT_XNNPACK
+  const std::string directory =
+      params_.Get<std::string>("xnnpack_weight_cache_dir");
+  if (!directory.empty()) {
+    const Allocation* allocation = model_->allocation();
+    params_.Set<std::string>(
+        "xnnpack_weight_cache_file_path",
+        xnnpack::GetWeightCacheFilePath(directory, allocation->base(),
+                                        allocation->bytes()));
+  }
+#endif  // !defined(TFLITE_WITHOUT_XNNPACK)
+  return params_.Get<std::string>("xnnpack_weight_cache_file_path");
+}
+
 TfLiteStatus BenchmarkTfLiteModel::LoadModel() {
   std::string fd_or_graph_path = params_.Get<std::string>("graph");
   model_loader_ = tools::CreateModelLoaderFromPath(fd_or_graph_path);
@@ -1290,15 +1448,30 @@ std::unique_ptr<BenchmarkListener>
 BenchmarkTfLiteModel::MayCreateProfilingListener() const {
   if (!params_.Get<bool>("enable_op_profiling")) return nullptr;
 
-  return std::unique_ptr<BenchmarkListener>(new ProfilingListener(
+  auto listener = std::make_unique<ProfilingListener>(
       interpreter_.get(), params_.Get<int32_t>("max_profiling_buffer_entries"),
       params_.Get<bool>("allow_dynamic_profiling_buffer_increase"),
       params_.Get<std::string>("op_profiling_output_file"),
       CreateProfileSummaryFormatter(
-          params_.Get<std::string>("op_profiling_output_mode"))));
+          params_.Get<std::string>("op_profiling_output_mode")));
+  if (params_.Get<bool>("op_profiling_cost_summary") ||
+      params_.Get<bool>("op_profiling_perf_counters")) {
+    listener->EnableOpCostSummary();
+  }
+  if (params_.Get<bool>("op_profiling_perf_counters") &&
+      !listener->EnablePerfCounters()) {
+    TFLITE_LOG(WARN) << "Hardware counters are unavailable, only the "
+                        "estimated op costs will be reported.";
+  }
+  listener->SetChromeTraceFilePath(
+      params_.Get<std::string>("op_profiling_chrome_trace_file"));
+  return listener;
 }
 
 TfLiteStatus BenchmarkTfLiteModel::RunImpl() {
+  if (!batch_request_ptrs_.empty()) {
+    return interpreter_runner_->InvokeBatch(batch_request_ptrs_);
+  }
   return interpreter_runner_->Invoke();
 }
 
@@ -88,6 +88,16 @@ class BenchmarkInterpreterRunner {
   // the given signature in dependency order).
   TfLiteStatus Invoke();
 
+  // Runs `requests` with SignatureRunner::InvokeBatch. Fails if no signature
+  // is used.
+  TfLiteStatus InvokeBatch(
+      const std::vector<SignatureRunnerBatchRequest*>& requests);
+
+  // Returns the signature runner, or nullptr if no signature is used.
+  tflite::SignatureRunner* signature_runner() const {
+    return signature_runner_.get();
+  }
+
   // Return vector of node indices in the order of execution.
   //
   // This is a list of node indices (to index into nodes_and_registration).
@@ -204,6 +214,14 @@ class BenchmarkTfLiteModel : public BenchmarkModel {
   utils::InputTensorData CreateRandomTensorData(
       const TfLiteTensor& t, const InputLayerInfo* layer_info);
 
+  // Returns the path of the XNNPACK weight cache file, if any, after resolving
+  // --xnnpack_weight_cache_dir for the loaded model.
+  std::string GetXnnpackWeightCachePath();
+
+  // Fills batch_requests_ with --batch_requests copies of one example of the
+  // input data.
+  TfLiteStatus PrepareBatchRequests();
+
   void AddOwnedListener(std::unique_ptr<BenchmarkListener> listener) {
     if (listener == nullptr) return;
     owned_listeners_.emplace_back(std::move(listener));
@@ -216,6 +234,9 @@ class BenchmarkTfLiteModel : public BenchmarkModel {
   // Always TFLITE_LOG the benchmark result.
   BenchmarkLoggingListener log_output_;
   std::unique_ptr<tools::ModelLoader> model_loader_;
+  // The requests run by each inference when --batch_requests is set.
+  std::vector<SignatureRunnerBatchRequest> batch_requests_;
+  std::vector<SignatureRunnerBatchRequest*> batch_request_ptrs_;
 };
 
 }  // namespace benchmark
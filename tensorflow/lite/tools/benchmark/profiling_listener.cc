@@ -20,6 +20,7 @@ limitations under the License.
 #include <string>
 
 #include "tensorflow/lite/interpreter.h"
+#include "tensorflow/lite/profiling/chrome_trace.h"
 #include "tensorflow/lite/profiling/profile_summarizer.h"
 #include "tensorflow/lite/profiling/profile_summary_formatter.h"
 #include "tensorflow/lite/tools/benchmark/benchmark_model.h"
@@ -70,12 +71,27 @@ void ProfilingListener::OnSingleRunEnd() {
   profiler_.StopProfiling();
   auto profile_events = profiler_.GetProfileEvents();
   run_summarizer_.ProcessProfiles(profile_events, *interpreter_);
+  if (!chrome_trace_file_path_.empty()) {
+    chrome_trace_.AddEvents(profile_events, *interpreter_);
+  }
 }
 
 void ProfilingListener::OnBenchmarkEnd(const BenchmarkResults& results) {
   summarizer_formatter_->HandleOutput(init_summarizer_.GetOutputString(),
                                       run_summarizer_.GetOutputString(),
                                       output_file_path_);
+  if (log_op_cost_summary_) {
+    TFLITE_LOG(INFO) << run_summarizer_.GetOpCostSummary();
+  }
+  if (!chrome_trace_file_path_.empty()) {
+    if (chrome_trace_.WriteToFile(chrome_trace_file_path_)) {
+      TFLITE_LOG(INFO) << "Chrome trace of " << chrome_trace_.size()
+                       << " events written to " << chrome_trace_file_path_;
+    } else {
+      TFLITE_LOG(ERROR) << "Failed to write the Chrome trace to "
+                        << chrome_trace_file_path_;
+    }
+  }
 }
 
 }  // namespace benchmark
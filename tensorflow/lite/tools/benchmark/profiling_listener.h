@@ -22,6 +22,7 @@ limitations under the License.
 
 #include "tensorflow/lite/interpreter.h"
 #include "tensorflow/lite/profiling/buffered_profiler.h"
+#include "tensorflow/lite/profiling/chrome_trace.h"
 #include "tensorflow/lite/profiling/profile_summarizer.h"
 #include "tensorflow/lite/profiling/profile_summary_formatter.h"
 #include "tensorflow/lite/tools/benchmark/benchmark_model.h"
@@ -40,6 +41,21 @@ class ProfilingListener : public BenchmarkListener {
       std::shared_ptr<profiling::ProfileSummaryFormatter> summarizer_formatter =
           std::make_shared<profiling::ProfileSummaryDefaultFormatter>());
 
+  // Records the hardware counters of the calling thread around each op. Must
+  // be called on the thread which invokes the interpreter. Returns false if the
+  // counters are unavailable.
+  bool EnablePerfCounters() { return profiler_.EnablePerfCounters(); }
+
+  // Logs the estimated memory traffic, FLOP/s and hardware counters of each op
+  // at the end of the benchmark.
+  void EnableOpCostSummary() { log_op_cost_summary_ = true; }
+
+  // Writes the events of the regular runs to `path` as a Chrome trace at the
+  // end of the benchmark.
+  void SetChromeTraceFilePath(const std::string& path) {
+    chrome_trace_file_path_ = path;
+  }
+
   void OnBenchmarkStart(const BenchmarkParams& params) override;
 
   void OnSingleRunStart(RunType run_type) override;
@@ -57,6 +73,9 @@ class ProfilingListener : public BenchmarkListener {
   Interpreter* interpreter_;
   profiling::BufferedProfiler profiler_;
   std::shared_ptr<profiling::ProfileSummaryFormatter> summarizer_formatter_;
+  bool log_op_cost_summary_ = false;
+  std::string chrome_trace_file_path_;
+  profiling::ChromeTraceBuilder chrome_trace_;
 };
 
 }  // namespace benchmark
@@ -638,6 +638,67 @@ TfLiteStatus SymmetricQuantizeTensorPerChannel(ModelT* model, TensorT* tensor,
 }
 // LINT.ThenChange(//tensorflow/compiler/mlir/lite/quantization/lite/toco_legacy/quantization_utils.cc:SymmetricQuantizeTensorPerChannel)
 
+TfLiteStatus SymmetricQuantizeTensorPerChannelToInt4(
+    ModelT* model, TensorT* tensor, int32_t channel_dim_index,
+    ErrorReporter* error_reporter) {
+  if (tensor->shape.size() > kPerChannelMaxDim) {
+    TF_LITE_REPORT_ERROR(
+        error_reporter,
+        "SymmetricQuantizeTensorPerChannelToInt4 requires tensor with less "
+        "than %d dimensions, but got %d dimension(s).",
+        kPerChannelMaxDim + 1, tensor->shape.size());
+    return kTfLiteError;
+  }
+
+  // Get dimensions.
+  uint64_t num_elements;
+  TF_LITE_ENSURE_STATUS(NumElements(*tensor, &num_elements));
+  const int32_t channel_dim_size = tensor->shape[channel_dim_index];
+
+  // Get input float data.
+  const BufferT* buffer = model->buffers[tensor->buffer].get();
+  const float* float_input_data =
+      reinterpret_cast<const float*>(buffer->data.data());
+
+  // Fill per channel max and min values if needed.
+  if (tensor->quantization == nullptr) {
+    tensor->quantization = std::make_unique<QuantizationParametersT>();
+  }
+  if (!HasMinMax(tensor)) {
+    TF_LITE_ENSURE_STATUS(
+        FillPerChannelMinMax(float_input_data, tensor->shape, channel_dim_index,
+                             tensor->quantization.get(), error_reporter));
+  }
+
+  // Calculate scales per channel using max and min values from tensor.
+  std::vector<float> scales(channel_dim_size);
+  std::vector<float> scale_invs(channel_dim_size);
+  const float half_scale = kMaxQuantizedValue4bit;
+  for (int channel_idx = 0; channel_idx < channel_dim_size; channel_idx++) {
+    const float half_range =
+        std::max(std::abs(tensor->quantization->min[channel_idx]),
+                 std::abs(tensor->quantization->max[channel_idx]));
+    scales[channel_idx] = half_range / half_scale;
+    scale_invs[channel_idx] = half_range == 0 ? 0 : half_scale / half_range;
+  }
+
+  // Quantize the input data to the int4 range, then pack it.
+  std::vector<int8_t> unpacked_buffer(num_elements);
+  SymmetricPerChannelQuantizeValues(float_input_data, scale_invs, tensor->shape,
+                                    channel_dim_index, &unpacked_buffer,
+                                    kTfLiteInt4);
+  std::vector<int8_t> final_buffer((num_elements + 1) / 2);
+  tensor_utils::PackInt8IntoDenseInt4(unpacked_buffer.data(), num_elements,
+                                      final_buffer.data());
+
+  // Set the buffers and output type.
+  uint8_t* uint8_buffer = reinterpret_cast<uint8_t*>(final_buffer.data());
+  std::vector<int64_t> zero_point(scales.size(), 0);
+  return AddQuantizationParams(scales, zero_point, channel_dim_index,
+                               uint8_buffer, final_buffer.size(),
+                               TensorType_INT4, model, tensor, error_reporter);
+}
+
 template <class BiasType>
 std::vector<BiasType> SymmetricBiasQuantize(const float* data,
                                             uint64_t num_elements,
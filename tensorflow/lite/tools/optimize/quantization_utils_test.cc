@@ -649,6 +649,34 @@ TEST_F(QuantizationUtilsTest, SymmetricQuantizeTensor) {
   EXPECT_EQ(quant_buffer_size * 4, float_buffer_size);
 }
 
+TEST_F(QuantizationUtilsTest, SymmetricQuantizeTensorPerChannelToInt4) {
+  // A 2x3 table quantized along its rows.
+  const std::vector<float> table = {0.7, -0.3, 0.0, 1.4, 0.2, -1.4};
+  ModelT model;
+  auto buffer = std::make_unique<BufferT>();
+  const uint8_t* table_bytes = reinterpret_cast<const uint8_t*>(table.data());
+  buffer->data.assign(table_bytes, table_bytes + table.size() * sizeof(float));
+  model.buffers.push_back(std::move(buffer));
+  TensorT tensor;
+  tensor.shape = {2, 3};
+  tensor.buffer = 0;
+  tensor.type = TensorType_FLOAT32;
+
+  EXPECT_EQ(SymmetricQuantizeTensorPerChannelToInt4(&model, &tensor, 0,
+                                                    &error_reporter_),
+            kTfLiteOk);
+
+  EXPECT_EQ(tensor.type, TensorType_INT4);
+  EXPECT_EQ(tensor.quantization->quantized_dimension, 0);
+  EXPECT_THAT(tensor.quantization->zero_point, ElementsAreArray({0, 0}));
+  ASSERT_EQ(tensor.quantization->scale.size(), 2);
+  EXPECT_FLOAT_EQ(tensor.quantization->scale[0], 0.1);
+  EXPECT_FLOAT_EQ(tensor.quantization->scale[1], 0.2);
+  // {7, -3, 0, 7, 1, -7}, two values per byte with the first one in the low
+  // nibble.
+  EXPECT_THAT(model.buffers[0]->data, ElementsAreArray({0xD7, 0x70, 0x91}));
+}
+
 TEST_F(QuantizationUtilsTest, QuantizeFloat16Clamp) {
   // Create data.
   auto model = std::make_unique<ModelT>();
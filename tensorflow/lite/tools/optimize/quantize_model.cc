@@ -1953,6 +1953,51 @@ TfLiteStatus EnsureBiasScaleCompatibility(
   return kTfLiteOk;
 }
 
+// Returns the index of the table input of embedding lookups, or -1 for other
+// operators.
+int GetEmbeddingTableInputIndex(BuiltinOperator op_code) {
+  switch (op_code) {
+    case BuiltinOperator_EMBEDDING_LOOKUP:
+      return 1;
+    case BuiltinOperator_EMBEDDING_LOOKUP_SPARSE:
+      return 4;
+    default:
+      return -1;
+  }
+}
+
+// Returns true if the tensor is only read as the table of embedding lookups
+// with float outputs, which the hybrid kernels can dequantize on the fly.
+bool IsOnlyUsedAsHybridEmbeddingTable(const ModelT* model,
+                                      const SubGraphT* subgraph,
+                                      int32_t tensor_idx) {
+  bool used = false;
+  for (const std::unique_ptr<OperatorT>& op : subgraph->operators) {
+    const int table_input = GetEmbeddingTableInputIndex(
+        GetBuiltinCode(model->operator_codes[op->opcode_index].get()));
+    for (size_t input_idx = 0; input_idx < op->inputs.size(); ++input_idx) {
+      if (op->inputs[input_idx] != tensor_idx) continue;
+      if (static_cast<int>(input_idx) != table_input ||
+          subgraph->tensors[op->outputs[0]]->type != TensorType_FLOAT32) {
+        return false;
+      }
+      used = true;
+    }
+  }
+  return used;
+}
+
+// Returns the number of tensors, in all subgraphs, referencing each buffer.
+std::vector<int> CountBufferReferences(const ModelT* model) {
+  std::vector<int> references(model->buffers.size(), 0);
+  for (const std::unique_ptr<SubGraphT>& subgraph : model->subgraphs) {
+    for (const std::unique_ptr<TensorT>& tensor : subgraph->tensors) {
+      if (tensor->buffer < references.size()) ++references[tensor->buffer];
+    }
+  }
+  return references;
+}
+
 }  // namespace
 
 // Assumes that the operators in the model have been topologically sorted.
@@ -2103,5 +2148,59 @@ TfLiteStatus QuantizeModel(flatbuffers::FlatBufferBuilder* builder,
                        /*allow_float=*/false, error_reporter);
 }
 
+TfLiteStatus QuantizeEmbeddingTables(flatbuffers::FlatBufferBuilder* builder,
+                                     ModelT* model,
+                                     const TensorType& table_type,
+                                     bool per_channel,
+                                     ErrorReporter* error_reporter) {
+  if (table_type != TensorType_INT8 && table_type != TensorType_INT4) {
+    TF_LITE_REPORT_ERROR(error_reporter,
+                         "Embedding tables can only be quantized to INT8 or "
+                         "INT4, got %s.",
+                         EnumNameTensorType(table_type));
+    return kTfLiteError;
+  }
+  // The tables are quantized in place, so tables whose buffer is shared with
+  // other tensors are left as they are.
+  const std::vector<int> buffer_references = CountBufferReferences(model);
+  for (size_t subgraph_idx = 0; subgraph_idx < model->subgraphs.size();
+       subgraph_idx++) {
+    SubGraphT* subgraph = model->subgraphs.at(subgraph_idx).get();
+    for (const std::unique_ptr<OperatorT>& op : subgraph->operators) {
+      const int table_input = GetEmbeddingTableInputIndex(
+          GetBuiltinCode(model->operator_codes[op->opcode_index].get()));
+      if (table_input < 0 ||
+          table_input >= static_cast<int>(op->inputs.size())) {
+        continue;
+      }
+      const int32_t table_idx = op->inputs[table_input];
+      TensorT* table = subgraph->tensors[table_idx].get();
+      // Tables shared by several lookups are quantized by the first one.
+      if (table->type != TensorType_FLOAT32 ||
+          !utils::HasBuffer(model, subgraph, table_idx) ||
+          buffer_references[table->buffer] > 1 ||
+          !IsOnlyUsedAsHybridEmbeddingTable(model, subgraph, table_idx)) {
+        continue;
+      }
+      // Per-row scales, or per-channel scales along the embedding dimension.
+      const int32_t channel_dim_index =
+          per_channel ? table->shape.size() - 1 : 0;
+      if (table_type == TensorType_INT4) {
+        TF_LITE_ENSURE_STATUS(utils::SymmetricQuantizeTensorPerChannelToInt4(
+            model, table, channel_dim_index, error_reporter));
+      } else {
+        TF_LITE_ENSURE_STATUS(utils::SymmetricQuantizeTensorPerChannel(
+            model, table, channel_dim_index, error_reporter));
+      }
+    }
+  }
+  utils::SetOperatorCodeVersion(model);
+  flatbuffers::Offset<Model> output_model_location =
+      Model::Pack(*builder, model);
+  FinishModelBuffer(*builder, output_model_location);
+
+  return kTfLiteOk;
+}
+
 }  // namespace optimize
 }  // namespace tflite
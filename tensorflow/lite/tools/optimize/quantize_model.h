@@ -133,6 +133,21 @@ TfLiteStatus QuantizeModel(
     bool disable_per_channel_quantization_for_dense_layers,
     ErrorReporter* error_reporter, bool handle_external_state);
 
+// Quantizes only the constant float tables of EMBEDDING_LOOKUP and
+// EMBEDDING_LOOKUP_SPARSE operators with float outputs to table_type (INT8 or
+// INT4), with symmetric per-row scales, or per-channel scales along the last
+// (embedding) dimension if per_channel is true. The kernels dequantize the
+// looked up rows on the fly, so no calibration is needed and the rest of the
+// model stays float. Tables also read by other operators, or whose buffer is
+// shared with other tensors, are left as they are.
+//
+// Note: This is a private API, subject to change.
+TfLiteStatus QuantizeEmbeddingTables(flatbuffers::FlatBufferBuilder* builder,
+                                     ModelT* model,
+                                     const TensorType& table_type,
+                                     bool per_channel,
+                                     ErrorReporter* error_reporter);
+
 }  // namespace optimize
 }  // namespace tflite
 
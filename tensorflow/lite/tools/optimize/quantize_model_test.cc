@@ -2304,6 +2304,146 @@ TEST_P(BiasInputTest, QuantizationSucceeds) {
   }
 }
 
+class QuantizeEmbeddingTablesTest : public testing::Test {
+ protected:
+  // Builds a model looking up rows of a constant 3x4 float table, which is
+  // also added to itself if `table_is_shared` is true.
+  void BuildModel(bool table_is_shared) {
+    const std::vector<float> table = {0.7, -0.3, 0.0,  0.1,  1.4, 0.2,
+                                      -1.4, 0.0, 0.07, 0.35, 0.0, -0.7};
+    const uint8_t* table_bytes = reinterpret_cast<const uint8_t*>(table.data());
+    model_.buffers.push_back(std::make_unique<BufferT>());
+    model_.buffers.push_back(std::make_unique<BufferT>());
+    model_.buffers[1]->data.assign(
+        table_bytes, table_bytes + table.size() * sizeof(float));
+
+    auto subgraph = std::make_unique<SubGraphT>();
+    AddTensor(subgraph.get(), "ids", {2}, TensorType_INT32, /*buffer=*/0);
+    AddTensor(subgraph.get(), "table", {3, 4}, TensorType_FLOAT32,
+              /*buffer=*/1);
+    AddTensor(subgraph.get(), "output", {2, 4}, TensorType_FLOAT32,
+              /*buffer=*/0);
+    AddOperator(subgraph.get(), BuiltinOperator_EMBEDDING_LOOKUP, {0, 1}, {2});
+    if (table_is_shared) {
+      AddTensor(subgraph.get(), "sum", {3, 4}, TensorType_FLOAT32,
+                /*buffer=*/0);
+      AddOperator(subgraph.get(), BuiltinOperator_ADD, {1, 1}, {3});
+    }
+    subgraph->inputs = {0};
+    subgraph->outputs = {2};
+    model_.subgraphs.push_back(std::move(subgraph));
+  }
+
+  const TensorT& table() const { return *model_.subgraphs[0]->tensors[1]; }
+
+  // Adds a float tensor sharing the buffer of the table to the subgraph
+  // `subgraph_idx`, which is created if it doesn't exist.
+  void AddTensorSharingTableBuffer(int subgraph_idx) {
+    if (subgraph_idx == static_cast<int>(model_.subgraphs.size())) {
+      model_.subgraphs.push_back(std::make_unique<SubGraphT>());
+    }
+    AddTensor(model_.subgraphs[subgraph_idx].get(), "table_alias", {3, 4},
+              TensorType_FLOAT32, table().buffer);
+  }
+
+  ModelT model_;
+  flatbuffers::FlatBufferBuilder builder_;
+  tflite::TestErrorReporter error_reporter_;
+
+ private:
+  static void AddTensor(SubGraphT* subgraph, const std::string& name,
+                        const std::vector<int32_t>& shape, TensorType type,
+                        uint32_t buffer) {
+    auto tensor = std::make_unique<TensorT>();
+    tensor->name = name;
+    tensor->shape = shape;
+    tensor->type = type;
+    tensor->buffer = buffer;
+    subgraph->tensors.push_back(std::move(tensor));
+  }
+
+  void AddOperator(SubGraphT* subgraph, BuiltinOperator op_code,
+                   const std::vector<int32_t>& inputs,
+                   const std::vector<int32_t>& outputs) {
+    auto opcode = std::make_unique<OperatorCodeT>();
+    opcode->builtin_code = op_code;
+    opcode->deprecated_builtin_code = static_cast<int8_t>(op_code);
+    opcode->version = 1;
+    model_.operator_codes.push_back(std::move(opcode));
+    auto op = std::make_unique<OperatorT>();
+    op->opcode_index = model_.operator_codes.size() - 1;
+    op->inputs = inputs;
+    op->outputs = outputs;
+    subgraph->operators.push_back(std::move(op));
+  }
+};
+
+TEST_F(QuantizeEmbeddingTablesTest, QuantizesTablesToInt4PerRow) {
+  BuildModel(/*table_is_shared=*/false);
+  ASSERT_EQ(QuantizeEmbeddingTables(&builder_, &model_, TensorType_INT4,
+                                    /*per_channel=*/false, &error_reporter_),
+            kTfLiteOk);
+
+  EXPECT_EQ(table().type, TensorType_INT4);
+  EXPECT_EQ(table().quantization->quantized_dimension, 0);
+  EXPECT_EQ(table().quantization->scale.size(), 3);
+  // Two values per byte.
+  EXPECT_EQ(model_.buffers[table().buffer]->data.size(), 6);
+  ASSERT_TRUE(GetModel(builder_.GetBufferPointer()));
+}
+
+TEST_F(QuantizeEmbeddingTablesTest, QuantizesTablesToInt8PerChannel) {
+  BuildModel(/*table_is_shared=*/false);
+  ASSERT_EQ(QuantizeEmbeddingTables(&builder_, &model_, TensorType_INT8,
+                                    /*per_channel=*/true, &error_reporter_),
+            kTfLiteOk);
+
+  EXPECT_EQ(table().type, TensorType_INT8);
+  EXPECT_EQ(table().quantization->quantized_dimension, 1);
+  EXPECT_EQ(table().quantization->scale.size(), 4);
+  EXPECT_EQ(model_.buffers[table().buffer]->data.size(), 12);
+}
+
+TEST_F(QuantizeEmbeddingTablesTest, SkipsTablesReadByOtherOperators) {
+  BuildModel(/*table_is_shared=*/true);
+  ASSERT_EQ(QuantizeEmbeddingTables(&builder_, &model_, TensorType_INT8,
+                                    /*per_channel=*/false, &error_reporter_),
+            kTfLiteOk);
+
+  EXPECT_EQ(table().type, TensorType_FLOAT32);
+}
+
+TEST_F(QuantizeEmbeddingTablesTest, SkipsTablesSharingTheirBuffer) {
+  BuildModel(/*table_is_shared=*/false);
+  AddTensorSharingTableBuffer(/*subgraph_idx=*/0);
+  const std::vector<uint8_t> table_data = model_.buffers[table().buffer]->data;
+  ASSERT_EQ(QuantizeEmbeddingTables(&builder_, &model_, TensorType_INT8,
+                                    /*per_channel=*/false, &error_reporter_),
+            kTfLiteOk);
+
+  EXPECT_EQ(table().type, TensorType_FLOAT32);
+  EXPECT_EQ(model_.buffers[table().buffer]->data, table_data);
+}
+
+TEST_F(QuantizeEmbeddingTablesTest, SkipsTablesSharingTheirBufferAcrossGraphs) {
+  BuildModel(/*table_is_shared=*/false);
+  AddTensorSharingTableBuffer(/*subgraph_idx=*/1);
+  const std::vector<uint8_t> table_data = model_.buffers[table().buffer]->data;
+  ASSERT_EQ(QuantizeEmbeddingTables(&builder_, &model_, TensorType_INT4,
+                                    /*per_channel=*/false, &error_reporter_),
+            kTfLiteOk);
+
+  EXPECT_EQ(table().type, TensorType_FLOAT32);
+  EXPECT_EQ(model_.buffers[table().buffer]->data, table_data);
+}
+
+TEST_F(QuantizeEmbeddingTablesTest, RejectsOtherTypes) {
+  BuildModel(/*table_is_shared=*/false);
+  EXPECT_EQ(QuantizeEmbeddingTables(&builder_, &model_, TensorType_INT16,
+                                    /*per_channel=*/false, &error_reporter_),
+            kTfLiteError);
+}
+
 }  // namespace
 }  // namespace optimize
 }  // namespace tflite
@@ -123,7 +123,9 @@ std::string FindMinimumRuntimeVersionForOp(tflite::BuiltinOperator op_code,
               {{BuiltinOperator_EMBEDDING_LOOKUP, 2}, "1.14.0"},
               {{BuiltinOperator_EMBEDDING_LOOKUP, 3}, "1.14.0"},
               {{BuiltinOperator_EMBEDDING_LOOKUP, 4}, "2.18.0"},
+              {{BuiltinOperator_EMBEDDING_LOOKUP, 5}, "2.20.0"},
               {{BuiltinOperator_EMBEDDING_LOOKUP_SPARSE, 1}, "1.5.0"},
+              {{BuiltinOperator_EMBEDDING_LOOKUP_SPARSE, 2}, "2.20.0"},
               {{BuiltinOperator_FAKE_QUANT, 1}, "1.5.0"},
               {{BuiltinOperator_FAKE_QUANT, 2}, "1.10.0"},
               {{BuiltinOperator_FULLY_CONNECTED, 1}, "1.5.0"},
@@ -166,6 +166,31 @@ class UniqueTest(test.TestCase):
     self.assertAllEqual(tf_y, true_y)
     self.assertAllEqual(tf_idx, true_idx)
 
+  def testOrderedByAppearanceLarge(self):
+    # Large enough to take the parallel, hash-partitioned code path.
+    for dtype in [np.int32, np.int64]:
+      with self.subTest(dtype=dtype):
+        x = np.random.randint(-5000, high=5000, size=300000).astype(dtype)
+        _, first_index, true_idx = np.unique(
+            x, return_index=True, return_inverse=True)
+        order = np.argsort(first_index)
+        rank = np.empty_like(order)
+        rank[order] = np.arange(len(order))
+        y, idx = array_ops.unique(x)
+        tf_y, tf_idx = self.evaluate([y, idx])
+        self.assertAllEqual(tf_y, x[np.sort(first_index)])
+        self.assertAllEqual(tf_idx, rank[true_idx])
+
+  def testStringLarge(self):
+    indx = np.random.randint(0, high=20000, size=300000)
+    x = [b'key_%d' % i for i in indx]
+    _, first_index = np.unique(indx, return_index=True)
+    y, idx = array_ops.unique(x)
+    tf_y, tf_idx = self.evaluate([y, idx])
+    self.assertAllEqual(tf_y, [x[i] for i in np.sort(first_index)])
+    for i in range(0, len(x), 997):
+      self.assertEqual(x[i], tf_y[tf_idx[i]])
+
 
 class UniqueWithCountsTest(test.TestCase):
 
@@ -313,6 +338,18 @@ class UniqueWithCountsTest(test.TestCase):
     self.assertAllEqual(tf_idx, true_idx)
     self.assertAllEqual(tf_count, true_count)
 
+  def testOrderedByAppearanceLarge(self):
+    # Large enough to take the parallel, hash-partitioned code path.
+    x = np.random.randint(0, high=3000, size=300000).astype(np.int64)
+    _, first_index, true_count = np.unique(
+        x, return_index=True, return_counts=True)
+    order = np.argsort(first_index)
+    y, idx, count = array_ops.unique_with_counts(x)
+    tf_y, tf_idx, tf_count = self.evaluate([y, idx, count])
+    self.assertAllEqual(tf_y, x[first_index[order]])
+    self.assertAllEqual(tf_y[tf_idx], x)
+    self.assertAllEqual(tf_count, true_count[order])
+
 
 if __name__ == '__main__':
   test.main()